@@ -0,0 +1,604 @@
+// bench/bench.cpp
+// Reproducible performance scenarios for rayforce-ui (make bench)
+//
+// Runs UI-thread hot paths against synthetic data in a headless GL context and
+// writes one JSON document with per-scenario timing statistics:
+//
+//   rfui-bench [--quick] [--filter NAME] [--out FILE] [--app PATH] [--script FILE]
+//
+// Data is generated from a fixed seed so runs are comparable across releases.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "imgui_impl_opengl3.h"
+#include "implot.h"
+#include "../src/embed_assets.h"
+
+#define GL_SILENCE_DEPRECATION
+#include <GLFW/glfw3.h>
+
+// Make rayforce headers C++ compatible by redefining _Static_assert
+#define _Static_assert static_assert
+
+extern "C" {
+#include "../include/rfui/context.h"
+#include "../include/rfui/queue.h"
+#include "../include/rfui/widget.h"
+#include "../include/rfui/grid_renderer.h"
+#include "../include/rfui/chart_renderer.h"
+#include "../include/rfui/repl_renderer.h"
+#include "../include/rfui/syntax.h"
+#include "../include/rfui/theme.h"
+#include "../include/rfui/headless.h"
+#include "../include/rfui/offscreen.h"
+#include "../include/rfui/version.h"
+#include "../include/rfui/symbols.h"
+#include "../include/rfui/ui.h"
+#include "../include/rfui/rfui.h"
+#include "../deps/rayforce/core/runtime.h"
+#include "../deps/rayforce/core/symbols.h"
+#include "../deps/rayforce/core/thread.h"
+
+// Renderers reach the Rayforce thread through g_ctx (defined in main.c);
+// the bench has no Rayforce thread, so it stays NULL
+rfui_ctx_t* g_ctx = NULL;
+
+// main.c and ui.cpp aren't linked: their entry points the renderers and
+// jobs call are stood in for here. The runtime lives on this thread, so
+// retired data can be dropped right away.
+i32_t rfui_eval(const char* expr) {
+    (void)expr;
+    return -1;
+}
+
+nil_t rfui_ui_wake(nil_t) {}
+
+nil_t rfui_ui_queue_drop(obj_p obj, i64_t bytes) {
+    (void)bytes;
+    if (obj) drop_obj(obj);
+}
+}
+
+#define BENCH_WIDTH   1920
+#define BENCH_HEIGHT  1080
+#define WARMUP_FRAMES 10
+
+// ============================================================================
+// Results
+// ============================================================================
+
+typedef struct bench_result_t {
+    std::string name;
+    std::string params;         // JSON object body, e.g. "\"rows\": 1000000"
+    std::vector<double> samples; // Per-iteration time in ms
+    double throughput;          // Optional derived rate (0 = none)
+    const char* throughput_unit;
+    std::string raw_json;       // Pre-rendered stats (external scenarios)
+} bench_result_t;
+
+static std::vector<bench_result_t> g_results;
+static bool g_quick = false;
+static const char* g_filter = nullptr;
+
+static double now_ms(void) {
+    using namespace std::chrono;
+    return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Deterministic xorshift so every run sees the same data
+static u64_t g_seed = 0x9E3779B97F4A7C15ull;
+static u64_t rng_next(void) {
+    g_seed ^= g_seed << 13;
+    g_seed ^= g_seed >> 7;
+    g_seed ^= g_seed << 17;
+    return g_seed;
+}
+static double rng_unit(void) {
+    return (double)(rng_next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static bool selected(const char* name) {
+    return !g_filter || strstr(name, g_filter) != nullptr;
+}
+
+static void write_stats(FILE* f, std::vector<double> s) {
+    std::sort(s.begin(), s.end());
+    size_t n = s.size();
+    double total = 0.0;
+    for (double v : s) total += v;
+    auto pct = [&](double p) -> double { return s[(size_t)(p * (double)(n - 1) + 0.5)]; };
+    fprintf(f, "\"iterations\": %zu, \"ms\": {\"min\": %.6f, \"avg\": %.6f, \"p50\": %.6f, "
+               "\"p95\": %.6f, \"p99\": %.6f, \"max\": %.6f}",
+            n, s[0], total / (double)n, pct(0.50), pct(0.95), pct(0.99), s[n - 1]);
+}
+
+static void write_json(FILE* f) {
+    time_t t = time(nullptr);
+    char stamp[32];
+    strftime(stamp, sizeof(stamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&t));
+
+    fprintf(f, "{\n  \"version\": \"%s\",\n  \"timestamp\": \"%s\",\n  \"quick\": %s,\n  \"results\": [",
+            RFUI_VERSION, stamp, g_quick ? "true" : "false");
+    for (size_t i = 0; i < g_results.size(); i++) {
+        const bench_result_t& r = g_results[i];
+        fprintf(f, "%s\n    {\"name\": \"%s\", \"params\": {%s}, ", i ? "," : "", r.name.c_str(), r.params.c_str());
+        if (!r.raw_json.empty()) {
+            fprintf(f, "%s", r.raw_json.c_str());
+        } else if (!r.samples.empty()) {
+            write_stats(f, r.samples);
+        } else {
+            fprintf(f, "\"skipped\": true");
+        }
+        if (r.throughput > 0.0) {
+            fprintf(f, ", \"throughput\": %.3f, \"throughput_unit\": \"%s\"", r.throughput, r.throughput_unit);
+        }
+        fprintf(f, "}");
+    }
+    fprintf(f, "\n  ]\n}\n");
+}
+
+// ============================================================================
+// Headless frame harness
+// ============================================================================
+
+static rfui_fbo_t g_fbo;
+
+static bool gl_init(void) {
+    if (rfui_headless_init() != 0) return false;
+    if (rfui_offscreen_init(rfui_headless_get_proc) != 0 ||
+        rfui_fbo_create(&g_fbo, BENCH_WIDTH, BENCH_HEIGHT) != 0) {
+        rfui_headless_destroy();
+        return false;
+    }
+
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImPlot::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr;
+    io.DisplaySize = ImVec2((float)BENCH_WIDTH, (float)BENCH_HEIGHT);
+    rfui_theme_apply();
+
+    // Same font as the app so text layout cost is representative
+    ImFontConfig font_cfg;
+    font_cfg.FontDataOwnedByAtlas = false;
+    io.Fonts->AddFontFromMemoryTTF((void*)embed_JetBrainsMono_Regular_ttf, embed_JetBrainsMono_Regular_ttf_len, 20.0f, &font_cfg);
+    static const ImWchar icon_ranges[] = { 0xf000, 0xf8ff, 0 };
+    ImFontConfig icon_cfg;
+    icon_cfg.MergeMode = true;
+    icon_cfg.FontDataOwnedByAtlas = false;
+    io.Fonts->AddFontFromMemoryTTF((void*)embed_fa_solid_900_otf, embed_fa_solid_900_otf_len, 20.0f, &icon_cfg, icon_ranges);
+
+    ImGui_ImplOpenGL3_Init("#version 130");
+    return true;
+}
+
+static void gl_destroy(void) {
+    ImGui_ImplOpenGL3_Shutdown();
+    ImPlot::DestroyContext();
+    ImGui::DestroyContext();
+    rfui_fbo_destroy(&g_fbo);
+    rfui_headless_destroy();
+}
+
+// One full frame: build UI, render, wait for the GPU. Returns wall time in ms.
+template <typename F>
+static double run_frame(F body) {
+    double start = now_ms();
+
+    ImGuiIO& io = ImGui::GetIO();
+    io.DeltaTime = 1.0f / 60.0f;
+    ImGui_ImplOpenGL3_NewFrame();
+    ImGui::NewFrame();
+
+    ImGui::SetNextWindowPos(ImVec2(0, 0));
+    ImGui::SetNextWindowSize(io.DisplaySize);
+    ImGui::Begin("bench", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings);
+    body();
+    ImGui::End();
+    ImGui::Render();
+
+    rfui_fbo_bind(&g_fbo);
+    glViewport(0, 0, g_fbo.width, g_fbo.height);
+    glClearColor(0.051f, 0.067f, 0.090f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    glFinish();
+
+    return now_ms() - start;
+}
+
+// Jump every scrollable child of the bench window to a pseudo-random offset
+// (exercises the ListClipper on each frame instead of the same top rows)
+static void scroll_children_randomly(void) {
+    ImGuiContext& g = *ImGui::GetCurrentContext();
+    double frac = rng_unit();
+    for (ImGuiWindow* w : g.Windows) {
+        if ((w->Flags & ImGuiWindowFlags_ChildWindow) && w->ScrollMax.y > 0.0f) {
+            ImGui::SetScrollY(w, (float)(frac * w->ScrollMax.y));
+        }
+    }
+}
+
+template <typename F>
+static void measure_frames(bench_result_t& r, i32_t frames, bool scroll, F body) {
+    for (i32_t i = 0; i < WARMUP_FRAMES; i++) {
+        run_frame(body);
+        if (scroll) scroll_children_randomly();
+    }
+    r.samples.reserve(frames);
+    for (i32_t i = 0; i < frames; i++) {
+        r.samples.push_back(run_frame(body));
+        if (scroll) scroll_children_randomly();
+    }
+}
+
+// ============================================================================
+// Synthetic tables
+// ============================================================================
+
+static obj_p make_table(i64_t ncols, const char** names, obj_p* cols) {
+    obj_p keys = vector(TYPE_SYMBOL, ncols);
+    obj_p vals = vector(TYPE_LIST, ncols);
+    for (i64_t i = 0; i < ncols; i++) {
+        AS_SYMBOL(keys)[i] = symbols_intern(names[i], strlen(names[i]));
+        AS_LIST(vals)[i] = cols[i];
+    }
+    obj_p t = table(keys, vals);
+
+    // Ship the symbol strings as a draw would (the bench has no Rayforce thread)
+    rfui_sym_delta_t* d = rfui_symbols_collect(t);
+    rfui_symbols_apply(d);
+    return t;
+}
+
+// Trades-like table: id, sym, ts, price, size
+static obj_p make_trades(i64_t rows) {
+    static const char* syms[] = { "AAPL", "IBM", "MSFT", "BABA", "GOOG", "AMZN" };
+    i64_t sym_ids[6];
+    for (i32_t i = 0; i < 6; i++) sym_ids[i] = symbols_intern(syms[i], strlen(syms[i]));
+
+    obj_p id = vector(TYPE_I64, rows);
+    obj_p sym = vector(TYPE_SYMBOL, rows);
+    obj_p ts = vector(TYPE_TIMESTAMP, rows);
+    obj_p price = vector(TYPE_F64, rows);
+    obj_p size = vector(TYPE_I64, rows);
+
+    double p = 100.0;
+    for (i64_t i = 0; i < rows; i++) {
+        p += rng_unit() - 0.5;
+        AS_I64(id)[i] = i;
+        AS_SYMBOL(sym)[i] = sym_ids[rng_next() % 6];
+        AS_TIMESTAMP(ts)[i] = 800000000000000000ll + i * 1000000ll;
+        AS_F64(price)[i] = p;
+        AS_I64(size)[i] = (i64_t)(rng_next() % 1000) + 1;
+    }
+
+    const char* names[] = { "id", "sym", "ts", "price", "size" };
+    obj_p cols[] = { id, sym, ts, price, size };
+    return make_table(5, names, cols);
+}
+
+// Single random-walk series
+static obj_p make_series(i64_t points) {
+    obj_p price = vector(TYPE_F64, points);
+    double p = 100.0;
+    for (i64_t i = 0; i < points; i++) {
+        p += rng_unit() - 0.5;
+        AS_F64(price)[i] = p;
+    }
+    const char* names[] = { "price" };
+    obj_p cols[] = { price };
+    return make_table(1, names, cols);
+}
+
+// OHLC bars
+static obj_p make_ohlc(i64_t bars) {
+    obj_p o = vector(TYPE_F64, bars);
+    obj_p h = vector(TYPE_F64, bars);
+    obj_p l = vector(TYPE_F64, bars);
+    obj_p c = vector(TYPE_F64, bars);
+    double p = 100.0;
+    for (i64_t i = 0; i < bars; i++) {
+        double open = p;
+        p += rng_unit() - 0.5;
+        AS_F64(o)[i] = open;
+        AS_F64(c)[i] = p;
+        AS_F64(h)[i] = (open > p ? open : p) + rng_unit() * 0.25;
+        AS_F64(l)[i] = (open < p ? open : p) - rng_unit() * 0.25;
+    }
+    const char* names[] = { "open", "high", "low", "close" };
+    obj_p cols[] = { o, h, l, c };
+    return make_table(4, names, cols);
+}
+
+// ============================================================================
+// Scenarios
+// ============================================================================
+
+typedef struct queue_bench_t {
+    rfui_queue_p q;
+    i64_t count;
+} queue_bench_t;
+
+static void* queue_producer(void* arg) {
+    queue_bench_t* b = (queue_bench_t*)arg;
+    for (i64_t i = 1; i <= b->count; i++) {
+        while (!rfui_queue_push(b->q, (raw_p)(intptr_t)i)) {
+            // Full - spin until the consumer catches up
+        }
+    }
+    return nullptr;
+}
+
+// One producer thread, one consumer (the pattern used by ray_to_ui/ui_to_ray)
+static void bench_queue(void) {
+    const char* name = "queue_spsc";
+    if (!selected(name)) return;
+
+    i64_t count = g_quick ? 1000000 : 10000000;
+    i32_t rounds = g_quick ? 3 : 5;
+
+    bench_result_t r;
+    r.name = name;
+    r.params = "\"items\": " + std::to_string(count) + ", \"capacity\": 1024";
+    r.throughput = 0.0;
+
+    double best = 0.0;
+    for (i32_t round = 0; round < rounds; round++) {
+        queue_bench_t b;
+        b.q = rfui_queue_create(1024);
+        b.count = count;
+        if (!b.q) break;
+
+        double start = now_ms();
+        ray_thread_t producer = ray_thread_create(queue_producer, &b);
+        i64_t received = 0;
+        while (received < count) {
+            if (rfui_queue_pop(b.q)) received++;
+        }
+        thread_join(producer);
+        double ms = now_ms() - start;
+
+        r.samples.push_back(ms);
+        double rate = (double)count / (ms / 1000.0);
+        if (rate > best) best = rate;
+        rfui_queue_destroy(b.q);
+    }
+    r.throughput = best;
+    r.throughput_unit = "items/s";
+    g_results.push_back(r);
+}
+
+static void bench_grid(i64_t rows) {
+    std::string name = "grid_" + std::to_string(rows / 1000000) + "m";
+    if (!selected(name.c_str())) return;
+
+    bench_result_t r;
+    r.name = name;
+    r.params = "\"rows\": " + std::to_string(rows) + ", \"cols\": 5, \"scroll\": \"random\"";
+    r.throughput = 0.0;
+
+    rfui_widget_t* w = rfui_widget_create(RFUI_WIDGET_GRID, "bench-grid");
+    w->render_data = make_trades(rows);
+    measure_frames(r, g_quick ? 100 : 500, true, [&]() { rfui_render_grid(w); });
+
+    rfui_widget_destroy(w);  // Drops render_data
+    g_results.push_back(r);
+}
+
+static void bench_chart(const char* kind, i64_t points) {
+    std::string name = std::string("chart_") + kind + "_" + std::to_string(points / 1000000) + "m";
+    if (!selected(name.c_str())) return;
+
+    bench_result_t r;
+    r.name = name;
+    r.params = "\"points\": " + std::to_string(points);
+    r.throughput = 0.0;
+
+    rfui_widget_t* w = rfui_widget_create(RFUI_WIDGET_CHART, "bench-chart");
+    w->render_data = strcmp(kind, "candle") == 0 ? make_ohlc(points) : make_series(points);
+    measure_frames(r, g_quick ? 20 : 100, false, [&]() { rfui_render_chart(w); });
+    r.throughput = (double)points / (r.samples[r.samples.size() / 2] / 1000.0);
+    r.throughput_unit = "points/s";
+
+    rfui_widget_destroy(w);  // Drops render_data
+    g_results.push_back(r);
+}
+
+static void bench_tokenize(void) {
+    const char* name = "tokenize";
+    if (!selected(name)) return;
+
+    // Representative Rayfall (strings, comments, symbols, numbers, builtins)
+    static const char* chunk =
+        ";; OHLC from last trades\n"
+        "(timer 100 10000000 (fn [x] (let r (select {from: (take trades -500) "
+        "by: (xbar Ts 1000) open: (first Price) high: (max Price) low: (min Price) "
+        "close: (last Price)})) (draw pc r) (insert 'quotes (list 'AAPL 12.5 \"tag\"))))\n";
+
+    size_t target = g_quick ? (1u << 20) : (8u << 20);
+    std::string text;
+    text.reserve(target + strlen(chunk));
+    while (text.size() < target) text += chunk;
+
+    std::vector<rfui_token_t> tokens(text.size());
+    bench_result_t r;
+    r.name = name;
+    r.params = "\"bytes\": " + std::to_string(text.size());
+
+    int ntok = 0;
+    for (i32_t i = 0; i < (g_quick ? 5 : 20); i++) {
+        double start = now_ms();
+        ntok = rfui_tokenize(text.c_str(), tokens.data(), (int)tokens.size());
+        r.samples.push_back(now_ms() - start);
+    }
+    std::vector<double> sorted(r.samples);
+    std::sort(sorted.begin(), sorted.end());
+    r.params += ", \"tokens\": " + std::to_string(ntok);
+    r.throughput = (double)text.size() / (1024.0 * 1024.0) / (sorted[sorted.size() / 2] / 1000.0);
+    r.throughput_unit = "MiB/s";
+    g_results.push_back(r);
+}
+
+static void bench_repl(void) {
+    const char* name = "repl_scrollback_10k";
+    if (!selected(name)) return;
+
+    rfui_repl_init();
+    for (i32_t i = 0; i < 10000; i++) {
+        char line[160];
+        if (i % 10 == 0) {
+            snprintf(line, sizeof(line), "error: \x1b[31mtype mismatch\x1b[0m at line %d", i);
+        } else {
+            snprintf(line, sizeof(line), "%d  \x1b[32mAAPL\x1b[0m  %.4f  %lld", i, 100.0 + i * 0.01, (long long)i * 37);
+        }
+        rfui_repl_add_result_text(line);
+    }
+
+    bench_result_t r;
+    r.name = name;
+    r.params = "\"lines\": 10000";
+    r.throughput = 0.0;
+    measure_frames(r, g_quick ? 50 : 300, false, [&]() { rfui_repl_render(); });
+
+    rfui_repl_destroy();
+    g_results.push_back(r);
+}
+
+// Full app under the simulator workload: spawn rayforce-ui headless and embed
+// the frame statistics it writes via --stats-json
+static void bench_simulator(const char* app, const char* script) {
+    const char* name = "simulator_e2e";
+    if (!selected(name)) return;
+
+    i32_t frames = g_quick ? 300 : 1800;
+    char stats_path[] = "/tmp/rfui-bench-XXXXXX";
+    bench_result_t r;
+    r.name = name;
+    r.params = "\"script\": \"" + std::string(script) + "\", \"frames\": " + std::to_string(frames) + ", \"fps\": 60";
+    r.throughput = 0.0;
+
+#ifndef _WIN32
+    int fd = mkstemp(stats_path);
+    if (fd < 0) {
+        g_results.push_back(r);
+        return;
+    }
+    close(fd);
+
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "%s --headless --size %dx%d --frames %d --fps 60 --stats-json %s -f %s > /dev/null",
+             app, BENCH_WIDTH, BENCH_HEIGHT, frames, stats_path, script);
+    if (system(cmd) == 0) {
+        FILE* f = fopen(stats_path, "r");
+        if (f) {
+            char buf[4096];
+            size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+            fclose(f);
+            buf[n] = '\0';
+            // Strip the outer braces so the fields merge into the result object
+            char* open = strchr(buf, '{');
+            char* close_brace = strrchr(buf, '}');
+            if (open && close_brace && close_brace > open) {
+                *close_brace = '\0';
+                std::string body(open + 1);
+                while (!body.empty() && (body.back() == '\n' || body.back() == ' ')) body.pop_back();
+                while (!body.empty() && (body[0] == '\n' || body[0] == ' ')) body.erase(0, 1);
+                r.raw_json = body;
+            }
+        }
+    } else {
+        fprintf(stderr, "bench: %s failed\n", cmd);
+    }
+    remove(stats_path);
+#else
+    (void)app;
+    (void)script;
+#endif
+    g_results.push_back(r);
+}
+
+// ============================================================================
+// Main
+// ============================================================================
+
+int main(int argc, char** argv) {
+    const char* out_path = nullptr;
+    const char* app = "./rayforce-ui";
+    const char* script = "examples/simulator.rfl";
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quick") == 0) {
+            g_quick = true;
+        } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            g_filter = argv[++i];
+        } else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            out_path = argv[++i];
+        } else if (strcmp(argv[i], "--app") == 0 && i + 1 < argc) {
+            app = argv[++i];
+        } else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc) {
+            script = argv[++i];
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--filter NAME] [--out FILE] [--app PATH] [--script FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    // Heap for synthetic tables (no script, no REPL)
+    char* runtime_argv[] = { argv[0], nullptr };
+    if (!runtime_create(1, runtime_argv)) {
+        fprintf(stderr, "bench: failed to create Rayforce runtime\n");
+        return 1;
+    }
+
+    bench_queue();
+
+    if (gl_init()) {
+        bench_grid(1000000);
+        if (!g_quick) bench_grid(10000000);
+
+        bench_chart("line", 1000000);
+        if (!g_quick) {
+            bench_chart("line", 10000000);
+            bench_chart("line", 50000000);
+        }
+        bench_chart("candle", 1000000);
+        if (!g_quick) bench_chart("candle", 10000000);
+
+        bench_repl();
+        gl_destroy();
+    } else {
+        fprintf(stderr, "bench: headless GL unavailable, skipping render scenarios\n");
+    }
+
+    bench_tokenize();
+    bench_simulator(app, script);
+
+    runtime_destroy();
+
+    FILE* out = stdout;
+    if (out_path) {
+        out = fopen(out_path, "w");
+        if (!out) {
+            fprintf(stderr, "bench: cannot write %s\n", out_path);
+            return 1;
+        }
+    }
+    write_json(out);
+    if (out != stdout) fclose(out);
+
+    return 0;
+}
@@ -36,6 +36,10 @@ typedef struct rfui_ctx_t {
 
     // Exit flag - access must be protected by ready_mutex
     b8_t quit;
+
+    // --replay: recorded draw log fed to the Rayforce thread instead of a script
+    const char* replay;
+    f64_t replay_speed;
 } rfui_ctx_t;
 
 // Create a new context with command line arguments
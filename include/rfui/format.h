@@ -0,0 +1,73 @@
+// include/rfui/format.h
+// Typed value formatting shared by the renderers
+//
+// Floats print as the shortest decimal that parses back to the same double
+// (Ryu), or with a fixed number of decimals. Dates and timestamps print as
+// calendar values (2000.01.01 epoch, `2024.03.15`, `2024.03.15D09:30:00.000000000`)
+// through table lookups rather than division chains. Numbers can group
+// integer digits with ','. Nothing here allocates except the column batch
+// buffer, so any thread may call it.
+
+#ifndef RFUI_FORMAT_H
+#define RFUI_FORMAT_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Longest formatted cell (longer symbols are truncated)
+#define RFUI_FMT_CELL_MAX 256
+
+// Longest string cell in characters (longer strings end in "...")
+#define RFUI_FMT_TEXT_MAX 120
+
+// Buffer size enough for any number, date, time, timestamp or guid
+#define RFUI_FMT_NUM_MAX 64
+
+typedef struct rfui_fmt_t {
+    i32_t decimals;    // F64 digits after the point (-1 = shortest round-trip)
+    b8_t thousands;    // Group integer digits with ','
+} rfui_fmt_t;
+
+extern const rfui_fmt_t rfui_fmt_default;
+
+// Single values; each writes at most RFUI_FMT_NUM_MAX bytes (no terminator)
+// and returns the length. Nulls print as "null".
+i32_t rfui_fmt_f64(f64_t v, const rfui_fmt_t* fmt, c8_t* buf);
+i32_t rfui_fmt_i64(i64_t v, const rfui_fmt_t* fmt, c8_t* buf);
+i32_t rfui_fmt_date(i32_t days, c8_t* buf);        // Days since 2000.01.01
+i32_t rfui_fmt_time(i32_t ms, c8_t* buf);          // Milliseconds since midnight
+i32_t rfui_fmt_timestamp(i64_t ns, c8_t* buf);     // Nanoseconds since 2000.01.01
+i32_t rfui_fmt_guid(const u8_t* g, c8_t* buf);
+
+// One cell of a column. Writes at most buf_sz - 1 bytes plus a terminator
+// and returns the length; *dim is set for values drawn dimmed (nulls, nested
+// lists other than strings, unknown types).
+i32_t rfui_fmt_cell(obj_p col, i64_t row, const rfui_fmt_t* fmt, c8_t* buf, i64_t buf_sz, b8_t* dim);
+
+// Growable text buffer for batches
+typedef struct rfui_fmt_buf_t {
+    c8_t* text;
+    i64_t len;
+    i64_t cap;
+} rfui_fmt_buf_t;
+
+// Append n cells of col to out: display rows [from, from + n), mapped to data
+// rows through rows[0..rows_n) (NULL or past rows_n = same row). offsets[i]
+// is where cell i starts in out->text; dim[i] as for rfui_fmt_cell. The type
+// dispatch happens once per call. False if out of memory.
+b8_t rfui_fmt_column(obj_p col, const u32_t* rows, i64_t rows_n, i64_t from, i64_t n,
+                     const rfui_fmt_t* fmt, rfui_fmt_buf_t* out, u32_t* offsets, u8_t* dim);
+
+// Append n bytes of already formatted text. False if out of memory.
+b8_t rfui_fmt_buf_append(rfui_fmt_buf_t* out, const c8_t* text, i64_t n);
+
+nil_t rfui_fmt_buf_free(rfui_fmt_buf_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_FORMAT_H
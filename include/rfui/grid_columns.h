@@ -0,0 +1,60 @@
+// include/rfui/grid_columns.h
+// Grid column side table: per-column widths and offsets
+//
+// ImGui tables hold at most 512 columns and set up every column each frame.
+// Wider grids draw a window of RFUI_GRID_COLUMN_WINDOW columns between two
+// spacer columns sized to the columns scrolled past on either side, so the
+// table's own horizontal scrollbar spans the whole grid. Widths come from
+// this side table rather than ImGui's per-column state, which would follow
+// table column indices as the window moves. Columns the user hides take no
+// width and no window slot: the window is cut from the list of visible
+// columns, so its slots always hold columns that are drawn.
+
+#ifndef RFUI_GRID_COLUMNS_H
+#define RFUI_GRID_COLUMNS_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Data columns drawn at once by a windowed grid; narrower grids use a plain table
+#define RFUI_GRID_COLUMN_WINDOW 128
+
+typedef struct rfui_grid_columns_t {
+    i64_t ncols;
+    i64_t version;     // Data version the widths were taken from
+    float pad;         // Per-column padding + border the offsets include
+    i64_t hidden_gen;  // Hidden-column generation the offsets were taken from
+    float* widths;     // Inner width (TableSetupColumn units)
+    float* x;          // x[c] = left edge of column c; x[ncols] = total width
+    i64_t* vis;        // Visible columns in order
+    i64_t nvis;
+} rfui_grid_columns_t;
+
+// Default inner width for a column type
+float rfui_grid_column_width(i8_t type);
+
+// Rebuild widths and offsets for new data or a new hidden set (no-op if
+// version, pad and hidden_gen match). hidden holds one flag per column, or
+// is NULL when every column shows.
+nil_t rfui_grid_columns_update(rfui_grid_columns_t* c, obj_p vals, i64_t version, float pad,
+                               const u8_t* hidden, i64_t hidden_gen);
+
+// Fill idx with the visible columns of the window that shows scroll_x,
+// clamped so the window stays full. Returns how many (at most
+// RFUI_GRID_COLUMN_WINDOW).
+i64_t rfui_grid_columns_window(const rfui_grid_columns_t* c, float scroll_x, i64_t* idx);
+
+// Visible column under x, or -1 past the last one
+i64_t rfui_grid_columns_at(const rfui_grid_columns_t* c, float x);
+
+nil_t rfui_grid_columns_free(rfui_grid_columns_t* c);
+i64_t rfui_grid_columns_bytes(const rfui_grid_columns_t* c);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_COLUMNS_H
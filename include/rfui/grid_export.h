@@ -0,0 +1,74 @@
+// include/rfui/grid_export.h
+// Grid export: the current view to a CSV / TSV file or the clipboard
+//
+// The job runs on the worker pool and walks the view in chunks: each chunk's
+// display rows are mapped through the sort / filter row list, every exported
+// column is formatted with rfui_fmt_column, and the cells are interleaved
+// into delimited lines and written out before the next chunk. Memory stays
+// at one chunk however many rows are exported (the clipboard, which needs
+// one string, is the exception). Values use the lossless default format:
+// shortest round-trip floats, no thousands separators, nulls as empty fields.
+
+#ifndef RFUI_GRID_EXPORT_H
+#define RFUI_GRID_EXPORT_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum rfui_export_kind_t {
+    RFUI_EXPORT_CSV = 0,       // Comma separated, RFC 4180 quoting
+    RFUI_EXPORT_TSV,           // Tab separated, tabs/newlines in fields become spaces
+    RFUI_EXPORT_CLIPBOARD      // TSV text handed back for the clipboard
+} rfui_export_kind_t;
+
+struct rfui_export_job_t;
+
+typedef struct rfui_grid_export_t {
+    struct rfui_export_job_t* job;   // In flight (NULL = idle)
+    char status[320];                // Outcome of the last export ("" = none)
+    b8_t failed;                     // status describes an error
+    f64_t status_time;               // When status was set (caller's clock)
+    c8_t* clipboard;                 // Finished clipboard text, taken by the UI (NULL = none)
+} rfui_grid_export_t;
+
+// View to export (everything is copied; the table must stay alive while
+// rfui_grid_export_reads says so)
+typedef struct rfui_export_view_t {
+    obj_p table;
+    const u32_t* rows;         // Display row -> data row for the first rows_n rows (NULL = natural)
+    i64_t rows_n;
+    i64_t display_rows;        // Rows in the view
+    const i32_t* cols;         // Exported columns in order
+    i32_t ncols;
+    const u64_t* only;         // Data-row bitmap: export only these rows (NULL = all)
+    i64_t only_n;              // Rows the bitmap covers
+} rfui_export_view_t;
+
+// Start an export (path is ignored for the clipboard). False if one is
+// already running or memory ran out.
+b8_t rfui_grid_export_start(rfui_grid_export_t* e, const rfui_export_view_t* view,
+                            rfui_export_kind_t kind, const char* path);
+
+// Share of the view done so far, or -1 when idle
+f64_t rfui_grid_export_progress(const rfui_grid_export_t* e);
+
+// Ask the running export to stop (the partial file is removed)
+nil_t rfui_grid_export_cancel(rfui_grid_export_t* e);
+
+// Per frame on the UI thread: adopt a finished job (sets status, clipboard)
+nil_t rfui_grid_export_update(rfui_grid_export_t* e, f64_t now);
+
+// Whether a job (running or not yet adopted) reads table
+b8_t rfui_grid_export_reads(const rfui_grid_export_t* e, obj_p table);
+
+// Cancel and wait for the job, free clipboard text
+nil_t rfui_grid_export_free(rfui_grid_export_t* e);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_EXPORT_H
@@ -0,0 +1,67 @@
+// include/rfui/grid_filter.h
+// Grid filter bar: per-column filters evaluated into a selection vector
+//
+// Each column's filter text is parsed into a grid rule and evaluated over the
+// whole column into a row mask (the same passes as conditional formatting).
+// Masks are kept per column, so editing one filter rescans only that column;
+// the masks are then ANDed and the passing rows gathered in display order.
+//
+// Filter syntax by column type:
+//   numbers, dates, times   10..20   >5   <5   >=5   <=5   =5   5   1,2,3
+//   symbols                 AA (prefix)   =AAPL   AAPL,MSFT (set)
+//   strings                 substring
+// Prefix and substring matches ignore ASCII case.
+
+#ifndef RFUI_GRID_FILTER_H
+#define RFUI_GRID_FILTER_H
+
+#include <stdint.h>
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rfui_col_filter_t {
+    char text[64];       // Edited in place by the filter row
+    b8_t dirty;          // Text changed since the mask was built
+    b8_t invalid;        // Text doesn't parse for the column type (ignored)
+    uint16_t* mask;      // 1 = row passes (NULL = no filter on this column)
+} rfui_col_filter_t;
+
+typedef struct rfui_grid_filter_t {
+    i64_t ncols;
+    rfui_col_filter_t* cols;
+    i64_t version;       // Data version the masks belong to
+    i64_t order_gen;     // Sort order the selection was gathered in
+    i64_t nrows;
+    b8_t active;         // Any column filtered
+    u8_t* pass;          // AND of all masks
+    u32_t* sel;          // Passing data rows in display order
+    i64_t nsel;
+    i64_t gen;           // Bumped whenever sel changes
+} rfui_grid_filter_t;
+
+// Match the table's column count (clears filters if it changed)
+nil_t rfui_grid_filter_resize(rfui_grid_filter_t* f, i64_t ncols);
+
+// Whether a column type has a filter syntax
+b8_t rfui_grid_filter_supported(i8_t type);
+
+// Mark a column's text as edited
+nil_t rfui_grid_filter_changed(rfui_grid_filter_t* f, i64_t col);
+
+// Rescan edited columns (all columns on new data) and regather the selection
+// if the masks or the display order changed. perm maps display -> data rows
+// for the first perm_n rows (NULL = natural order).
+nil_t rfui_grid_filter_update(rfui_grid_filter_t* f, obj_p table, i64_t version,
+                              const u32_t* perm, i64_t perm_n, i64_t order_gen);
+
+nil_t rfui_grid_filter_free(rfui_grid_filter_t* f);
+i64_t rfui_grid_filter_bytes(const rfui_grid_filter_t* f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_FILTER_H
@@ -0,0 +1,65 @@
+// include/rfui/grid_find.h
+// Grid find (Ctrl+F): every cell searched on the worker pool
+//
+// The query is compiled once per column on the UI thread: numeric and
+// temporal columns match by value (the text parsed in the column's domain,
+// as filters are), symbols and strings by case-insensitive substring. The
+// scan splits the rows into chunks that every pool thread pulls from, sets
+// one bit per row with a matching cell, and publishes each chunk as it
+// completes, so results stream in while the rest is scanned. Symbol columns
+// decide each distinct id once per thread and keep the matching ids in a set.
+// Navigation walks the row bits in display order; which cells of a row
+// match is worked out again only for the rows drawn or jumped to.
+
+#ifndef RFUI_GRID_FIND_H
+#define RFUI_GRID_FIND_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_FIND_CHUNK 65536   // Rows per published chunk (a multiple of 64)
+
+struct rfui_find_job_t;
+
+typedef struct rfui_grid_find_t {
+    char text[64];             // Edited in place by the find box
+    b8_t dirty;                // Text changed since the scan started
+    i64_t version;             // Data version the scan belongs to
+    struct rfui_find_job_t* job;   // Current scan; results are read from it
+    i64_t cur_row;             // Current match: display row (-1 = none)
+    i64_t cur_col;             // and data column
+    b8_t jump;                 // Scroll the grid to the current match
+} rfui_grid_find_t;
+
+// Per frame on the UI thread: restart the scan when the text or the data
+// version changed (a running scan is cancelled first)
+nil_t rfui_grid_find_update(rfui_grid_find_t* f, obj_p table, i64_t version);
+
+// Fraction of the rows scanned (-1 = no search) and matching cells so far
+f64_t rfui_grid_find_progress(const rfui_grid_find_t* f, i64_t* cells);
+
+// Whether a cell of a scanned row matches (col is a data column)
+b8_t rfui_grid_find_cell(const rfui_grid_find_t* f, obj_p table, i64_t col, i64_t data_row);
+
+// Move to the next (dir > 0) or previous match in display order, wrapping
+// around; rows maps display -> data rows for the first rows_n rows (NULL =
+// natural order). False if nothing has matched yet.
+b8_t rfui_grid_find_next(rfui_grid_find_t* f, obj_p table, const u32_t* rows, i64_t rows_n,
+                         i64_t display_rows, i32_t dir);
+
+// Whether a running scan reads table
+b8_t rfui_grid_find_reads(const rfui_grid_find_t* f, obj_p table);
+
+// Cancel and wait for the scan, drop its results
+nil_t rfui_grid_find_free(rfui_grid_find_t* f);
+
+i64_t rfui_grid_find_bytes(const rfui_grid_find_t* f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_FIND_H
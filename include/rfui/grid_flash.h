@@ -0,0 +1,77 @@
+// include/rfui/grid_flash.h
+// Grid changed-cell flash: columnar diff of consecutive render_data
+//
+// When a grid's render_data is replaced, each column of the new table is
+// compared with the same column of the old one, a 64-row word at a time,
+// once per update. Rows are aligned by position or, with a key column, by
+// key (last old row wins for duplicate keys). The result is a generation:
+// two bitmaps per changed column (rows that rose, rows that fell; both bits
+// = changed with no direction, e.g. symbols) and the update's timestamp.
+// The last RFUI_FLASH_GENS generations are kept and fade out over
+// RFUI_FLASH_SECONDS; under key alignment older generations are remapped to
+// the new row order so a flash follows its row.
+
+#ifndef RFUI_GRID_FLASH_H
+#define RFUI_GRID_FLASH_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_FLASH_GENS 4
+#define RFUI_FLASH_SECONDS 0.8
+
+// rfui_grid_flash_at result bits
+#define RFUI_FLASH_UP 1
+#define RFUI_FLASH_DOWN 2
+#define RFUI_FLASH_CHANGED (RFUI_FLASH_UP | RFUI_FLASH_DOWN)
+
+typedef struct rfui_flash_gen_t {
+    f64_t time;        // When the update was applied (0 = empty)
+    i64_t nrows;       // Rows the bitmaps cover (new table's row order)
+    i64_t ncols;
+    u64_t** bits;      // Per column: up words then down words (NULL = unchanged)
+} rfui_flash_gen_t;
+
+typedef struct rfui_grid_flash_t {
+    b8_t enabled;
+    i32_t key_col;     // Align rows by this column's values (-1 = by position)
+    i32_t head;        // Newest generation
+    rfui_flash_gen_t gens[RFUI_FLASH_GENS];
+
+    // Scratch reused across updates
+    u64_t* words;      // One column's up + down words
+    i64_t words_cap;
+    i64_t* align;      // New row -> old row (-1 = new key)
+    i64_t align_cap;
+    u64_t* map_keys;   // Old key -> old row (open addressing)
+    i64_t* map_rows;
+    i64_t map_cap;
+} rfui_grid_flash_t;
+
+// Whether a column type can align rows (integers, temporals, symbols)
+b8_t rfui_grid_flash_key_supported(i8_t type);
+
+// Diff old_table against new_table and push a generation stamped now
+// (seconds, same clock as rfui_grid_flash_at)
+nil_t rfui_grid_flash_diff(rfui_grid_flash_t* f, obj_p old_table, obj_p new_table, f64_t now);
+
+// Whether any generation is still fading at now
+b8_t rfui_grid_flash_live(const rfui_grid_flash_t* f, f64_t now);
+
+// Newest live flash of a cell: RFUI_FLASH_* bits (0 = none), *fade in (0, 1]
+u8_t rfui_grid_flash_at(const rfui_grid_flash_t* f, i64_t col, i64_t row, f64_t now, float* fade);
+
+// Drop all generations (e.g. alignment changed)
+nil_t rfui_grid_flash_clear(rfui_grid_flash_t* f);
+
+nil_t rfui_grid_flash_free(rfui_grid_flash_t* f);
+i64_t rfui_grid_flash_bytes(const rfui_grid_flash_t* f);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_FLASH_H
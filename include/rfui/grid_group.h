@@ -0,0 +1,106 @@
+// include/rfui/grid_group.h
+// Grid grouped mode: rows bucketed into a collapsible tree by key columns
+//
+// Once per data version a job on the worker pool builds the group index: a
+// hash-group pass per level assigns every row to a node (level l groups by
+// its parent node and key l), then the nodes get row counts, sums of the
+// numeric columns, children sorted by key and, for the last level, their
+// rows in data order. Nothing is materialized for display: the grid keeps a
+// short list of segments (a run of sibling nodes, or a slice of one node's
+// rows) that only grows where a node is expanded, and the row clipper maps
+// display rows through it. Expanded nodes are remembered by key path, so
+// they stay open across updates.
+
+#ifndef RFUI_GRID_GROUP_H
+#define RFUI_GRID_GROUP_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_GROUP_MAX_LEVELS 3
+
+// Immutable result of a job
+typedef struct rfui_group_index_t {
+    i32_t nlevels;
+    i32_t key_cols[RFUI_GROUP_MAX_LEVELS];
+    i64_t nnodes;              // All levels
+    i32_t* level;              // Per node
+    i32_t* parent;             // Per node (-1 = top level)
+    i64_t* first_row;          // Per node: first row (key labels)
+    i64_t* count;              // Per node: rows below it
+    u64_t* path;               // Per node: key path hash (expansion state)
+    i64_t ntop;
+    i32_t* top;                // Top level nodes in key order (heads children)
+    i64_t* child_ptr;          // Children of node n: children[child_ptr[n] .. child_ptr[n + 1])
+    i32_t* children;           // In key order
+    i64_t* row_ptr;            // Rows of last-level node n: rows[row_ptr[n] .. row_ptr[n + 1])
+    u32_t* rows;
+    i32_t nsums;
+    i32_t* sum_cols;           // Numeric columns summed per node
+    f64_t* sums;               // nnodes * nsums
+} rfui_group_index_t;
+
+// Display segment: a run of sibling nodes or a slice of a node's rows
+typedef struct rfui_group_seg_t {
+    i64_t display;             // First display row
+    i64_t n;
+    const i32_t* nodes;        // Sibling run (NULL = rows of node)
+    i32_t node;
+    i64_t start;               // First row of the node's rows
+} rfui_group_seg_t;
+
+struct rfui_group_job_t;
+
+typedef struct rfui_grid_group_t {
+    b8_t enabled;              // Grid shows the tree instead of the rows
+    i32_t key_cols[RFUI_GROUP_MAX_LEVELS];
+    i32_t nkeys;
+    i64_t config_gen;          // Bumped on any key edit
+    i64_t job_gen;             // config_gen the last job was started for
+    i64_t version;             // Data version the last job was started for
+    rfui_group_index_t* index; // Latest result (NULL = none yet)
+    struct rfui_group_job_t* job;   // In flight (NULL = idle)
+
+    u64_t* expanded;           // Key path hashes of open nodes, sorted
+    i64_t nexpanded;
+    i64_t expanded_cap;
+
+    rfui_group_seg_t* segs;    // Visible tree (rebuilt when dirty)
+    i64_t nsegs;
+    i64_t segs_cap;
+    i64_t display_rows;
+    b8_t dirty;
+} rfui_grid_group_t;
+
+// Whether a column type can be a group key
+b8_t rfui_grid_group_key_supported(i8_t type);
+
+// Per frame on the UI thread while enabled: adopt a finished job, start a new
+// one if the data version or keys changed, rebuild the segments if needed
+nil_t rfui_grid_group_update(rfui_grid_group_t* g, obj_p table, i64_t version);
+
+// Display row: node (*row = -1) or a row under last-level node *node.
+// False past the end.
+b8_t rfui_grid_group_at(const rfui_grid_group_t* g, i64_t display, i32_t* node, i64_t* row);
+
+b8_t rfui_grid_group_expanded(const rfui_grid_group_t* g, i32_t node);
+nil_t rfui_grid_group_toggle(rfui_grid_group_t* g, i32_t node);
+nil_t rfui_grid_group_collapse_all(rfui_grid_group_t* g);
+
+// Whether a job (running or not yet adopted) reads table
+b8_t rfui_grid_group_reads(const rfui_grid_group_t* g, obj_p table);
+
+// Cancel and wait for the job, free the index, expansion and segments (the
+// next update starts over)
+nil_t rfui_grid_group_free(rfui_grid_group_t* g);
+
+i64_t rfui_grid_group_bytes(const rfui_grid_group_t* g);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_GROUP_H
@@ -0,0 +1,105 @@
+// include/rfui/grid_pivot.h
+// Grid pivot (crosstab): hash aggregation on the worker pool
+//
+// Rows are grouped by up to RFUI_PIVOT_MAX_KEYS row key columns and spread
+// across one output column per combination of the column key values; each
+// cell aggregates a value column (sum, avg, count or last). A job folds the
+// source rows into three hash tables (row groups, column groups, cells)
+// that are kept between jobs, so when new data only appends rows (key and
+// value column fingerprints unchanged) just the new rows are folded in. The
+// finished job publishes a sorted, immutable view (labels plus the cells in
+// compressed rows) that the grid draws until the next one replaces it.
+
+#ifndef RFUI_GRID_PIVOT_H
+#define RFUI_GRID_PIVOT_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+#include "format.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_PIVOT_MAX_KEYS 3
+#define RFUI_PIVOT_MAX_COLUMNS 256   // Column groups shown (the rest are counted)
+
+typedef enum rfui_pivot_agg_t {
+    RFUI_PIVOT_SUM = 0,
+    RFUI_PIVOT_AVG,
+    RFUI_PIVOT_COUNT,          // Rows in the cell (no value column needed)
+    RFUI_PIVOT_LAST            // Last non-null value in row order
+} rfui_pivot_agg_t;
+
+typedef struct rfui_pivot_config_t {
+    i32_t row_keys[RFUI_PIVOT_MAX_KEYS];
+    i32_t nrow_keys;
+    i32_t col_keys[RFUI_PIVOT_MAX_KEYS];
+    i32_t ncol_keys;           // 0 = a single value column
+    i32_t value;               // Aggregated column (-1 = none, count only)
+    rfui_pivot_agg_t agg;
+} rfui_pivot_config_t;
+
+// Published result: row groups and shown column groups in key order
+typedef struct rfui_pivot_view_t {
+    i64_t nrows;
+    i64_t ncols;
+    i64_t ncols_total;         // Column groups found (ncols caps at RFUI_PIVOT_MAX_COLUMNS)
+    rfui_pivot_config_t config;  // What the view was built for
+    b8_t integral;             // Values are whole numbers (counts, integer sums / lasts)
+    rfui_fmt_buf_t labels;     // Row labels (key k of row r at k * nrows + r), then column labels
+    u32_t* label_offsets;      // nrows * config.nrow_keys + ncols + 1
+    i64_t* row_ptr;            // Cells of row r: [row_ptr[r], row_ptr[r + 1])
+    u32_t* cell_col;           // Ascending within a row
+    f64_t* cell_val;
+    i64_t source_rows;         // Rows aggregated
+} rfui_pivot_view_t;
+
+struct rfui_pivot_state_t;
+struct rfui_pivot_job_t;
+
+typedef struct rfui_grid_pivot_t {
+    b8_t enabled;              // Grid shows the pivot instead of the rows
+    rfui_pivot_config_t config;
+    i64_t config_gen;          // Bumped on any config edit
+    i64_t job_gen;             // config_gen the last job was started for
+    i64_t version;             // Data version the last job was started for
+    rfui_pivot_view_t* view;   // Latest result (NULL = none yet)
+    struct rfui_pivot_state_t* state;  // Folded groups (moved into the running job)
+    struct rfui_pivot_job_t* job;      // In flight (NULL = idle)
+} rfui_grid_pivot_t;
+
+// Whether a column type can be a row / column key, or the aggregated value
+b8_t rfui_grid_pivot_key_supported(i8_t type);
+b8_t rfui_grid_pivot_value_supported(i8_t type);
+
+// Whether the config names enough columns to run (at least one row key)
+b8_t rfui_grid_pivot_valid(const rfui_pivot_config_t* c);
+
+// Per frame on the UI thread while enabled: adopt a finished job and start a
+// new one if the data version or config changed
+nil_t rfui_grid_pivot_update(rfui_grid_pivot_t* p, obj_p table, i64_t version);
+
+// Whether a job is computing a newer view than p->view
+b8_t rfui_grid_pivot_busy(const rfui_grid_pivot_t* p);
+
+// Label of row r's key k, or of column c (length in *len)
+const c8_t* rfui_grid_pivot_row_label(const rfui_pivot_view_t* v, i64_t r, i32_t k, i32_t* len);
+const c8_t* rfui_grid_pivot_col_label(const rfui_pivot_view_t* v, i64_t c, i32_t* len);
+
+// Cell value; false for an empty cell
+b8_t rfui_grid_pivot_cell(const rfui_pivot_view_t* v, i64_t r, i64_t c, f64_t* value);
+
+// Whether a job (running or not yet adopted) reads table
+b8_t rfui_grid_pivot_reads(const rfui_grid_pivot_t* p, obj_p table);
+
+// Cancel and wait for the job, free the view and folded state (the next
+// update starts over)
+nil_t rfui_grid_pivot_free(rfui_grid_pivot_t* p);
+
+i64_t rfui_grid_pivot_bytes(const rfui_grid_pivot_t* p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_PIVOT_H
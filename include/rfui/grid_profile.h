@@ -0,0 +1,74 @@
+// include/rfui/grid_profile.h
+// Grid column profiler: summary statistics and sketches on the worker pool
+//
+// While the profiler is open, a job folds the column into streaming sketches:
+// exact min / max / sum / null count, a HyperLogLog register set for the
+// distinct count and a KLL sketch for quantiles (the histogram is read off
+// the KLL items). The sketch state is kept between jobs, so when new data
+// only appends rows (column prefix fingerprint unchanged) just the new rows
+// are folded in. Nothing runs on the Rayforce thread.
+
+#ifndef RFUI_GRID_PROFILE_H
+#define RFUI_GRID_PROFILE_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_PROFILE_QUANTILES 5   // p1 p25 p50 p75 p99
+#define RFUI_PROFILE_BINS 32
+
+extern const f64_t rfui_profile_quantile_ranks[RFUI_PROFILE_QUANTILES];
+
+typedef struct rfui_col_profile_t {
+    i8_t type;
+    i64_t rows;
+    i64_t nulls;
+    f64_t distinct;                      // HyperLogLog estimate (~1.6% error)
+    b8_t numeric;                        // min..hist are set
+    f64_t min;
+    f64_t max;
+    f64_t sum;
+    f64_t mean;
+    f64_t quantiles[RFUI_PROFILE_QUANTILES];  // KLL estimates
+    float hist[RFUI_PROFILE_BINS];       // Share of rows per bin over [min, max]
+} rfui_col_profile_t;
+
+struct rfui_profile_job_t;
+struct rfui_profile_sketch_t;
+
+typedef struct rfui_grid_profile_t {
+    i32_t col;                           // Profiled column (-1 = closed)
+    i32_t last_col;                      // Column the last job was started for
+    i64_t version;                       // Data version the last job was started for
+    b8_t ready;                          // result is valid for col
+    rfui_col_profile_t result;
+    struct rfui_profile_sketch_t* sketch;  // Folded state (moved into the running job)
+    struct rfui_profile_job_t* job;      // In flight (NULL = idle)
+} rfui_grid_profile_t;
+
+// Whether a column type can be profiled
+b8_t rfui_grid_profile_supported(i8_t type);
+
+// Profile column col (-1 closes the profiler and frees its state)
+nil_t rfui_grid_profile_open(rfui_grid_profile_t* p, i32_t col);
+
+// Per frame on the UI thread: adopt a finished job and start a new one if
+// the data version or column changed
+nil_t rfui_grid_profile_update(rfui_grid_profile_t* p, obj_p table, i64_t version);
+
+// Whether a job (running or not yet adopted) reads table
+b8_t rfui_grid_profile_reads(const rfui_grid_profile_t* p, obj_p table);
+
+// Cancel and wait for the job, free the sketch
+nil_t rfui_grid_profile_free(rfui_grid_profile_t* p);
+
+i64_t rfui_grid_profile_bytes(const rfui_grid_profile_t* p);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_PROFILE_H
@@ -12,6 +12,23 @@ extern "C" {
 // widget->render_data should be a Rayforce table (keyed list)
 nil_t rfui_render_grid(rfui_widget_t* widget);
 
+// render_data of a grid is being replaced (widget->render_data is already the
+// new table): diffs the two for the changed-cell flash, then returns old_data
+// for the caller to drop, or NULL if a background job (sort, profile, export) still
+// reads it (dropped once the job is adopted, bytes kept for the drop accounting)
+obj_p rfui_grid_retire_data(rfui_widget_t* widget, obj_p old_data, i64_t bytes);
+
+// An upsert replaced render_data (version was base before the swap) and
+// wrote only these data rows: the cell cache re-formats just those rows
+// instead of the whole window, chaining upserts that arrive between frames
+nil_t rfui_grid_upsert_rows(rfui_widget_t* widget, i64_t base, const i64_t* rows, i64_t n);
+
+// Bytes held by the grid's ui_state (selection, color rules, sort order, profiler, flash, cell cache)
+i64_t rfui_grid_state_bytes(rfui_widget_t* widget);
+
+// Free the grid's ui_state and its caches (called by rfui_widget_destroy)
+nil_t rfui_grid_free_state(rfui_widget_t* widget);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,84 @@
+// include/rfui/grid_rules.h
+// Conditional formatting for grid widgets
+//
+// Rules are compiled once per data version or rule edit into typed range and
+// set predicates, evaluated over whole columns into a per-cell style index.
+// Rendering only looks up styles->cells[col][row] in the palette.
+
+#ifndef RFUI_GRID_RULES_H
+#define RFUI_GRID_RULES_H
+
+#include <stdint.h>
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum rfui_rule_op_t {
+    RFUI_RULE_EQ = 0,
+    RFUI_RULE_LT,
+    RFUI_RULE_GT,
+    RFUI_RULE_BETWEEN,   // value..value2 inclusive (empty bound = open)
+    RFUI_RULE_IN,        // value is a comma-separated list
+    RFUI_RULE_GRADIENT,  // color..color2 over value..value2 (empty = column min/max)
+    RFUI_RULE_PREFIX,    // Symbols/strings starting with value (ASCII case-insensitive)
+    RFUI_RULE_CONTAINS,  // Symbols/strings containing value (ASCII case-insensitive)
+    RFUI_RULE_OP_COUNT
+} rfui_rule_op_t;
+
+// Palette steps per gradient rule
+#define RFUI_GRADIENT_STEPS 32
+
+typedef struct rfui_grid_rule_t {
+    char column[64];
+    i32_t op;            // rfui_rule_op_t
+    char value[64];
+    char value2[64];
+    float color[4];      // Text color (gradient low end)
+    float color2[4];     // Gradient high end
+    b8_t enabled;
+} rfui_grid_rule_t;
+
+typedef struct rfui_rgba_t {
+    float r, g, b, a;
+} rfui_rgba_t;
+
+typedef struct rfui_grid_styles_t {
+    i64_t version;        // Data version the styles belong to (-1 = none)
+    i64_t rules_version;
+    i64_t ncols;
+    i64_t nrows;
+    uint16_t** cells;     // Per column: style per row, NULL = column has no rules
+    rfui_rgba_t* palette; // Style -> color; 0 = unstyled
+    i64_t npalette;
+    i64_t palette_cap;
+} rfui_grid_styles_t;
+
+extern const char* rfui_rule_op_names[RFUI_RULE_OP_COUNT];
+
+// Rebuild styles if version or rules_version changed (UI thread).
+// keys/vals are the table's column names and columns (validated by the caller).
+// Earlier rules win when several match the same cell.
+nil_t rfui_grid_styles_update(rfui_grid_styles_t* s, i64_t version, i64_t rules_version,
+                              obj_p keys, obj_p vals,
+                              const rfui_grid_rule_t* rules, i32_t nrules);
+
+// Evaluate one rule over a whole column: out[i] = style where it matches,
+// other entries untouched. Returns false if the rule is incomplete or doesn't
+// apply to the column type (gradients need rfui_grid_styles_update).
+b8_t rfui_grid_rule_apply(const rfui_grid_rule_t* r, obj_p col, uint16_t style, uint16_t* out);
+
+// Parse a rule value in the column's display domain: numbers, true/false,
+// HH:MM[:SS[.mmm]] times, YYYY.MM.DD dates and YYYY.MM.DDDHH:MM[:SS[.f]]
+// timestamps, as the column stores them (days, milliseconds, nanoseconds)
+b8_t rfui_grid_rule_parse(i8_t type, const char* text, f64_t* out);
+
+nil_t rfui_grid_styles_free(rfui_grid_styles_t* s);
+i64_t rfui_grid_styles_bytes(const rfui_grid_styles_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_RULES_H
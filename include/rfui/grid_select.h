@@ -0,0 +1,50 @@
+// include/rfui/grid_select.h
+// Grid row selection: a bitmap over data rows
+//
+// Selection is kept by data row, so it survives re-sorting and filtering.
+// The Shift-range anchor is a display row, so ranges follow what is on
+// screen. Changes mark the selection dirty; the grid sends the
+// current rows to the widget's on-select callback at most one message at a
+// time, so a burst of changes collapses into the latest selection.
+
+#ifndef RFUI_GRID_SELECT_H
+#define RFUI_GRID_SELECT_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rfui_grid_select_t {
+    u64_t* bits;       // 1 bit per data row
+    i64_t nrows;       // Rows the bitmap covers
+    i64_t count;       // Selected rows
+    i64_t anchor;      // Display row Shift ranges start from (-1 = none)
+    b8_t dirty;        // Changed since the last send
+} rfui_grid_select_t;
+
+// Match the data's row count, dropping selected rows past the end
+nil_t rfui_grid_select_resize(rfui_grid_select_t* s, i64_t nrows);
+
+b8_t rfui_grid_select_has(const rfui_grid_select_t* s, i64_t row);
+
+nil_t rfui_grid_select_clear(rfui_grid_select_t* s);
+nil_t rfui_grid_select_set(rfui_grid_select_t* s, i64_t row, b8_t on);
+
+// Select display rows [from, to] (either order). rows maps display -> data
+// rows for the first rows_n display rows (NULL = natural order).
+nil_t rfui_grid_select_range(rfui_grid_select_t* s, i64_t from, i64_t to,
+                             const u32_t* rows, i64_t rows_n);
+
+// Selected data rows, ascending (malloc'd, count in *n). NULL if none/OOM.
+i64_t* rfui_grid_select_rows(const rfui_grid_select_t* s, i64_t* n);
+
+nil_t rfui_grid_select_free(rfui_grid_select_t* s);
+i64_t rfui_grid_select_bytes(const rfui_grid_select_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_SELECT_H
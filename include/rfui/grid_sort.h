@@ -0,0 +1,79 @@
+// include/rfui/grid_sort.h
+// Grid column sorting: a row permutation built on the worker pool
+//
+// Sorting never copies column data. A job radix-sorts row indices by the
+// key columns (last key first, stable), with symbols sorted by the rank of
+// their string. The grid keeps drawing the previous permutation until the
+// job lands. When new data only appends rows (key column prefix unchanged),
+// only the new rows are sorted and merged into the previous order.
+
+#ifndef RFUI_GRID_SORT_H
+#define RFUI_GRID_SORT_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_SORT_MAX_KEYS 8
+
+typedef struct rfui_sort_key_t {
+    i32_t col;     // Column index
+    b8_t desc;
+} rfui_sort_key_t;
+
+struct rfui_sort_job_t;
+
+typedef struct rfui_grid_sort_t {
+    // Requested order (0 keys = natural order)
+    i32_t nkeys;
+    rfui_sort_key_t keys[RFUI_SORT_MAX_KEYS];
+    b8_t dirty;                    // Keys changed since the last job started
+    i64_t version;                 // Data version the last job was started for
+
+    // Current order
+    u32_t* perm;                   // Display row -> data row (NULL = natural)
+    i64_t perm_n;                  // Rows covered; rows past it draw in natural order
+    i32_t perm_nkeys;              // Keys the permutation was built with
+    rfui_sort_key_t perm_keys[RFUI_SORT_MAX_KEYS];
+    u64_t perm_hash[RFUI_SORT_MAX_KEYS];  // Key column fingerprints (append detection)
+    i64_t order_gen;               // Bumped whenever the displayed order changes
+
+    struct rfui_sort_job_t* job;   // In flight (NULL = idle)
+} rfui_grid_sort_t;
+
+// Replace the sort keys (from the table's sort specs)
+nil_t rfui_grid_sort_set(rfui_grid_sort_t* s, const rfui_sort_key_t* keys, i32_t nkeys);
+
+// Header click on a header drawn outside ImGui's sort specs (windowed grids),
+// with the same cycle: ascending, descending, off. add (shift) keeps the
+// other keys; otherwise the column becomes the only key.
+nil_t rfui_grid_sort_click(rfui_grid_sort_t* s, i32_t col, b8_t add);
+
+// Per frame on the UI thread: adopt a finished job and start a new one if
+// the data version or keys changed
+nil_t rfui_grid_sort_update(rfui_grid_sort_t* s, obj_p table, i64_t version);
+
+// Display order to draw with, or NULL for natural order
+const u32_t* rfui_grid_sort_perm(const rfui_grid_sort_t* s, i64_t nrows, i64_t* perm_n);
+
+// Whether a job (running or not yet adopted) reads table: it must not be
+// dropped until this turns false
+b8_t rfui_grid_sort_reads(const rfui_grid_sort_t* s, obj_p table);
+
+// Cancel and wait for the job, free the permutation
+nil_t rfui_grid_sort_free(rfui_grid_sort_t* s);
+
+// Streaming FNV fingerprint of a column's raw values (any element size, one
+// 8-byte word at a time); *prefix gets the value after prefix_n rows (append
+// detection)
+u64_t rfui_grid_column_hash(obj_p col, i64_t prefix_n, u64_t* prefix);
+
+i64_t rfui_grid_sort_bytes(const rfui_grid_sort_t* s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_SORT_H
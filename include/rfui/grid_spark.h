@@ -0,0 +1,52 @@
+// include/rfui/grid_spark.h
+// Grid sparklines: nested numeric vectors drawn inline in their cell
+//
+// A list column cell holding a numeric vector (order book levels, a price
+// path) is reduced to one min / max pair per pixel of the cell's width, in
+// the order they occur, scaled to the vector's own range. Like the text
+// cache, the points are built once per data version for the rows on screen
+// and only redrawn on later frames.
+
+#ifndef RFUI_GRID_SPARK_H
+#define RFUI_GRID_SPARK_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Widest sparkline in buckets (pixels)
+#define RFUI_SPARK_MAX_WIDTH 1024
+
+// Point values: 0 = the vector's minimum .. RFUI_SPARK_TOP = its maximum;
+// RFUI_SPARK_GAP marks a bucket of nulls (the line breaks there)
+#define RFUI_SPARK_TOP 254
+#define RFUI_SPARK_GAP 255
+
+// Whether a list item of this type draws as a sparkline
+b8_t rfui_spark_supported(i8_t type);
+
+typedef struct rfui_spark_buf_t {
+    u8_t* points;
+    i64_t len;
+    i64_t cap;
+} rfui_spark_buf_t;
+
+// Append sparklines for n cells of a list column: display rows [from, from + n)
+// mapped to data rows as in rfui_fmt_column. A numeric vector of len values
+// gets min(len, width) buckets of two points each; other cells get none.
+// offsets[i] is where cell i starts in out->points. False if out of memory.
+b8_t rfui_spark_column(obj_p col, const u32_t* rows, i64_t rows_n, i64_t from, i64_t n,
+                       i32_t width, rfui_spark_buf_t* out, u32_t* offsets);
+
+// Append n points of already built sparklines. False if out of memory.
+b8_t rfui_spark_buf_append(rfui_spark_buf_t* out, const u8_t* points, i64_t n);
+
+nil_t rfui_spark_buf_free(rfui_spark_buf_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_GRID_SPARK_H
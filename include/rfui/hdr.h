@@ -0,0 +1,61 @@
+// include/rfui/hdr.h
+// Log-linear (HDR) latency histogram: fixed memory, <= 1/64 (~1.6%) relative error
+//
+// Values are non-negative integers (nanoseconds in practice). Each power of
+// two is split into 64 linear sub-buckets, so recording is O(1) and
+// percentiles stay accurate from microseconds to minutes.
+
+#ifndef RFUI_HDR_H
+#define RFUI_HDR_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_HDR_SUB_BITS  7     // 128 sub-buckets for the first range
+#define RFUI_HDR_MAX_BITS  40    // Largest trackable value ~2^40 (~18 min in ns)
+#define RFUI_HDR_BUCKETS   ((1 << RFUI_HDR_SUB_BITS) + \
+                            (RFUI_HDR_MAX_BITS - RFUI_HDR_SUB_BITS) * (1 << (RFUI_HDR_SUB_BITS - 1)))
+
+typedef struct rfui_hdr_t {
+    i64_t counts[RFUI_HDR_BUCKETS];
+    i64_t total;
+    i64_t min;
+    i64_t max;
+    f64_t sum;
+} rfui_hdr_t;
+
+// Percentile summary (values in recorded units)
+typedef struct rfui_hdr_summary_t {
+    i64_t count;
+    f64_t mean;
+    i64_t min;
+    i64_t p50;
+    i64_t p90;
+    i64_t p99;
+    i64_t p999;
+    i64_t max;
+} rfui_hdr_summary_t;
+
+// Clear all counts
+nil_t rfui_hdr_reset(rfui_hdr_t* h);
+
+// Record one value (negative values are clamped to 0, huge ones to the top bucket)
+nil_t rfui_hdr_record(rfui_hdr_t* h, i64_t value);
+
+// Add all counts of src into dst
+nil_t rfui_hdr_merge(rfui_hdr_t* dst, const rfui_hdr_t* src);
+
+// Value at percentile p (0..100), reported as the bucket's upper bound
+i64_t rfui_hdr_percentile(const rfui_hdr_t* h, f64_t p);
+
+// Fill count/mean/min/percentiles/max in one pass over the buckets
+nil_t rfui_hdr_summarize(const rfui_hdr_t* h, rfui_hdr_summary_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_HDR_H
@@ -0,0 +1,28 @@
+// include/rfui/headless.h
+// Headless GL context (EGL surfaceless) for running without a display server
+
+#ifndef RFUI_HEADLESS_H
+#define RFUI_HEADLESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Create a surfaceless GL 3.0 context and make it current. Returns 0 on success.
+// Only supported on Linux (libEGL with EGL_MESA_platform_surfaceless).
+int rfui_headless_init(void);
+
+// Destroy the headless context.
+void rfui_headless_destroy(void);
+
+// GL entry point loader for the headless context (eglGetProcAddress).
+void* rfui_headless_get_proc(const char* name);
+
+// Sleep the calling thread (used for fixed-rate headless frames).
+void rfui_headless_sleep(double seconds);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_HEADLESS_H
@@ -28,6 +28,20 @@
 #define ICON_CHECK       "\xef\x80\x8c"  // f00c - enabled/checkbox
 #define ICON_EYE         "\xef\x81\xae"  // f06e - visible/enabled
 #define ICON_FILTER      "\xef\x82\xb0"  // f0b0 - filter
+#define ICON_CHART_COLUMN "\xef\x82\x80"  // f080 - column profiler
+#define ICON_SORT_UP     "\xef\x83\x9e"  // f0de - ascending sort key
+#define ICON_SORT_DOWN   "\xef\x83\x9d"  // f0dd - descending sort key
+#define ICON_CALCULATOR  "\xef\x87\xac"  // f1ec - number format
+#define ICON_BOLT        "\xef\x83\xa7"  // f0e7 - changed-cell flash
+#define ICON_FILE_EXPORT "\xef\x95\xae"  // f56e - grid export
+#define ICON_COPY        "\xef\x83\x85"  // f0c5 - copy to clipboard
+#define ICON_LAYER_GROUP "\xef\x97\xbd"  // f5fd - grid grouping
+#define ICON_CARET_R     "\xef\x83\x9a"  // f0da - collapsed group
+#define ICON_CARET_D     "\xef\x83\x97"  // f0d7 - expanded group
+#define ICON_MAGNIFYING_GLASS "\xef\x80\x82"  // f002 - grid find
+#define ICON_ARROW_UP    "\xef\x81\xa2"  // f062 - previous match
+#define ICON_ARROW_DOWN  "\xef\x81\xa3"  // f063 - next match
+#define ICON_GAUGE       "\xef\x98\xa5"  // f625 - performance overlay
 
 // Window controls (custom title bar)
 #define ICON_MINIMIZE    "\xef\x8a\x8d"  // f28d - fa-window-minimize
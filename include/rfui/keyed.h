@@ -0,0 +1,61 @@
+// include/rfui/keyed.h
+// Keyed tables for grids: flattening and upserts by key (Rayforce thread)
+//
+// A keyed table is a dict from a table of key columns to a table of value
+// columns. Grids draw it flattened, key columns first. The widget keeps the
+// flattened table it was last drawn with, and (draw-upsert w rows) merges
+// rows into it through an index from key to row (open addressing over the
+// key columns, built on the first upsert after a draw): a known key
+// overwrites its row, a new key is appended. Rows never move, so the UI's
+// scroll position, selection and flash alignment (all by data row) stay
+// valid, and the UPSERT message lists the rows written so the grid
+// re-formats only those. Columns an upsert writes are copied once, since the
+// UI may still hold the previous table; the others are shared.
+
+#ifndef RFUI_KEYED_H
+#define RFUI_KEYED_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_KEYED_MAX_KEYS 8
+
+typedef struct rfui_keyed_t {
+    i64_t nkeys;      // Leading key columns of the widget's table
+    i64_t nrows;      // Rows indexed (0 with no slots = index not built yet)
+    i64_t* slots;     // Row + 1 per slot (0 = empty)
+    i64_t cap;        // Slots, a power of two
+} rfui_keyed_t;
+
+// Whether o is a keyed table (dict of key table -> value table)
+b8_t rfui_keyed_is(obj_p o);
+
+// Whether a column type can be a key (integers, temporals, symbols)
+b8_t rfui_keyed_key_supported(i8_t type);
+
+// New plain table with the key columns first; *nkeys = their count.
+// Returns an error object if the two tables don't line up.
+obj_p rfui_keyed_flatten(obj_p keyed, i64_t* nkeys);
+
+// The widget was drawn with a table whose first nkeys columns are keys
+// (0 = not keyed); the index is rebuilt on the next upsert
+nil_t rfui_keyed_reset(rfui_keyed_t* k, i64_t nkeys);
+
+// Merge rows (a keyed table, or a plain table with the key columns and any
+// of the value columns) into base, the table last drawn or upserted. On
+// success *merged is the new table and *written the rows it wrote, ascending
+// (malloc'd, *nwritten of them), and NULL is returned; otherwise an error
+// object and base is unchanged.
+obj_p rfui_keyed_upsert(rfui_keyed_t* k, obj_p base, obj_p rows, obj_p* merged,
+                        i64_t** written, i64_t* nwritten);
+
+nil_t rfui_keyed_free(rfui_keyed_t* k);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_KEYED_H
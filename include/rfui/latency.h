@@ -0,0 +1,57 @@
+// include/rfui/latency.h
+// End-to-end draw latency: fn_draw -> UI apply -> presented frame
+//
+// fn_draw stamps each message with rfui_clock_ns(). The UI thread records
+// draw->apply when it swaps in render_data and draw->present once the frame
+// showing that data has been swapped. Histograms are read from the Rayforce
+// thread (ui-latency), so every access goes through the mutex.
+
+#ifndef RFUI_LATENCY_H
+#define RFUI_LATENCY_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+#include "../../deps/rayforce/core/thread.h"
+#include "hdr.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rfui_latency_t {
+    mutex_t mutex;
+    rfui_hdr_t apply;     // fn_draw -> render_data swapped in on UI thread
+    rfui_hdr_t present;   // fn_draw -> first frame showing it presented
+    i64_t superseded;     // Draws replaced before any frame presented them
+    i64_t pending;        // Stamp of applied, not yet presented draw (0 = none)
+} rfui_latency_t;
+
+typedef struct rfui_latency_summary_t {
+    rfui_hdr_summary_t apply;    // Nanoseconds
+    rfui_hdr_summary_t present;  // Nanoseconds
+    i64_t superseded;
+} rfui_latency_summary_t;
+
+// Monotonic clock in nanoseconds (comparable across threads)
+i64_t rfui_clock_ns(nil_t);
+
+rfui_latency_t* rfui_latency_create(nil_t);
+nil_t rfui_latency_destroy(rfui_latency_t* l);
+
+// UI thread: draw stamped at `stamp` became visible to the renderer at `now`
+nil_t rfui_latency_applied(rfui_latency_t* l, i64_t stamp, i64_t now);
+
+// UI thread: a frame was presented at `now`; records the pending draw, if any
+nil_t rfui_latency_presented(rfui_latency_t* l, i64_t now);
+
+// Any thread
+nil_t rfui_latency_reset(rfui_latency_t* l);
+nil_t rfui_latency_summary(rfui_latency_t* l, rfui_latency_summary_t* out);
+
+// UI thread: totals across all widgets since startup (frame statistics)
+nil_t rfui_latency_global_summary(rfui_latency_summary_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_LATENCY_H
@@ -0,0 +1,70 @@
+// include/rfui/memory.h
+// Memory accounting: per-widget render_data/ui_state, REPL, pending drops, textures
+//
+// The UI thread rebuilds the report about once per second while the overlay
+// shows, or on the next frame after rfui_memory_request, and publishes it
+// under a mutex; (ui-memory) on the Rayforce thread and the overlay read the
+// latest published copy. Sizes are payload bytes (headers + elements). Table
+// sizes are measured on the Rayforce thread when a draw ships and travel with
+// the message, so the UI thread never walks render_data; objects shared
+// between widgets are counted once per widget.
+
+#ifndef RFUI_MEMORY_H
+#define RFUI_MEMORY_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct rfui_mem_widget_t {
+    char name[64];
+    i64_t render_data;    // Bytes of render_data (measured when it was shipped)
+    i64_t ui_state;       // Type-specific UI state (selection, text, caches)
+} rfui_mem_widget_t;
+
+typedef struct rfui_mem_report_t {
+    i64_t nwidgets;
+    rfui_mem_widget_t* widgets;   // nwidgets entries (owned by the report)
+    i64_t repl_lines;             // REPL scrollback
+    i64_t repl_history;           // REPL command history
+    i64_t pending_drops;          // Objects queued for drop on the Rayforce thread
+    i64_t pending_drop_bytes;
+    i64_t font_atlas;             // ImGui textures (font atlas, CPU copy)
+    i64_t textures;               // Other GL textures (logo)
+    i64_t symbols;                // Symbol strings shipped to the UI (see symbols.h)
+    i64_t total;
+} rfui_mem_report_t;
+
+// Bytes reachable from obj (walks lists, dicts and tables). Pure read, any thread.
+i64_t rfui_obj_bytes(obj_p obj);
+
+// Element size of a plain vector type (0 for lists, tables, functions, ...)
+i64_t rfui_elem_size(i8_t type);
+
+nil_t rfui_memory_init(nil_t);
+nil_t rfui_memory_destroy(nil_t);
+
+// Drop queue accounting: UI thread on enqueue, Rayforce thread after drop_obj
+nil_t rfui_memory_drop_queued(i64_t bytes);
+nil_t rfui_memory_drop_done(i64_t bytes);
+
+// UI thread: rebuild and publish the report if one was requested, or if the
+// overlay shows and it is older than a second (force = now)
+nil_t rfui_memory_refresh(b8_t force);
+
+// Any thread: ask for a rebuild on the UI thread's next frame. Returns the
+// generation rfui_memory_generation reaches once it is published.
+i64_t rfui_memory_request(nil_t);
+i64_t rfui_memory_generation(nil_t);
+
+// Copy of the latest report (free with rfui_memory_report_free)
+nil_t rfui_memory_report(rfui_mem_report_t* out);
+nil_t rfui_memory_report_free(rfui_mem_report_t* r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_MEMORY_H
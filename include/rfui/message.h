@@ -4,14 +4,18 @@
 
 #include "../../deps/rayforce/core/rayforce.h"
 
-// Forward declaration
+// Forward declarations
 struct rfui_widget_t;
+struct rfui_sym_delta_t;
 
 // UI → Rayforce message types
 typedef enum rfui_ui_msg_type_t {
     RFUI_MSG_EVAL,           // Evaluate expression
     RFUI_MSG_SET_POST_QUERY, // Set widget post_query
     RFUI_MSG_DROP,           // Drop obj_p after render
+    RFUI_MSG_REPLAY,         // Recorded widget/draw from --replay (blob)
+    RFUI_MSG_SELECT,         // Grid selection changed: call widget on_select (rows)
+    RFUI_MSG_SET_HIDDEN,     // Grid columns hidden/shown: rows holds the hidden names
     RFUI_MSG_QUIT            // Shutdown
 } rfui_ui_msg_type_t;
 
@@ -19,7 +23,10 @@ typedef enum rfui_ui_msg_type_t {
 typedef enum rfui_ray_msg_type_t {
     RFUI_MSG_WIDGET_CREATED, // New widget panel
     RFUI_MSG_DRAW,           // Widget data update
-    RFUI_MSG_RESULT          // REPL result
+    RFUI_MSG_UPSERT,         // Grid rows merged by key: data is the whole new table
+    RFUI_MSG_RESULT,         // REPL result
+    RFUI_MSG_SNAPSHOT,       // Capture widget (or dashboard) to PNG
+    RFUI_MSG_OVERLAY         // Show/hide performance overlay (width: 1/0)
 } rfui_ray_msg_type_t;
 
 // UI → Rayforce message
@@ -28,6 +35,11 @@ typedef struct rfui_ui_msg_t {
     char* expr;                      // Expression string (owned, must free)
     obj_p obj;                       // Object to drop
     struct rfui_widget_t* widget;  // Target widget
+    i64_t bytes;                     // rfui_obj_bytes(obj) for MSG_DROP, blob length for MSG_REPLAY,
+                                     // row count for MSG_SELECT, name count for MSG_SET_HIDDEN
+    u8_t* blob;                      // Encoded replay record (owned, must free)
+    i64_t* rows;                     // Selected data rows, ascending, or hidden column
+                                     // names as symbol ids (owned, must free)
 } rfui_ui_msg_t;
 
 // Rayforce → UI message
@@ -35,7 +47,16 @@ typedef struct rfui_ray_msg_t {
     rfui_ray_msg_type_t type;
     struct rfui_widget_t* widget;  // Target widget
     obj_p data;                      // Data for rendering
-    char* text;                      // Result text (owned, must free)
+    char* text;                      // Result text / snapshot path (owned, must free)
+    i32_t width;                     // Snapshot size (0 = on-screen size)
+    i32_t height;
+    i64_t stamp;                     // fn_draw entry time (rfui_clock_ns), 0 = none
+    i64_t* rows;                     // MSG_UPSERT: data rows written, ascending (owned, must free)
+    i64_t nrows;
+    struct rfui_sym_delta_t* symbols; // MSG_DRAW / MSG_UPSERT: strings of symbol ids new to the UI,
+                                      // added before data is swapped in (owned, must free)
+    i64_t bytes;                     // MSG_DRAW / MSG_UPSERT: bytes of data
+    i64_t drop_bytes;                // MSG_DRAW / MSG_UPSERT: bytes freed by dropping the data it replaces
 } rfui_ray_msg_t;
 
 #endif // RFUI_MESSAGE_H
@@ -0,0 +1,41 @@
+// include/rfui/offscreen.h
+// Offscreen OpenGL render targets (framebuffer objects)
+
+#ifndef RFUI_OFFSCREEN_H
+#define RFUI_OFFSCREEN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// GL entry point loader (glfwGetProcAddress, eglGetProcAddress, ...)
+typedef void* (*rfui_gl_loader_t)(const char* name);
+
+// RGBA8 color-only framebuffer object
+typedef struct rfui_fbo_t {
+    unsigned int fbo;
+    unsigned int rbo;
+    int width;
+    int height;
+} rfui_fbo_t;
+
+// Load FBO entry points. Call once with a current GL context. Returns 0 on success.
+int rfui_offscreen_init(rfui_gl_loader_t loader);
+
+// Create a framebuffer of the given size. Returns 0 on success.
+int rfui_fbo_create(rfui_fbo_t* fbo, int width, int height);
+
+// Bind framebuffer for drawing and reading (NULL binds the default framebuffer).
+void rfui_fbo_bind(const rfui_fbo_t* fbo);
+
+// Read back the bound framebuffer as top-down RGBA8 (width * height * 4 bytes).
+void rfui_fbo_read(const rfui_fbo_t* fbo, unsigned char* rgba);
+
+// Delete framebuffer and its storage.
+void rfui_fbo_destroy(rfui_fbo_t* fbo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_OFFSCREEN_H
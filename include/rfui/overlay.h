@@ -0,0 +1,27 @@
+// include/rfui/overlay.h
+// Performance overlay: frame times and per-widget draw latency (F12 / ui-overlay)
+
+#ifndef RFUI_OVERLAY_H
+#define RFUI_OVERLAY_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+nil_t rfui_overlay_set_visible(b8_t visible);
+b8_t rfui_overlay_visible(nil_t);
+nil_t rfui_overlay_toggle(nil_t);
+
+// Record the previous frame's wall time (UI thread, once per frame)
+nil_t rfui_overlay_frame(f64_t ms);
+
+// Draw the overlay window if visible (inside the ImGui frame, after widgets)
+nil_t rfui_overlay_render(nil_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_OVERLAY_H
@@ -0,0 +1,20 @@
+// include/rfui/png.h
+// Minimal PNG encoder (RGBA8, zlib deflate with fixed Huffman codes)
+
+#ifndef RFUI_PNG_H
+#define RFUI_PNG_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Encode top-down RGBA8 pixels and write them to path. Returns 0 on success.
+i32_t rfui_png_write(const char* path, const u8_t* rgba, i32_t width, i32_t height);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_PNG_H
@@ -0,0 +1,69 @@
+// include/rfui/record.h
+// Record and replay of the widget/draw message stream
+//
+// (ui-record "file") appends every widget creation and every table shipped
+// to the UI (after post_query, keyed flattening and column projection) to a
+// binary columnar log. --replay reads the log on a timing thread and hands
+// each record to the Rayforce thread, which rebuilds the data and runs it
+// through the normal draw path - no script, timers or server connections
+// involved. Replayed widgets have no post_query or columns: the logged data
+// already went through them.
+//
+// Log layout (native byte order):
+//   "RFUIREC2"
+//   record*: u8 kind, i64 t_ns, u32 widget id, u64 len, payload[len]
+//     widget: u8 widget type, u8 flags (RFUI_RECORD_DENSE), name bytes
+//     draw:   encoded object (vectors stored as raw column bytes,
+//             symbol columns as a string dictionary + u32 indices)
+
+#ifndef RFUI_RECORD_H
+#define RFUI_RECORD_H
+
+#include "context.h"
+#include "widget.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RFUI_RECORD_WIDGET 1
+#define RFUI_RECORD_DRAW 2
+
+// Widget record flags
+#define RFUI_RECORD_DENSE 1
+
+typedef struct rfui_replay_rec_t {
+    u8_t kind;                  // RFUI_RECORD_WIDGET / RFUI_RECORD_DRAW
+    u32_t id;                   // Widget id within the log
+    rfui_widget_type_t type;    // Widget records
+    char* name;                 // Widget records (owned, must free)
+    b8_t dense;                 // Widget records: grid starts in dense mode
+    obj_p data;                 // Draw records (owned, must drop)
+} rfui_replay_rec_t;
+
+// Start recording to path (replaces any active recording). Returns 0 on success.
+// Recording functions run on the Rayforce thread.
+i32_t rfui_record_start(const char* path);
+nil_t rfui_record_stop(nil_t);
+b8_t rfui_record_active(nil_t);
+
+nil_t rfui_record_widget(rfui_widget_t* w);
+// data is the table as shipped to the UI
+nil_t rfui_record_draw(rfui_widget_t* w, obj_p data);
+
+// Start the replay thread: records are pushed to ctx->ui_to_ray as
+// RFUI_MSG_REPLAY at their recorded time divided by speed (speed <= 0 = no
+// delays). Returns 0 on success.
+i32_t rfui_replay_start(rfui_ctx_t* ctx, const char* path, f64_t speed);
+
+// Stop and join the replay thread
+nil_t rfui_replay_stop(nil_t);
+
+// Decode an RFUI_MSG_REPLAY blob (Rayforce thread: allocates objects)
+b8_t rfui_replay_decode(const u8_t* blob, i64_t len, rfui_replay_rec_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_RECORD_H
@@ -20,6 +20,9 @@ nil_t rfui_repl_add_result_text(const char* text);
 // Load a script file via REPL (shows in history, evaluates)
 nil_t rfui_repl_load_file(const char* path);
 
+// Bytes held by output lines and command history (UI thread)
+nil_t rfui_repl_memory(i64_t* lines, i64_t* history);
+
 // Destroy REPL state
 nil_t rfui_repl_destroy(nil_t);
 
@@ -0,0 +1,29 @@
+// include/rfui/snapshot.h
+// Offscreen widget/dashboard snapshots written as PNG on a background thread
+
+#ifndef RFUI_SNAPSHOT_H
+#define RFUI_SNAPSHOT_H
+
+#include "widget.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Queue a snapshot (UI thread, on MSG_SNAPSHOT). widget == NULL captures the
+// whole dashboard (main viewport). width/height of 0 keep the on-screen size;
+// otherwise the capture is scaled to fit. Takes ownership of path.
+nil_t rfui_snapshot_request(rfui_widget_t* widget, char* path, i32_t width, i32_t height);
+
+// Render pending snapshots into an FBO and hand pixels to the worker pool.
+// Call after ImGui::Render() with the main GL context current.
+nil_t rfui_snapshot_process(nil_t);
+
+// Drop pending requests (in-flight PNG writes finish in the worker pool)
+nil_t rfui_snapshot_destroy(nil_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_SNAPSHOT_H
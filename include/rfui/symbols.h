@@ -0,0 +1,64 @@
+// include/rfui/symbols.h
+// Symbol strings for the UI thread and the worker pool
+//
+// Only the Rayforce thread may resolve symbol ids (str_from_symbol reads the
+// runtime's symbol table). Tables going to the UI (draw, draw-upsert) are
+// scanned there for ids not shipped before, column names and symbol columns,
+// and their strings travel with the message as a delta. The UI thread adds a
+// delta to its cache before it swaps the data in, so renderers and jobs
+// resolve every id they can meet without touching the runtime.
+//
+// The cache is an open-addressing table with one writer (the UI thread) and
+// lock-free readers on any thread: a slot's id is stored before its string
+// pointer is published, and growth publishes a new table with one pointer
+// store. Symbols are interned for the life of the runtime, so nothing is
+// removed; replaced tables and the strings stay allocated until exit, which
+// keeps them valid for readers still probing them.
+
+#ifndef RFUI_SYMBOLS_H
+#define RFUI_SYMBOLS_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Strings for symbol ids new to the UI (one allocation: free() it, or hand
+// it to rfui_symbols_apply)
+typedef struct rfui_sym_delta_t {
+    i64_t n;
+    i64_t* ids;
+    u32_t* offsets;   // n + 1 offsets into text; each string is NUL-terminated
+    char* text;
+    i64_t done;       // UI thread: entries already added to the cache
+    struct rfui_sym_delta_t* next;   // UI thread: next delta waiting for memory
+} rfui_sym_delta_t;
+
+// Rayforce thread: delta for the ids in data (a table or keyed table) that
+// no earlier delta carried, NULL if there are none. Out of memory it returns
+// NULL and forgets what was sent, so the next delta carries every id again.
+rfui_sym_delta_t* rfui_symbols_collect(obj_p data);
+
+// Rayforce thread: a delta was lost (message not queued); resend everything
+nil_t rfui_symbols_reset(nil_t);
+
+// UI thread: add a delta's strings to the cache and free it (NULL = nothing
+// new). Out of memory, the rest of the delta is kept and every later call
+// retries it first, so call it once per frame even without a delta.
+nil_t rfui_symbols_apply(rfui_sym_delta_t* d);
+
+// Any thread: string for a symbol id, NULL if it was never shipped
+const char* rfui_symbols_get(i64_t id);
+
+// Bytes held by the UI cache (tables and strings)
+i64_t rfui_symbols_bytes(nil_t);
+
+// At exit, once no other thread reads the cache or collects deltas
+nil_t rfui_symbols_free(nil_t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_SYMBOLS_H
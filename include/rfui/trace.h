@@ -0,0 +1,44 @@
+// include/rfui/trace.h
+// Span tracing across UI, Rayforce and worker threads, dumped as Chrome
+// trace-event JSON (chrome://tracing, ui.perfetto.dev)
+//
+// Each thread appends to its own fixed-size buffer; the only shared state is
+// an atomically published event count, so recording never takes a lock.
+// Full buffers drop further events until the next rfui_trace_start().
+
+#ifndef RFUI_TRACE_H
+#define RFUI_TRACE_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Events kept per thread per session (~64 bytes each)
+#define RFUI_TRACE_EVENTS 262144
+
+// Start a new session (discards previous events) / stop recording
+nil_t rfui_trace_start(nil_t);
+nil_t rfui_trace_stop(nil_t);
+b8_t rfui_trace_enabled(nil_t);
+
+// Name the calling thread in the dump ("ui", "rayforce", "worker")
+nil_t rfui_trace_thread_name(const char* name);
+
+// Span start timestamp, or 0 when tracing is off
+i64_t rfui_trace_begin(nil_t);
+
+// Close a span opened by rfui_trace_begin. name must be a string literal;
+// detail (widget name, expression, ...) is copied and may be NULL.
+nil_t rfui_trace_end(const char* name, const char* detail, i64_t start);
+
+// Write the current session as Chrome trace JSON. Returns the number of
+// events written, or -1 if the file could not be written.
+i64_t rfui_trace_dump(const char* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_TRACE_H
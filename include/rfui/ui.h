@@ -8,9 +8,20 @@
 extern "C" {
 #endif
 
-// Initialize GLFW and ImGui
+// UI startup options (parsed from the command line in main.c)
+typedef struct rfui_ui_opts_t {
+    b8_t headless;       // Render offscreen with no display (EGL surfaceless)
+    i32_t width;         // Headless framebuffer size in pixels
+    i32_t height;
+    i64_t max_frames;    // Exit after this many frames (0 = run until quit)
+    f64_t fps;           // Headless frame rate cap (0 = as fast as possible)
+    const char* stats_json;  // Also write frame statistics as JSON here (NULL = off)
+    const char* trace;       // Trace from startup, dump Chrome trace JSON here on exit (NULL = off)
+} rfui_ui_opts_t;
+
+// Initialize GLFW and ImGui (opts may be NULL for a default windowed UI)
 // Returns 0 on success, -1 on failure
-i32_t rfui_ui_init(nil_t);
+i32_t rfui_ui_init(const rfui_ui_opts_t* opts);
 
 // Run the main UI loop
 // Returns exit code
@@ -25,6 +36,10 @@ b8_t rfui_ui_should_run(nil_t);
 // Wake UI from another thread (called after pushing to ray_to_ui queue)
 nil_t rfui_ui_wake(nil_t);
 
+// Hand an object back to the Rayforce thread for drop_obj (UI thread); bytes
+// is what the drop frees, as measured when the object was shipped
+nil_t rfui_ui_queue_drop(obj_p obj, i64_t bytes);
+
 #ifdef __cplusplus
 }
 #endif
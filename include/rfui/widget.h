@@ -3,6 +3,8 @@
 #define RFUI_WIDGET_H
 
 #include "../../deps/rayforce/core/rayforce.h"
+#include "latency.h"
+#include "keyed.h"
 
 typedef enum rfui_widget_type_t {
     RFUI_WIDGET_GRID,
@@ -13,15 +15,29 @@ typedef enum rfui_widget_type_t {
 typedef struct rfui_widget_t {
     rfui_widget_type_t type;
     char* name;
-    obj_p data;           // Base data from draw()
+    obj_p data;           // Grids: table last drawn or upserted, before projection
+    rfui_keyed_t keyed;   // Key index over data for draw-upsert (keyed tables)
+    obj_p columns;        // Config columns: drawn tables keep only these (NULL = all)
+    i64_t* hidden;        // Column names (symbol ids) the grid hides, ascending: shipped blank
+    i64_t nhidden;
+    obj_p blank;          // Shared stand-in for hidden columns (C8, one per row)
+    obj_p* shipped;       // Columns of the table last shipped to the UI (compared by address only)
+    i64_t* shipped_bytes; // Their bytes (0 for the blank column)
+    i64_t nshipped;
+    i64_t shipped_total;  // Bytes dropping that table frees if it shares nothing
+    b8_t dense;           // Grids: start in dense rendering mode (config)
     obj_p post_query;     // Expression applied before render
-    obj_p on_select;      // Callback function
+    obj_p on_select;      // Callback function: (on_select rows)
+    rfui_latency_t* latency;  // Draw latency histograms (shared, locked)
+    i32_t select_busy;    // MSG_SELECT queued or running (atomic; UI sends the next one after)
 
     // UI state (UI thread only)
     b8_t is_open;
     u32_t dock_id;
     raw_p ui_state;       // Type-specific UI state
     obj_p render_data;    // Current data for rendering
+    i64_t render_bytes;   // Bytes of render_data (measured on the Rayforce thread)
+    i64_t version;        // Bumped on every render_data swap (cache key)
 } rfui_widget_t;
 
 // Create widget struct (called from Rayforce thread)
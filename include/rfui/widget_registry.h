@@ -24,6 +24,16 @@ nil_t rfui_registry_render(nil_t);
 // Returns old render_data that should be queued for drop
 obj_p rfui_registry_update_data(rfui_widget_t* widget, obj_p new_data);
 
+// Icon-prefixed ImGui window label for widget (also its window ID)
+nil_t rfui_registry_window_label(rfui_widget_t* widget, char* buf, i64_t size);
+
+// Number of registered widgets / widget at index (UI thread)
+i64_t rfui_registry_count(nil_t);
+rfui_widget_t* rfui_registry_get(i64_t index);
+
+// Record draw->present latency for every open widget (after frame swap)
+nil_t rfui_registry_frame_presented(i64_t now);
+
 // Find first widget of specified type
 // Returns NULL if not found
 rfui_widget_t* rfui_registry_find_by_type(rfui_widget_type_t type);
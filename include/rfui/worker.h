@@ -0,0 +1,73 @@
+// include/rfui/worker.h
+// Background worker pool for UI-side jobs (image encoding, sorting, scans)
+//
+// Jobs run off the UI thread and must not call Rayforce runtime functions
+// (no heap, no drop_obj). Column buffers they read must be kept alive by
+// the submitter until the job reports completion.
+//
+// Cancellable jobs the UI polls (sort, filter scans, profile, group, pivot,
+// find, export) embed an rfui_task_t. It runs the job on the pool, or inline
+// when there is no pool, and publishes completion. The job struct and
+// everything it reads must stay alive until rfui_task_done is true;
+// rfui_task_wait cancels and blocks until then, so freeing a grid waits for
+// its jobs rather than pulling data out from under them.
+
+#ifndef RFUI_WORKER_H
+#define RFUI_WORKER_H
+
+#include "../../deps/rayforce/core/rayforce.h"
+#include "../../deps/rayforce/core/thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Default number of pool threads
+#define RFUI_WORKER_THREADS 4
+
+typedef nil_t (*rfui_job_fn)(raw_p arg);
+
+typedef struct rfui_task_t {
+    rfui_job_fn fn;
+    raw_p arg;
+    i32_t running;                 // Atomic: copies still to finish
+    i32_t cancel;                  // Atomic
+    i32_t done;                    // Atomic
+    mutex_t mutex;                 // Guards done for waiters
+    cond_t cond;
+} rfui_task_t;
+
+// Start the pool (nthreads <= 0 uses RFUI_WORKER_THREADS). Returns 0 on success.
+i32_t rfui_worker_init(i32_t nthreads);
+
+// Queue a job. Returns B8_FALSE if the pool is not running or allocation failed.
+b8_t rfui_worker_submit(rfui_job_fn fn, raw_p arg);
+
+// Number of running pool threads (0 if not initialized)
+i32_t rfui_worker_count(nil_t);
+
+// Finish queued jobs and join all threads
+nil_t rfui_worker_destroy(nil_t);
+
+// Run fn(arg) as copies pool jobs (several copies share chunked work), inline
+// for any the pool can't take. A cancel before a copy starts skips it. The
+// last copy out marks the task done and wakes the UI.
+nil_t rfui_task_submit(rfui_task_t* t, rfui_job_fn fn, raw_p arg, i32_t copies);
+
+nil_t rfui_task_cancel(rfui_task_t* t);
+b8_t rfui_task_cancelled(const rfui_task_t* t);
+
+// Every copy has finished: results can be read and the job freed
+b8_t rfui_task_done(const rfui_task_t* t);
+
+// Cancel and block until done
+nil_t rfui_task_wait(rfui_task_t* t);
+
+// Release a task that was submitted and is done
+nil_t rfui_task_free(rfui_task_t* t);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RFUI_WORKER_H
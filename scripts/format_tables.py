@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+# Generate the lookup tables used by src/format.c: Ryu power-of-5 tables,
+# two-digit pairs and March-based day of year -> month/day.
+# Usage: format_tables.py > src/format_tables.h
+
+POW5_BITCOUNT = 125
+POW5_INV_BITCOUNT = 125
+INV_TABLE_SIZE = 291   # q <= 290 for e2 >= 0
+TABLE_SIZE = 326       # i <= 325 for e2 < 0
+MASK = (1 << 64) - 1
+
+
+def bits(v):
+    return max(1, v.bit_length())
+
+
+def emit(name, rows):
+    print("static const u64_t %s[%d][2] = {" % (name, len(rows)))
+    for v in rows:
+        print("    { %du, %du }," % (v & MASK, v >> 64))
+    print("};")
+
+
+inv = []
+for q in range(INV_TABLE_SIZE):
+    k = bits(5 ** q) - 1 + POW5_INV_BITCOUNT
+    inv.append((1 << k) // 5 ** q + 1)
+
+pow5 = []
+for i in range(TABLE_SIZE):
+    p = 5 ** i
+    shift = bits(p) - POW5_BITCOUNT
+    pow5.append(p >> shift if shift >= 0 else p << -shift)
+
+print("// Auto-generated by scripts/format_tables.py -- do not edit")
+print("#ifndef FORMAT_TABLES_H")
+print("#define FORMAT_TABLES_H")
+print("")
+print("#define DOUBLE_POW5_INV_BITCOUNT %d" % POW5_INV_BITCOUNT)
+print("#define DOUBLE_POW5_BITCOUNT %d" % POW5_BITCOUNT)
+print("")
+print("// floor(2^k / 5^q) + 1, k = bits(5^q) - 1 + %d (low, high)" % POW5_INV_BITCOUNT)
+emit("DOUBLE_POW5_INV_SPLIT", inv)
+print("")
+print("// 5^i normalized to %d bits (low, high)" % POW5_BITCOUNT)
+emit("DOUBLE_POW5_SPLIT", pow5)
+print("")
+print("// \"00\" .. \"99\"")
+print("static const c8_t DIGIT_PAIRS[200] = {")
+for row in range(10):
+    print("    " + " ".join("'%d', '%d'," % divmod(row * 10 + c, 10) for c in range(10)))
+print("};")
+print("")
+print("// Day of a March-based year (0 = Mar 1) -> month << 8 | day")
+print("static const uint16_t MARCH_DOY[366] = {")
+lengths = [31, 30, 31, 30, 31, 31, 30, 31, 30, 31, 31, 29]
+doy = []
+for i, n in enumerate(lengths):
+    month = (i + 2) % 12 + 1
+    doy += [month << 8 | d for d in range(1, n + 1)]
+for i in range(0, len(doy), 12):
+    print("    " + " ".join("0x%04x," % v for v in doy[i:i + 12]))
+print("};")
+print("")
+print("#endif // FORMAT_TABLES_H")
@@ -14,6 +14,16 @@
 extern "C" {
 #include "../include/rfui/chart_renderer.h"
 #include "../include/rfui/widget.h"
+#include "../include/rfui/format.h"
+#include "../include/rfui/symbols.h"
+}
+
+// Tooltip line: label plus the column's value formatted like a grid cell
+static void tooltip_value(const char* label, obj_p col, i64_t row) {
+    char buf[RFUI_FMT_CELL_MAX];
+    b8_t dim;
+    rfui_fmt_cell(col, row, &rfui_fmt_default, buf, sizeof(buf), &dim);
+    ImGui::Text("%s%s", label, buf);
 }
 
 // Helper function to check if a type is numeric and plottable
@@ -306,7 +316,7 @@ static double get_numeric_value(obj_p col, i64_t idx) {
 // Find a column index by name. Returns -1 if not found.
 static i64_t find_column(i64_t* sym_ids, i64_t ncols, const char* name) {
     for (i64_t i = 0; i < ncols; i++) {
-        const char* col_name = str_from_symbol(sym_ids[i]);
+        const char* col_name = rfui_symbols_get(sym_ids[i]);
         if (col_name && strcmp(col_name, name) == 0) return i;
     }
     return -1;
@@ -345,11 +355,6 @@ static void plot_candlestick(obj_p* cols, i64_t* sym_ids, i64_t ncols, i64_t nro
         ImPlotPoint mouse = ImPlot::GetPlotMousePos();
         int idx = (int)(mouse.x + 0.5);
         if (idx >= 0 && idx < count) {
-            double o = get_numeric_value(open_col, idx);
-            double c = get_numeric_value(close_col, idx);
-            double l = get_numeric_value(low_col, idx);
-            double h = get_numeric_value(high_col, idx);
-
             // Highlight bar
             ImDrawList* draw_list = ImPlot::GetPlotDrawList();
             float tool_l = ImPlot::PlotToPixels((double)idx - half_width * 1.5, mouse.y).x;
@@ -363,10 +368,10 @@ static void plot_candlestick(obj_p* cols, i64_t* sym_ids, i64_t ncols, i64_t nro
 
             ImGui::BeginTooltip();
             ImGui::Text("Bar:   %d", idx);
-            ImGui::Text("Open:  %.2f", o);
-            ImGui::Text("Close: %.2f", c);
-            ImGui::Text("Low:   %.2f", l);
-            ImGui::Text("High:  %.2f", h);
+            tooltip_value("Open:  ", open_col, idx);
+            tooltip_value("Close: ", close_col, idx);
+            tooltip_value("Low:   ", low_col, idx);
+            tooltip_value("High:  ", high_col, idx);
             ImGui::EndTooltip();
         }
     }
@@ -536,7 +541,7 @@ nil_t rfui_render_chart(rfui_widget_t* widget) {
                 if (!is_numeric_type(col->type)) continue;
                 if (col->len != nrows) continue;
 
-                const char* col_name = str_from_symbol(sym_ids[col_idx]);
+                const char* col_name = rfui_symbols_get(sym_ids[col_idx]);
                 if (!col_name) col_name = "<unknown>";
 
                 switch (chart_type) {
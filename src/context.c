@@ -33,6 +33,8 @@ rfui_ctx_t* rfui_ctx_create(i32_t argc, str_p argv[]) {
     ctx->ready = B8_FALSE;
     ctx->quit = B8_FALSE;
     ctx->waker = NULL;
+    ctx->replay = NULL;
+    ctx->replay_speed = 1.0;
 
     return ctx;
 }
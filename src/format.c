@@ -0,0 +1,672 @@
+// src/format.c
+// Typed value formatting: shortest floats, calendar dates, column batches
+//
+// The shortest-float core is Ryu (Ulf Adams, PLDI 2018): the double's
+// rounding interval is scaled by a 125-bit power of 5 from format_tables.h,
+// after which the shortest digit string inside it comes out of 64-bit
+// arithmetic with no loops over digits of the input.
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include "../include/rfui/format.h"
+#include "../include/rfui/symbols.h"
+#include "format_tables.h"
+
+typedef unsigned __int128 u128_t;
+
+const rfui_fmt_t rfui_fmt_default = { -1, B8_FALSE };
+
+static const f64_t POW10[10] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+static const c8_t HEX[16] = { '0', '1', '2', '3', '4', '5', '6', '7',
+                              '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
+
+// ============================================================================
+// Digits
+// ============================================================================
+
+static inline i32_t decimal_length(u64_t v) {
+    i32_t n = 1;
+    while (v >= 10000) {
+        v /= 10000;
+        n += 4;
+    }
+    return n + (v >= 10) + (v >= 100) + (v >= 1000);
+}
+
+// Write v right-aligned in buf[0..n) two digits at a time
+static inline void put_digits(u64_t v, c8_t* buf, i32_t n) {
+    c8_t* p = buf + n;
+    while (v >= 100) {
+        u32_t pair = (u32_t)(v % 100);
+        v /= 100;
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + pair * 2, 2);
+    }
+    if (v >= 10) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + v * 2, 2);
+    } else {
+        *--p = (c8_t)('0' + v);
+    }
+}
+
+static inline c8_t* put2(c8_t* p, u32_t v) {
+    memcpy(p, DIGIT_PAIRS + v * 2, 2);
+    return p + 2;
+}
+
+// Copy n digits, with ',' between groups of three if asked
+static c8_t* put_grouped(c8_t* p, const c8_t* digits, i32_t n, b8_t thousands) {
+    if (!thousands || n <= 3) {
+        memcpy(p, digits, (size_t)n);
+        return p + n;
+    }
+    i32_t lead = n % 3 ? n % 3 : 3;
+    memcpy(p, digits, (size_t)lead);
+    p += lead;
+    for (i32_t i = lead; i < n; i += 3) {
+        *p++ = ',';
+        memcpy(p, digits + i, 3);
+        p += 3;
+    }
+    return p;
+}
+
+static c8_t* put_u64(c8_t* p, u64_t v, b8_t thousands) {
+    c8_t d[20];
+    i32_t n = decimal_length(v);
+    put_digits(v, d, n);
+    return put_grouped(p, d, n, thousands);
+}
+
+static inline i32_t put_null(c8_t* buf) {
+    memcpy(buf, "null", 4);
+    return 4;
+}
+
+// ============================================================================
+// Shortest round-trip doubles (Ryu)
+// ============================================================================
+
+static inline i32_t pow5bits(i32_t e) { return ((e * 1217359) >> 19) + 1; }
+static inline i32_t log10_pow2(i32_t e) { return (e * 78913) >> 18; }
+static inline i32_t log10_pow5(i32_t e) { return (e * 732923) >> 20; }
+
+static inline u32_t pow5_factor(u64_t v) {
+    u32_t count = 0;
+    while (v % 5 == 0) {
+        v /= 5;
+        count++;
+    }
+    return count;
+}
+
+static inline b8_t multiple_of_pow5(u64_t v, u32_t p) { return pow5_factor(v) >= p; }
+static inline b8_t multiple_of_pow2(u64_t v, u32_t p) { return (v & ((1ULL << p) - 1)) == 0; }
+
+static inline u64_t mul_shift(u64_t m, const u64_t* mul, i32_t j) {
+    u128_t lo = (u128_t)m * mul[0];
+    u128_t hi = (u128_t)m * mul[1];
+    return (u64_t)(((lo >> 64) + hi) >> (j - 64));
+}
+
+// Shortest digits d with v = d * 10^e10 for a finite nonzero double
+static u64_t shortest(u64_t mantissa, u32_t exponent, i32_t* e10_out) {
+    i32_t e2;
+    u64_t m2;
+    if (exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = mantissa;
+    } else {
+        e2 = (i32_t)exponent - 1023 - 52 - 2;
+        m2 = (1ULL << 52) | mantissa;
+    }
+    b8_t accept_bounds = (m2 & 1) == 0;
+
+    // Interval [mm, mp] of reals rounding to v, scaled by 4
+    u64_t mv = 4 * m2;
+    u32_t mm_shift = mantissa != 0 || exponent <= 1;
+
+    u64_t vr, vp, vm;
+    i32_t e10;
+    b8_t vm_trailing_zeros = B8_FALSE, vr_trailing_zeros = B8_FALSE;
+    if (e2 >= 0) {
+        i32_t q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        i32_t k = DOUBLE_POW5_INV_BITCOUNT + pow5bits(q) - 1;
+        i32_t i = -e2 + q + k;
+        vr = mul_shift(4 * m2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vp = mul_shift(4 * m2 + 2, DOUBLE_POW5_INV_SPLIT[q], i);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, DOUBLE_POW5_INV_SPLIT[q], i);
+        if (q <= 21) {
+            // Only here can the scaled values be exact (trailing zeros matter)
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, (u32_t)q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, (u32_t)q);
+            } else {
+                vp -= multiple_of_pow5(mv + 2, (u32_t)q);
+            }
+        }
+    } else {
+        i32_t q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        i32_t i = -e2 - q;
+        i32_t k = pow5bits(i) - DOUBLE_POW5_BITCOUNT;
+        i32_t j = q - k;
+        vr = mul_shift(4 * m2, DOUBLE_POW5_SPLIT[i], j);
+        vp = mul_shift(4 * m2 + 2, DOUBLE_POW5_SPLIT[i], j);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, DOUBLE_POW5_SPLIT[i], j);
+        if (q <= 1) {
+            vr_trailing_zeros = B8_TRUE;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = multiple_of_pow2(mv, (u32_t)q);
+        }
+    }
+
+    // Drop digits while the interval still holds a shorter number
+    i32_t removed = 0;
+    u8_t last_removed = 0;
+    u64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = (u8_t)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = (u8_t)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) {
+            last_removed = 4;  // Exactly halfway: round to even
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        // Common case: no exact-boundary bookkeeping
+        b8_t round_up = B8_FALSE;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    *e10_out = e10 + removed;
+    return output;
+}
+
+// Shortest digits laid out like %g: plain decimals for exponents -5..16,
+// d.ddde+XX outside
+static i32_t f64_shortest(u64_t bits, b8_t thousands, c8_t* buf) {
+    c8_t* p = buf;
+    if (bits >> 63) *p++ = '-';
+    u64_t mantissa = bits & ((1ULL << 52) - 1);
+    u32_t exponent = (u32_t)((bits >> 52) & 0x7ff);
+    if (exponent == 0 && mantissa == 0) {
+        *p++ = '0';
+        return (i32_t)(p - buf);
+    }
+
+    i32_t e10;
+    u64_t digits = shortest(mantissa, exponent, &e10);
+    c8_t d[20];
+    i32_t nd = decimal_length(digits);
+    put_digits(digits, d, nd);
+    i32_t point = nd + e10;  // Digits before the decimal point
+
+    if (point > 17 || point < -4) {
+        *p++ = d[0];
+        if (nd > 1) {
+            *p++ = '.';
+            memcpy(p, d + 1, (size_t)(nd - 1));
+            p += nd - 1;
+        }
+        i32_t x = point - 1;
+        *p++ = 'e';
+        *p++ = x < 0 ? '-' : '+';
+        if (x < 0) x = -x;
+        if (x >= 100) {
+            *p++ = (c8_t)('0' + x / 100);
+            x %= 100;
+        }
+        return (i32_t)(put2(p, (u32_t)x) - buf);
+    }
+
+    if (point <= 0) {
+        *p++ = '0';
+        *p++ = '.';
+        memset(p, '0', (size_t)-point);
+        p += -point;
+        memcpy(p, d, (size_t)nd);
+        return (i32_t)(p + nd - buf);
+    }
+    if (point >= nd) {
+        memset(d + nd, '0', (size_t)(point - nd));
+        return (i32_t)(put_grouped(p, d, point, thousands) - buf);
+    }
+    p = put_grouped(p, d, point, thousands);
+    *p++ = '.';
+    memcpy(p, d + point, (size_t)(nd - point));
+    return (i32_t)(p + nd - point - buf);
+}
+
+i32_t rfui_fmt_f64(f64_t v, const rfui_fmt_t* fmt, c8_t* buf) {
+    if (v != v) return put_null(buf);
+    u64_t bits;
+    memcpy(&bits, &v, sizeof(bits));
+    if (((bits >> 52) & 0x7ff) == 0x7ff) {
+        // Infinity (NaN handled above)
+        if (bits >> 63) {
+            memcpy(buf, "-inf", 4);
+            return 4;
+        }
+        memcpy(buf, "inf", 3);
+        return 3;
+    }
+
+    b8_t thousands = fmt ? fmt->thousands : B8_FALSE;
+    i32_t decimals = fmt ? fmt->decimals : -1;
+    if (decimals < 0) return f64_shortest(bits, thousands, buf);
+
+    // Fixed decimals, rounded like printf: the scaled value is rounded once
+    // and below 2^52 keeps its fraction bits, so only an apparent .5 needs
+    // the product's exact error (fma) to say which way it goes. Exact ties
+    // go to even.
+    if (decimals > 9) decimals = 9;
+    f64_t a = v < 0 ? -v : v;
+    f64_t scaled = a * POW10[decimals];
+    if (!(scaled < 4503599627370496.0)) return f64_shortest(bits, thousands, buf);
+
+    f64_t whole = floor(scaled);
+    u64_t m = (u64_t)whole;
+    f64_t above = (scaled - whole) - 0.5;
+    if (above == 0.0) {
+        f64_t err = fma(a, POW10[decimals], -scaled);
+        above = err != 0.0 ? err : (f64_t)(m & 1);
+    }
+    if (above > 0.0) m++;
+    u64_t unit = (u64_t)POW10[decimals];
+    c8_t* p = buf;
+    if (v < 0 && m != 0) *p++ = '-';
+    p = put_u64(p, m / unit, thousands);
+    if (decimals > 0) {
+        *p++ = '.';
+        put_digits(m % unit + unit, p - 1, decimals + 1);  // Leading 1 lands on the '.'
+        p[-1] = '.';
+        p += decimals;
+    }
+    return (i32_t)(p - buf);
+}
+
+// ============================================================================
+// Integers and temporals
+// ============================================================================
+
+i32_t rfui_fmt_i64(i64_t v, const rfui_fmt_t* fmt, c8_t* buf) {
+    c8_t* p = buf;
+    u64_t u = (u64_t)v;
+    if (v < 0) {
+        *p++ = '-';
+        u = 0 - u;
+    }
+    return (i32_t)(put_u64(p, u, fmt ? fmt->thousands : B8_FALSE) - buf);
+}
+
+// Civil date from days since 2000.01.01: the 400-year era arithmetic finds
+// the March-based year, MARCH_DOY gives month and day
+static c8_t* put_date(c8_t* p, i64_t days) {
+    i64_t z = days + 730425;  // Days since 0000.03.01
+    i64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    u32_t doe = (u32_t)(z - era * 146097);
+    u32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    u32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    u32_t md = MARCH_DOY[doy];
+    i64_t y = (i64_t)yoe + era * 400 + ((md >> 8) <= 2);
+
+    if (y >= 0 && y <= 9999) {
+        p = put2(p, (u32_t)(y / 100));
+        p = put2(p, (u32_t)(y % 100));
+    } else {
+        p += rfui_fmt_i64(y, NULL, p);
+    }
+    *p++ = '.';
+    p = put2(p, md >> 8);
+    *p++ = '.';
+    return put2(p, md & 0xff);
+}
+
+// HH:MM:SS from seconds of the day (hours may exceed 99)
+static c8_t* put_hms(c8_t* p, i64_t s) {
+    i64_t h = s / 3600;
+    s -= h * 3600;
+    i64_t m = s / 60;
+    if (h >= 100) {
+        p = put_u64(p, (u64_t)h, B8_FALSE);
+    } else {
+        p = put2(p, (u32_t)h);
+    }
+    *p++ = ':';
+    p = put2(p, (u32_t)m);
+    *p++ = ':';
+    return put2(p, (u32_t)(s - m * 60));
+}
+
+i32_t rfui_fmt_date(i32_t days, c8_t* buf) {
+    if (days == NULL_I32) return put_null(buf);
+    return (i32_t)(put_date(buf, days) - buf);
+}
+
+i32_t rfui_fmt_time(i32_t ms, c8_t* buf) {
+    if (ms == NULL_I32) return put_null(buf);
+    c8_t* p = buf;
+    i64_t t = ms;
+    if (t < 0) {
+        *p++ = '-';
+        t = -t;
+    }
+    i64_t s = t / 1000;
+    p = put_hms(p, s);
+    *p++ = '.';
+    put_digits((u64_t)(t - s * 1000) + 1000, p - 1, 4);
+    p[-1] = '.';
+    return (i32_t)(p + 3 - buf);
+}
+
+i32_t rfui_fmt_timestamp(i64_t ns, c8_t* buf) {
+    if (ns == NULL_I64) return put_null(buf);
+    const i64_t day = 86400000000000LL;
+    i64_t days = ns / day;
+    i64_t rem = ns - days * day;
+    if (rem < 0) {
+        days--;
+        rem += day;
+    }
+    c8_t* p = put_date(buf, days);
+    *p++ = 'D';
+    i64_t s = rem / 1000000000;
+    p = put_hms(p, s);
+    *p++ = '.';
+    put_digits((u64_t)(rem - s * 1000000000) + 1000000000ULL, p - 1, 10);
+    p[-1] = '.';
+    return (i32_t)(p + 9 - buf);
+}
+
+i32_t rfui_fmt_guid(const u8_t* g, c8_t* buf) {
+    c8_t* p = buf;
+    for (i32_t i = 0; i < 16; i++) {
+        if (i == 4 || i == 6 || i == 8 || i == 10) *p++ = '-';
+        *p++ = HEX[g[i] >> 4];
+        *p++ = HEX[g[i] & 15];
+    }
+    return (i32_t)(p - buf);
+}
+
+// ============================================================================
+// Cells
+// ============================================================================
+
+// Per-type cell writers: buf has RFUI_FMT_CELL_MAX bytes, *dim preset to 0
+
+static inline i32_t cell_i64(obj_p col, i64_t r, const rfui_fmt_t* fmt, c8_t* buf, u8_t* dim) {
+    i64_t v = AS_I64(col)[r];
+    if (v == NULL_I64) {
+        *dim = 1;
+        return put_null(buf);
+    }
+    return rfui_fmt_i64(v, fmt, buf);
+}
+
+static inline i32_t cell_i32(obj_p col, i64_t r, const rfui_fmt_t* fmt, c8_t* buf, u8_t* dim) {
+    i32_t v = AS_I32(col)[r];
+    if (v == NULL_I32) {
+        *dim = 1;
+        return put_null(buf);
+    }
+    return rfui_fmt_i64(v, fmt, buf);
+}
+
+static inline i32_t cell_f64(obj_p col, i64_t r, const rfui_fmt_t* fmt, c8_t* buf, u8_t* dim) {
+    f64_t v = AS_F64(col)[r];
+    if (v != v) *dim = 1;
+    return rfui_fmt_f64(v, fmt, buf);
+}
+
+static inline i32_t cell_symbol(obj_p col, i64_t r, c8_t* buf, u8_t* dim) {
+    const char* s = rfui_symbols_get(AS_SYMBOL(col)[r]);
+    if (!s) {
+        *dim = 1;
+        return put_null(buf);
+    }
+    i32_t n = 0;
+    while (n < RFUI_FMT_CELL_MAX - 1 && s[n]) n++;
+    memcpy(buf, s, (size_t)n);
+    return n;
+}
+
+static inline i32_t cell_c8(obj_p col, i64_t r, c8_t* buf) {
+    u8_t c = (u8_t)AS_C8(col)[r];
+    if (c >= 32 && c < 127) {
+        buf[0] = (c8_t)c;
+        return 1;
+    }
+    buf[0] = '0';
+    buf[1] = 'x';
+    buf[2] = HEX[c >> 4];
+    buf[3] = HEX[c & 15];
+    return 4;
+}
+
+static inline i32_t cell_date(obj_p col, i64_t r, c8_t* buf, u8_t* dim) {
+    i32_t v = AS_DATE(col)[r];
+    if (v == NULL_I32) *dim = 1;
+    return rfui_fmt_date(v, buf);
+}
+
+static inline i32_t cell_time(obj_p col, i64_t r, c8_t* buf, u8_t* dim) {
+    i32_t v = AS_TIME(col)[r];
+    if (v == NULL_I32) *dim = 1;
+    return rfui_fmt_time(v, buf);
+}
+
+static inline i32_t cell_timestamp(obj_p col, i64_t r, c8_t* buf, u8_t* dim) {
+    i64_t v = AS_TIMESTAMP(col)[r];
+    if (v == NULL_I64) *dim = 1;
+    return rfui_fmt_timestamp(v, buf);
+}
+
+// Type name in brackets: "[type:len]" for nested lists, "<type>" otherwise
+static i32_t cell_tagged(i8_t type, i64_t len, b8_t list, c8_t* buf) {
+    const char* name = type_name(type);
+    size_t n = 0;
+    while (name && n < 64 && name[n]) n++;
+    c8_t* p = buf;
+    *p++ = list ? '[' : '<';
+    memcpy(p, name, n);
+    p += n;
+    if (list) {
+        *p++ = ':';
+        p += rfui_fmt_i64(len, NULL, p);
+    }
+    *p++ = list ? ']' : '>';
+    return (i32_t)(p - buf);
+}
+
+// String cell: one line of at most RFUI_FMT_TEXT_MAX characters, cut on a
+// UTF-8 boundary and marked with "..." (control characters become spaces)
+static i32_t cell_string(obj_p s, c8_t* buf) {
+    const u8_t* src = (const u8_t*)AS_C8(s);
+    i64_t len = s->len;
+    while (len > 0 && src[len - 1] == 0) len--;
+    i32_t n = 0;
+    i32_t chars = 0;
+    i64_t i = 0;
+    for (; i < len && n < RFUI_FMT_CELL_MAX - 8; i++) {
+        u8_t c = src[i];
+        if ((c & 0xC0) != 0x80 && chars++ == RFUI_FMT_TEXT_MAX) break;
+        buf[n++] = c < 32 || c == 127 ? ' ' : (c8_t)c;
+    }
+    if (i == len) return n;
+
+    // Drop a sequence split by the byte limit
+    if ((src[i] & 0xC0) == 0x80) {
+        while (n > 0 && ((u8_t)buf[n - 1] & 0xC0) == 0x80) n--;
+        if (n > 0) n--;
+    }
+    memcpy(buf + n, "...", 3);
+    return n + 3;
+}
+
+static inline i32_t cell_list(obj_p col, i64_t r, c8_t* buf, u8_t* dim) {
+    obj_p item = AS_LIST(col)[r];
+    if (item && item->type == TYPE_C8) return cell_string(item, buf);
+    *dim = 1;
+    if (!item) return put_null(buf);
+    return cell_tagged(item->type, item->len, B8_TRUE, buf);
+}
+
+static i32_t cell_any(obj_p col, i64_t r, const rfui_fmt_t* fmt, c8_t* buf, u8_t* dim) {
+    switch (col->type) {
+        case TYPE_I64:       return cell_i64(col, r, fmt, buf, dim);
+        case TYPE_I32:       return cell_i32(col, r, fmt, buf, dim);
+        case TYPE_I16:       return rfui_fmt_i64(AS_I16(col)[r], fmt, buf);
+        case TYPE_F64:       return cell_f64(col, r, fmt, buf, dim);
+        case TYPE_SYMBOL:    return cell_symbol(col, r, buf, dim);
+        case TYPE_U8:        return rfui_fmt_i64(AS_U8(col)[r], NULL, buf);
+        case TYPE_C8:        return cell_c8(col, r, buf);
+        case TYPE_DATE:      return cell_date(col, r, buf, dim);
+        case TYPE_TIME:      return cell_time(col, r, buf, dim);
+        case TYPE_TIMESTAMP: return cell_timestamp(col, r, buf, dim);
+        case TYPE_GUID:      return rfui_fmt_guid(AS_GUID(col)[r], buf);
+        case TYPE_LIST:      return cell_list(col, r, buf, dim);
+        case TYPE_B8:
+            if (AS_B8(col)[r]) {
+                memcpy(buf, "true", 4);
+                return 4;
+            }
+            memcpy(buf, "false", 5);
+            return 5;
+        default:
+            *dim = 1;
+            return cell_tagged(col->type, 0, B8_FALSE, buf);
+    }
+}
+
+i32_t rfui_fmt_cell(obj_p col, i64_t row, const rfui_fmt_t* fmt, c8_t* buf, i64_t buf_sz, b8_t* dim) {
+    *dim = B8_FALSE;
+    if (buf_sz <= 0) return 0;
+    if (!col || row < 0 || row >= col->len) {
+        i32_t n = buf_sz > 1 ? 1 : 0;
+        memcpy(buf, "?", (size_t)n);
+        buf[n] = '\0';
+        return n;
+    }
+
+    c8_t tmp[RFUI_FMT_CELL_MAX];
+    c8_t* out = buf_sz >= RFUI_FMT_CELL_MAX ? buf : tmp;
+    u8_t dm = 0;
+    i32_t n = cell_any(col, row, fmt, out, &dm);
+    if (n > buf_sz - 1) n = (i32_t)(buf_sz - 1);
+    if (out != buf) memcpy(buf, out, (size_t)n);
+    buf[n] = '\0';
+    *dim = dm ? B8_TRUE : B8_FALSE;
+    return n;
+}
+
+// ============================================================================
+// Batches
+// ============================================================================
+
+static b8_t reserve(rfui_fmt_buf_t* out) {
+    if (out->len + RFUI_FMT_CELL_MAX <= out->cap) return B8_TRUE;
+    i64_t cap = out->cap ? out->cap * 2 : 16384;
+    while (cap < out->len + RFUI_FMT_CELL_MAX) cap *= 2;
+    c8_t* text = (c8_t*)realloc(out->text, (size_t)cap);
+    if (!text) return B8_FALSE;
+    out->text = text;
+    out->cap = cap;
+    return B8_TRUE;
+}
+
+// One loop per type; CELL writes row r into p and may set dm
+#define EACH_ROW(CELL)                                                      \
+    for (i64_t i = 0; i < n; i++) {                                         \
+        i64_t r = from + i;                                                 \
+        if (rows && r < rows_n) r = rows[r];                                \
+        if (!reserve(out)) return B8_FALSE;                                 \
+        c8_t* p = out->text + out->len;                                     \
+        u8_t dm = 0;                                                        \
+        offsets[i] = (u32_t)out->len;                                       \
+        out->len += (r >= 0 && r < col->len) ? (CELL) : (p[0] = '?', 1);    \
+        dim[i] = dm;                                                        \
+    }
+
+b8_t rfui_fmt_column(obj_p col, const u32_t* rows, i64_t rows_n, i64_t from, i64_t n,
+                     const rfui_fmt_t* fmt, rfui_fmt_buf_t* out, u32_t* offsets, u8_t* dim) {
+    if (!col) {
+        for (i64_t i = 0; i < n; i++) {
+            if (!reserve(out)) return B8_FALSE;
+            offsets[i] = (u32_t)out->len;
+            out->text[out->len++] = '?';
+            dim[i] = 0;
+        }
+        return B8_TRUE;
+    }
+
+    switch (col->type) {
+        case TYPE_I64:       EACH_ROW(cell_i64(col, r, fmt, p, &dm)); break;
+        case TYPE_I32:       EACH_ROW(cell_i32(col, r, fmt, p, &dm)); break;
+        case TYPE_F64:       EACH_ROW(cell_f64(col, r, fmt, p, &dm)); break;
+        case TYPE_SYMBOL:    EACH_ROW(cell_symbol(col, r, p, &dm)); break;
+        case TYPE_DATE:      EACH_ROW(cell_date(col, r, p, &dm)); break;
+        case TYPE_TIME:      EACH_ROW(cell_time(col, r, p, &dm)); break;
+        case TYPE_TIMESTAMP: EACH_ROW(cell_timestamp(col, r, p, &dm)); break;
+        default:             EACH_ROW(cell_any(col, r, fmt, p, &dm)); break;
+    }
+    return B8_TRUE;
+}
+
+b8_t rfui_fmt_buf_append(rfui_fmt_buf_t* out, const c8_t* text, i64_t n) {
+    if (out->len + n > out->cap) {
+        i64_t cap = out->cap ? out->cap * 2 : 16384;
+        while (cap < out->len + n) cap *= 2;
+        c8_t* grown = (c8_t*)realloc(out->text, (size_t)cap);
+        if (!grown) return B8_FALSE;
+        out->text = grown;
+        out->cap = cap;
+    }
+    memcpy(out->text + out->len, text, (size_t)n);
+    out->len += n;
+    return B8_TRUE;
+}
+
+nil_t rfui_fmt_buf_free(rfui_fmt_buf_t* out) {
+    free(out->text);
+    out->text = NULL;
+    out->len = 0;
+    out->cap = 0;
+}
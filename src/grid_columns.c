@@ -0,0 +1,111 @@
+// src/grid_columns.c
+// Grid column side table for horizontal virtualization
+#include <stdlib.h>
+#include "../include/rfui/grid_columns.h"
+
+float rfui_grid_column_width(i8_t type) {
+    switch (type) {
+        case TYPE_B8:
+            return 50.0f;
+        case TYPE_I16:
+        case TYPE_I32:
+            return 80.0f;
+        case TYPE_I64:
+        case TYPE_TIMESTAMP:
+            return 120.0f;
+        case TYPE_DATE:
+            return 90.0f;
+        case TYPE_SYMBOL:
+        case TYPE_C8:
+            return 120.0f;
+        case TYPE_GUID:
+            return 280.0f;
+        case TYPE_LIST:
+            return 160.0f;  // Strings and sparklines
+        case TYPE_F64:
+        case TYPE_TIME:
+        default:
+            return 100.0f;
+    }
+}
+
+nil_t rfui_grid_columns_update(rfui_grid_columns_t* c, obj_p vals, i64_t version, float pad,
+                               const u8_t* hidden, i64_t hidden_gen) {
+    i64_t ncols = vals->len;
+    if (c->widths && c->version == version && c->ncols == ncols && c->pad == pad &&
+        c->hidden_gen == hidden_gen) {
+        return;
+    }
+
+    if (!c->widths || c->ncols != ncols) {
+        float* widths = (float*)realloc(c->widths, sizeof(float) * (ncols > 0 ? ncols : 1));
+        if (widths) c->widths = widths;
+        float* x = (float*)realloc(c->x, sizeof(float) * (ncols + 1));
+        if (x) c->x = x;
+        i64_t* vis = (i64_t*)realloc(c->vis, sizeof(i64_t) * (ncols > 0 ? ncols : 1));
+        if (vis) c->vis = vis;
+        if (!widths || !x || !vis) {
+            rfui_grid_columns_free(c);
+            return;
+        }
+    }
+
+    float offset = 0.0f;
+    i64_t nvis = 0;
+    for (i64_t i = 0; i < ncols; i++) {
+        obj_p col = AS_LIST(vals)[i];
+        c->widths[i] = rfui_grid_column_width(col ? col->type : TYPE_LIST);
+        c->x[i] = offset;
+        if (!hidden || !hidden[i]) {
+            offset += c->widths[i] + pad;
+            c->vis[nvis++] = i;
+        }
+    }
+    c->x[ncols] = offset;
+    c->nvis = nvis;
+    c->ncols = ncols;
+    c->version = version;
+    c->pad = pad;
+    c->hidden_gen = hidden_gen;
+}
+
+// Last visible column whose left edge is at or before x (position in vis)
+static i64_t vis_at(const rfui_grid_columns_t* c, float x) {
+    i64_t lo = 0, hi = c->nvis;
+    while (hi - lo > 1) {
+        i64_t mid = (lo + hi) / 2;
+        if (c->x[c->vis[mid]] <= x) lo = mid;
+        else hi = mid;
+    }
+    return lo;
+}
+
+i64_t rfui_grid_columns_window(const rfui_grid_columns_t* c, float scroll_x, i64_t* idx) {
+    if (!c->widths || c->nvis == 0) return 0;
+
+    i64_t n = c->nvis < RFUI_GRID_COLUMN_WINDOW ? c->nvis : RFUI_GRID_COLUMN_WINDOW;
+    i64_t first = vis_at(c, scroll_x);
+    if (first > c->nvis - n) first = c->nvis - n;
+    for (i64_t i = 0; i < n; i++) idx[i] = c->vis[first + i];
+    return n;
+}
+
+i64_t rfui_grid_columns_at(const rfui_grid_columns_t* c, float x) {
+    if (!c->widths || c->nvis == 0 || x < 0.0f || x >= c->x[c->ncols]) return -1;
+    return c->vis[vis_at(c, x)];
+}
+
+nil_t rfui_grid_columns_free(rfui_grid_columns_t* c) {
+    free(c->widths);
+    free(c->x);
+    free(c->vis);
+    c->widths = NULL;
+    c->x = NULL;
+    c->vis = NULL;
+    c->ncols = 0;
+    c->nvis = 0;
+}
+
+i64_t rfui_grid_columns_bytes(const rfui_grid_columns_t* c) {
+    return c->widths ? c->ncols * (i64_t)(sizeof(float) * 2 + sizeof(i64_t)) + (i64_t)sizeof(float) : 0;
+}
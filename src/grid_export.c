@@ -0,0 +1,374 @@
+// src/grid_export.c
+// Grid export to CSV / TSV / clipboard (worker pool)
+//
+// Each chunk maps its display rows to data rows (dropping unselected ones),
+// formats every exported column into one column-major batch, then
+// interleaves the cells into lines. Symbols and strings bypass the
+// formatter, which cuts them to fit a cell.
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include "../include/rfui/grid_export.h"
+#include "../include/rfui/format.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/symbols.h"
+
+#define CHUNK_ROWS 4096
+#define CHUNK_CELLS (1 << 18)     // Rows per chunk shrink for wide tables
+
+typedef struct rfui_export_job_t {
+    // Inputs: data is kept alive by the grid until the job is adopted
+    obj_p data;
+    u32_t* rows;
+    i64_t rows_n;
+    i64_t display_rows;
+    i32_t* cols;
+    i32_t ncols;
+    u64_t* only;
+    i64_t only_n;
+    rfui_export_kind_t kind;
+    char path[256];
+
+    // Outputs
+    rfui_fmt_buf_t out;            // Pending text (whole export for the clipboard)
+    i64_t exported;                // Data rows written
+    i32_t err;                     // errno of the failure (0 = ok)
+    b8_t oom;
+    b8_t stopped;                  // Cancelled before the last chunk
+
+    i64_t progress;                // Atomic: display rows processed
+    rfui_task_t task;
+} rfui_export_job_t;
+
+static b8_t out_reserve(rfui_fmt_buf_t* out, i64_t extra) {
+    if (out->len + extra <= out->cap) return B8_TRUE;
+    i64_t cap = out->cap ? out->cap : 65536;
+    while (cap < out->len + extra) cap *= 2;
+    c8_t* text = (c8_t*)realloc(out->text, (size_t)cap);
+    if (!text) return B8_FALSE;
+    out->text = text;
+    out->cap = cap;
+    return B8_TRUE;
+}
+
+// Append one field: CSV quotes fields holding a delimiter, quote or line
+// break (doubling quotes); TSV turns tabs and line breaks into spaces
+static b8_t put_field(rfui_fmt_buf_t* out, rfui_export_kind_t kind, const c8_t* s, i64_t n) {
+    if (!out_reserve(out, 2 * n + 2)) return B8_FALSE;
+    c8_t* p = out->text + out->len;
+
+    if (kind == RFUI_EXPORT_CSV) {
+        b8_t quote = B8_FALSE;
+        for (i64_t i = 0; i < n && !quote; i++) {
+            c8_t c = s[i];
+            quote = c == ',' || c == '"' || c == '\n' || c == '\r';
+        }
+        if (!quote) {
+            memcpy(p, s, (size_t)n);
+            out->len += n;
+            return B8_TRUE;
+        }
+        i64_t k = 0;
+        p[k++] = '"';
+        for (i64_t i = 0; i < n; i++) {
+            if (s[i] == '"') p[k++] = '"';
+            p[k++] = s[i];
+        }
+        p[k++] = '"';
+        out->len += k;
+        return B8_TRUE;
+    }
+
+    for (i64_t i = 0; i < n; i++) {
+        c8_t c = s[i];
+        p[i] = (c == '\t' || c == '\n' || c == '\r') ? ' ' : c;
+    }
+    out->len += n;
+    return B8_TRUE;
+}
+
+static b8_t put_char(rfui_fmt_buf_t* out, c8_t c) {
+    if (!out_reserve(out, 1)) return B8_FALSE;
+    out->text[out->len++] = c;
+    return B8_TRUE;
+}
+
+// Symbol and string columns (a string cell is a char vector in a list)
+static b8_t direct(obj_p col) {
+    return col && (col->type == TYPE_SYMBOL || col->type == TYPE_LIST);
+}
+
+// Cell of a direct column: symbols and strings whole, other list items as the
+// formatter shows them, nulls empty
+static b8_t put_text(rfui_fmt_buf_t* out, rfui_export_kind_t kind, obj_p col, i64_t r) {
+    if (col->type == TYPE_SYMBOL) {
+        const char* s = rfui_symbols_get(AS_SYMBOL(col)[r]);
+        return s ? put_field(out, kind, s, (i64_t)strlen(s)) : B8_TRUE;
+    }
+    obj_p item = AS_LIST(col)[r];
+    if (!item) return B8_TRUE;
+    if (item->type == TYPE_C8) {
+        i64_t n = item->len;
+        while (n > 0 && AS_C8(item)[n - 1] == 0) n--;
+        return put_field(out, kind, AS_C8(item), n);
+    }
+    c8_t buf[RFUI_FMT_CELL_MAX];
+    b8_t dim;
+    i32_t n = rfui_fmt_cell(col, r, &rfui_fmt_default, buf, sizeof(buf), &dim);
+    return put_field(out, kind, buf, n);
+}
+
+static b8_t put_header(rfui_export_job_t* job, c8_t sep) {
+    obj_p keys = AS_LIST(job->data)[0];
+    for (i32_t c = 0; c < job->ncols; c++) {
+        const char* name = job->cols[c] < keys->len ? rfui_symbols_get(AS_SYMBOL(keys)[job->cols[c]]) : NULL;
+        if (!name) name = "";
+        if (c > 0 && !put_char(&job->out, sep)) return B8_FALSE;
+        if (!put_field(&job->out, job->kind, name, (i64_t)strlen(name))) return B8_FALSE;
+    }
+    return put_char(&job->out, '\n');
+}
+
+// Hand the pending text to the file (the clipboard keeps accumulating)
+static b8_t flush(rfui_export_job_t* job, FILE* f) {
+    if (!f || job->out.len == 0) return B8_TRUE;
+    if (fwrite(job->out.text, 1, (size_t)job->out.len, f) != (size_t)job->out.len) {
+        job->err = errno ? errno : EIO;
+        return B8_FALSE;
+    }
+    job->out.len = 0;
+    return B8_TRUE;
+}
+
+static void run_export(rfui_export_job_t* job) {
+    obj_p vals = AS_LIST(job->data)[1];
+    c8_t sep = job->kind == RFUI_EXPORT_CSV ? ',' : '\t';
+    i32_t ncols = job->ncols;
+    i64_t chunk = ncols > 0 ? CHUNK_CELLS / ncols : CHUNK_ROWS;
+    if (chunk > CHUNK_ROWS) chunk = CHUNK_ROWS;
+    if (chunk < 16) chunk = 16;
+
+    FILE* f = NULL;
+    if (job->kind != RFUI_EXPORT_CLIPBOARD) {
+        f = fopen(job->path, "wb");
+        if (!f) {
+            job->err = errno ? errno : EIO;
+            return;
+        }
+    }
+
+    u32_t* data_rows = (u32_t*)malloc(sizeof(u32_t) * (size_t)chunk);
+    u32_t* offsets = (u32_t*)malloc(sizeof(u32_t) * (size_t)(chunk * ncols + 1));
+    u8_t* dim = (u8_t*)malloc((size_t)(chunk * ncols + 1));
+    rfui_fmt_buf_t cells = {0};
+    b8_t ok = data_rows && offsets && dim && put_header(job, sep);
+    if (!data_rows || !offsets || !dim) job->oom = B8_TRUE;
+
+    for (i64_t from = 0; ok && from < job->display_rows; from += chunk) {
+        if (rfui_task_cancelled(&job->task)) {
+            job->stopped = B8_TRUE;
+            ok = B8_FALSE;
+            break;
+        }
+
+        // Display rows -> data rows, keeping only selected ones
+        i64_t end = from + chunk < job->display_rows ? from + chunk : job->display_rows;
+        i64_t m = 0;
+        for (i64_t d = from; d < end; d++) {
+            i64_t r = (job->rows && d < job->rows_n) ? job->rows[d] : d;
+            if (job->only && (r >= job->only_n || !((job->only[r >> 6] >> (r & 63)) & 1))) continue;
+            data_rows[m++] = (u32_t)r;
+        }
+
+        cells.len = 0;
+        for (i32_t c = 0; ok && c < ncols; c++) {
+            obj_p col = job->cols[c] < vals->len ? AS_LIST(vals)[job->cols[c]] : NULL;
+            if (direct(col)) continue;   // Written directly below
+            ok = rfui_fmt_column(col, data_rows, m, 0, m, &rfui_fmt_default, &cells,
+                                 offsets + c * m, dim + c * m);
+            if (!ok) job->oom = B8_TRUE;
+        }
+        if (!ok) break;
+
+        for (i64_t i = 0; ok && i < m; i++) {
+            for (i32_t c = 0; ok && c < ncols; c++) {
+                if (c > 0) ok = put_char(&job->out, sep);
+                obj_p col = job->cols[c] < vals->len ? AS_LIST(vals)[job->cols[c]] : NULL;
+                if (direct(col)) {
+                    if (ok && data_rows[i] < col->len) ok = put_text(&job->out, job->kind, col, data_rows[i]);
+                    continue;
+                }
+                // Cell end: next cell of this column, else the next formatted
+                // column's first cell, else the end of the batch
+                i64_t cell = c * m + i;
+                u32_t begin = offsets[cell];
+                u32_t stop = (u32_t)cells.len;
+                if (i + 1 < m) {
+                    stop = offsets[cell + 1];
+                } else {
+                    for (i32_t k = c + 1; k < ncols; k++) {
+                        obj_p next = job->cols[k] < vals->len ? AS_LIST(vals)[job->cols[k]] : NULL;
+                        if (direct(next)) continue;
+                        stop = offsets[k * m];
+                        break;
+                    }
+                }
+                const c8_t* text = cells.text + begin;
+                i64_t n = stop - begin;
+                if (dim[cell] && n == 4 && memcmp(text, "null", 4) == 0) continue;   // Nulls export empty
+                if (ok) ok = put_field(&job->out, job->kind, text, n);
+            }
+            if (ok) ok = put_char(&job->out, '\n');
+        }
+        if (!ok) {
+            job->oom = B8_TRUE;
+            break;
+        }
+
+        job->exported += m;
+        ok = flush(job, f);
+        __atomic_store_n(&job->progress, end, __ATOMIC_RELAXED);
+    }
+
+    if (ok && job->kind == RFUI_EXPORT_CLIPBOARD) {
+        ok = put_char(&job->out, '\0');
+        if (!ok) job->oom = B8_TRUE;
+    }
+
+    free(data_rows);
+    free(offsets);
+    free(dim);
+    rfui_fmt_buf_free(&cells);
+
+    if (f) {
+        if (fclose(f) != 0 && ok) {
+            job->err = errno ? errno : EIO;
+            ok = B8_FALSE;
+        }
+        // Don't leave a truncated file behind
+        if (!ok) remove(job->path);
+    }
+}
+
+static nil_t export_job(raw_p arg) {
+    rfui_export_job_t* job = (rfui_export_job_t*)arg;
+
+    i64_t trace_span = rfui_trace_begin();
+    job->stopped = B8_FALSE;
+    run_export(job);
+    rfui_trace_end("grid_export", NULL, trace_span);
+}
+
+static void job_free(rfui_export_job_t* job) {
+    free(job->rows);
+    free(job->cols);
+    free(job->only);
+    rfui_fmt_buf_free(&job->out);
+    rfui_task_free(&job->task);
+    free(job);
+}
+
+// ============================================================================
+// Grid side (UI thread)
+// ============================================================================
+
+b8_t rfui_grid_export_start(rfui_grid_export_t* e, const rfui_export_view_t* view,
+                            rfui_export_kind_t kind, const char* path) {
+    if (e->job || view->ncols <= 0) return B8_FALSE;
+
+    rfui_export_job_t* job = (rfui_export_job_t*)calloc(1, sizeof(rfui_export_job_t));
+    if (!job) return B8_FALSE;
+    job->data = view->table;
+    job->display_rows = view->display_rows;
+    job->kind = kind;
+    job->ncols = view->ncols;
+    if (path) snprintf(job->path, sizeof(job->path), "%s", path);
+
+    b8_t ok = B8_TRUE;
+    if (view->rows && view->rows_n > 0) {
+        job->rows_n = view->rows_n;
+        job->rows = (u32_t*)malloc(sizeof(u32_t) * (size_t)view->rows_n);
+        ok = job->rows != NULL;
+        if (ok) memcpy(job->rows, view->rows, sizeof(u32_t) * (size_t)view->rows_n);
+    }
+    job->cols = (i32_t*)malloc(sizeof(i32_t) * (size_t)view->ncols);
+    ok = ok && job->cols;
+    if (ok) memcpy(job->cols, view->cols, sizeof(i32_t) * (size_t)view->ncols);
+    if (ok && view->only) {
+        size_t words = (size_t)((view->only_n + 63) / 64);
+        job->only_n = view->only_n;
+        job->only = (u64_t*)malloc(sizeof(u64_t) * (words ? words : 1));
+        ok = job->only != NULL;
+        if (ok) memcpy(job->only, view->only, sizeof(u64_t) * words);
+    }
+    if (!ok) {
+        free(job->rows);
+        free(job->cols);
+        free(job->only);
+        free(job);
+        return B8_FALSE;
+    }
+
+    e->job = job;
+    e->status[0] = '\0';
+
+    // Stays set if a cancel lands before the job starts (it is then skipped)
+    job->stopped = B8_TRUE;
+    rfui_task_submit(&job->task, export_job, job, 1);
+    return B8_TRUE;
+}
+
+f64_t rfui_grid_export_progress(const rfui_grid_export_t* e) {
+    if (!e->job) return -1.0;
+    if (e->job->display_rows <= 0) return 1.0;
+    return (f64_t)__atomic_load_n(&e->job->progress, __ATOMIC_RELAXED) / (f64_t)e->job->display_rows;
+}
+
+nil_t rfui_grid_export_cancel(rfui_grid_export_t* e) {
+    if (e->job) rfui_task_cancel(&e->job->task);
+}
+
+nil_t rfui_grid_export_update(rfui_grid_export_t* e, f64_t now) {
+    rfui_export_job_t* job = e->job;
+    if (!job || !rfui_task_done(&job->task)) return;
+    e->job = NULL;
+
+    e->failed = B8_TRUE;
+    if (job->err) {
+        snprintf(e->status, sizeof(e->status), "Export failed: %s", strerror(job->err));
+    } else if (job->oom) {
+        snprintf(e->status, sizeof(e->status), "Export failed: out of memory");
+    } else if (job->stopped) {
+        snprintf(e->status, sizeof(e->status), "Export cancelled");
+    } else {
+        e->failed = B8_FALSE;
+        if (job->kind == RFUI_EXPORT_CLIPBOARD) {
+            snprintf(e->status, sizeof(e->status), "Copied %lld rows", (long long)job->exported);
+            free(e->clipboard);
+            e->clipboard = job->out.text;
+            job->out.text = NULL;
+        } else {
+            snprintf(e->status, sizeof(e->status), "Exported %lld rows to %s", (long long)job->exported, job->path);
+        }
+    }
+    e->status_time = now;
+    job_free(job);
+}
+
+b8_t rfui_grid_export_reads(const rfui_grid_export_t* e, obj_p table) {
+    return e->job != NULL && e->job->data == table;
+}
+
+nil_t rfui_grid_export_free(rfui_grid_export_t* e) {
+    rfui_export_job_t* job = e->job;
+    if (job) {
+        rfui_task_wait(&job->task);
+        job_free(job);
+        e->job = NULL;
+    }
+    free(e->clipboard);
+    e->clipboard = NULL;
+    e->status[0] = '\0';
+}
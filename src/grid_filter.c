@@ -0,0 +1,206 @@
+// src/grid_filter.c
+// Grid filter bar: filter text -> grid rule -> column mask -> selection vector
+#include <stdlib.h>
+#include <string.h>
+#include "../include/rfui/grid_filter.h"
+#include "../include/rfui/grid_rules.h"
+
+b8_t rfui_grid_filter_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8: case TYPE_B8: case TYPE_C8:
+        case TYPE_F64: case TYPE_DATE: case TYPE_TIME: case TYPE_TIMESTAMP:
+        case TYPE_SYMBOL: case TYPE_LIST:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+static void copy_value(char* dst, size_t dst_sz, const char* src, size_t len) {
+    if (len >= dst_sz) len = dst_sz - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// Filter text -> rule (see grid_filter.h for the syntax). Returns false if empty.
+static b8_t parse_filter(const char* text, i8_t type, rfui_grid_rule_t* r) {
+    memset(r, 0, sizeof(*r));
+    r->enabled = B8_TRUE;
+
+    while (*text == ' ') text++;
+    size_t len = strlen(text);
+    while (len > 0 && text[len - 1] == ' ') len--;
+    if (len == 0) return B8_FALSE;
+
+    char s[64];
+    copy_value(s, sizeof(s), text, len);
+
+    if (type == TYPE_LIST) {
+        r->op = RFUI_RULE_CONTAINS;
+        copy_value(r->value, sizeof(r->value), s, strlen(s));
+        return B8_TRUE;
+    }
+    if (type == TYPE_SYMBOL) {
+        const char* v = s;
+        if (strchr(s, ',')) {
+            r->op = RFUI_RULE_IN;
+        } else if (s[0] == '=') {
+            r->op = RFUI_RULE_EQ;
+            v = s + 1;
+        } else {
+            r->op = RFUI_RULE_PREFIX;
+        }
+        copy_value(r->value, sizeof(r->value), v, strlen(v));
+        return B8_TRUE;
+    }
+
+    const char* dots = strstr(s, "..");
+    if (dots) {
+        r->op = RFUI_RULE_BETWEEN;
+        copy_value(r->value, sizeof(r->value), s, (size_t)(dots - s));
+        copy_value(r->value2, sizeof(r->value2), dots + 2, strlen(dots + 2));
+    } else if (s[0] == '>' && s[1] == '=') {
+        r->op = RFUI_RULE_BETWEEN;
+        copy_value(r->value, sizeof(r->value), s + 2, strlen(s + 2));
+    } else if (s[0] == '<' && s[1] == '=') {
+        r->op = RFUI_RULE_BETWEEN;
+        copy_value(r->value2, sizeof(r->value2), s + 2, strlen(s + 2));
+    } else if (s[0] == '>' || s[0] == '<' || s[0] == '=') {
+        r->op = s[0] == '>' ? RFUI_RULE_GT : (s[0] == '<' ? RFUI_RULE_LT : RFUI_RULE_EQ);
+        copy_value(r->value, sizeof(r->value), s + 1, strlen(s + 1));
+    } else {
+        r->op = strchr(s, ',') ? RFUI_RULE_IN : RFUI_RULE_EQ;
+        copy_value(r->value, sizeof(r->value), s, strlen(s));
+    }
+    return B8_TRUE;
+}
+
+static void clear_mask(rfui_col_filter_t* cf) {
+    free(cf->mask);
+    cf->mask = NULL;
+}
+
+// Rebuild one column's mask from its text
+static void rescan(rfui_col_filter_t* cf, obj_p col, i64_t nrows) {
+    rfui_grid_rule_t rule;
+    cf->invalid = B8_FALSE;
+
+    if (!col || !rfui_grid_filter_supported(col->type) || !parse_filter(cf->text, col->type, &rule)) {
+        clear_mask(cf);
+        return;
+    }
+
+    uint16_t* mask = (uint16_t*)realloc(cf->mask, sizeof(uint16_t) * (nrows > 0 ? nrows : 1));
+    if (!mask) {
+        clear_mask(cf);
+        return;
+    }
+    cf->mask = mask;
+    memset(mask, 0, sizeof(uint16_t) * nrows);
+
+    if (!rfui_grid_rule_apply(&rule, col, 1, mask)) {
+        cf->invalid = B8_TRUE;
+        clear_mask(cf);
+    }
+}
+
+nil_t rfui_grid_filter_resize(rfui_grid_filter_t* f, i64_t ncols) {
+    if (f->ncols == ncols && f->cols) return;
+
+    rfui_grid_filter_free(f);
+    f->cols = (rfui_col_filter_t*)calloc(ncols > 0 ? ncols : 1, sizeof(rfui_col_filter_t));
+    if (f->cols) f->ncols = ncols;
+}
+
+nil_t rfui_grid_filter_changed(rfui_grid_filter_t* f, i64_t col) {
+    if (col >= 0 && col < f->ncols) f->cols[col].dirty = B8_TRUE;
+}
+
+nil_t rfui_grid_filter_update(rfui_grid_filter_t* f, obj_p table, i64_t version,
+                              const u32_t* perm, i64_t perm_n, i64_t order_gen) {
+    if (!f->cols) return;
+
+    obj_p vals = AS_LIST(table)[1];
+    i64_t ncols = vals->len < f->ncols ? vals->len : f->ncols;
+    i64_t nrows = ncols > 0 ? AS_LIST(vals)[0]->len : 0;
+    b8_t new_data = f->version != version || f->nrows != nrows;
+    b8_t masks_changed = new_data;
+
+    // Only edited columns are rescanned; new data rescans every filter
+    for (i64_t c = 0; c < ncols; c++) {
+        rfui_col_filter_t* cf = &f->cols[c];
+        if (!cf->dirty && !(new_data && cf->text[0])) continue;
+        cf->dirty = B8_FALSE;
+        rescan(cf, AS_LIST(vals)[c], nrows);
+        masks_changed = B8_TRUE;
+    }
+    f->version = version;
+    f->nrows = nrows;
+
+    if (!masks_changed && f->order_gen == order_gen) return;
+    f->order_gen = order_gen;
+
+    b8_t active = B8_FALSE;
+    for (i64_t c = 0; c < ncols && !active; c++) active = f->cols[c].mask != NULL;
+    if (!active) {
+        if (f->active) {
+            f->active = B8_FALSE;
+            f->gen++;
+        }
+        return;
+    }
+
+    if (masks_changed || !f->pass) {
+        u8_t* pass = (u8_t*)realloc(f->pass, nrows > 0 ? nrows : 1);
+        u32_t* sel = (u32_t*)realloc(f->sel, sizeof(u32_t) * (nrows > 0 ? nrows : 1));
+        if (pass) f->pass = pass;
+        if (sel) f->sel = sel;
+        if (!pass || !sel) {
+            f->active = B8_FALSE;
+            f->gen++;
+            return;
+        }
+
+        memset(pass, 1, nrows);
+        for (i64_t c = 0; c < ncols; c++) {
+            const uint16_t* mask = f->cols[c].mask;
+            if (!mask) continue;
+            for (i64_t i = 0; i < nrows; i++) pass[i] &= (u8_t)(mask[i] != 0);
+        }
+    }
+
+    // Gather passing rows in display order (branchless append)
+    const u8_t* pass = f->pass;
+    u32_t* sel = f->sel;
+    i64_t k = 0;
+    i64_t sorted = perm ? perm_n : 0;
+    for (i64_t i = 0; i < sorted; i++) {
+        u32_t r = perm[i];
+        sel[k] = r;
+        k += pass[r];
+    }
+    for (i64_t i = sorted; i < nrows; i++) {
+        sel[k] = (u32_t)i;
+        k += pass[i];
+    }
+    f->nsel = k;
+    f->active = B8_TRUE;
+    f->gen++;
+}
+
+nil_t rfui_grid_filter_free(rfui_grid_filter_t* f) {
+    for (i64_t c = 0; c < f->ncols; c++) clear_mask(&f->cols[c]);
+    free(f->cols);
+    free(f->pass);
+    free(f->sel);
+    memset(f, 0, sizeof(*f));
+}
+
+i64_t rfui_grid_filter_bytes(const rfui_grid_filter_t* f) {
+    i64_t bytes = f->ncols * (i64_t)sizeof(rfui_col_filter_t);
+    for (i64_t c = 0; c < f->ncols; c++) {
+        if (f->cols[c].mask) bytes += f->nrows * (i64_t)sizeof(uint16_t);
+    }
+    if (f->pass) bytes += f->nrows * (i64_t)(1 + sizeof(u32_t));
+    return bytes;
+}
@@ -0,0 +1,447 @@
+// src/grid_find.c
+// Grid find (worker pool)
+//
+// Every pool thread runs the same task: take the next unclaimed chunk, test
+// each searchable column against it 64 rows at a time (one word of row bits
+// per group, ORed across columns), then publish the chunk. Chunk edges fall
+// on word edges, so no two threads write the same word and the UI reads a
+// chunk's words only after its release flag is set.
+#include <stdlib.h>
+#include <string.h>
+#include "../include/rfui/grid_find.h"
+#include "../include/rfui/grid_rules.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/ui.h"
+#include "../include/rfui/symbols.h"
+
+typedef enum match_kind_t {
+    MATCH_NONE = 0,
+    MATCH_INT,         // Integer and temporal columns: equal value
+    MATCH_F64,
+    MATCH_SYM,         // Symbol name contains the text
+    MATCH_STR          // String (list of C8) contains the text
+} match_kind_t;
+
+typedef struct find_col_t {
+    u8_t kind;         // match_kind_t
+    i64_t ival;
+    f64_t fval;
+} find_col_t;
+
+typedef struct rfui_find_job_t {
+    // Inputs: data is kept alive by the grid while tasks run
+    obj_p data;
+    i64_t nrows;
+    i64_t ncols;
+    find_col_t* cols;
+    char needle[64];               // Lowercased text for substring matches
+    i64_t needle_len;
+
+    // Outputs, published per chunk
+    u64_t* bits;                   // Row has a matching cell
+    u8_t* published;               // Per chunk, atomic
+    i64_t nchunks;
+    i64_t next_chunk;              // Atomic: next unclaimed chunk
+    i64_t chunks_done;             // Atomic
+    i64_t cells;                   // Atomic: matching cells in published chunks
+
+    rfui_task_t task;              // One copy per pool thread
+} rfui_find_job_t;
+
+// ============================================================================
+// Matching
+// ============================================================================
+
+static inline char lower(char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch;
+}
+
+// Whether s[0 .. len) contains the lowercased needle, ignoring ASCII case
+static b8_t contains_nocase(const char* s, i64_t len, const char* needle, i64_t n) {
+    for (i64_t i = 0; i + n <= len; i++) {
+        i64_t k = 0;
+        while (k < n && lower(s[i + k]) == needle[k]) k++;
+        if (k == n) return B8_TRUE;
+    }
+    return B8_FALSE;
+}
+
+static b8_t string_matches(const rfui_find_job_t* job, obj_p item) {
+    return item && item->type == TYPE_C8 && contains_nocase(AS_C8(item), item->len, job->needle, job->needle_len);
+}
+
+static b8_t symbol_matches(const rfui_find_job_t* job, i64_t id) {
+    const char* s = rfui_symbols_get(id);
+    return s && contains_nocase(s, (i64_t)strlen(s), job->needle, job->needle_len);
+}
+
+// Compile the text for each column: by value where it parses in the
+// column's domain, by substring on symbols and strings
+static void compile(rfui_find_job_t* job, obj_p vals, const char* text) {
+    i64_t n = 0;
+    for (; text[n] && n < (i64_t)sizeof(job->needle) - 1; n++) job->needle[n] = lower(text[n]);
+    while (n > 0 && job->needle[n - 1] == ' ') n--;
+    job->needle[n] = '\0';
+    job->needle_len = n;
+
+    for (i64_t c = 0; c < job->ncols; c++) {
+        find_col_t* fc = &job->cols[c];
+        obj_p col = AS_LIST(vals)[c];
+        if (!col || col->len != job->nrows || n == 0) continue;
+        f64_t v;
+        switch (col->type) {
+            case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+            case TYPE_I16: case TYPE_U8: case TYPE_B8:
+                if (rfui_grid_rule_parse(col->type, job->needle, &v) && v == (f64_t)(i64_t)v) {
+                    fc->kind = MATCH_INT;
+                    fc->ival = (i64_t)v;
+                }
+                break;
+            case TYPE_F64:
+                if (rfui_grid_rule_parse(col->type, job->needle, &v)) {
+                    fc->kind = MATCH_F64;
+                    fc->fval = v;
+                }
+                break;
+            case TYPE_SYMBOL: fc->kind = MATCH_SYM; break;
+            case TYPE_LIST: fc->kind = MATCH_STR; break;
+            default: break;
+        }
+    }
+}
+
+// ============================================================================
+// Scan (pool threads)
+// ============================================================================
+
+// Symbol id -> matches, decided once per id (per task)
+typedef struct sym_set_t {
+    i64_t* ids;
+    u8_t* state;       // 0 = free slot, 1 = no match, 2 = match
+    i64_t cap;         // Power of two
+    i64_t count;
+} sym_set_t;
+
+static i64_t set_slot(const sym_set_t* m, i64_t id) {
+    u64_t mask = (u64_t)m->cap - 1;
+    u64_t i = ((u64_t)id * 0x9E3779B97F4A7C15ULL >> 17) & mask;
+    while (m->state[i] && m->ids[i] != id) i = (i + 1) & mask;
+    return (i64_t)i;
+}
+
+static b8_t set_grow(sym_set_t* m) {
+    sym_set_t next = {0};
+    next.cap = m->cap ? m->cap * 2 : 256;
+    next.ids = (i64_t*)malloc(sizeof(i64_t) * (size_t)next.cap);
+    next.state = (u8_t*)calloc((size_t)next.cap, 1);
+    if (!next.ids || !next.state) {
+        free(next.ids);
+        free(next.state);
+        return B8_FALSE;
+    }
+    for (i64_t i = 0; i < m->cap; i++) {
+        if (!m->state[i]) continue;
+        i64_t s = set_slot(&next, m->ids[i]);
+        next.ids[s] = m->ids[i];
+        next.state[s] = m->state[i];
+    }
+    next.count = m->count;
+    free(m->ids);
+    free(m->state);
+    *m = next;
+    return B8_TRUE;
+}
+
+static b8_t symbol_hit(const rfui_find_job_t* job, sym_set_t* set, i64_t id) {
+    if ((set->count + 1) * 2 > set->cap && !set_grow(set)) return symbol_matches(job, id);
+    i64_t s = set_slot(set, id);
+    if (!set->state[s]) {
+        set->ids[s] = id;
+        set->state[s] = symbol_matches(job, id) ? 2 : 1;
+        set->count++;
+    }
+    return set->state[s] == 2;
+}
+
+// One word of row bits per 64 rows of [start, end), ORed into bits
+#define SCAN_WORDS(HIT)                                                          \
+    for (i64_t r0 = start; r0 < end; r0 += 64) {                                 \
+        i64_t m = end - r0 < 64 ? end - r0 : 64;                                 \
+        u64_t w = 0;                                                             \
+        for (i64_t j = 0; j < m; j++) {                                          \
+            i64_t r = r0 + j;                                                    \
+            w |= (u64_t)(HIT) << j;                                              \
+        }                                                                        \
+        bits[r0 >> 6] |= w;                                                      \
+        cells += __builtin_popcountll(w);                                        \
+    }
+
+static i64_t scan_column(const rfui_find_job_t* job, const find_col_t* fc, obj_p col, sym_set_t* set,
+                         i64_t start, i64_t end) {
+    u64_t* bits = job->bits;
+    i64_t cells = 0;
+    i64_t iv = fc->ival;
+    switch (fc->kind) {
+        case MATCH_INT:
+            switch (col->type) {
+                case TYPE_I64: case TYPE_TIMESTAMP: {
+                    const i64_t* a = AS_I64(col);
+                    SCAN_WORDS(a[r] == iv);
+                    break;
+                }
+                case TYPE_I32: case TYPE_DATE: case TYPE_TIME: {
+                    const i32_t* a = AS_I32(col);
+                    SCAN_WORDS((i64_t)a[r] == iv);
+                    break;
+                }
+                case TYPE_I16: {
+                    const i16_t* a = AS_I16(col);
+                    SCAN_WORDS((i64_t)a[r] == iv);
+                    break;
+                }
+                default: {
+                    const u8_t* a = AS_U8(col);
+                    SCAN_WORDS((i64_t)a[r] == iv);
+                    break;
+                }
+            }
+            break;
+        case MATCH_F64: {
+            const f64_t* a = AS_F64(col);
+            f64_t fv = fc->fval;
+            SCAN_WORDS(a[r] == fv);
+            break;
+        }
+        case MATCH_SYM: {
+            // Runs of one id (sorted or keyed data) skip the set lookup
+            const i64_t* a = AS_SYMBOL(col);
+            i64_t last_id = 0;
+            b8_t last = B8_FALSE, have = B8_FALSE;
+            for (i64_t r0 = start; r0 < end; r0 += 64) {
+                i64_t m = end - r0 < 64 ? end - r0 : 64;
+                u64_t w = 0;
+                for (i64_t j = 0; j < m; j++) {
+                    i64_t id = a[r0 + j];
+                    if (!have || id != last_id) {
+                        last = symbol_hit(job, set, id);
+                        last_id = id;
+                        have = B8_TRUE;
+                    }
+                    w |= (u64_t)last << j;
+                }
+                bits[r0 >> 6] |= w;
+                cells += __builtin_popcountll(w);
+            }
+            break;
+        }
+        case MATCH_STR: {
+            obj_p* items = AS_LIST(col);
+            SCAN_WORDS(string_matches(job, items[r]));
+            break;
+        }
+        default:
+            break;
+    }
+    return cells;
+}
+
+static nil_t find_task(raw_p arg) {
+    rfui_find_job_t* job = (rfui_find_job_t*)arg;
+    obj_p* cols = AS_LIST(AS_LIST(job->data)[1]);
+    sym_set_t set = {0};
+
+    i64_t trace_span = rfui_trace_begin();
+    while (!rfui_task_cancelled(&job->task)) {
+        i64_t c = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED);
+        if (c >= job->nchunks) break;
+        i64_t start = c * RFUI_FIND_CHUNK;
+        i64_t end = job->nrows - start < RFUI_FIND_CHUNK ? job->nrows : start + RFUI_FIND_CHUNK;
+        i64_t cells = 0;
+        for (i64_t k = 0; k < job->ncols && !rfui_task_cancelled(&job->task); k++) {
+            if (job->cols[k].kind != MATCH_NONE) cells += scan_column(job, &job->cols[k], cols[k], &set, start, end);
+        }
+        if (rfui_task_cancelled(&job->task)) break;
+        __atomic_fetch_add(&job->cells, cells, __ATOMIC_RELAXED);
+        __atomic_store_n(&job->published[c], 1, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&job->chunks_done, 1, __ATOMIC_RELAXED);
+        rfui_ui_wake();
+    }
+    rfui_trace_end("grid_find", NULL, trace_span);
+    free(set.ids);
+    free(set.state);
+}
+
+static void job_free(rfui_find_job_t* job) {
+    free(job->cols);
+    free(job->bits);
+    free(job->published);
+    rfui_task_free(&job->task);
+    free(job);
+}
+
+// ============================================================================
+// Grid side (UI thread)
+// ============================================================================
+
+static void start_job(rfui_grid_find_t* f, obj_p table) {
+    obj_p vals = AS_LIST(table)[1];
+    const char* text = f->text;
+    while (*text == ' ') text++;
+    if (!*text || vals->len == 0 || !AS_LIST(vals)[0]) return;
+
+    rfui_find_job_t* job = (rfui_find_job_t*)calloc(1, sizeof(rfui_find_job_t));
+    if (!job) return;
+    job->data = table;
+    job->ncols = vals->len;
+    job->nrows = AS_LIST(vals)[0]->len;
+    job->nchunks = (job->nrows + RFUI_FIND_CHUNK - 1) / RFUI_FIND_CHUNK;
+    job->cols = (find_col_t*)calloc((size_t)job->ncols, sizeof(find_col_t));
+    job->bits = (u64_t*)calloc((size_t)((job->nrows + 63) / 64 + 1), sizeof(u64_t));
+    job->published = (u8_t*)calloc((size_t)(job->nchunks + 1), 1);
+    if (!job->cols || !job->bits || !job->published) {
+        free(job->cols);
+        free(job->bits);
+        free(job->published);
+        free(job);
+        return;
+    }
+    compile(job, vals, text);
+    f->job = job;
+
+    // Copies claim chunks from a shared counter; without a pool the first
+    // inline copy takes every chunk left
+    rfui_task_submit(&job->task, find_task, job, rfui_worker_count());
+}
+
+nil_t rfui_grid_find_update(rfui_grid_find_t* f, obj_p table, i64_t version) {
+    if (!f->dirty && f->version == version) return;
+    rfui_find_job_t* job = f->job;
+    if (job) {
+        // Results of the old scan are dropped; wait for its tasks to leave
+        rfui_task_cancel(&job->task);
+        if (!rfui_task_done(&job->task)) return;
+        job_free(job);
+        f->job = NULL;
+    }
+    // A new query starts from the top; new data keeps the current match
+    if (f->dirty) f->cur_row = -1;
+    f->dirty = B8_FALSE;
+    f->version = version;
+    start_job(f, table);
+}
+
+f64_t rfui_grid_find_progress(const rfui_grid_find_t* f, i64_t* cells) {
+    const rfui_find_job_t* job = f->job;
+    *cells = 0;
+    if (!job) return -1.0;
+    *cells = __atomic_load_n(&job->cells, __ATOMIC_RELAXED);
+    if (job->nchunks == 0) return 1.0;
+    return (f64_t)__atomic_load_n(&job->chunks_done, __ATOMIC_RELAXED) / (f64_t)job->nchunks;
+}
+
+static b8_t row_hit(const rfui_find_job_t* job, i64_t r) {
+    if (r < 0 || r >= job->nrows) return B8_FALSE;
+    if (!__atomic_load_n(&job->published[r / RFUI_FIND_CHUNK], __ATOMIC_ACQUIRE)) return B8_FALSE;
+    return (job->bits[r >> 6] >> (r & 63)) & 1;
+}
+
+static b8_t cell_hit(const rfui_find_job_t* job, obj_p col, i64_t c, i64_t r) {
+    const find_col_t* fc = &job->cols[c];
+    switch (fc->kind) {
+        case MATCH_INT:
+            switch (col->type) {
+                case TYPE_I64: case TYPE_TIMESTAMP: return AS_I64(col)[r] == fc->ival;
+                case TYPE_I32: case TYPE_DATE: case TYPE_TIME: return (i64_t)AS_I32(col)[r] == fc->ival;
+                case TYPE_I16: return (i64_t)AS_I16(col)[r] == fc->ival;
+                default: return (i64_t)AS_U8(col)[r] == fc->ival;
+            }
+        case MATCH_F64: return AS_F64(col)[r] == fc->fval;
+        case MATCH_SYM: return symbol_matches(job, AS_SYMBOL(col)[r]);
+        case MATCH_STR: return string_matches(job, AS_LIST(col)[r]);
+        default: return B8_FALSE;
+    }
+}
+
+b8_t rfui_grid_find_cell(const rfui_grid_find_t* f, obj_p table, i64_t col, i64_t data_row) {
+    const rfui_find_job_t* job = f->job;
+    if (!job || job->data != table || col < 0 || col >= job->ncols || !row_hit(job, data_row)) return B8_FALSE;
+    return cell_hit(job, AS_LIST(AS_LIST(table)[1])[col], col, data_row);
+}
+
+// First matching column of a row hit after (dir > 0) or before from
+static i64_t row_column(const rfui_grid_find_t* f, obj_p table, i64_t r, i64_t from, i32_t dir) {
+    i64_t ncols = f->job->ncols;
+    for (i64_t c = from + dir; c >= 0 && c < ncols; c += dir) {
+        if (rfui_grid_find_cell(f, table, c, r)) return c;
+    }
+    return -1;
+}
+
+b8_t rfui_grid_find_next(rfui_grid_find_t* f, obj_p table, const u32_t* rows, i64_t rows_n,
+                         i64_t display_rows, i32_t dir) {
+    const rfui_find_job_t* job = f->job;
+    if (!job || job->data != table || display_rows <= 0) return B8_FALSE;
+    if (__atomic_load_n(&job->cells, __ATOMIC_RELAXED) == 0) return B8_FALSE;
+    dir = dir < 0 ? -1 : 1;
+
+    // Another match in the current row
+    i64_t d = f->cur_row;
+    if (d >= 0 && d < display_rows) {
+        i64_t r = rows && d < rows_n ? (i64_t)rows[d] : d;
+        i64_t c = row_column(f, table, r, f->cur_col, dir);
+        if (c >= 0) {
+            f->cur_col = c;
+            f->jump = B8_TRUE;
+            return B8_TRUE;
+        }
+    } else {
+        d = dir > 0 ? -1 : display_rows;
+    }
+
+    // Then the following rows, wrapping once around
+    for (i64_t step = 1; step <= display_rows; step++) {
+        i64_t at = ((d + dir * step) % display_rows + display_rows) % display_rows;
+        i64_t r = rows && at < rows_n ? (i64_t)rows[at] : at;
+        // Published first: the word is only read once its chunk is complete
+        if (!rows && r < job->nrows &&
+            (!__atomic_load_n(&job->published[r / RFUI_FIND_CHUNK], __ATOMIC_ACQUIRE) || !job->bits[r >> 6])) {
+            // Natural order: skip the rest of an empty or unscanned word, but
+            // not past the end (or start) of the rows, where the search wraps
+            i64_t skip = dir > 0 ? 63 - (r & 63) : (r & 63);
+            i64_t edge = dir > 0 ? display_rows - 1 - at : at;
+            if (skip > edge) skip = edge;
+            step += skip < display_rows - step ? skip : display_rows - step;
+            continue;
+        }
+        if (!row_hit(job, r)) continue;
+        i64_t c = row_column(f, table, r, dir > 0 ? -1 : job->ncols, dir);
+        if (c < 0) continue;
+        f->cur_row = at;
+        f->cur_col = c;
+        f->jump = B8_TRUE;
+        return B8_TRUE;
+    }
+    return B8_FALSE;
+}
+
+b8_t rfui_grid_find_reads(const rfui_grid_find_t* f, obj_p table) {
+    return f->job != NULL && f->job->data == table && !rfui_task_done(&f->job->task);
+}
+
+nil_t rfui_grid_find_free(rfui_grid_find_t* f) {
+    if (f->job) {
+        rfui_task_wait(&f->job->task);
+        job_free(f->job);
+        f->job = NULL;
+    }
+    f->cur_row = -1;
+    f->version = -1;
+}
+
+i64_t rfui_grid_find_bytes(const rfui_grid_find_t* f) {
+    const rfui_find_job_t* job = f->job;
+    if (!job) return 0;
+    return (i64_t)sizeof(*job) + job->ncols * (i64_t)sizeof(find_col_t) +
+           ((job->nrows + 63) / 64 + 1) * (i64_t)sizeof(u64_t) + job->nchunks + 1;
+}
@@ -0,0 +1,315 @@
+// src/grid_flash.c
+// Grid changed-cell flash: per-column diff into up/down bitmaps
+#include <stdlib.h>
+#include <string.h>
+#include "../include/rfui/grid_flash.h"
+
+#define WORDS(n) (((n) + 63) >> 6)
+
+// ============================================================================
+// Generations
+// ============================================================================
+
+static void gen_clear(rfui_flash_gen_t* g) {
+    for (i64_t c = 0; c < g->ncols; c++) free(g->bits[c]);
+    free(g->bits);
+    memset(g, 0, sizeof(*g));
+}
+
+static b8_t gen_live(const rfui_flash_gen_t* g, f64_t now) {
+    return g->time > 0 && now - g->time < RFUI_FLASH_SECONDS;
+}
+
+// Move a generation's bits to the new row order (key alignment)
+static void gen_remap(rfui_flash_gen_t* g, const i64_t* align, i64_t nrows) {
+    i64_t words = WORDS(nrows);
+    i64_t old_words = WORDS(g->nrows);
+    for (i64_t c = 0; c < g->ncols; c++) {
+        u64_t* src = g->bits[c];
+        if (!src) continue;
+
+        u64_t* dst = (u64_t*)calloc(words * 2 > 0 ? words * 2 : 1, sizeof(u64_t));
+        if (dst) {
+            for (i64_t r = 0; r < nrows; r++) {
+                i64_t o = align[r];
+                if (o < 0 || o >= g->nrows) continue;
+                u64_t bit = (u64_t)1 << (r & 63);
+                if ((src[o >> 6] >> (o & 63)) & 1) dst[r >> 6] |= bit;
+                if ((src[old_words + (o >> 6)] >> (o & 63)) & 1) dst[words + (r >> 6)] |= bit;
+            }
+        }
+        free(src);
+        g->bits[c] = dst;
+    }
+    g->nrows = nrows;
+}
+
+// ============================================================================
+// Key alignment
+// ============================================================================
+
+b8_t rfui_grid_flash_key_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+        case TYPE_I16: case TYPE_SYMBOL:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+static inline u64_t key_at(obj_p col, i64_t row) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: return (u64_t)AS_I64(col)[row];
+        case TYPE_SYMBOL: return (u64_t)AS_SYMBOL(col)[row];
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: return (u64_t)(i64_t)AS_I32(col)[row];
+        case TYPE_I16: return (u64_t)(i64_t)AS_I16(col)[row];
+        default: return 0;
+    }
+}
+
+static inline u64_t key_hash(u64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    return k;
+}
+
+// Fill f->align[0..new_n) with each new row's old row by key
+static b8_t align_by_key(rfui_grid_flash_t* f, obj_p old_key, obj_p new_key) {
+    i64_t old_n = old_key->len, new_n = new_key->len;
+
+    i64_t cap = 16;
+    while (cap < old_n * 2) cap <<= 1;
+    if (cap > f->map_cap) {
+        u64_t* keys = (u64_t*)realloc(f->map_keys, sizeof(u64_t) * cap);
+        if (keys) f->map_keys = keys;
+        i64_t* rows = (i64_t*)realloc(f->map_rows, sizeof(i64_t) * cap);
+        if (rows) f->map_rows = rows;
+        if (!keys || !rows) return B8_FALSE;
+        f->map_cap = cap;
+    }
+    if (new_n > f->align_cap) {
+        i64_t* align = (i64_t*)realloc(f->align, sizeof(i64_t) * new_n);
+        if (!align) return B8_FALSE;
+        f->align = align;
+        f->align_cap = new_n;
+    }
+
+    u64_t mask = (u64_t)cap - 1;
+    memset(f->map_rows, 0xff, sizeof(i64_t) * cap);
+    for (i64_t r = 0; r < old_n; r++) {
+        u64_t k = key_at(old_key, r);
+        u64_t s = key_hash(k) & mask;
+        while (f->map_rows[s] >= 0 && f->map_keys[s] != k) s = (s + 1) & mask;
+        f->map_keys[s] = k;
+        f->map_rows[s] = r;
+    }
+    for (i64_t r = 0; r < new_n; r++) {
+        u64_t k = key_at(new_key, r);
+        u64_t s = key_hash(k) & mask;
+        while (f->map_rows[s] >= 0 && f->map_keys[s] != k) s = (s + 1) & mask;
+        f->align[r] = f->map_rows[s];
+    }
+    return B8_TRUE;
+}
+
+// ============================================================================
+// Diff
+// ============================================================================
+
+// Build 64-row words of up / down bits. Positional rows compare two
+// contiguous runs (vectorizes); aligned rows gather the old value.
+#define DIFF_WORDS(T, ARR, UP, DOWN)                                              \
+    do {                                                                          \
+        const T* nv = (const T*)ARR(nc);                                          \
+        const T* ov = (const T*)ARR(oc);                                          \
+        for (i64_t w = 0; w < words; w++) {                                       \
+            i64_t base = w << 6;                                                  \
+            i64_t m = n - base < 64 ? n - base : 64;                              \
+            u64_t up = 0, down = 0;                                               \
+            if (align) {                                                          \
+                for (i64_t b = 0; b < m; b++) {                                   \
+                    i64_t o = align[base + b];                                    \
+                    if (o < 0) continue;                                          \
+                    T x = nv[base + b], y = ov[o];                                \
+                    up |= (u64_t)(UP) << b;                                       \
+                    down |= (u64_t)(DOWN) << b;                                   \
+                }                                                                 \
+            } else {                                                              \
+                for (i64_t b = 0; b < m; b++) {                                   \
+                    T x = nv[base + b], y = ov[base + b];                         \
+                    up |= (u64_t)(UP) << b;                                       \
+                    down |= (u64_t)(DOWN) << b;                                   \
+                }                                                                 \
+            }                                                                     \
+            out[w] = up;                                                          \
+            out[words + w] = down;                                                \
+            any |= up | down;                                                     \
+        }                                                                         \
+    } while (0)
+
+// Diff one column into out (2 * WORDS(n) words); false if nothing changed
+static b8_t diff_column(obj_p oc, obj_p nc, i64_t n, const i64_t* align, u64_t* out) {
+    i64_t words = WORDS(n);
+    u64_t any = 0;
+    switch (nc->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP:
+            DIFF_WORDS(i64_t, AS_I64, x > y, x < y);
+            break;
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+            DIFF_WORDS(i32_t, AS_I32, x > y, x < y);
+            break;
+        case TYPE_I16:
+            DIFF_WORDS(i16_t, AS_I16, x > y, x < y);
+            break;
+        case TYPE_U8: case TYPE_B8:
+            DIFF_WORDS(u8_t, AS_U8, x > y, x < y);
+            break;
+        case TYPE_F64:
+            // NaN (null) on either side compares false both ways: no flash
+            DIFF_WORDS(f64_t, AS_F64, x > y, x < y);
+            break;
+        case TYPE_SYMBOL:
+            DIFF_WORDS(i64_t, AS_SYMBOL, x != y, x != y);
+            break;
+        case TYPE_C8:
+            DIFF_WORDS(c8_t, AS_C8, x != y, x != y);
+            break;
+        default:
+            return B8_FALSE;
+    }
+    return any != 0;
+}
+
+nil_t rfui_grid_flash_diff(rfui_grid_flash_t* f, obj_p old_table, obj_p new_table, f64_t now) {
+    if (!f->enabled || !old_table || !new_table ||
+        old_table->type != TYPE_TABLE || new_table->type != TYPE_TABLE) {
+        return;
+    }
+    obj_p old_vals = AS_LIST(old_table)[1];
+    obj_p new_vals = AS_LIST(new_table)[1];
+    if (old_vals->type != TYPE_LIST || new_vals->type != TYPE_LIST) return;
+
+    i64_t ncols = new_vals->len;
+    i64_t old_n = old_vals->len > 0 && AS_LIST(old_vals)[0] ? AS_LIST(old_vals)[0]->len : 0;
+    i64_t new_n = ncols > 0 && AS_LIST(new_vals)[0] ? AS_LIST(new_vals)[0]->len : 0;
+    if (old_vals->len != ncols) {
+        // Different layout: nothing to compare, old flashes no longer apply
+        rfui_grid_flash_clear(f);
+        return;
+    }
+
+    // Row alignment: by key if the key column is usable on both sides
+    const i64_t* align = NULL;
+    i64_t k = f->key_col;
+    if (k >= 0 && k < ncols) {
+        obj_p ok = AS_LIST(old_vals)[k], nk = AS_LIST(new_vals)[k];
+        if (ok && nk && ok->type == nk->type && rfui_grid_flash_key_supported(nk->type) &&
+            ok->len == old_n && nk->len == new_n && align_by_key(f, ok, nk)) {
+            align = f->align;
+        }
+    }
+    i64_t n = align ? new_n : (old_n < new_n ? old_n : new_n);
+
+    // Older generations: drop faded ones, follow the new row order
+    for (i32_t g = 0; g < RFUI_FLASH_GENS; g++) {
+        rfui_flash_gen_t* gen = &f->gens[g];
+        if (!gen_live(gen, now) || gen->ncols != ncols) {
+            gen_clear(gen);
+        } else if (align) {
+            gen_remap(gen, align, new_n);
+        }
+    }
+
+    i64_t words = WORDS(n);
+    if (words * 2 > f->words_cap) {
+        u64_t* buf = (u64_t*)realloc(f->words, sizeof(u64_t) * words * 2);
+        if (!buf) return;
+        f->words = buf;
+        f->words_cap = words * 2;
+    }
+
+    f->head = (f->head + 1) % RFUI_FLASH_GENS;
+    rfui_flash_gen_t* gen = &f->gens[f->head];
+    gen_clear(gen);
+    gen->bits = (u64_t**)calloc(ncols > 0 ? ncols : 1, sizeof(u64_t*));
+    if (!gen->bits) return;
+    gen->ncols = ncols;
+    gen->nrows = n;
+    gen->time = now;
+
+    for (i64_t c = 0; c < ncols && n > 0; c++) {
+        obj_p oc = AS_LIST(old_vals)[c], nc = AS_LIST(new_vals)[c];
+        // Shared column objects are unchanged by construction
+        if (!oc || !nc || oc == nc || oc->type != nc->type || oc->len != old_n || nc->len != new_n) {
+            continue;
+        }
+        if (!diff_column(oc, nc, n, align, f->words)) continue;
+
+        u64_t* bits = (u64_t*)malloc(sizeof(u64_t) * words * 2);
+        if (!bits) continue;
+        memcpy(bits, f->words, sizeof(u64_t) * words * 2);
+        gen->bits[c] = bits;
+    }
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+b8_t rfui_grid_flash_live(const rfui_grid_flash_t* f, f64_t now) {
+    return f->enabled && gen_live(&f->gens[f->head], now);
+}
+
+u8_t rfui_grid_flash_at(const rfui_grid_flash_t* f, i64_t col, i64_t row, f64_t now, float* fade) {
+    // Newest first; generations are pushed in time order
+    for (i32_t i = 0; i < RFUI_FLASH_GENS; i++) {
+        const rfui_flash_gen_t* g = &f->gens[(f->head - i + RFUI_FLASH_GENS) % RFUI_FLASH_GENS];
+        if (!gen_live(g, now)) break;
+        if (col >= g->ncols || row >= g->nrows || !g->bits[col]) continue;
+
+        const u64_t* bits = g->bits[col];
+        u64_t bit = (u64_t)1 << (row & 63);
+        u8_t dir = 0;
+        if (bits[row >> 6] & bit) dir |= RFUI_FLASH_UP;
+        if (bits[WORDS(g->nrows) + (row >> 6)] & bit) dir |= RFUI_FLASH_DOWN;
+        if (dir) {
+            *fade = (float)(1.0 - (now - g->time) / RFUI_FLASH_SECONDS);
+            return dir;
+        }
+    }
+    return 0;
+}
+
+nil_t rfui_grid_flash_clear(rfui_grid_flash_t* f) {
+    for (i32_t g = 0; g < RFUI_FLASH_GENS; g++) gen_clear(&f->gens[g]);
+}
+
+nil_t rfui_grid_flash_free(rfui_grid_flash_t* f) {
+    rfui_grid_flash_clear(f);
+    free(f->words);
+    free(f->align);
+    free(f->map_keys);
+    free(f->map_rows);
+    f->words = NULL;
+    f->align = NULL;
+    f->map_keys = NULL;
+    f->map_rows = NULL;
+    f->words_cap = 0;
+    f->align_cap = 0;
+    f->map_cap = 0;
+}
+
+i64_t rfui_grid_flash_bytes(const rfui_grid_flash_t* f) {
+    i64_t bytes = (f->words_cap + f->map_cap) * (i64_t)sizeof(u64_t) +
+                  (f->align_cap + f->map_cap) * (i64_t)sizeof(i64_t);
+    for (i32_t g = 0; g < RFUI_FLASH_GENS; g++) {
+        const rfui_flash_gen_t* gen = &f->gens[g];
+        bytes += gen->ncols * (i64_t)sizeof(u64_t*);
+        for (i64_t c = 0; c < gen->ncols; c++) {
+            if (gen->bits[c]) bytes += WORDS(gen->nrows) * 2 * (i64_t)sizeof(u64_t);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,608 @@
+// src/grid_group.c
+// Grid grouped mode (worker pool)
+//
+// Nodes are numbered level by level, so a parent always has a smaller id
+// than its children: counts and sums roll up in one pass over the nodes in
+// descending order and key paths hash down in one ascending pass. Sorting
+// every node by (parent, key) lays out the top level and then each parent's
+// children contiguously, which is the child list as it stands.
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/rfui/grid_group.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/symbols.h"
+
+#define GROUP_CHUNK 65536
+#define GROUP_MAX_SUMS 64
+
+// Nodes of one level: (parent node, key) pairs in order of first appearance
+typedef struct level_t {
+    u64_t* keys;       // n * 2
+    i64_t* rep;        // First row of each node
+    i64_t n;
+    i64_t cap;
+    i32_t* slots;      // Node + 1 (0 = empty)
+    i64_t nslots;
+} level_t;
+
+typedef struct rfui_group_job_t {
+    // Inputs: data is kept alive by the grid until the job is adopted
+    obj_p data;
+    i32_t key_cols[RFUI_GROUP_MAX_LEVELS];
+    i32_t nkeys;
+
+    // Outputs
+    rfui_group_index_t* index;
+    b8_t ok;
+
+    rfui_task_t task;
+} rfui_group_job_t;
+
+b8_t rfui_grid_group_key_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_SYMBOL: case TYPE_I32: case TYPE_DATE:
+        case TYPE_TIME: case TYPE_I16: case TYPE_U8: case TYPE_B8: case TYPE_F64:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+static b8_t sum_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8: case TYPE_F64:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+// ============================================================================
+// Hash grouping
+// ============================================================================
+
+static inline u64_t mix64(u64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static inline u64_t pair_hash(u64_t parent, u64_t key) {
+    return mix64(mix64(parent ^ 0x9E3779B97F4A7C15ULL) ^ key);
+}
+
+static b8_t level_rehash(level_t* l) {
+    i64_t nslots = l->nslots ? l->nslots * 2 : 1024;
+    i32_t* slots = (i32_t*)calloc((size_t)nslots, sizeof(i32_t));
+    if (!slots) return B8_FALSE;
+    u64_t mask = (u64_t)nslots - 1;
+    for (i64_t i = 0; i < l->n; i++) {
+        u64_t s = pair_hash(l->keys[2 * i], l->keys[2 * i + 1]) & mask;
+        while (slots[s]) s = (s + 1) & mask;
+        slots[s] = (i32_t)(i + 1);
+    }
+    free(l->slots);
+    l->slots = slots;
+    l->nslots = nslots;
+    return B8_TRUE;
+}
+
+// Node of (parent, key), added with row as its first row if new (-1 = out of memory)
+static i64_t level_find(level_t* l, u64_t parent, u64_t key, i64_t row) {
+    if ((l->n + 1) * 2 > l->nslots && !level_rehash(l)) return -1;
+    u64_t mask = (u64_t)l->nslots - 1;
+    u64_t s = pair_hash(parent, key) & mask;
+    while (l->slots[s]) {
+        i64_t i = l->slots[s] - 1;
+        if (l->keys[2 * i] == parent && l->keys[2 * i + 1] == key) return i;
+        s = (s + 1) & mask;
+    }
+
+    if (l->n == l->cap) {
+        i64_t cap = l->cap ? l->cap * 2 : 256;
+        u64_t* keys = (u64_t*)realloc(l->keys, sizeof(u64_t) * 2 * (size_t)cap);
+        if (!keys) return -1;
+        l->keys = keys;
+        i64_t* rep = (i64_t*)realloc(l->rep, sizeof(i64_t) * (size_t)cap);
+        if (!rep) return -1;
+        l->rep = rep;
+        l->cap = cap;
+    }
+    l->keys[2 * l->n] = parent;
+    l->keys[2 * l->n + 1] = key;
+    l->rep[l->n] = row;
+    l->slots[s] = (i32_t)(l->n + 1);
+    return l->n++;
+}
+
+static void level_free(level_t* l) {
+    free(l->keys);
+    free(l->rep);
+    free(l->slots);
+    memset(l, 0, sizeof(*l));
+}
+
+// Raw key: equal values give equal keys (-0.0 folds into 0.0)
+static inline u64_t key_at(obj_p col, i64_t r) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_SYMBOL:
+            return (u64_t)AS_I64(col)[r];
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+            return (u64_t)(i64_t)AS_I32(col)[r];
+        case TYPE_I16:
+            return (u64_t)(i64_t)AS_I16(col)[r];
+        case TYPE_U8: case TYPE_B8:
+            return AS_U8(col)[r];
+        default: {
+            f64_t x = AS_F64(col)[r] + 0.0;
+            u64_t k;
+            memcpy(&k, &x, sizeof(k));
+            return k;
+        }
+    }
+}
+
+// Value as f64 (NaN = null)
+static inline f64_t value_at(obj_p col, i64_t r) {
+    switch (col->type) {
+        case TYPE_I64: {
+            i64_t x = AS_I64(col)[r];
+            return x == NULL_I64 ? NAN : (f64_t)x;
+        }
+        case TYPE_I32: {
+            i32_t x = AS_I32(col)[r];
+            return x == NULL_I32 ? NAN : (f64_t)x;
+        }
+        case TYPE_I16: return (f64_t)AS_I16(col)[r];
+        case TYPE_U8: return (f64_t)AS_U8(col)[r];
+        default: return AS_F64(col)[r];
+    }
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+typedef struct sort_item_t {
+    i32_t parent;
+    i32_t node;
+    u64_t k;           // Order-preserving key
+    const char* s;     // Symbol name (compared instead of k)
+} sort_item_t;
+
+static int item_cmp(const void* a, const void* b) {
+    const sort_item_t* x = (const sort_item_t*)a;
+    const sort_item_t* y = (const sort_item_t*)b;
+    if (x->parent != y->parent) return x->parent < y->parent ? -1 : 1;
+    if (x->s && y->s) {
+        int c = strcmp(x->s, y->s);
+        if (c) return c;
+    } else if (x->k != y->k) {
+        return x->k < y->k ? -1 : 1;
+    }
+    return x->node < y->node ? -1 : x->node > y->node;
+}
+
+static u64_t sort_key(i8_t type, u64_t v) {
+    switch (type) {
+        case TYPE_U8: case TYPE_B8: return v;
+        case TYPE_F64: return (v >> 63) ? ~v : v | (1ULL << 63);
+        default: return v ^ (1ULL << 63);
+    }
+}
+
+static void index_free(rfui_group_index_t* x) {
+    if (!x) return;
+    free(x->level);
+    free(x->parent);
+    free(x->first_row);
+    free(x->count);
+    free(x->path);
+    free(x->child_ptr);
+    free(x->children);
+    free(x->row_ptr);
+    free(x->rows);
+    free(x->sum_cols);
+    free(x->sums);
+    free(x);
+}
+
+// Nodes, their rows and rollups from the per-level groups and each row's
+// last-level node
+static rfui_group_index_t* build_index(rfui_group_job_t* job, obj_p* cols, i64_t ncols,
+                                       level_t* levels, const i32_t* leaf_of, i64_t n) {
+    rfui_group_index_t* x = (rfui_group_index_t*)calloc(1, sizeof(rfui_group_index_t));
+    if (!x) return NULL;
+    x->nlevels = job->nkeys;
+    memcpy(x->key_cols, job->key_cols, sizeof(x->key_cols));
+
+    i64_t base[RFUI_GROUP_MAX_LEVELS + 1];
+    base[0] = 0;
+    for (i32_t l = 0; l < x->nlevels; l++) base[l + 1] = base[l] + levels[l].n;
+    i64_t nn = x->nnodes = base[x->nlevels];
+    i64_t leaf_base = base[x->nlevels - 1];
+
+    for (i64_t c = 0; c < ncols && x->nsums < GROUP_MAX_SUMS; c++) {
+        b8_t key = B8_FALSE;
+        for (i32_t l = 0; l < x->nlevels; l++) key |= x->key_cols[l] == c;
+        if (!key && cols[c] && cols[c]->len == n && sum_supported(cols[c]->type)) x->nsums++;
+    }
+
+    x->level = (i32_t*)malloc(sizeof(i32_t) * (size_t)(nn + 1));
+    x->parent = (i32_t*)malloc(sizeof(i32_t) * (size_t)(nn + 1));
+    x->first_row = (i64_t*)malloc(sizeof(i64_t) * (size_t)(nn + 1));
+    x->count = (i64_t*)calloc((size_t)(nn + 1), sizeof(i64_t));
+    x->path = (u64_t*)malloc(sizeof(u64_t) * (size_t)(nn + 1));
+    x->child_ptr = (i64_t*)calloc((size_t)(nn + 2), sizeof(i64_t));
+    x->children = (i32_t*)malloc(sizeof(i32_t) * (size_t)(nn + 1));
+    x->row_ptr = (i64_t*)calloc((size_t)(nn + 2), sizeof(i64_t));
+    x->rows = (u32_t*)malloc(sizeof(u32_t) * (size_t)(n + 1));
+    x->sum_cols = (i32_t*)malloc(sizeof(i32_t) * (size_t)(x->nsums + 1));
+    x->sums = (f64_t*)calloc((size_t)(nn * x->nsums + 1), sizeof(f64_t));
+    sort_item_t* items = (sort_item_t*)malloc(sizeof(sort_item_t) * (size_t)(nn + 1));
+    b8_t ok = x->level && x->parent && x->first_row && x->count && x->path && x->child_ptr &&
+              x->children && x->row_ptr && x->rows && x->sum_cols && x->sums && items;
+    if (!ok) goto done;
+
+    // Nodes and key paths (parents come first)
+    for (i32_t l = 0; l < x->nlevels; l++) {
+        i8_t type = cols[x->key_cols[l]]->type;
+        for (i64_t i = 0; i < levels[l].n; i++) {
+            i64_t node = base[l] + i;
+            i32_t parent = l ? (i32_t)levels[l].keys[2 * i] : -1;
+            u64_t key = levels[l].keys[2 * i + 1];
+            x->level[node] = l;
+            x->parent[node] = parent;
+            x->first_row[node] = levels[l].rep[i];
+            x->path[node] = pair_hash(parent >= 0 ? x->path[parent] : (u64_t)l, key);
+            items[node].parent = parent;
+            items[node].node = (i32_t)node;
+            items[node].k = sort_key(type, key);
+            items[node].s = type == TYPE_SYMBOL ? rfui_symbols_get((i64_t)key) : NULL;
+        }
+    }
+    if (rfui_task_cancelled(&job->task)) {
+        ok = B8_FALSE;
+        goto done;
+    }
+
+    // Rows of each last-level node in data order
+    for (i64_t r = 0; r < n; r++) x->row_ptr[leaf_of[r] + 1]++;
+    for (i64_t i = 0; i < nn; i++) x->row_ptr[i + 1] += x->row_ptr[i];
+    for (i64_t i = leaf_base; i < nn; i++) x->count[i] = x->row_ptr[i + 1] - x->row_ptr[i];
+    i64_t* fill = x->child_ptr;   // Borrowed until the children are laid out
+    memcpy(fill, x->row_ptr, sizeof(i64_t) * (size_t)(nn + 1));
+    for (i64_t r = 0; r < n; r++) x->rows[fill[leaf_of[r]]++] = (u32_t)r;
+
+    // Sums per last-level node, one column at a time
+    i32_t j = 0;
+    for (i64_t c = 0; c < ncols && j < x->nsums; c++) {
+        b8_t key = B8_FALSE;
+        for (i32_t l = 0; l < x->nlevels; l++) key |= x->key_cols[l] == c;
+        if (key || !cols[c] || cols[c]->len != n || !sum_supported(cols[c]->type)) continue;
+        x->sum_cols[j] = (i32_t)c;
+        for (i64_t start = 0; start < n; start += GROUP_CHUNK) {
+            if (rfui_task_cancelled(&job->task)) {
+                ok = B8_FALSE;
+                goto done;
+            }
+            i64_t end = n - start < GROUP_CHUNK ? n : start + GROUP_CHUNK;
+            for (i64_t r = start; r < end; r++) {
+                f64_t v = value_at(cols[c], r);
+                if (v == v) x->sums[(i64_t)leaf_of[r] * x->nsums + j] += v;
+            }
+        }
+        j++;
+    }
+
+    // Roll up: children before parents
+    for (i64_t i = nn - 1; i >= 0; i--) {
+        i32_t p = x->parent[i];
+        if (p < 0) continue;
+        x->count[p] += x->count[i];
+        for (i32_t s = 0; s < x->nsums; s++) x->sums[(i64_t)p * x->nsums + s] += x->sums[i * x->nsums + s];
+    }
+
+    // Top level, then each parent's children, all in key order
+    qsort(items, (size_t)nn, sizeof(sort_item_t), item_cmp);
+    memset(x->child_ptr, 0, sizeof(i64_t) * (size_t)(nn + 2));
+    for (i64_t i = 0; i < nn; i++) {
+        x->children[i] = items[i].node;
+        if (items[i].parent < 0) {
+            x->ntop++;
+        } else {
+            x->child_ptr[items[i].parent + 1]++;
+        }
+    }
+    x->top = x->children;
+    x->child_ptr[0] = x->ntop;
+    for (i64_t i = 0; i < nn; i++) x->child_ptr[i + 1] += x->child_ptr[i];
+
+done:
+    free(items);
+    if (!ok) {
+        index_free(x);
+        return NULL;
+    }
+    return x;
+}
+
+static void run_group(rfui_group_job_t* job) {
+    obj_p vals = AS_LIST(job->data)[1];
+    obj_p* cols = AS_LIST(vals);
+    if (job->nkeys <= 0 || job->nkeys > RFUI_GROUP_MAX_LEVELS) return;
+    for (i32_t l = 0; l < job->nkeys; l++) {
+        i32_t c = job->key_cols[l];
+        if (c < 0 || c >= vals->len || !cols[c] || !rfui_grid_group_key_supported(cols[c]->type)) return;
+    }
+    i64_t n = cols[job->key_cols[0]]->len;
+    for (i32_t l = 1; l < job->nkeys; l++) {
+        if (cols[job->key_cols[l]]->len != n) return;
+    }
+    if (n > (i64_t)UINT32_MAX) return;
+
+    level_t levels[RFUI_GROUP_MAX_LEVELS];
+    memset(levels, 0, sizeof(levels));
+    i32_t* node_of = (i32_t*)malloc(sizeof(i32_t) * (size_t)(n + 1));
+    b8_t ok = node_of != NULL;
+
+    // One hash-group pass per level: (parent node, key) -> node
+    i64_t base = 0;
+    for (i32_t l = 0; ok && l < job->nkeys; l++) {
+        obj_p col = cols[job->key_cols[l]];
+        for (i64_t start = 0; ok && start < n; start += GROUP_CHUNK) {
+            if (rfui_task_cancelled(&job->task)) {
+                ok = B8_FALSE;
+                break;
+            }
+            i64_t end = n - start < GROUP_CHUNK ? n : start + GROUP_CHUNK;
+            for (i64_t r = start; r < end; r++) {
+                u64_t parent = l ? (u64_t)node_of[r] : 0;
+                i64_t i = level_find(&levels[l], parent, key_at(col, r), r);
+                if (i < 0 || base + i > INT32_MAX - 2) {
+                    ok = B8_FALSE;
+                    break;
+                }
+                node_of[r] = (i32_t)(base + i);
+            }
+        }
+        base += levels[l].n;
+    }
+
+    if (ok) job->index = build_index(job, cols, vals->len, levels, node_of, n);
+    job->ok = job->index != NULL;
+
+    for (i32_t l = 0; l < RFUI_GROUP_MAX_LEVELS; l++) level_free(&levels[l]);
+    free(node_of);
+}
+
+static nil_t group_job(raw_p arg) {
+    rfui_group_job_t* job = (rfui_group_job_t*)arg;
+
+    i64_t trace_span = rfui_trace_begin();
+    run_group(job);
+    rfui_trace_end("grid_group", NULL, trace_span);
+}
+
+static void job_free(rfui_group_job_t* job) {
+    index_free(job->index);
+    rfui_task_free(&job->task);
+    free(job);
+}
+
+// ============================================================================
+// Grid side (UI thread)
+// ============================================================================
+
+static void start_job(rfui_grid_group_t* g, obj_p table, i64_t version) {
+    g->version = version;
+    g->job_gen = g->config_gen;
+    if (g->nkeys <= 0) return;
+
+    rfui_group_job_t* job = (rfui_group_job_t*)calloc(1, sizeof(rfui_group_job_t));
+    if (!job) return;
+    job->data = table;
+    job->nkeys = g->nkeys;
+    memcpy(job->key_cols, g->key_cols, sizeof(job->key_cols));
+    g->job = job;
+    rfui_task_submit(&job->task, group_job, job, 1);
+}
+
+static b8_t same_keys(const rfui_group_index_t* x, const rfui_group_job_t* job) {
+    if (!x || x->nlevels != job->nkeys) return B8_FALSE;
+    return memcmp(x->key_cols, job->key_cols, sizeof(i32_t) * (size_t)job->nkeys) == 0;
+}
+
+// Position of path in the sorted expanded set (or where it would go)
+static i64_t expanded_find(const rfui_grid_group_t* g, u64_t path) {
+    i64_t lo = 0, hi = g->nexpanded;
+    while (lo < hi) {
+        i64_t mid = lo + (hi - lo) / 2;
+        if (g->expanded[mid] < path) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static b8_t path_expanded(const rfui_grid_group_t* g, u64_t path) {
+    i64_t i = expanded_find(g, path);
+    return i < g->nexpanded && g->expanded[i] == path;
+}
+
+static b8_t seg_push(rfui_grid_group_t* g, const i32_t* nodes, i32_t node, i64_t start, i64_t n) {
+    if (n <= 0) return B8_TRUE;
+    if (g->nsegs == g->segs_cap) {
+        i64_t cap = g->segs_cap ? g->segs_cap * 2 : 64;
+        rfui_group_seg_t* segs = (rfui_group_seg_t*)realloc(g->segs, sizeof(rfui_group_seg_t) * (size_t)cap);
+        if (!segs) return B8_FALSE;
+        g->segs = segs;
+        g->segs_cap = cap;
+    }
+    rfui_group_seg_t* s = &g->segs[g->nsegs++];
+    s->display = g->display_rows;
+    s->n = n;
+    s->nodes = nodes;
+    s->node = node;
+    s->start = start;
+    g->display_rows += n;
+    return B8_TRUE;
+}
+
+// Siblings ids[0 .. m): collapsed runs stay one segment each, an open node
+// splits its run and brings in its children or rows
+static b8_t emit_nodes(rfui_grid_group_t* g, const i32_t* ids, i64_t m) {
+    const rfui_group_index_t* x = g->index;
+    i64_t run = 0;
+    for (i64_t i = 0; g->nexpanded > 0 && i < m; i++) {
+        i32_t node = ids[i];
+        if (!path_expanded(g, x->path[node])) continue;
+        if (!seg_push(g, ids + run, -1, 0, i + 1 - run)) return B8_FALSE;
+        run = i + 1;
+        if (x->level[node] == x->nlevels - 1) {
+            if (!seg_push(g, NULL, node, 0, x->row_ptr[node + 1] - x->row_ptr[node])) return B8_FALSE;
+        } else if (!emit_nodes(g, x->children + x->child_ptr[node],
+                               x->child_ptr[node + 1] - x->child_ptr[node])) {
+            return B8_FALSE;
+        }
+    }
+    return seg_push(g, ids + run, -1, 0, m - run);
+}
+
+static void rebuild_segs(rfui_grid_group_t* g) {
+    g->nsegs = 0;
+    g->display_rows = 0;
+    g->dirty = B8_FALSE;
+    if (!g->index) return;
+    if (!emit_nodes(g, g->index->top, g->index->ntop)) {
+        // Out of memory: fall back to the collapsed tree
+        g->nsegs = 0;
+        g->display_rows = 0;
+        g->nexpanded = 0;
+        emit_nodes(g, g->index->top, g->index->ntop);
+    }
+}
+
+nil_t rfui_grid_group_update(rfui_grid_group_t* g, obj_p table, i64_t version) {
+    rfui_group_job_t* job = g->job;
+    if (job && rfui_task_done(&job->task)) {
+        g->job = NULL;
+        if (job->ok && g->job_gen == g->config_gen) {
+            // Open nodes are kept by key path, but only mean something under the same keys
+            if (!same_keys(g->index, job)) g->nexpanded = 0;
+            index_free(g->index);
+            g->index = job->index;
+            job->index = NULL;
+            g->dirty = B8_TRUE;
+        }
+        job_free(job);
+    }
+
+    if (g->job) {
+        // A key edit makes the running job's result useless
+        if (g->job_gen != g->config_gen) rfui_task_cancel(&g->job->task);
+    } else if (g->version != version || g->job_gen != g->config_gen) {
+        start_job(g, table, version);
+    }
+    if (g->dirty) rebuild_segs(g);
+}
+
+b8_t rfui_grid_group_at(const rfui_grid_group_t* g, i64_t display, i32_t* node, i64_t* row) {
+    if (display < 0 || display >= g->display_rows) return B8_FALSE;
+    i64_t lo = 0, hi = g->nsegs - 1;
+    while (lo < hi) {
+        i64_t mid = lo + (hi - lo + 1) / 2;
+        if (g->segs[mid].display <= display) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    const rfui_group_seg_t* s = &g->segs[lo];
+    i64_t off = display - s->display;
+    if (s->nodes) {
+        *node = s->nodes[off];
+        *row = -1;
+    } else {
+        *node = s->node;
+        *row = g->index->rows[g->index->row_ptr[s->node] + s->start + off];
+    }
+    return B8_TRUE;
+}
+
+b8_t rfui_grid_group_expanded(const rfui_grid_group_t* g, i32_t node) {
+    return g->index && node >= 0 && node < g->index->nnodes && path_expanded(g, g->index->path[node]);
+}
+
+nil_t rfui_grid_group_toggle(rfui_grid_group_t* g, i32_t node) {
+    if (!g->index || node < 0 || node >= g->index->nnodes) return;
+    u64_t path = g->index->path[node];
+    i64_t i = expanded_find(g, path);
+    if (i < g->nexpanded && g->expanded[i] == path) {
+        memmove(g->expanded + i, g->expanded + i + 1, sizeof(u64_t) * (size_t)(g->nexpanded - i - 1));
+        g->nexpanded--;
+    } else {
+        if (g->nexpanded == g->expanded_cap) {
+            i64_t cap = g->expanded_cap ? g->expanded_cap * 2 : 64;
+            u64_t* expanded = (u64_t*)realloc(g->expanded, sizeof(u64_t) * (size_t)cap);
+            if (!expanded) return;
+            g->expanded = expanded;
+            g->expanded_cap = cap;
+        }
+        memmove(g->expanded + i + 1, g->expanded + i, sizeof(u64_t) * (size_t)(g->nexpanded - i));
+        g->expanded[i] = path;
+        g->nexpanded++;
+    }
+    g->dirty = B8_TRUE;
+}
+
+nil_t rfui_grid_group_collapse_all(rfui_grid_group_t* g) {
+    g->nexpanded = 0;
+    g->dirty = B8_TRUE;
+}
+
+b8_t rfui_grid_group_reads(const rfui_grid_group_t* g, obj_p table) {
+    return g->job != NULL && g->job->data == table;
+}
+
+nil_t rfui_grid_group_free(rfui_grid_group_t* g) {
+    rfui_group_job_t* job = g->job;
+    if (job) {
+        rfui_task_wait(&job->task);
+        job_free(job);
+        g->job = NULL;
+    }
+    index_free(g->index);
+    g->index = NULL;
+    free(g->expanded);
+    g->expanded = NULL;
+    g->nexpanded = 0;
+    g->expanded_cap = 0;
+    free(g->segs);
+    g->segs = NULL;
+    g->nsegs = 0;
+    g->segs_cap = 0;
+    g->display_rows = 0;
+    g->dirty = B8_FALSE;
+    g->version = -1;
+}
+
+i64_t rfui_grid_group_bytes(const rfui_grid_group_t* g) {
+    i64_t bytes = g->expanded_cap * (i64_t)sizeof(u64_t) + g->segs_cap * (i64_t)sizeof(rfui_group_seg_t);
+    const rfui_group_index_t* x = g->index;
+    if (x) {
+        i64_t nn = x->nnodes;
+        bytes += (i64_t)sizeof(*x) +
+                 nn * (i64_t)(3 * sizeof(i32_t) + 2 * sizeof(i64_t) + sizeof(u64_t)) +
+                 2 * (nn + 2) * (i64_t)sizeof(i64_t) + x->row_ptr[nn] * (i64_t)sizeof(u32_t) +
+                 nn * x->nsums * (i64_t)sizeof(f64_t);
+    }
+    return bytes;
+}
@@ -0,0 +1,709 @@
+// src/grid_pivot.c
+// Grid pivot (worker pool)
+//
+// Each source row costs three probes: its row key tuple and column key
+// tuple find their groups (first row of a group is kept for its label), then
+// the pair finds its cell. All three tables use open addressing on a mixed
+// hash. Publishing sorts the groups by key (symbols by name) and scatters
+// the cells into rows with two counting passes, so columns come out
+// ascending without a comparison sort.
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/rfui/grid_pivot.h"
+#include "../include/rfui/grid_sort.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/symbols.h"
+
+#define FOLD_CHUNK 65536
+
+// Groups of key tuples, in order of first appearance
+typedef struct groups_t {
+    i32_t nk;
+    u64_t* keys;       // n * nk raw key values
+    i64_t* rep;        // First source row of each group
+    i64_t n;
+    i64_t cap;
+    i32_t* slots;      // Group + 1 (0 = empty)
+    i64_t nslots;
+} groups_t;
+
+// Aggregates per (row group, column group)
+typedef struct cells_t {
+    u64_t* key;        // Row group << 32 | column group
+    f64_t* sum;
+    f64_t* last;
+    i64_t* count;      // Non-null values
+    i64_t* rows;
+    i64_t n;
+    i64_t cap;
+    i32_t* slots;
+    i64_t nslots;
+} cells_t;
+
+typedef struct rfui_pivot_state_t {
+    rfui_pivot_config_t config;
+    i64_t rows;                              // Source rows folded in
+    u64_t hash[2 * RFUI_PIVOT_MAX_KEYS + 1]; // Fingerprint of those rows per used column
+    groups_t row_groups;
+    groups_t col_groups;
+    cells_t cells;
+} rfui_pivot_state_t;
+
+typedef struct rfui_pivot_job_t {
+    // Inputs: data is kept alive by the grid until the job is adopted
+    obj_p data;
+    rfui_pivot_config_t config;
+    rfui_pivot_state_t* state;     // Owned by the job while it runs
+
+    // Outputs
+    rfui_pivot_view_t* view;
+    b8_t ok;                       // False on failure or cancel (state is then stale)
+
+    rfui_task_t task;
+} rfui_pivot_job_t;
+
+b8_t rfui_grid_pivot_key_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_SYMBOL: case TYPE_I32: case TYPE_DATE:
+        case TYPE_TIME: case TYPE_I16: case TYPE_U8: case TYPE_B8: case TYPE_F64:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+b8_t rfui_grid_pivot_value_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8: case TYPE_B8: case TYPE_F64:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+b8_t rfui_grid_pivot_valid(const rfui_pivot_config_t* c) {
+    return c->nrow_keys > 0 && (c->agg == RFUI_PIVOT_COUNT || c->value >= 0);
+}
+
+static b8_t config_equal(const rfui_pivot_config_t* a, const rfui_pivot_config_t* b) {
+    if (a->nrow_keys != b->nrow_keys || a->ncol_keys != b->ncol_keys || a->agg != b->agg) return B8_FALSE;
+    if (a->agg != RFUI_PIVOT_COUNT && a->value != b->value) return B8_FALSE;
+    for (i32_t k = 0; k < a->nrow_keys; k++) {
+        if (a->row_keys[k] != b->row_keys[k]) return B8_FALSE;
+    }
+    for (i32_t k = 0; k < a->ncol_keys; k++) {
+        if (a->col_keys[k] != b->col_keys[k]) return B8_FALSE;
+    }
+    return B8_TRUE;
+}
+
+// ============================================================================
+// Hash tables
+// ============================================================================
+
+static inline u64_t mix64(u64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static u64_t tuple_hash(const u64_t* k, i32_t nk) {
+    u64_t h = 0x9E3779B97F4A7C15ULL;
+    for (i32_t i = 0; i < nk; i++) h = mix64(h ^ k[i]);
+    return h;
+}
+
+// Rehash into twice the slots once half full
+static b8_t groups_rehash(groups_t* g) {
+    i64_t nslots = g->nslots ? g->nslots * 2 : 1024;
+    i32_t* slots = (i32_t*)calloc((size_t)nslots, sizeof(i32_t));
+    if (!slots) return B8_FALSE;
+    u64_t mask = (u64_t)nslots - 1;
+    for (i64_t i = 0; i < g->n; i++) {
+        u64_t s = tuple_hash(g->keys + i * g->nk, g->nk) & mask;
+        while (slots[s]) s = (s + 1) & mask;
+        slots[s] = (i32_t)(i + 1);
+    }
+    free(g->slots);
+    g->slots = slots;
+    g->nslots = nslots;
+    return B8_TRUE;
+}
+
+// Group of key tuple k, added with row as its first row if new (-1 = out of memory)
+static i64_t groups_find(groups_t* g, const u64_t* k, i64_t row) {
+    if ((g->n + 1) * 2 > g->nslots && !groups_rehash(g)) return -1;
+    u64_t mask = (u64_t)g->nslots - 1;
+    u64_t s = tuple_hash(k, g->nk) & mask;
+    size_t kb = sizeof(u64_t) * (size_t)g->nk;
+    while (g->slots[s]) {
+        i64_t i = g->slots[s] - 1;
+        if (memcmp(g->keys + i * g->nk, k, kb) == 0) return i;
+        s = (s + 1) & mask;
+    }
+
+    if (g->n == g->cap) {
+        i64_t cap = g->cap ? g->cap * 2 : 256;
+        u64_t* keys = (u64_t*)realloc(g->keys, sizeof(u64_t) * (size_t)(cap * (g->nk ? g->nk : 1)));
+        if (!keys) return -1;
+        g->keys = keys;
+        i64_t* rep = (i64_t*)realloc(g->rep, sizeof(i64_t) * (size_t)cap);
+        if (!rep) return -1;
+        g->rep = rep;
+        g->cap = cap;
+    }
+    memcpy(g->keys + g->n * g->nk, k, kb);
+    g->rep[g->n] = row;
+    g->slots[s] = (i32_t)(g->n + 1);
+    return g->n++;
+}
+
+static void groups_free(groups_t* g) {
+    free(g->keys);
+    free(g->rep);
+    free(g->slots);
+    memset(g, 0, sizeof(*g));
+}
+
+static b8_t cells_rehash(cells_t* c) {
+    i64_t nslots = c->nslots ? c->nslots * 2 : 1024;
+    i32_t* slots = (i32_t*)calloc((size_t)nslots, sizeof(i32_t));
+    if (!slots) return B8_FALSE;
+    u64_t mask = (u64_t)nslots - 1;
+    for (i64_t i = 0; i < c->n; i++) {
+        u64_t s = mix64(c->key[i]) & mask;
+        while (slots[s]) s = (s + 1) & mask;
+        slots[s] = (i32_t)(i + 1);
+    }
+    free(c->slots);
+    c->slots = slots;
+    c->nslots = nslots;
+    return B8_TRUE;
+}
+
+#define CELLS_GROW(field, T)                                                 \
+    do {                                                                     \
+        T* p = (T*)realloc(c->field, sizeof(T) * (size_t)cap);               \
+        if (!p) return -1;                                                   \
+        c->field = p;                                                        \
+    } while (0)
+
+static i64_t cells_find(cells_t* c, u64_t key) {
+    if ((c->n + 1) * 2 > c->nslots && !cells_rehash(c)) return -1;
+    u64_t mask = (u64_t)c->nslots - 1;
+    u64_t s = mix64(key) & mask;
+    while (c->slots[s]) {
+        i64_t i = c->slots[s] - 1;
+        if (c->key[i] == key) return i;
+        s = (s + 1) & mask;
+    }
+
+    if (c->n == c->cap) {
+        i64_t cap = c->cap ? c->cap * 2 : 1024;
+        CELLS_GROW(key, u64_t);
+        CELLS_GROW(sum, f64_t);
+        CELLS_GROW(last, f64_t);
+        CELLS_GROW(count, i64_t);
+        CELLS_GROW(rows, i64_t);
+        c->cap = cap;
+    }
+    i64_t i = c->n++;
+    c->key[i] = key;
+    c->sum[i] = 0.0;
+    c->last[i] = NAN;
+    c->count[i] = 0;
+    c->rows[i] = 0;
+    c->slots[s] = (i32_t)(i + 1);
+    return i;
+}
+
+static void cells_free(cells_t* c) {
+    free(c->key);
+    free(c->sum);
+    free(c->last);
+    free(c->count);
+    free(c->rows);
+    free(c->slots);
+    memset(c, 0, sizeof(*c));
+}
+
+static void state_reset(rfui_pivot_state_t* st, const rfui_pivot_config_t* config) {
+    groups_free(&st->row_groups);
+    groups_free(&st->col_groups);
+    cells_free(&st->cells);
+    st->config = *config;
+    st->rows = 0;
+    memset(st->hash, 0, sizeof(st->hash));
+    st->row_groups.nk = config->nrow_keys;
+    st->col_groups.nk = config->ncol_keys;
+}
+
+static void state_free(rfui_pivot_state_t* st) {
+    if (!st) return;
+    groups_free(&st->row_groups);
+    groups_free(&st->col_groups);
+    cells_free(&st->cells);
+    free(st);
+}
+
+// ============================================================================
+// Folding
+// ============================================================================
+
+// Raw key: equal values give equal keys (-0.0 folds into 0.0)
+static inline u64_t key_at(obj_p col, i64_t r) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_SYMBOL:
+            return (u64_t)AS_I64(col)[r];
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+            return (u64_t)(i64_t)AS_I32(col)[r];
+        case TYPE_I16:
+            return (u64_t)(i64_t)AS_I16(col)[r];
+        case TYPE_U8: case TYPE_B8:
+            return AS_U8(col)[r];
+        default: {
+            f64_t x = AS_F64(col)[r] + 0.0;
+            u64_t k;
+            memcpy(&k, &x, sizeof(k));
+            return k;
+        }
+    }
+}
+
+// Value as f64 (NaN = null)
+static inline f64_t value_at(obj_p col, i64_t r) {
+    switch (col->type) {
+        case TYPE_I64: {
+            i64_t x = AS_I64(col)[r];
+            return x == NULL_I64 ? NAN : (f64_t)x;
+        }
+        case TYPE_I32: {
+            i32_t x = AS_I32(col)[r];
+            return x == NULL_I32 ? NAN : (f64_t)x;
+        }
+        case TYPE_I16: return (f64_t)AS_I16(col)[r];
+        case TYPE_U8: case TYPE_B8: return (f64_t)AS_U8(col)[r];
+        default: return AS_F64(col)[r];
+    }
+}
+
+// Fold rows [st->rows, n) into the groups and cells
+static b8_t fold_rows(rfui_pivot_job_t* job, obj_p* cols, i64_t n) {
+    rfui_pivot_state_t* st = job->state;
+    const rfui_pivot_config_t* cfg = &st->config;
+    obj_p vcol = cfg->agg != RFUI_PIVOT_COUNT ? cols[cfg->value] : NULL;
+    u64_t rk[RFUI_PIVOT_MAX_KEYS];
+    u64_t ck[RFUI_PIVOT_MAX_KEYS];
+
+    for (i64_t start = st->rows; start < n; start += FOLD_CHUNK) {
+        if (rfui_task_cancelled(&job->task)) return B8_FALSE;
+        i64_t end = n - start < FOLD_CHUNK ? n : start + FOLD_CHUNK;
+        for (i64_t r = start; r < end; r++) {
+            for (i32_t k = 0; k < cfg->nrow_keys; k++) rk[k] = key_at(cols[cfg->row_keys[k]], r);
+            for (i32_t k = 0; k < cfg->ncol_keys; k++) ck[k] = key_at(cols[cfg->col_keys[k]], r);
+            i64_t rg = groups_find(&st->row_groups, rk, r);
+            i64_t cg = groups_find(&st->col_groups, ck, r);
+            if (rg < 0 || cg < 0) return B8_FALSE;
+            i64_t c = cells_find(&st->cells, (u64_t)rg << 32 | (u64_t)cg);
+            if (c < 0) return B8_FALSE;
+
+            st->cells.rows[c]++;
+            if (!vcol) continue;
+            f64_t v = value_at(vcol, r);
+            if (v != v) continue;
+            st->cells.sum[c] += v;
+            st->cells.count[c]++;
+            st->cells.last[c] = v;
+        }
+        st->rows = end;
+    }
+    return B8_TRUE;
+}
+
+// ============================================================================
+// Publishing
+// ============================================================================
+
+typedef struct sort_item_t {
+    u64_t k[RFUI_PIVOT_MAX_KEYS];          // Order-preserving key
+    const char* s[RFUI_PIVOT_MAX_KEYS];    // Symbol name (compared instead of k)
+    i64_t group;
+} sort_item_t;
+
+static int item_cmp(const void* a, const void* b) {
+    const sort_item_t* x = (const sort_item_t*)a;
+    const sort_item_t* y = (const sort_item_t*)b;
+    for (i32_t k = 0; k < RFUI_PIVOT_MAX_KEYS; k++) {
+        if (x->s[k] || y->s[k]) {
+            if (!x->s[k] || !y->s[k]) return x->s[k] ? 1 : -1;
+            int c = strcmp(x->s[k], y->s[k]);
+            if (c) return c;
+        } else if (x->k[k] != y->k[k]) {
+            return x->k[k] < y->k[k] ? -1 : 1;
+        }
+    }
+    return x->group < y->group ? -1 : x->group > y->group;
+}
+
+// Groups in key order (malloc'd display -> group)
+static i64_t* sorted_groups(const groups_t* g, obj_p* cols, const i32_t* keys) {
+    sort_item_t* items = (sort_item_t*)calloc((size_t)(g->n ? g->n : 1), sizeof(sort_item_t));
+    i64_t* order = (i64_t*)malloc(sizeof(i64_t) * (size_t)(g->n ? g->n : 1));
+    if (!items || !order) {
+        free(items);
+        free(order);
+        return NULL;
+    }
+    for (i64_t i = 0; i < g->n; i++) {
+        items[i].group = i;
+        for (i32_t k = 0; k < g->nk; k++) {
+            u64_t v = g->keys[i * g->nk + k];
+            switch (cols[keys[k]]->type) {
+                case TYPE_SYMBOL:
+                    items[i].s[k] = rfui_symbols_get((i64_t)v);
+                    break;
+                case TYPE_U8: case TYPE_B8:
+                    items[i].k[k] = v;
+                    break;
+                case TYPE_F64:
+                    items[i].k[k] = (v >> 63) ? ~v : v | (1ULL << 63);
+                    break;
+                default:
+                    items[i].k[k] = v ^ (1ULL << 63);
+                    break;
+            }
+        }
+    }
+    qsort(items, (size_t)g->n, sizeof(sort_item_t), item_cmp);
+    for (i64_t i = 0; i < g->n; i++) order[i] = items[i].group;
+    free(items);
+    return order;
+}
+
+static b8_t labels_put(rfui_fmt_buf_t* out, const c8_t* s, i64_t n) {
+    if (out->len + n > out->cap) {
+        i64_t cap = out->cap ? out->cap * 2 : 4096;
+        while (cap < out->len + n) cap *= 2;
+        c8_t* text = (c8_t*)realloc(out->text, (size_t)cap);
+        if (!text) return B8_FALSE;
+        out->text = text;
+        out->cap = cap;
+    }
+    memcpy(out->text + out->len, s, (size_t)n);
+    out->len += n;
+    return B8_TRUE;
+}
+
+static void view_free(rfui_pivot_view_t* v) {
+    if (!v) return;
+    rfui_fmt_buf_free(&v->labels);
+    free(v->label_offsets);
+    free(v->row_ptr);
+    free(v->cell_col);
+    free(v->cell_val);
+    free(v);
+}
+
+// Cell value under the configured aggregation (false = empty)
+static b8_t cell_value(const cells_t* c, i64_t i, rfui_pivot_agg_t agg, f64_t* out) {
+    switch (agg) {
+        case RFUI_PIVOT_COUNT: *out = (f64_t)c->rows[i]; return B8_TRUE;
+        case RFUI_PIVOT_SUM:   *out = c->sum[i]; break;
+        case RFUI_PIVOT_AVG:   *out = c->sum[i] / (f64_t)c->count[i]; break;
+        default:               *out = c->last[i]; break;
+    }
+    return c->count[i] > 0;
+}
+
+static rfui_pivot_view_t* build_view(rfui_pivot_job_t* job, obj_p* cols, i64_t source_rows) {
+    const rfui_pivot_state_t* st = job->state;
+    const rfui_pivot_config_t* cfg = &st->config;
+    const groups_t* rg = &st->row_groups;
+    const groups_t* cg = &st->col_groups;
+    const cells_t* cells = &st->cells;
+
+    rfui_pivot_view_t* v = (rfui_pivot_view_t*)calloc(1, sizeof(rfui_pivot_view_t));
+    i64_t* row_order = sorted_groups(rg, cols, cfg->row_keys);
+    i64_t* col_order = sorted_groups(cg, cols, cfg->col_keys);
+    i64_t* row_rank = (i64_t*)malloc(sizeof(i64_t) * (size_t)(rg->n + 1));
+    i64_t* col_rank = (i64_t*)malloc(sizeof(i64_t) * (size_t)(cg->n + 1));
+    u32_t* reps = (u32_t*)malloc(sizeof(u32_t) * (size_t)(rg->n + 1));
+    u8_t* dim = (u8_t*)malloc((size_t)(rg->n + 1));
+    i64_t* by_col = NULL;
+    i64_t* col_start = NULL;
+    b8_t ok = v && row_order && col_order && row_rank && col_rank && reps && dim;
+    if (!ok) goto done;
+
+    v->nrows = rg->n;
+    v->ncols_total = cg->n;
+    v->ncols = cg->n < RFUI_PIVOT_MAX_COLUMNS ? cg->n : RFUI_PIVOT_MAX_COLUMNS;
+    v->config = *cfg;
+    v->source_rows = source_rows;
+    v->integral = cfg->agg == RFUI_PIVOT_COUNT ||
+                  (cfg->agg != RFUI_PIVOT_AVG && cols[cfg->value]->type != TYPE_F64);
+    for (i64_t d = 0; d < rg->n; d++) row_rank[row_order[d]] = d;
+    for (i64_t d = 0; d < cg->n; d++) col_rank[col_order[d]] = d < v->ncols ? d : -1;
+
+    // Labels: row key k of every row, then the column groups ("a / b")
+    i64_t nlabels = v->nrows * v->config.nrow_keys + v->ncols;
+    v->label_offsets = (u32_t*)malloc(sizeof(u32_t) * (size_t)(nlabels + 1));
+    ok = v->label_offsets != NULL;
+    for (i64_t d = 0; ok && d < rg->n; d++) reps[d] = (u32_t)rg->rep[row_order[d]];
+    for (i32_t k = 0; ok && k < v->config.nrow_keys; k++) {
+        ok = rfui_fmt_column(cols[cfg->row_keys[k]], reps, v->nrows, 0, v->nrows, &rfui_fmt_default,
+                             &v->labels, v->label_offsets + k * v->nrows, dim);
+    }
+    for (i64_t d = 0; ok && d < v->ncols; d++) {
+        v->label_offsets[v->nrows * v->config.nrow_keys + d] = (u32_t)v->labels.len;
+        i64_t rep = cg->rep[col_order[d]];
+        for (i32_t k = 0; ok && k < cfg->ncol_keys; k++) {
+            c8_t buf[RFUI_FMT_CELL_MAX];
+            b8_t dm;
+            i32_t n = rfui_fmt_cell(cols[cfg->col_keys[k]], rep, &rfui_fmt_default, buf, sizeof(buf), &dm);
+            if (k > 0) ok = labels_put(&v->labels, " / ", 3);
+            if (ok) ok = labels_put(&v->labels, buf, n);
+        }
+        if (ok && cfg->ncol_keys == 0) {
+            static const char* const agg_names[] = {"sum", "avg", "count", "last"};
+            ok = labels_put(&v->labels, agg_names[cfg->agg], (i64_t)strlen(agg_names[cfg->agg]));
+        }
+    }
+    if (!ok) goto done;
+    v->label_offsets[nlabels] = (u32_t)v->labels.len;
+
+    // Cells into rows: bucket by display column, then stable scatter by row
+    v->row_ptr = (i64_t*)calloc((size_t)(v->nrows + 1), sizeof(i64_t));
+    col_start = (i64_t*)calloc((size_t)(v->ncols + 1), sizeof(i64_t));
+    by_col = (i64_t*)malloc(sizeof(i64_t) * (size_t)(cells->n + 1));
+    ok = v->row_ptr && col_start && by_col;
+    if (!ok) goto done;
+
+    f64_t val;
+    for (i64_t i = 0; i < cells->n; i++) {
+        i64_t c = col_rank[cells->key[i] & 0xFFFFFFFFu];
+        if (c < 0 || !cell_value(cells, i, cfg->agg, &val)) continue;
+        col_start[c + 1]++;
+        v->row_ptr[row_rank[cells->key[i] >> 32] + 1]++;
+    }
+    for (i64_t c = 0; c < v->ncols; c++) col_start[c + 1] += col_start[c];
+    for (i64_t r = 0; r < v->nrows; r++) v->row_ptr[r + 1] += v->row_ptr[r];
+    i64_t ncells = v->row_ptr[v->nrows];
+
+    v->cell_col = (u32_t*)malloc(sizeof(u32_t) * (size_t)(ncells + 1));
+    v->cell_val = (f64_t*)malloc(sizeof(f64_t) * (size_t)(ncells + 1));
+    ok = v->cell_col && v->cell_val;
+    if (!ok) goto done;
+
+    for (i64_t i = 0; i < cells->n; i++) {
+        i64_t c = col_rank[cells->key[i] & 0xFFFFFFFFu];
+        if (c < 0 || !cell_value(cells, i, cfg->agg, &val)) continue;
+        by_col[col_start[c]++] = i;
+    }
+    // row_rank doubles as each row's fill position
+    for (i64_t r = 0; r < v->nrows; r++) row_rank[row_order[r]] = v->row_ptr[r];
+    for (i64_t j = 0; j < ncells; j++) {
+        i64_t i = by_col[j];
+        i64_t at = row_rank[cells->key[i] >> 32]++;
+        cell_value(cells, i, cfg->agg, &v->cell_val[at]);
+        v->cell_col[at] = (u32_t)col_rank[cells->key[i] & 0xFFFFFFFFu];
+    }
+
+done:
+    free(row_order);
+    free(col_order);
+    free(row_rank);
+    free(col_rank);
+    free(reps);
+    free(dim);
+    free(by_col);
+    free(col_start);
+    if (!ok) {
+        view_free(v);
+        return NULL;
+    }
+    return v;
+}
+
+static void run_pivot(rfui_pivot_job_t* job) {
+    obj_p vals = AS_LIST(job->data)[1];
+    obj_p* cols = AS_LIST(vals);
+    const rfui_pivot_config_t* cfg = &job->config;
+
+    // Columns the config reads, checked against this table
+    i32_t used[2 * RFUI_PIVOT_MAX_KEYS + 1];
+    i32_t nused = 0;
+    for (i32_t k = 0; k < cfg->nrow_keys; k++) used[nused++] = cfg->row_keys[k];
+    for (i32_t k = 0; k < cfg->ncol_keys; k++) used[nused++] = cfg->col_keys[k];
+    if (cfg->agg != RFUI_PIVOT_COUNT) used[nused++] = cfg->value;
+    if (nused == 0) return;
+    for (i32_t u = 0; u < nused; u++) {
+        if (used[u] < 0 || used[u] >= vals->len || !cols[used[u]]) return;
+        i8_t type = cols[used[u]]->type;
+        b8_t is_value = cfg->agg != RFUI_PIVOT_COUNT && u == nused - 1;
+        if (is_value ? !rfui_grid_pivot_value_supported(type) : !rfui_grid_pivot_key_supported(type)) return;
+    }
+    i64_t n = cols[used[0]]->len;
+
+    // Keep the folded groups only if the new data appends to the same columns
+    rfui_pivot_state_t* st = job->state;
+    b8_t append = config_equal(&st->config, cfg) && st->rows <= n;
+    u64_t hash[2 * RFUI_PIVOT_MAX_KEYS + 1];
+    for (i32_t u = 0; u < nused; u++) {
+        u64_t prefix;
+        hash[u] = rfui_grid_column_hash(cols[used[u]], st->rows, &prefix);
+        if (prefix != st->hash[u]) append = B8_FALSE;
+    }
+    if (!append) state_reset(st, cfg);
+
+    if (!fold_rows(job, cols, n)) return;
+    memcpy(st->hash, hash, sizeof(u64_t) * (size_t)nused);
+    job->view = build_view(job, cols, n);
+    job->ok = job->view != NULL;
+}
+
+static nil_t pivot_job(raw_p arg) {
+    rfui_pivot_job_t* job = (rfui_pivot_job_t*)arg;
+
+    i64_t trace_span = rfui_trace_begin();
+    run_pivot(job);
+    rfui_trace_end("grid_pivot", NULL, trace_span);
+}
+
+static void job_free(rfui_pivot_job_t* job) {
+    state_free(job->state);
+    view_free(job->view);
+    rfui_task_free(&job->task);
+    free(job);
+}
+
+// ============================================================================
+// Grid side (UI thread)
+// ============================================================================
+
+static void start_job(rfui_grid_pivot_t* p, obj_p table, i64_t version) {
+    p->version = version;
+    p->job_gen = p->config_gen;
+    if (!rfui_grid_pivot_valid(&p->config)) return;
+
+    rfui_pivot_job_t* job = (rfui_pivot_job_t*)calloc(1, sizeof(rfui_pivot_job_t));
+    if (!job) return;
+    job->data = table;
+    job->config = p->config;
+    job->state = p->state;
+    if (!job->state) {
+        job->state = (rfui_pivot_state_t*)calloc(1, sizeof(rfui_pivot_state_t));
+        if (!job->state) {
+            free(job);
+            return;
+        }
+        job->state->config.nrow_keys = -1;   // Matches no config: first job starts fresh
+    }
+    p->state = NULL;
+
+    p->job = job;
+    rfui_task_submit(&job->task, pivot_job, job, 1);
+}
+
+nil_t rfui_grid_pivot_update(rfui_grid_pivot_t* p, obj_p table, i64_t version) {
+    rfui_pivot_job_t* job = p->job;
+    if (job && rfui_task_done(&job->task)) {
+        p->job = NULL;
+        if (job->ok) {
+            if (p->job_gen == p->config_gen) {
+                view_free(p->view);
+                p->view = job->view;
+                job->view = NULL;
+            }
+            p->state = job->state;
+            job->state = NULL;
+        }
+        job_free(job);
+    }
+
+    if (p->job) {
+        // A config edit makes the running job's result useless
+        if (p->job_gen != p->config_gen) rfui_task_cancel(&p->job->task);
+        return;
+    }
+    if (p->version != version || p->job_gen != p->config_gen) {
+        start_job(p, table, version);
+    }
+}
+
+b8_t rfui_grid_pivot_busy(const rfui_grid_pivot_t* p) {
+    return p->job != NULL;
+}
+
+const c8_t* rfui_grid_pivot_row_label(const rfui_pivot_view_t* v, i64_t r, i32_t k, i32_t* len) {
+    i64_t i = k * v->nrows + r;
+    *len = (i32_t)(v->label_offsets[i + 1] - v->label_offsets[i]);
+    return v->labels.text + v->label_offsets[i];
+}
+
+const c8_t* rfui_grid_pivot_col_label(const rfui_pivot_view_t* v, i64_t c, i32_t* len) {
+    i64_t i = v->nrows * v->config.nrow_keys + c;
+    *len = (i32_t)(v->label_offsets[i + 1] - v->label_offsets[i]);
+    return v->labels.text + v->label_offsets[i];
+}
+
+b8_t rfui_grid_pivot_cell(const rfui_pivot_view_t* v, i64_t r, i64_t c, f64_t* value) {
+    i64_t lo = v->row_ptr[r];
+    i64_t hi = v->row_ptr[r + 1];
+    while (lo < hi) {
+        i64_t mid = lo + (hi - lo) / 2;
+        if (v->cell_col[mid] < (u32_t)c) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == v->row_ptr[r + 1] || v->cell_col[lo] != (u32_t)c) return B8_FALSE;
+    *value = v->cell_val[lo];
+    return B8_TRUE;
+}
+
+b8_t rfui_grid_pivot_reads(const rfui_grid_pivot_t* p, obj_p table) {
+    return p->job != NULL && p->job->data == table;
+}
+
+nil_t rfui_grid_pivot_free(rfui_grid_pivot_t* p) {
+    rfui_pivot_job_t* job = p->job;
+    if (job) {
+        rfui_task_wait(&job->task);
+        job_free(job);
+        p->job = NULL;
+    }
+    state_free(p->state);
+    p->state = NULL;
+    view_free(p->view);
+    p->view = NULL;
+    p->version = -1;
+}
+
+static i64_t groups_bytes(const groups_t* g) {
+    return g->cap * (i64_t)(sizeof(u64_t) * (size_t)(g->nk ? g->nk : 1) + sizeof(i64_t)) +
+           g->nslots * (i64_t)sizeof(i32_t);
+}
+
+i64_t rfui_grid_pivot_bytes(const rfui_grid_pivot_t* p) {
+    i64_t bytes = 0;
+    const rfui_pivot_state_t* st = p->state;
+    if (st) {
+        bytes += (i64_t)sizeof(*st) + groups_bytes(&st->row_groups) + groups_bytes(&st->col_groups) +
+                 st->cells.cap * (i64_t)(sizeof(u64_t) + 2 * sizeof(f64_t) + 2 * sizeof(i64_t)) +
+                 st->cells.nslots * (i64_t)sizeof(i32_t);
+    }
+    const rfui_pivot_view_t* v = p->view;
+    if (v) {
+        i64_t nlabels = v->nrows * v->config.nrow_keys + v->ncols;
+        bytes += (i64_t)sizeof(*v) + v->labels.cap + (nlabels + 1) * (i64_t)sizeof(u32_t) +
+                 (v->nrows + 1) * (i64_t)sizeof(i64_t) +
+                 v->row_ptr[v->nrows] * (i64_t)(sizeof(u32_t) + sizeof(f64_t));
+    }
+    return bytes;
+}
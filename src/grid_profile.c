@@ -0,0 +1,496 @@
+// src/grid_profile.c
+// Grid column profiler (worker pool)
+//
+// The column is read in chunks converted to f64 (NaN = null) plus a u64
+// distinct key per row. The min / max / sum / null pass over a chunk keeps
+// four independent lanes with no branches, so it vectorizes; HyperLogLog and
+// KLL then take the non-null values one at a time.
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/rfui/grid_profile.h"
+#include "../include/rfui/grid_sort.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/symbols.h"
+
+const f64_t rfui_profile_quantile_ranks[RFUI_PROFILE_QUANTILES] = {0.01, 0.25, 0.5, 0.75, 0.99};
+
+#define HLL_BITS 12
+#define HLL_M (1 << HLL_BITS)
+
+#define KLL_K 200                  // Top level capacity (~1% rank error)
+#define KLL_MIN_CAP 8
+#define KLL_MAX_LEVELS 40
+#define KLL_LEVEL_ITEMS (2 * KLL_K + 2)
+
+#define CHUNK 4096
+
+// KLL sketch: level h holds items of weight 2^h. A full level is sorted and
+// every other item (random offset) is promoted, halving it.
+typedef struct kll_t {
+    f64_t* items[KLL_MAX_LEVELS];
+    i32_t n[KLL_MAX_LEVELS];
+    i32_t nlevels;
+    u64_t rng;
+} kll_t;
+
+typedef struct rfui_profile_sketch_t {
+    i32_t col;
+    i8_t type;
+    i64_t rows;                    // Rows folded in
+    u64_t hash;                    // Fingerprint of those rows (append detection)
+    i64_t nulls;
+    f64_t min;
+    f64_t max;
+    f64_t sum;
+    u8_t hll[HLL_M];
+    kll_t kll;
+} rfui_profile_sketch_t;
+
+typedef struct rfui_profile_job_t {
+    // Inputs: data is kept alive by the grid until the job is adopted
+    obj_p data;
+    i32_t col;
+    rfui_profile_sketch_t* sketch; // Owned by the job while it runs
+
+    // Outputs
+    rfui_col_profile_t result;
+    b8_t ok;                       // False on failure or cancel (sketch is then stale)
+
+    rfui_task_t task;
+} rfui_profile_job_t;
+
+b8_t rfui_grid_profile_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+        case TYPE_I16: case TYPE_U8: case TYPE_B8: case TYPE_F64: case TYPE_SYMBOL:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+// ============================================================================
+// KLL
+// ============================================================================
+
+// Level 0 is a full-size buffer: compactions (sorts) stay rare on long columns
+static i32_t kll_cap(const kll_t* s, i32_t h) {
+    if (h == 0) return KLL_K;
+    f64_t c = KLL_K;
+    for (i32_t d = s->nlevels - 1 - h; d > 0 && c > KLL_MIN_CAP; d--) c *= 2.0 / 3.0;
+    return c > KLL_MIN_CAP ? (i32_t)c : KLL_MIN_CAP;
+}
+
+static b8_t kll_add_level(kll_t* s) {
+    if (s->nlevels == KLL_MAX_LEVELS) return B8_FALSE;
+    f64_t* items = (f64_t*)malloc(sizeof(f64_t) * KLL_LEVEL_ITEMS);
+    if (!items) return B8_FALSE;
+    s->items[s->nlevels] = items;
+    s->n[s->nlevels] = 0;
+    s->nlevels++;
+    return B8_TRUE;
+}
+
+static int f64_cmp(const void* a, const void* b) {
+    f64_t x = *(const f64_t*)a, y = *(const f64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static b8_t kll_compress(kll_t* s) {
+    for (i32_t h = 0; h < s->nlevels; h++) {
+        if (s->n[h] < kll_cap(s, h)) continue;
+        if (h + 1 == s->nlevels && !kll_add_level(s)) return B8_FALSE;
+
+        f64_t* items = s->items[h];
+        i32_t m = s->n[h];
+        qsort(items, m, sizeof(f64_t), f64_cmp);
+
+        // xorshift64: which half is promoted
+        s->rng ^= s->rng << 13;
+        s->rng ^= s->rng >> 7;
+        s->rng ^= s->rng << 17;
+
+        // An odd item out stays behind (the smallest)
+        i32_t keep = m & 1;
+        f64_t* up = s->items[h + 1];
+        for (i32_t i = keep + (i32_t)(s->rng & 1); i < m; i += 2) up[s->n[h + 1]++] = items[i];
+        s->n[h] = keep;
+    }
+    return B8_TRUE;
+}
+
+static b8_t kll_insert(kll_t* s, f64_t v) {
+    if (s->nlevels == 0 && !kll_add_level(s)) return B8_FALSE;
+    s->items[0][s->n[0]++] = v;
+    return s->n[0] < kll_cap(s, 0) || kll_compress(s);
+}
+
+static void kll_free(kll_t* s) {
+    for (i32_t h = 0; h < s->nlevels; h++) free(s->items[h]);
+    memset(s, 0, sizeof(*s));
+}
+
+typedef struct weighted_t {
+    f64_t v;
+    u64_t w;
+} weighted_t;
+
+static int weighted_cmp(const void* a, const void* b) {
+    return f64_cmp(&((const weighted_t*)a)->v, &((const weighted_t*)b)->v);
+}
+
+// All items with their weights, sorted by value. NULL if empty/OOM.
+static weighted_t* kll_sorted(const kll_t* s, i64_t* n, u64_t* total) {
+    i64_t m = 0;
+    for (i32_t h = 0; h < s->nlevels; h++) m += s->n[h];
+    *n = 0;
+    *total = 0;
+    if (m == 0) return NULL;
+
+    weighted_t* out = (weighted_t*)malloc(sizeof(weighted_t) * m);
+    if (!out) return NULL;
+    i64_t k = 0;
+    for (i32_t h = 0; h < s->nlevels; h++) {
+        for (i32_t i = 0; i < s->n[h]; i++) {
+            out[k].v = s->items[h][i];
+            out[k].w = (u64_t)1 << h;
+            *total += out[k].w;
+            k++;
+        }
+    }
+    qsort(out, m, sizeof(weighted_t), weighted_cmp);
+    *n = m;
+    return out;
+}
+
+// ============================================================================
+// HyperLogLog
+// ============================================================================
+
+static inline u64_t mix64(u64_t x) {
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+static inline void hll_add(u8_t* regs, u64_t key) {
+    u64_t h = mix64(key);
+    u32_t idx = (u32_t)(h >> (64 - HLL_BITS));
+    u8_t rank = (u8_t)(__builtin_clzll((h << HLL_BITS) | (1ULL << (HLL_BITS - 1))) + 1);
+    if (rank > regs[idx]) regs[idx] = rank;
+}
+
+static f64_t hll_estimate(const u8_t* regs) {
+    f64_t sum = 0.0;
+    i32_t zeros = 0;
+    for (i32_t i = 0; i < HLL_M; i++) {
+        sum += ldexp(1.0, -regs[i]);
+        zeros += regs[i] == 0;
+    }
+    f64_t m = HLL_M;
+    f64_t e = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+    // Small range: linear counting is more accurate
+    if (e <= 2.5 * m && zeros > 0) e = m * log(m / zeros);
+    return e;
+}
+
+// ============================================================================
+// Folding
+// ============================================================================
+
+static void sketch_reset(rfui_profile_sketch_t* sk, i32_t col, i8_t type) {
+    kll_free(&sk->kll);
+    memset(sk, 0, sizeof(*sk));
+    sk->col = col;
+    sk->type = type;
+    sk->min = HUGE_VAL;
+    sk->max = -HUGE_VAL;
+    sk->kll.rng = 0x9E3779B97F4A7C15ULL;
+}
+
+static void sketch_free(rfui_profile_sketch_t* sk) {
+    if (!sk) return;
+    kll_free(&sk->kll);
+    free(sk);
+}
+
+#define LOAD_CHUNK(T, null_expr, key_expr) { \
+    const T* a = (const T*)AS_U8(col) + start; \
+    for (i64_t i = 0; i < len; i++) { \
+        T x = a[i]; \
+        vals[i] = (null_expr) ? NAN : (f64_t)x; \
+        keys[i] = (u64_t)(key_expr); \
+    } \
+    break; \
+}
+
+// Rows [start, start + len) -> values (NaN = null) and distinct keys.
+// Symbols only carry null-ness in vals (0 or NaN).
+static void load_chunk(obj_p col, i64_t start, i64_t len, f64_t* vals, u64_t* keys) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: LOAD_CHUNK(i64_t, x == NULL_I64, x)
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: LOAD_CHUNK(i32_t, x == NULL_I32, (i64_t)x)
+        case TYPE_I16: LOAD_CHUNK(i16_t, 0, (i64_t)x)
+        case TYPE_U8: case TYPE_B8: LOAD_CHUNK(u8_t, 0, x)
+        case TYPE_F64: {
+            const f64_t* a = AS_F64(col) + start;
+            for (i64_t i = 0; i < len; i++) {
+                f64_t x = a[i] + 0.0;  // -0.0 -> 0.0 for the distinct key
+                vals[i] = x;
+                memcpy(&keys[i], &x, sizeof(u64_t));
+            }
+            break;
+        }
+        case TYPE_SYMBOL: {
+            // Null symbols have no string; runs of one symbol hit the memo
+            const i64_t* a = AS_SYMBOL(col) + start;
+            i64_t last_id = 0;
+            b8_t last_null = B8_TRUE;
+            b8_t have_last = B8_FALSE;
+            for (i64_t i = 0; i < len; i++) {
+                if (!have_last || a[i] != last_id) {
+                    const char* s = rfui_symbols_get(a[i]);
+                    last_id = a[i];
+                    last_null = !s || !s[0];
+                    have_last = B8_TRUE;
+                }
+                vals[i] = last_null ? NAN : 0.0;
+                keys[i] = (u64_t)a[i];
+            }
+            break;
+        }
+        default:
+            for (i64_t i = 0; i < len; i++) vals[i] = NAN;
+            memset(keys, 0, sizeof(u64_t) * len);
+            break;
+    }
+}
+
+// Min / max / sum / nulls over one chunk: four branchless lanes
+static void fold_stats(rfui_profile_sketch_t* sk, const f64_t* v, i64_t n) {
+    f64_t mn[4] = {HUGE_VAL, HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    f64_t mx[4] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    f64_t sm[4] = {0.0, 0.0, 0.0, 0.0};
+    i64_t nl[4] = {0, 0, 0, 0};
+
+    i64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (i32_t l = 0; l < 4; l++) {
+            f64_t x = v[i + l];
+            i64_t null = x != x;
+            nl[l] += null;
+            sm[l] += null ? 0.0 : x;
+            mn[l] = x < mn[l] ? x : mn[l];  // NaN compares false: skipped
+            mx[l] = x > mx[l] ? x : mx[l];
+        }
+    }
+    for (; i < n; i++) {
+        f64_t x = v[i];
+        i64_t null = x != x;
+        nl[0] += null;
+        sm[0] += null ? 0.0 : x;
+        mn[0] = x < mn[0] ? x : mn[0];
+        mx[0] = x > mx[0] ? x : mx[0];
+    }
+
+    for (i32_t l = 0; l < 4; l++) {
+        sk->nulls += nl[l];
+        sk->sum += sm[l];
+        if (mn[l] < sk->min) sk->min = mn[l];
+        if (mx[l] > sk->max) sk->max = mx[l];
+    }
+}
+
+// Fold rows [sk->rows, n) into the sketch
+static b8_t fold_rows(rfui_profile_job_t* job, obj_p col, i64_t n) {
+    rfui_profile_sketch_t* sk = job->sketch;
+    b8_t numeric = col->type != TYPE_SYMBOL;
+    f64_t* vals = (f64_t*)malloc(sizeof(f64_t) * CHUNK);
+    u64_t* keys = (u64_t*)malloc(sizeof(u64_t) * CHUNK);
+    b8_t ok = vals && keys;
+
+    for (i64_t start = sk->rows; ok && start < n; start += CHUNK) {
+        if (rfui_task_cancelled(&job->task)) {
+            ok = B8_FALSE;
+            break;
+        }
+        i64_t len = n - start < CHUNK ? n - start : CHUNK;
+        load_chunk(col, start, len, vals, keys);
+        fold_stats(sk, vals, len);
+        for (i64_t i = 0; i < len && ok; i++) {
+            if (vals[i] != vals[i]) continue;
+            hll_add(sk->hll, keys[i]);
+            if (numeric) ok = kll_insert(&sk->kll, vals[i]);
+        }
+    }
+
+    free(vals);
+    free(keys);
+    return ok;
+}
+
+static void sketch_result(const rfui_profile_sketch_t* sk, rfui_col_profile_t* r) {
+    memset(r, 0, sizeof(*r));
+    r->type = sk->type;
+    r->rows = sk->rows;
+    r->nulls = sk->nulls;
+    r->distinct = hll_estimate(sk->hll);
+
+    i64_t count = sk->rows - sk->nulls;
+    r->numeric = sk->type != TYPE_SYMBOL && count > 0;
+    if (!r->numeric) return;
+
+    r->min = sk->min;
+    r->max = sk->max;
+    r->sum = sk->sum;
+    r->mean = sk->sum / (f64_t)count;
+
+    i64_t m;
+    u64_t total;
+    weighted_t* items = kll_sorted(&sk->kll, &m, &total);
+    if (!items) return;
+
+    i64_t i = 0;
+    u64_t cum = 0;
+    for (i32_t q = 0; q < RFUI_PROFILE_QUANTILES; q++) {
+        f64_t target = rfui_profile_quantile_ranks[q] * (f64_t)total;
+        while (i < m - 1 && (f64_t)(cum + items[i].w) < target) cum += items[i++].w;
+        r->quantiles[q] = items[i].v;
+    }
+
+    f64_t span = r->max - r->min;
+    for (i64_t k = 0; k < m; k++) {
+        i32_t bin = span > 0.0 ? (i32_t)((items[k].v - r->min) / span * RFUI_PROFILE_BINS) : 0;
+        if (bin < 0) bin = 0;
+        if (bin >= RFUI_PROFILE_BINS) bin = RFUI_PROFILE_BINS - 1;
+        r->hist[bin] += (float)items[k].w;
+    }
+    for (i32_t b = 0; b < RFUI_PROFILE_BINS; b++) r->hist[b] /= (float)total;
+    free(items);
+}
+
+static void run_profile(rfui_profile_job_t* job) {
+    obj_p col = AS_LIST(AS_LIST(job->data)[1])[job->col];
+    rfui_profile_sketch_t* sk = job->sketch;
+    i64_t n = col->len;
+
+    // Keep the folded state only if the new data appends to the same column
+    u64_t prefix;
+    u64_t hash = rfui_grid_column_hash(col, sk->rows, &prefix);
+    if (sk->col != job->col || sk->type != col->type || sk->rows > n || prefix != sk->hash) {
+        sketch_reset(sk, job->col, col->type);
+    }
+
+    if (!fold_rows(job, col, n)) return;
+    sk->rows = n;
+    sk->hash = hash;
+    sketch_result(sk, &job->result);
+    job->ok = B8_TRUE;
+}
+
+static nil_t profile_job(raw_p arg) {
+    rfui_profile_job_t* job = (rfui_profile_job_t*)arg;
+
+    i64_t trace_span = rfui_trace_begin();
+    run_profile(job);
+    rfui_trace_end("grid_profile", NULL, trace_span);
+}
+
+static void job_free(rfui_profile_job_t* job) {
+    sketch_free(job->sketch);
+    rfui_task_free(&job->task);
+    free(job);
+}
+
+// ============================================================================
+// Grid side (UI thread)
+// ============================================================================
+
+static void start_job(rfui_grid_profile_t* p, obj_p table, i64_t version) {
+    p->version = version;
+    p->last_col = p->col;
+
+    obj_p vals = AS_LIST(table)[1];
+    if (p->col >= vals->len || !rfui_grid_profile_supported(AS_LIST(vals)[p->col]->type)) {
+        p->ready = B8_FALSE;
+        return;
+    }
+
+    rfui_profile_job_t* job = (rfui_profile_job_t*)calloc(1, sizeof(rfui_profile_job_t));
+    if (!job) return;
+    job->data = table;
+    job->col = p->col;
+    job->sketch = p->sketch;
+    if (!job->sketch) {
+        job->sketch = (rfui_profile_sketch_t*)calloc(1, sizeof(rfui_profile_sketch_t));
+        if (!job->sketch) {
+            free(job);
+            return;
+        }
+        sketch_reset(job->sketch, -1, 0);
+    }
+    p->sketch = NULL;
+
+    p->job = job;
+    rfui_task_submit(&job->task, profile_job, job, 1);
+}
+
+nil_t rfui_grid_profile_open(rfui_grid_profile_t* p, i32_t col) {
+    if (col == p->col) return;
+    if (col < 0) {
+        rfui_grid_profile_free(p);
+        return;
+    }
+    p->col = col;
+    p->ready = B8_FALSE;
+}
+
+nil_t rfui_grid_profile_update(rfui_grid_profile_t* p, obj_p table, i64_t version) {
+    rfui_profile_job_t* job = p->job;
+    if (job && rfui_task_done(&job->task)) {
+        p->job = NULL;
+        if (job->ok) {
+            if (job->col == p->col) {
+                p->result = job->result;
+                p->ready = B8_TRUE;
+            }
+            p->sketch = job->sketch;
+            job->sketch = NULL;
+        }
+        job_free(job);
+    }
+
+    if (p->job || p->col < 0) return;
+    if (p->version != version || p->last_col != p->col) {
+        start_job(p, table, version);
+    }
+}
+
+b8_t rfui_grid_profile_reads(const rfui_grid_profile_t* p, obj_p table) {
+    return p->job != NULL && p->job->data == table;
+}
+
+nil_t rfui_grid_profile_free(rfui_grid_profile_t* p) {
+    rfui_profile_job_t* job = p->job;
+    if (job) {
+        rfui_task_wait(&job->task);
+        job_free(job);
+        p->job = NULL;
+    }
+    sketch_free(p->sketch);
+    p->sketch = NULL;
+    p->col = -1;
+    p->last_col = -1;
+    p->ready = B8_FALSE;
+}
+
+i64_t rfui_grid_profile_bytes(const rfui_grid_profile_t* p) {
+    if (!p->sketch) return 0;
+    return (i64_t)sizeof(rfui_profile_sketch_t) +
+           p->sketch->kll.nlevels * (i64_t)(sizeof(f64_t) * KLL_LEVEL_ITEMS);
+}
@@ -6,6 +6,8 @@
 #include <stdlib.h>
 
 #include "imgui.h"
+#include "imgui_internal.h"   // Column display order for exports
+#include "ImGuiFileDialog.h"
 #include "../include/rfui/icons.h"
 
 // Make rayforce headers C++ compatible by redefining _Static_assert
@@ -13,64 +15,243 @@
 
 extern "C" {
 #include "../include/rfui/grid_renderer.h"
+#include "../include/rfui/grid_rules.h"
+#include "../include/rfui/grid_sort.h"
+#include "../include/rfui/grid_filter.h"
+#include "../include/rfui/grid_select.h"
+#include "../include/rfui/grid_profile.h"
+#include "../include/rfui/grid_columns.h"
+#include "../include/rfui/grid_flash.h"
+#include "../include/rfui/grid_export.h"
+#include "../include/rfui/grid_spark.h"
+#include "../include/rfui/grid_pivot.h"
+#include "../include/rfui/grid_group.h"
+#include "../include/rfui/grid_find.h"
+#include "../include/rfui/format.h"
+#include "../include/rfui/ui.h"
 #include "../include/rfui/widget.h"
 #include "../include/rfui/context.h"
 #include "../include/rfui/message.h"
 #include "../include/rfui/queue.h"
+#include "../include/rfui/symbols.h"
 #include "../deps/rayforce/core/poll.h"
 
 // Global context declared in main.c
 extern rfui_ctx_t* g_ctx;
 }
 
-#define MAX_COLOR_RULES 8
-
-typedef struct color_rule_t {
-    char column[64];     // Column name to match
-    char value[64];      // Value to match (string comparison)
-    ImVec4 color;        // Text color when matched
-    bool enabled;
-} color_rule_t;
+// Replaced tables parked until no background job reads them. Each job kind
+// (sort, profile, export, pivot, group, find) reads one table, so six slots
+// always suffice.
+#define GRID_RETIRED_MAX 6
+
+// How long an export's outcome stays next to the toolbar
+#define GRID_EXPORT_STATUS_SECONDS 4.0
+
+// Formatted cell strings for a window of rows around the visible ones.
+// Rebuilt when the data version changes or the view leaves the window, so
+// steady frames only call TextUnformatted. Cells are stored column by column
+// (one rfui_fmt_column batch each). List columns also get sparkline points
+// for their numeric vectors, sized to the column's pixel width.
+typedef struct cell_cache_t {
+    i64_t version;     // widget->version the strings belong to (-1 = empty)
+    i64_t order;       // Row layout (sort + filter + number format generation)
+    i64_t row_start;   // First cached display row
+    i64_t row_count;
+    i64_t ncols;
+    u32_t* offsets;    // ncols * row_count + 1 offsets into text
+    u8_t* disabled;    // Per cell: draw dimmed (null, nested, unknown type)
+    rfui_fmt_buf_t text;
+    u32_t* spark_offsets;  // ncols * row_count + 1 offsets into spark
+    rfui_spark_buf_t spark;
+    i64_t col_idx[RFUI_GRID_COLUMN_WINDOW];   // Data column of each cached column
+    i32_t spark_px[RFUI_GRID_COLUMN_WINDOW];  // Sparkline width per cached column (0 = none)
+    i64_t cells_cap;
+
+    // Upserts since the window was built: only these data rows need formatting
+    i64_t patch_base;      // Version the rows were written on top of (-1 = none)
+    i64_t patch_version;   // Version they lead to
+    i64_t* patch_rows;     // Data rows written (may repeat)
+    i64_t npatch;
+    i64_t patch_cap;
+    rfui_fmt_buf_t spare;  // Text and sparklines being spliced (swapped in after)
+    rfui_spark_buf_t spare_spark;
+} cell_cache_t;
 
 // UI state for grid selection (stored in widget->ui_state)
 typedef struct grid_ui_state_t {
-    int selected_row;  // -1 = no selection
-    color_rule_t color_rules[MAX_COLOR_RULES];
+    rfui_grid_rule_t* rules;      // Conditional formatting, first match wins
     int num_rules;
+    int rules_cap;
+    i64_t rules_version;          // Bumped on any rule edit
     bool settings_open;
+    cell_cache_t cache;
+    rfui_grid_styles_t styles;    // Compiled rules: per-cell style index
+    rfui_grid_sort_t sort;        // Header sort: row permutation
+    rfui_grid_filter_t filter;    // Filter row: selection vector
+    rfui_grid_select_t select;    // Selected data rows (sent to on-select)
+    rfui_grid_profile_t profile;  // Column profiler popup
+    rfui_grid_columns_t columns;  // Widths/offsets for windowed (wide) grids
+    rfui_grid_flash_t flash;      // Changed cells, diffed when render_data is replaced
+    rfui_fmt_t fmt;               // Number format (decimals, thousands)
+    i64_t fmt_gen;                // Bumped on any format edit
+    rfui_grid_export_t exporter;  // CSV / TSV / clipboard export job
+    rfui_grid_pivot_t pivot;      // Crosstab drawn instead of the rows when enabled
+    rfui_grid_group_t group;      // Group tree drawn instead of the rows when enabled
+    rfui_grid_find_t find;        // Ctrl+F scan over every cell
+    bool dense;                   // Rows drawn straight into the draw list (no table)
+    i32_t find_step;              // Move to the next (1) / previous (-1) match once rows are known
+    bool export_pending;          // Start export_kind once the view is known this frame
+    rfui_export_kind_t export_kind;
+    rfui_export_kind_t dialog_kind;   // File kind the save dialog was opened for
+    char export_path[256];
+    obj_p retired[GRID_RETIRED_MAX];  // Old render_data still read by a job
+    i64_t retired_bytes[GRID_RETIRED_MAX];
+    u8_t* hidden;                 // Per column: hidden from the header menu or the Columns popup
+    i64_t hidden_n;               // Columns hidden covers
+    i64_t hidden_gen;             // Bumped on any hide / show
+    bool hidden_push;             // hidden edited outside the table: apply it to the table's columns
+    i64_t* hidden_sent;           // Hidden column names last sent (symbol ids)
+    i64_t nhidden_sent;
+    char columns_filter[64];      // Columns popup name filter
 } grid_ui_state_t;
 
-// Helper to send MSG_SET_POST_QUERY to Rayforce thread
-static void send_post_query(rfui_widget_t* widget, const char* expr) {
-    if (!g_ctx || !widget) return;
+// Send the selection to the widget's on-select callback. At most one
+// MSG_SELECT per widget is in flight: changes made meanwhile stay dirty and
+// go out once the Rayforce thread clears select_busy, so bursts (arrow-key
+// scrolling) collapse into the latest selection.
+static void send_select(rfui_widget_t* widget, rfui_grid_select_t* sel) {
+    if (!sel->dirty || !g_ctx) return;
+    if (!widget->on_select) {
+        sel->dirty = B8_FALSE;
+        return;
+    }
+    if (__atomic_load_n(&widget->select_busy, __ATOMIC_ACQUIRE)) return;
 
-    // Allocate message
-    rfui_ui_msg_t* msg = (rfui_ui_msg_t*)malloc(sizeof(rfui_ui_msg_t));
+    rfui_ui_msg_t* msg = (rfui_ui_msg_t*)calloc(1, sizeof(rfui_ui_msg_t));
     if (!msg) return;
+    i64_t n = 0;
+    msg->rows = rfui_grid_select_rows(sel, &n);
+    if (n < sel->count) {
+        // Out of memory: retry next frame
+        free(msg);
+        return;
+    }
+    msg->type = RFUI_MSG_SELECT;
+    msg->widget = widget;
+    msg->bytes = n;
 
-    // Duplicate expression string
-    char* expr_copy = nullptr;
-    if (expr) {
-        size_t len = strlen(expr);
-        expr_copy = (char*)malloc(len + 1);
-        if (!expr_copy) {
-            free(msg);
-            return;
+    __atomic_store_n(&widget->select_busy, 1, __ATOMIC_RELEASE);
+    if (!rfui_queue_push(g_ctx->ui_to_ray, msg)) {
+        __atomic_store_n(&widget->select_busy, 0, __ATOMIC_RELEASE);
+        free(msg->rows);
+        free(msg);
+        return;
+    }
+    sel->dirty = B8_FALSE;
+
+    // Wake Rayforce thread
+    poll_waker_p waker = rfui_ctx_get_waker(g_ctx);
+    if (waker) {
+        poll_waker_wake(waker);
+    }
+}
+
+// Whether a column feeds a filter, a sort or group key, the flash alignment
+// or the profiler, so it must keep its values while hidden
+static bool column_in_use(const grid_ui_state_t* s, i64_t col) {
+    if (col < s->filter.ncols && s->filter.cols[col].text[0]) return true;
+    for (i32_t k = 0; k < s->sort.nkeys; k++) {
+        if (s->sort.keys[k].col == col) return true;
+    }
+    if (s->flash.key_col == col || s->profile.col == col || s->pivot.config.value == col) return true;
+    for (i32_t k = 0; k < s->pivot.config.nrow_keys; k++) {
+        if (s->pivot.config.row_keys[k] == col) return true;
+    }
+    for (i32_t k = 0; k < s->pivot.config.ncol_keys; k++) {
+        if (s->pivot.config.col_keys[k] == col) return true;
+    }
+    for (i32_t k = 0; k < s->group.nkeys; k++) {
+        if (s->group.key_cols[k] == col) return true;
+    }
+    return false;
+}
+
+static bool column_hidden(const grid_ui_state_t* s, i64_t col) {
+    return s && col < s->hidden_n && s->hidden[col];
+}
+
+// Size the hidden map to the data. A new column count starts with every
+// column shown (a plain table then reads its own menu state back).
+static void hidden_resize(grid_ui_state_t* s, i64_t ncols) {
+    if (s->hidden_n == ncols && s->hidden) return;
+    free(s->hidden);
+    s->hidden = (u8_t*)calloc((size_t)ncols, 1);
+    s->hidden_n = s->hidden ? ncols : 0;
+    s->hidden_gen++;
+    s->hidden_push = false;
+}
+
+// Keep the hidden map and a plain table's header menu in step: edits from
+// the Columns popup are applied to the table (visible next frame), menu edits
+// are read back. Call inside the grid table after the headers.
+static void hidden_sync_table(grid_ui_state_t* s, i64_t ncols) {
+    for (i64_t i = 0; i < ncols && i < s->hidden_n; i++) {
+        if (s->hidden_push) {
+            ImGui::TableSetColumnEnabled((int)i, !s->hidden[i]);
+            continue;
+        }
+        u8_t off = (ImGui::TableGetColumnFlags((int)i) & ImGuiTableColumnFlags_IsEnabled) ? 0 : 1;
+        if (s->hidden[i] != off) {
+            s->hidden[i] = off;
+            s->hidden_gen++;
         }
-        memcpy(expr_copy, expr, len + 1);
     }
+    s->hidden_push = false;
+}
 
-    msg->type = RFUI_MSG_SET_POST_QUERY;
-    msg->expr = expr_copy;
-    msg->obj = nullptr;
-    msg->widget = widget;
+// Send the names of the hidden columns (across the whole width, in every
+// mode) that are not in use whenever they change, so later draws ship those
+// columns blank
+static void send_hidden(rfui_widget_t* widget, grid_ui_state_t* s, obj_p keys) {
+    if (!g_ctx) return;
+    i64_t n = 0;
+    bool same = true;
+    for (i64_t i = 0; i < s->hidden_n && i < keys->len; i++) {
+        if (!s->hidden[i] || column_in_use(s, i)) continue;
+        if (n >= s->nhidden_sent || s->hidden_sent[n] != AS_SYMBOL(keys)[i]) same = false;
+        n++;
+    }
+    if (same && n == s->nhidden_sent) return;
 
-    // Push to queue
+    rfui_ui_msg_t* msg = (rfui_ui_msg_t*)calloc(1, sizeof(rfui_ui_msg_t));
+    i64_t* sent = (i64_t*)malloc(sizeof(i64_t) * (size_t)(n ? n : 1));
+    i64_t* kept = (i64_t*)malloc(sizeof(i64_t) * (size_t)(n ? n : 1));
+    if (!msg || !sent || !kept) {
+        // Out of memory: retry next frame
+        free(msg);
+        free(sent);
+        free(kept);
+        return;
+    }
+    n = 0;
+    for (i64_t i = 0; i < s->hidden_n && i < keys->len; i++) {
+        if (s->hidden[i] && !column_in_use(s, i)) sent[n++] = AS_SYMBOL(keys)[i];
+    }
+    memcpy(kept, sent, sizeof(i64_t) * (size_t)n);
+    msg->type = RFUI_MSG_SET_HIDDEN;
+    msg->widget = widget;
+    msg->rows = sent;
+    msg->bytes = n;
     if (!rfui_queue_push(g_ctx->ui_to_ray, msg)) {
-        if (expr_copy) free(expr_copy);
+        free(sent);
+        free(kept);
         free(msg);
         return;
     }
+    free(s->hidden_sent);
+    s->hidden_sent = kept;
+    s->nhidden_sent = n;
 
     // Wake Rayforce thread
     poll_waker_p waker = rfui_ctx_get_waker(g_ctx);
@@ -79,152 +260,895 @@ static void send_post_query(rfui_widget_t* widget, const char* expr) {
     }
 }
 
-// Build a filter expression for the selected row
-// Expression: {[x] (take 1 (drop ROW_INDEX x))}
-// This creates a lambda that takes data and returns just the selected row
-static char* build_row_filter_expr(int row_index) {
-    // Max length: "{[x] (take 1 (drop 999999999 x))}" = ~40 chars
-    char* buf = (char*)malloc(64);
-    if (!buf) return nullptr;
-    snprintf(buf, 64, "{[x] (take 1 (drop %d x))}", row_index);
-    return buf;
+// Row click (or keyboard move): plain replaces the selection, Ctrl toggles,
+// Shift extends from the anchor. Clicking the only selected row deselects it.
+static void select_click(rfui_grid_select_t* sel, i64_t row, i64_t data_row,
+                         const u32_t* rows, i64_t rows_n, i64_t display_rows) {
+    const ImGuiIO& io = ImGui::GetIO();
+    if (sel->anchor >= display_rows) sel->anchor = display_rows - 1;
+    if (io.KeyShift && sel->anchor >= 0) {
+        if (!io.KeyCtrl) rfui_grid_select_clear(sel);
+        rfui_grid_select_range(sel, sel->anchor, row, rows, rows_n);
+        return;
+    }
+    if (io.KeyCtrl) {
+        rfui_grid_select_set(sel, data_row, !rfui_grid_select_has(sel, data_row));
+    } else if (sel->count == 1 && rfui_grid_select_has(sel, data_row)) {
+        rfui_grid_select_clear(sel);
+    } else {
+        rfui_grid_select_clear(sel);
+        rfui_grid_select_set(sel, data_row, B8_TRUE);
+    }
+    sel->anchor = row;
+}
+
+// Whether a background job still reads table
+static bool jobs_read(const grid_ui_state_t* state, obj_p table) {
+    return rfui_grid_sort_reads(&state->sort, table) || rfui_grid_profile_reads(&state->profile, table) ||
+           rfui_grid_export_reads(&state->exporter, table) || rfui_grid_pivot_reads(&state->pivot, table) ||
+           rfui_grid_group_reads(&state->group, table) || rfui_grid_find_reads(&state->find, table);
+}
+
+// Hand parked tables back for drop once their jobs have been adopted
+static void sweep_retired(grid_ui_state_t* state) {
+    for (int i = 0; i < GRID_RETIRED_MAX; i++) {
+        if (state->retired[i] && !jobs_read(state, state->retired[i])) {
+            rfui_ui_queue_drop(state->retired[i], state->retired_bytes[i]);
+            state->retired[i] = nullptr;
+        }
+    }
 }
 
-// Helper function to render a single cell based on column type
-static void render_cell(obj_p col, i64_t row) {
-    if (col == nullptr || row < 0 || row >= col->len) {
-        ImGui::Text("?");
+// Start the pending export from the view as drawn: sort / filter rows and
+// the visible columns in display order (called inside the grid table)
+static void start_export(grid_ui_state_t* state, obj_p table, i64_t ncols, bool windowed,
+                         const u32_t* rows, i64_t rows_n, i64_t display_rows) {
+    state->export_pending = false;
+    i32_t* cols = (i32_t*)malloc(sizeof(i32_t) * (size_t)ncols);
+    if (!cols) return;
+    i32_t n = 0;
+    ImGuiTable* t = ImGui::GetCurrentTable();
+    for (i64_t order = 0; order < ncols; order++) {
+        int c = (int)order;
+        if (!windowed && t) {
+            c = t->DisplayOrderToIndex[order];
+            if (!(ImGui::TableGetColumnFlags(c) & ImGuiTableColumnFlags_IsEnabled)) continue;
+        } else if (column_hidden(state, c)) {
+            continue;
+        }
+        cols[n++] = c;
+    }
+
+    rfui_export_view_t view = {};
+    view.table = table;
+    view.rows = rows;
+    view.rows_n = rows_n;
+    view.display_rows = display_rows;
+    view.cols = cols;
+    view.ncols = n;
+    if (state->export_kind == RFUI_EXPORT_CLIPBOARD) {
+        view.only = state->select.bits;
+        view.only_n = state->select.nrows;
+    }
+    rfui_grid_export_start(&state->exporter, &view, state->export_kind, state->export_path);
+    free(cols);
+}
+
+// Column picker over the columns accepted by supported; returns true when
+// *col changed (-1 = none)
+static bool column_combo(const char* label, i32_t* col, obj_p keys, obj_p vals,
+                               b8_t (*supported)(i8_t)) {
+    const char* current = *col >= 0 && *col < keys->len ? rfui_symbols_get(AS_SYMBOL(keys)[*col]) : nullptr;
+    bool changed = false;
+    ImGui::SetNextItemWidth(160.0f);
+    if (ImGui::BeginCombo(label, current ? current : "(none)")) {
+        if (ImGui::Selectable("(none)", *col < 0)) {
+            changed = *col >= 0;
+            *col = -1;
+        }
+        for (i64_t c = 0; c < vals->len && c < keys->len; c++) {
+            obj_p v = AS_LIST(vals)[c];
+            if (!v || !supported(v->type)) continue;
+            const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
+            ImGui::PushID((int)c);
+            if (ImGui::Selectable(name ? name : "<invalid>", *col == c)) {
+                changed = *col != c;
+                *col = (i32_t)c;
+            }
+            ImGui::PopID();
+        }
+        ImGui::EndCombo();
+    }
+    return changed;
+}
+
+// Key list editor: one combo per key plus an empty one to add another (up
+// to max); picking (none) removes a key
+static bool keys_edit(const char* label, i32_t* key_cols, i32_t* nkeys, i32_t max, obj_p keys, obj_p vals,
+                      b8_t (*supported)(i8_t)) {
+    bool changed = false;
+    for (i32_t k = 0; k <= *nkeys && k < max; k++) {
+        char id[48];
+        snprintf(id, sizeof(id), "%s##%s%d", k == 0 ? label : "", label, (int)k);
+        i32_t col = k < *nkeys ? key_cols[k] : -1;
+        if (!column_combo(id, &col, keys, vals, supported)) continue;
+        changed = true;
+        if (col >= 0) {
+            key_cols[k] = col;
+            if (k == *nkeys) (*nkeys)++;
+        } else if (k < *nkeys) {
+            for (i32_t j = k; j + 1 < *nkeys; j++) key_cols[j] = key_cols[j + 1];
+            (*nkeys)--;
+        }
+    }
+    return changed;
+}
+
+// Columns popup body: a name filter, Show all, and a checkbox per matching
+// column. The list is clipped, so grids of any width list every column.
+static void columns_edit(grid_ui_state_t* s, obj_p keys) {
+    ImGui::SetNextItemWidth(200.0f);
+    ImGui::InputTextWithHint("##columns_filter", ICON_MAGNIFYING_GLASS " Filter", s->columns_filter,
+                             sizeof(s->columns_filter));
+    ImGui::SameLine();
+    if (ImGui::SmallButton("Show all") && s->hidden) {
+        memset(s->hidden, 0, (size_t)s->hidden_n);
+        s->hidden_gen++;
+        s->hidden_push = true;
+    }
+    ImGui::Separator();
+
+    i64_t* match = (i64_t*)malloc(sizeof(i64_t) * (size_t)(s->hidden_n ? s->hidden_n : 1));
+    if (!match) {
+        ImGui::TextDisabled("Out of memory");
+        return;
+    }
+    i64_t n = 0;
+    for (i64_t c = 0; c < s->hidden_n; c++) {
+        const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
+        if (!s->columns_filter[0] || (name && ImStristr(name, nullptr, s->columns_filter, nullptr))) match[n++] = c;
+    }
+    if (n == 0) {
+        ImGui::TextDisabled("No columns");
+        free(match);
         return;
     }
 
-    switch (col->type) {
-        case TYPE_I64:
-            ImGui::Text("%lld", (long long)AS_I64(col)[row]);
-            break;
-        case TYPE_I32:
-            ImGui::Text("%d", AS_I32(col)[row]);
-            break;
-        case TYPE_I16:
-            ImGui::Text("%d", (int)AS_I16(col)[row]);
-            break;
-        case TYPE_F64: {
-            f64_t val = AS_F64(col)[row];
-            // Check for NaN (null value in Rayforce)
-            if (val != val) {
-                ImGui::TextDisabled("null");
-            } else {
-                ImGui::Text("%.6g", val);
+    float height = ImGui::GetFrameHeightWithSpacing() * (float)(n < 16 ? n : 16);
+    if (ImGui::BeginChild("##columns", ImVec2(260.0f, height))) {
+        ImGuiListClipper clipper;
+        clipper.Begin((int)n);
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                i64_t c = match[i];
+                const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
+                bool shown = !s->hidden[c];
+                ImGui::PushID((int)c);
+                if (ImGui::Checkbox(name ? name : "<invalid>", &shown)) {
+                    s->hidden[c] = shown ? 0 : 1;
+                    s->hidden_gen++;
+                    s->hidden_push = true;
+                }
+                ImGui::PopID();
             }
-            break;
         }
-        case TYPE_SYMBOL: {
-            i64_t sid = AS_SYMBOL(col)[row];
-            const char* str = str_from_symbol(sid);
-            if (str) {
-                ImGui::Text("%s", str);
-            } else {
-                ImGui::TextDisabled("null");
+    }
+    ImGui::EndChild();
+    free(match);
+}
+
+// Pivot table in place of the rows: row key columns frozen on the left, one
+// column per column group, values formatted like the grid's cells
+static void draw_pivot(const rfui_grid_pivot_t* p, obj_p keys, const rfui_fmt_t* fmt) {
+    const rfui_pivot_view_t* v = p->view;
+    if (!rfui_grid_pivot_valid(&p->config)) {
+        ImGui::TextDisabled("Choose a row key and a value in " ICON_TABLE " Pivot");
+        return;
+    }
+    if (!v) {
+        ImGui::TextDisabled(rfui_grid_pivot_busy(p) ? "Computing pivot..." : "Pivot unavailable");
+        return;
+    }
+    if (v->ncols < v->ncols_total) {
+        ImGui::TextDisabled("Showing %lld of %lld columns", (long long)v->ncols, (long long)v->ncols_total);
+    }
+
+    i32_t nkeys = v->config.nrow_keys;
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollX |
+                            ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Resizable;
+    if (!ImGui::BeginTable("##pivot", nkeys + (int)v->ncols, flags)) return;
+
+    for (i32_t k = 0; k < nkeys; k++) {
+        i32_t col = v->config.row_keys[k];
+        const char* name = col < keys->len ? rfui_symbols_get(AS_SYMBOL(keys)[col]) : nullptr;
+        ImGui::TableSetupColumn(name ? name : "<invalid>", ImGuiTableColumnFlags_None, 120.0f);
+    }
+    for (i64_t c = 0; c < v->ncols; c++) {
+        i32_t len;
+        const c8_t* label = rfui_grid_pivot_col_label(v, c, &len);
+        char name[RFUI_FMT_CELL_MAX];
+        snprintf(name, sizeof(name), "%.*s", (int)len, label);
+        ImGui::TableSetupColumn(name, ImGuiTableColumnFlags_None, 100.0f);
+    }
+    ImGui::TableSetupScrollFreeze(nkeys, 1);
+    ImGui::TableHeadersRow();
+
+    ImGuiListClipper clipper;
+    clipper.Begin((int)v->nrows);
+    while (clipper.Step()) {
+        for (int r = clipper.DisplayStart; r < clipper.DisplayEnd; r++) {
+            ImGui::TableNextRow();
+            for (i32_t k = 0; k < nkeys; k++) {
+                if (!ImGui::TableSetColumnIndex(k)) continue;
+                i32_t len;
+                const c8_t* label = rfui_grid_pivot_row_label(v, r, k, &len);
+                ImGui::TextUnformatted(label, label + len);
+            }
+            for (i64_t c = 0; c < v->ncols; c++) {
+                f64_t x;
+                if (!ImGui::TableSetColumnIndex(nkeys + (int)c) || !rfui_grid_pivot_cell(v, r, c, &x)) continue;
+                char buf[RFUI_FMT_NUM_MAX];
+                i32_t n = v->integral && x == (f64_t)(i64_t)x ? rfui_fmt_i64((i64_t)x, fmt, buf)
+                                                              : rfui_fmt_f64(x, fmt, buf);
+                ImGui::TextUnformatted(buf, buf + n);
             }
-            break;
         }
-        case TYPE_B8:
-            ImGui::Text("%s", AS_B8(col)[row] ? "true" : "false");
+    }
+    clipper.End();
+    ImGui::EndTable();
+}
+
+// Find match background: the current match stronger than the others
+static ImU32 find_color(bool current) {
+    return ImGui::GetColorU32(ImVec4(0.824f, 0.600f, 0.133f, current ? 0.75f : 0.30f));  // #D29922
+}
+
+// Changed-cell background: green up, red down, blue changed, fading out
+static ImU32 flash_color(u8_t dir, float fade) {
+    float a = 0.45f * fade;
+    switch (dir) {
+        case RFUI_FLASH_UP:   return ImGui::GetColorU32(ImVec4(0.247f, 0.725f, 0.314f, a));  // #3FB950
+        case RFUI_FLASH_DOWN: return ImGui::GetColorU32(ImVec4(0.973f, 0.318f, 0.286f, a));  // #F85149
+        default:              return ImGui::GetColorU32(ImVec4(0.345f, 0.651f, 1.000f, a));  // #58A6FF
+    }
+}
+
+// Profiler statistic in the column's units (fractional values of integer
+// columns, e.g. a mean, print as floats)
+static void format_stat(i8_t type, f64_t v, const rfui_fmt_t* fmt, char* buf) {
+    i32_t n;
+    switch (type) {
+        case TYPE_TIME:
+            n = rfui_fmt_time((i32_t)v, buf);
             break;
-        case TYPE_U8:
-            ImGui::Text("%u", (unsigned)AS_U8(col)[row]);
+        case TYPE_DATE:
+            n = rfui_fmt_date((i32_t)v, buf);
             break;
-        case TYPE_C8: {
-            // Single character or string
-            char c = AS_C8(col)[row];
-            if (c >= 32 && c < 127) {
-                ImGui::Text("%c", c);
-            } else {
-                ImGui::Text("0x%02x", (unsigned char)c);
-            }
+        case TYPE_TIMESTAMP:
+            n = rfui_fmt_timestamp((i64_t)v, buf);
             break;
-        }
-        case TYPE_DATE: {
-            // Date stored as i32 (days since epoch)
-            i32_t d = AS_DATE(col)[row];
-            if (d == NULL_I32) {
-                ImGui::TextDisabled("null");
-            } else {
-                // Simple date format: YYYY.MM.DD
-                // Days since 2000-01-01
-                ImGui::Text("%d", d);
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8:
+            if (v == (f64_t)(i64_t)v) {
+                n = rfui_fmt_i64((i64_t)v, fmt, buf);
+                break;
             }
+            n = rfui_fmt_f64(v, fmt, buf);
+            break;
+        default:
+            n = rfui_fmt_f64(v, fmt, buf);
             break;
+    }
+    buf[n] = '\0';
+}
+
+static void profile_row(const char* label, const char* value) {
+    ImGui::TableNextRow();
+    ImGui::TableSetColumnIndex(0);
+    ImGui::TextDisabled("%s", label);
+    ImGui::TableSetColumnIndex(1);
+    ImGui::TextUnformatted(value);
+}
+
+// Profiler popup body: column picker, statistics, histogram
+static void draw_profile(rfui_grid_profile_t* p, obj_p table, i64_t version, obj_p keys, obj_p vals,
+                         const rfui_fmt_t* fmt) {
+    const char* col_name = p->col >= 0 && p->col < keys->len ? rfui_symbols_get(AS_SYMBOL(keys)[p->col]) : nullptr;
+    ImGui::SetNextItemWidth(200);
+    if (ImGui::BeginCombo("##profile_col", col_name ? col_name : "<column>")) {
+        for (i64_t c = 0; c < vals->len; c++) {
+            obj_p col = AS_LIST(vals)[c];
+            const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
+            if (!name || !col || !rfui_grid_profile_supported(col->type)) continue;
+            if (ImGui::Selectable(name, c == p->col)) rfui_grid_profile_open(p, (i32_t)c);
         }
-        case TYPE_TIME: {
-            // Time stored as i32 (milliseconds since midnight)
-            i32_t t = AS_TIME(col)[row];
-            if (t == NULL_I32) {
-                ImGui::TextDisabled("null");
-            } else {
-                int ms = t % 1000;
-                int sec = (t / 1000) % 60;
-                int min = (t / 60000) % 60;
-                int hr = t / 3600000;
-                ImGui::Text("%02d:%02d:%02d.%03d", hr, min, sec, ms);
+        ImGui::EndCombo();
+    }
+
+    rfui_grid_profile_update(p, table, version);
+    if (!p->ready) {
+        ImGui::TextDisabled(p->job ? "Profiling..." : "Column type can't be profiled");
+        return;
+    }
+    if (p->job) {
+        ImGui::SameLine();
+        ImGui::TextDisabled("updating");
+    }
+
+    const rfui_col_profile_t* r = &p->result;
+    char buf[RFUI_FMT_NUM_MAX + 1];
+    if (ImGui::BeginTable("##profile", 2, ImGuiTableFlags_SizingFixedFit)) {
+        snprintf(buf, sizeof(buf), "%lld", (long long)r->rows);
+        profile_row("Rows", buf);
+        snprintf(buf, sizeof(buf), "%lld", (long long)r->nulls);
+        profile_row("Nulls", buf);
+        snprintf(buf, sizeof(buf), "~%.0f", r->distinct);
+        profile_row("Distinct", buf);
+        if (r->numeric) {
+            format_stat(r->type, r->min, fmt, buf);
+            profile_row("Min", buf);
+            format_stat(r->type, r->max, fmt, buf);
+            profile_row("Max", buf);
+            bool temporal = r->type == TYPE_TIME || r->type == TYPE_DATE || r->type == TYPE_TIMESTAMP;
+            format_stat(temporal ? r->type : TYPE_F64, r->mean, fmt, buf);
+            profile_row("Mean", buf);
+            if (!temporal) {
+                format_stat(TYPE_F64, r->sum, fmt, buf);
+                profile_row("Sum", buf);
+            }
+            for (int q = 0; q < RFUI_PROFILE_QUANTILES; q++) {
+                char label[16];
+                snprintf(label, sizeof(label), "p%d", (int)(rfui_profile_quantile_ranks[q] * 100.0 + 0.5));
+                format_stat(r->type, r->quantiles[q], fmt, buf);
+                profile_row(label, buf);
             }
-            break;
         }
-        case TYPE_TIMESTAMP: {
-            // Timestamp stored as i64 (nanoseconds since epoch)
-            i64_t ts = AS_TIMESTAMP(col)[row];
-            if (ts == NULL_I64) {
-                ImGui::TextDisabled("null");
+        ImGui::EndTable();
+    }
+    if (r->numeric) {
+        ImGui::PlotHistogram("##hist", r->hist, RFUI_PROFILE_BINS, 0, nullptr, 0.0f, FLT_MAX, ImVec2(260, 60));
+    }
+}
+
+// Draw formatted cell text (no printf at draw time)
+static void draw_cell_text(const char* text, int len, bool disabled) {
+    if (disabled) {
+        ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_TextDisabled));
+        ImGui::TextUnformatted(text, text + len);
+        ImGui::PopStyleColor();
+    } else {
+        ImGui::TextUnformatted(text, text + len);
+    }
+}
+
+// Sparkline of width w at pos: a min / max pair per bucket, broken at
+// all-null buckets
+static void draw_spark_at(ImDrawList* draw, ImVec2 pos, float w, const u8_t* points, int n) {
+    float h = ImGui::GetTextLineHeight();
+    ImU32 color = ImGui::GetColorU32(ImGuiCol_PlotLines);
+    int buckets = n / 2;
+    float dx = buckets > 1 ? (w - 1.0f) / (float)(buckets - 1) : 0.0f;
+    float dy = (h - 2.0f) / (float)RFUI_SPARK_TOP;
+    ImVec2 line[2 * RFUI_SPARK_MAX_WIDTH];
+    int m = 0;
+    for (int k = 0; k <= n; k++) {
+        if (k < n && points[k] != RFUI_SPARK_GAP) {
+            line[m++] = ImVec2(pos.x + (float)(k / 2) * dx, pos.y + h - 1.0f - (float)points[k] * dy);
+            continue;
+        }
+        if (m == 1) line[m++] = ImVec2(line[0].x + 1.0f, line[0].y);
+        if (m > 1) draw->AddPolyline(line, m, color, ImDrawFlags_None, 1.0f);
+        m = 0;
+    }
+}
+
+// Sparkline in the rest of the cell
+static void draw_spark(const u8_t* points, int n) {
+    ImVec2 pos = ImGui::GetCursorScreenPos();
+    float w = ImGui::GetContentRegionAvail().x;
+    ImGui::Dummy(ImVec2(w, ImGui::GetTextLineHeight()));
+    draw_spark_at(ImGui::GetWindowDrawList(), pos, w, points, n);
+}
+
+// Group tree in place of the rows: a tree column (open / closed marker, key
+// and row count, indented by level) ahead of the data columns. Node rows
+// show their keys and the sums of the numeric columns; rows under an open
+// last-level node are drawn like the grid's and select like them.
+static void draw_grouped(grid_ui_state_t* state, obj_p keys, obj_p vals) {
+    rfui_grid_group_t* g = &state->group;
+    const rfui_group_index_t* x = g->index;
+    if (g->nkeys == 0) {
+        ImGui::TextDisabled("Choose a key in " ICON_LAYER_GROUP " Group");
+        return;
+    }
+    if (!x) {
+        ImGui::TextDisabled(g->job ? "Grouping rows..." : "Grouping unavailable");
+        return;
+    }
+
+    obj_p* cols = AS_LIST(vals);
+    i64_t ncols = vals->len < RFUI_GRID_COLUMN_WINDOW ? vals->len : RFUI_GRID_COLUMN_WINDOW;
+    if (ncols < vals->len) {
+        ImGui::TextDisabled("Showing %lld of %lld columns", (long long)ncols, (long long)vals->len);
+    }
+
+    // Data column -> sum slot and -> key level (-1 = none)
+    i32_t sum_of[RFUI_GRID_COLUMN_WINDOW];
+    i32_t level_of[RFUI_GRID_COLUMN_WINDOW];
+    for (i64_t c = 0; c < ncols; c++) sum_of[c] = level_of[c] = -1;
+    for (i32_t s = 0; s < x->nsums; s++) {
+        if (x->sum_cols[s] < ncols) sum_of[x->sum_cols[s]] = s;
+    }
+    for (i32_t l = 0; l < x->nlevels; l++) {
+        if (x->key_cols[l] < ncols) level_of[x->key_cols[l]] = l;
+    }
+
+    ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders | ImGuiTableFlags_ScrollX |
+                            ImGuiTableFlags_ScrollY | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Resizable;
+    if (!ImGui::BeginTable("##group", 1 + (int)ncols, flags)) return;
+
+    ImGui::TableSetupColumn("Group", ImGuiTableColumnFlags_None, 220.0f);
+    for (i64_t c = 0; c < ncols; c++) {
+        const char* name = c < keys->len ? rfui_symbols_get(AS_SYMBOL(keys)[c]) : nullptr;
+        ImGui::TableSetupColumn(name ? name : "<invalid>", ImGuiTableColumnFlags_None,
+                                rfui_grid_column_width(cols[c] ? cols[c]->type : TYPE_LIST));
+    }
+    ImGui::TableSetupScrollFreeze(1, 1);
+    ImGui::TableHeadersRow();
+
+    float indent = ImGui::GetStyle().IndentSpacing;
+    i32_t toggled = -1;
+    ImGuiListClipper clipper;
+    clipper.Begin((int)g->display_rows);
+    while (clipper.Step()) {
+        for (int d = clipper.DisplayStart; d < clipper.DisplayEnd; d++) {
+            i32_t node;
+            i64_t row;
+            if (!rfui_grid_group_at(g, d, &node, &row)) break;
+            ImGui::TableNextRow();
+            ImGui::TableSetColumnIndex(0);
+            ImGui::PushID(d);
+
+            if (row < 0) {
+                // Node: keys are read at its first row (the index may trail the data by a frame)
+                i32_t level = x->level[node];
+                i64_t first = x->first_row[node];
+                obj_p key_col = x->key_cols[level] < vals->len ? cols[x->key_cols[level]] : nullptr;
+                char key[RFUI_FMT_CELL_MAX] = "";
+                b8_t dim;
+                if (key_col && first < key_col->len) rfui_fmt_cell(key_col, first, &state->fmt, key, sizeof(key), &dim);
+                char label[RFUI_FMT_CELL_MAX + 64];
+                snprintf(label, sizeof(label), "%s %s (%lld)",
+                         rfui_grid_group_expanded(g, node) ? ICON_CARET_D : ICON_CARET_R, key,
+                         (long long)x->count[node]);
+                ImGui::Indent(indent * (float)level + 1.0f);
+                if (ImGui::Selectable(label, false, ImGuiSelectableFlags_SpanAllColumns)) toggled = node;
+                ImGui::Unindent(indent * (float)level + 1.0f);
+
+                for (i64_t c = 0; c < ncols; c++) {
+                    obj_p col = cols[c];
+                    if (!col || !ImGui::TableSetColumnIndex(1 + (int)c)) continue;
+                    char buf[RFUI_FMT_CELL_MAX];
+                    i32_t n = 0;
+                    if (level_of[c] >= 0 && level_of[c] <= level) {
+                        if (first < col->len) n = rfui_fmt_cell(col, first, &state->fmt, buf, sizeof(buf), &dim);
+                    } else if (sum_of[c] >= 0) {
+                        f64_t v = x->sums[(i64_t)node * x->nsums + sum_of[c]];
+                        n = col->type != TYPE_F64 ? rfui_fmt_i64((i64_t)v, &state->fmt, buf)
+                                                  : rfui_fmt_f64(v, &state->fmt, buf);
+                    }
+                    if (n > 0) ImGui::TextUnformatted(buf, buf + n);
+                }
             } else {
-                // Display as raw value for now
-                ImGui::Text("%lld", (long long)ts);
+                // Row under an open node
+                bool selected = rfui_grid_select_has(&state->select, row);
+                if (ImGui::Selectable("##row", selected,
+                                      ImGuiSelectableFlags_SpanAllColumns | ImGuiSelectableFlags_AllowOverlap)) {
+                    rfui_grid_select_t* sel = &state->select;
+                    if (!ImGui::GetIO().KeyCtrl) rfui_grid_select_clear(sel);
+                    rfui_grid_select_set(sel, row, selected && ImGui::GetIO().KeyCtrl ? B8_FALSE : B8_TRUE);
+                }
+                for (i64_t c = 0; c < ncols; c++) {
+                    obj_p col = cols[c];
+                    if (!col || row >= col->len || !ImGui::TableSetColumnIndex(1 + (int)c)) continue;
+                    char buf[RFUI_FMT_CELL_MAX];
+                    b8_t disabled;
+                    int len = rfui_fmt_cell(col, row, &state->fmt, buf, sizeof(buf), &disabled);
+                    draw_cell_text(buf, len, disabled != 0);
+                }
             }
-            break;
+            ImGui::PopID();
         }
-        case TYPE_GUID: {
-            // GUID is 16 bytes
-            guid_t* g = &AS_GUID(col)[row];
-            ImGui::Text("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x-%02x%02x%02x%02x%02x%02x",
-                (*g)[0], (*g)[1], (*g)[2], (*g)[3],
-                (*g)[4], (*g)[5], (*g)[6], (*g)[7],
-                (*g)[8], (*g)[9], (*g)[10], (*g)[11],
-                (*g)[12], (*g)[13], (*g)[14], (*g)[15]);
-            break;
+    }
+    clipper.End();
+    ImGui::EndTable();
+
+    // Segments are rebuilt on the next update, never under the clipper
+    if (toggled >= 0) rfui_grid_group_toggle(g, toggled);
+}
+
+static void cache_free(cell_cache_t* cache) {
+    free(cache->offsets);
+    free(cache->disabled);
+    free(cache->spark_offsets);
+    free(cache->patch_rows);
+    rfui_fmt_buf_free(&cache->text);
+    rfui_fmt_buf_free(&cache->spare);
+    rfui_spark_buf_free(&cache->spark);
+    rfui_spark_buf_free(&cache->spare_spark);
+    memset(cache, 0, sizeof(*cache));
+    cache->version = -1;
+    cache->patch_base = -1;
+}
+
+typedef struct window_row_t {
+    i64_t data_row;
+    i64_t cached;      // Row within the cached window
+} window_row_t;
+
+static int cmp_window_row(const void* a, const void* b) {
+    i64_t x = ((const window_row_t*)a)->data_row, y = ((const window_row_t*)b)->data_row;
+    return (x > y) - (x < y);
+}
+
+// Re-format the cached cells of the rows upserts wrote, copying every other
+// cell's text and sparkline over from the current buffers. The layout is
+// unchanged, so rows / rows_n map display rows as when the window was built.
+static bool cache_patch(cell_cache_t* cache, obj_p* cols, const u32_t* rows, i64_t rows_n,
+                        const rfui_fmt_t* fmt) {
+    i64_t n = cache->row_count;
+    window_row_t* window = (window_row_t*)malloc(sizeof(window_row_t) * (size_t)(n ? n : 1));
+    u8_t* hit = (u8_t*)calloc((size_t)(n ? n : 1), 1);
+    if (!window || !hit) {
+        free(window);
+        free(hit);
+        return false;
+    }
+
+    // Written rows that fall in the window: one binary search each
+    for (i64_t j = 0; j < n; j++) {
+        i64_t r = cache->row_start + j;
+        window[j].data_row = (rows && r < rows_n) ? (i64_t)rows[r] : r;
+        window[j].cached = j;
+    }
+    if (rows) qsort(window, (size_t)n, sizeof(window_row_t), cmp_window_row);
+    i64_t nhit = 0;
+    for (i64_t p = 0; p < cache->npatch; p++) {
+        i64_t lo = 0, hi = n;
+        while (lo < hi) {
+            i64_t mid = (lo + hi) / 2;
+            if (window[mid].data_row < cache->patch_rows[p]) lo = mid + 1; else hi = mid;
         }
-        case TYPE_LIST: {
-            // Nested list - show type indicator
-            obj_p item = AS_LIST(col)[row];
-            if (item) {
-                ImGui::TextDisabled("[%s:%lld]", type_name(item->type), (long long)item->len);
-            } else {
-                ImGui::TextDisabled("null");
+        if (lo < n && window[lo].data_row == cache->patch_rows[p] && !hit[window[lo].cached]) {
+            hit[window[lo].cached] = 1;
+            nhit++;
+        }
+    }
+    free(window);
+
+    bool ok = true;
+    if (nhit > 0) {
+        rfui_fmt_buf_t* text = &cache->spare;
+        rfui_spark_buf_t* spark = &cache->spare_spark;
+        text->len = 0;
+        spark->len = 0;
+        u32_t text_b = cache->offsets[0], spark_b = cache->spark_offsets[0];
+        for (i64_t c = 0; c < cache->ncols && ok; c++) {
+            obj_p col = cols[cache->col_idx[c]];
+            for (i64_t j = 0; j < n && ok; j++) {
+                i64_t cell = c * n + j;
+                u32_t text_e = cache->offsets[cell + 1], spark_e = cache->spark_offsets[cell + 1];
+                if (hit[j]) {
+                    ok = rfui_fmt_column(col, rows, rows_n, cache->row_start + j, 1, fmt,
+                                         text, cache->offsets + cell, cache->disabled + cell) &&
+                         rfui_spark_column(col, rows, rows_n, cache->row_start + j, 1, cache->spark_px[c],
+                                           spark, cache->spark_offsets + cell);
+                } else {
+                    cache->offsets[cell] = (u32_t)text->len;
+                    cache->spark_offsets[cell] = (u32_t)spark->len;
+                    ok = rfui_fmt_buf_append(text, cache->text.text + text_b, text_e - text_b) &&
+                         rfui_spark_buf_append(spark, cache->spark.points + spark_b, spark_e - spark_b);
+                }
+                text_b = text_e;
+                spark_b = spark_e;
             }
-            break;
         }
-        default:
-            ImGui::TextDisabled("<%s>", type_name(col->type));
-            break;
+        if (ok) {
+            i64_t cells = cache->ncols * n;
+            cache->offsets[cells] = (u32_t)text->len;
+            cache->spark_offsets[cells] = (u32_t)spark->len;
+            rfui_fmt_buf_t t = cache->text;
+            cache->text = *text;
+            *text = t;
+            rfui_spark_buf_t p = cache->spark;
+            cache->spark = *spark;
+            *spark = p;
+        }
     }
+    free(hit);
+    return ok;
 }
 
-// Get cell value as string for color rule matching
-static void cell_to_string(obj_p col, i64_t row, char* buf, size_t buf_sz) {
-    buf[0] = '\0';
-    if (!col || row < 0 || row >= col->len) return;
+// Make sure display rows [start, end) are formatted. Rebuilds a window of one
+// extra screen above and below so ordinary scrolling stays inside the cache.
+// rows maps the first rows_n display rows to data rows (NULL = natural order).
+// col_idx lists the ncols data columns to cache; spark_px is the sparkline
+// width of each (a resize rebuilds).
+static bool cache_ensure(cell_cache_t* cache, i64_t version, i64_t order, obj_p* cols,
+                         const i64_t* col_idx, i64_t ncols, i64_t nrows, const u32_t* rows, i64_t rows_n,
+                         const rfui_fmt_t* fmt, const i32_t* spark_px, i64_t start, i64_t end) {
+    bool same_window = cache->order == order && cache->ncols == ncols &&
+        memcmp(cache->col_idx, col_idx, sizeof(i64_t) * (size_t)ncols) == 0 &&
+        memcmp(cache->spark_px, spark_px, sizeof(i32_t) * (size_t)ncols) == 0 &&
+        start >= cache->row_start && end <= cache->row_start + cache->row_count;
+    if (same_window && cache->version == version) {
+        return true;
+    }
+    // Only upserts happened since: re-format just the rows they wrote (a
+    // failed splice leaves offsets half rewritten, so rebuild then)
+    if (same_window && cache->version >= 0 && cache->patch_base == cache->version &&
+        cache->patch_version == version) {
+        if (cache_patch(cache, cols, rows, rows_n, fmt)) {
+            cache->version = version;
+            cache->npatch = 0;
+            cache->patch_base = -1;
+            return true;
+        }
+    }
 
-    switch (col->type) {
-        case TYPE_I64:     snprintf(buf, buf_sz, "%lld", (long long)AS_I64(col)[row]); break;
-        case TYPE_I32:     snprintf(buf, buf_sz, "%d", AS_I32(col)[row]); break;
-        case TYPE_I16:     snprintf(buf, buf_sz, "%d", (int)AS_I16(col)[row]); break;
-        case TYPE_F64:     snprintf(buf, buf_sz, "%.6g", AS_F64(col)[row]); break;
-        case TYPE_SYMBOL: {
-            i64_t sid = AS_SYMBOL(col)[row];
-            const char* s = str_from_symbol(sid);
-            if (s) snprintf(buf, buf_sz, "%s", s);
-            break;
+    i64_t visible = end - start;
+    i64_t row_start = start - visible > 0 ? start - visible : 0;
+    i64_t row_end = end + visible < nrows ? end + visible : nrows;
+    i64_t row_count = row_end - row_start;
+    i64_t cells = row_count * ncols;
+
+    if (cells + 1 > cache->cells_cap) {
+        u32_t* offsets = (u32_t*)realloc(cache->offsets, sizeof(u32_t) * (size_t)(cells + 1));
+        if (!offsets) {
+            cache_free(cache);
+            return false;
+        }
+        cache->offsets = offsets;
+        u8_t* disabled = (u8_t*)realloc(cache->disabled, (size_t)(cells + 1));
+        if (!disabled) {
+            cache_free(cache);
+            return false;
+        }
+        cache->disabled = disabled;
+        u32_t* spark_offsets = (u32_t*)realloc(cache->spark_offsets, sizeof(u32_t) * (size_t)(cells + 1));
+        if (!spark_offsets) {
+            cache_free(cache);
+            return false;
+        }
+        cache->spark_offsets = spark_offsets;
+        cache->cells_cap = cells + 1;
+    }
+
+    cache->text.len = 0;
+    cache->spark.len = 0;
+    for (i64_t c = 0; c < ncols; c++) {
+        i64_t cell = c * row_count;
+        if (!rfui_fmt_column(cols[col_idx[c]], rows, rows_n, row_start, row_count, fmt,
+                             &cache->text, cache->offsets + cell, cache->disabled + cell) ||
+            !rfui_spark_column(cols[col_idx[c]], rows, rows_n, row_start, row_count, spark_px[c],
+                               &cache->spark, cache->spark_offsets + cell)) {
+            cache_free(cache);
+            return false;
+        }
+    }
+    cache->offsets[cells] = (u32_t)cache->text.len;
+    cache->spark_offsets[cells] = (u32_t)cache->spark.len;
+    memcpy(cache->spark_px, spark_px, sizeof(i32_t) * (size_t)ncols);
+    memcpy(cache->col_idx, col_idx, sizeof(i64_t) * (size_t)ncols);
+
+    cache->version = version;
+    cache->order = order;
+    cache->row_start = row_start;
+    cache->row_count = row_count;
+    cache->ncols = ncols;
+    return true;
+}
+
+// Dense mode: rows without an ImGui table or any per-cell item. Glyphs go
+// from the cell cache straight into the window's draw list under one clip
+// rect per column, row and cell backgrounds are plain rects, and a single
+// invisible item spans header and rows: a click is resolved from the mouse
+// position to a header (sort) or a row (selection). Column widths follow
+// the column type, and columns hidden from the Columns popup take no room;
+// the filter row, resizing and reordering stay with the table, though
+// filters set there still apply.
+static void draw_dense(rfui_widget_t* widget, grid_ui_state_t* s, obj_p table, obj_p keys, obj_p vals,
+                       const u32_t* perm, i64_t perm_n) {
+    i64_t ncols = keys->len;
+    i64_t nrows = AS_LIST(vals)[0]->len;
+    ImVec2 pad = ImGui::GetStyle().CellPadding;
+
+    const u32_t* rows = perm;
+    i64_t rows_n = perm_n;
+    i64_t display_rows = nrows;
+    rfui_grid_filter_t* filter = &s->filter;
+    rfui_grid_filter_resize(filter, ncols);
+    rfui_grid_filter_update(filter, table, widget->version, perm, perm_n, s->sort.order_gen);
+    if (filter->active) {
+        rows = filter->sel;
+        rows_n = filter->nsel;
+        display_rows = filter->nsel;
+    }
+    if (s->export_pending) start_export(s, table, ncols, true, rows, rows_n, display_rows);
+    if (s->find_step) {
+        rfui_grid_find_next(&s->find, table, rows, rows_n, display_rows, s->find_step);
+        s->find_step = 0;
+    }
+
+    rfui_grid_columns_t* columns = &s->columns;
+    rfui_grid_columns_update(columns, vals, widget->version, 1.0f + pad.x * 2.0f, s->hidden, s->hidden_gen);
+    if (!columns->widths) {
+        ImGui::TextDisabled("Out of memory");
+        return;
+    }
+
+    if (!ImGui::BeginChild("##dense", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar)) {
+        ImGui::EndChild();
+        return;
+    }
+
+    // Row r sits at origin + (r + 1) rows; the header covers the top row of the view
+    float row_h = ImGui::GetTextLineHeight() + pad.y * 2.0f;
+    float width = columns->x[ncols];
+    ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImRect clip = ImGui::GetCurrentWindow()->InnerClipRect;
+    float body_top = clip.Min.y + row_h;
+    float right = ImMin(clip.Max.x, origin.x + width);
+    float bottom = ImMin(clip.Max.y, origin.y + (float)(display_rows + 1) * row_h);
+
+    ImGui::InvisibleButton("##cells", ImVec2(ImMax(width, 1.0f), (float)(display_rows + 1) * row_h));
+    bool hovered = ImGui::IsItemHovered();
+    ImVec2 mouse = ImGui::GetMousePos();
+    i64_t hit_col = -1;
+    if (hovered && mouse.x - origin.x < width) {
+        hit_col = rfui_grid_columns_at(columns, mouse.x - origin.x);
+    }
+    if (ImGui::IsItemClicked(ImGuiMouseButton_Left) && hit_col >= 0) {
+        if (mouse.y < body_top) {
+            rfui_grid_sort_click(&s->sort, (i32_t)hit_col, ImGui::GetIO().KeyShift ? B8_TRUE : B8_FALSE);
+        } else {
+            i64_t row = (i64_t)((mouse.y - origin.y) / row_h) - 1;
+            if (row >= 0 && row < display_rows) {
+                select_click(&s->select, row, (rows && row < rows_n) ? (i64_t)rows[row] : row,
+                             rows, rows_n, display_rows);
+            }
+        }
+    }
+
+    const rfui_grid_find_t* find = s->find.job ? &s->find : nullptr;
+    if (find && find->jump && find->cur_row >= 0 && find->cur_row < display_rows) {
+        ImGui::SetScrollY((float)(find->cur_row + 1) * row_h - clip.GetHeight() * 0.5f);
+        if (find->cur_col < ncols) ImGui::SetScrollX(columns->x[find->cur_col] - clip.GetWidth() * 0.5f);
+        s->find.jump = B8_FALSE;
+    }
+
+    i64_t first = (i64_t)((body_top - origin.y) / row_h) - 1;
+    if (first < 0) first = 0;
+    i64_t last = (i64_t)((bottom - origin.y) / row_h);
+    if (last > display_rows) last = display_rows;
+
+    // Same column window as a wide table, so the cache carries over between modes
+    obj_p* cols = AS_LIST(vals);
+    i64_t win[RFUI_GRID_COLUMN_WINDOW];
+    i64_t col_n = rfui_grid_columns_window(columns, ImGui::GetScrollX(), win);
+    i32_t spark_px[RFUI_GRID_COLUMN_WINDOW] = {};
+    for (i64_t i = 0; i < col_n; i++) {
+        if (cols[win[i]]->type == TYPE_LIST) spark_px[i] = (i32_t)columns->widths[win[i]];
+    }
+    cell_cache_t* cache = nullptr;
+    i64_t layout = s->sort.order_gen + s->filter.gen + s->fmt_gen;
+    if (first < last && cache_ensure(&s->cache, widget->version, layout, cols, win, col_n, display_rows,
+                                     rows, rows_n, &s->fmt, spark_px, first, last)) {
+        cache = &s->cache;
+    }
+
+    rfui_grid_styles_update(&s->styles, widget->version, s->rules_version, keys, vals, s->rules, s->num_rules);
+    const rfui_grid_styles_t* styles = s->styles.cells ? &s->styles : nullptr;
+    f64_t now = ImGui::GetTime();
+    const rfui_grid_flash_t* flash = rfui_grid_flash_live(&s->flash, now) ? &s->flash : nullptr;
+
+    ImDrawList* draw = ImGui::GetWindowDrawList();
+    ImFont* font = ImGui::GetFont();
+    float font_size = ImGui::GetFontSize();
+    ImU32 text_color = ImGui::GetColorU32(ImGuiCol_Text);
+    ImU32 disabled_color = ImGui::GetColorU32(ImGuiCol_TextDisabled);
+    ImU32 border_color = ImGui::GetColorU32(ImGuiCol_TableBorderLight);
+
+    // Stripes and selection under all columns
+    ImU32 row_bg[2] = { ImGui::GetColorU32(ImGuiCol_TableRowBg), ImGui::GetColorU32(ImGuiCol_TableRowBgAlt) };
+    ImU32 selected_bg = ImGui::GetColorU32(ImGuiCol_Header);
+    draw->PushClipRect(ImVec2(clip.Min.x, body_top), clip.Max, true);
+    for (i64_t r = first; r < last; r++) {
+        i64_t data_row = (rows && r < rows_n) ? (i64_t)rows[r] : r;
+        float y = origin.y + (float)(r + 1) * row_h;
+        ImU32 bg = rfui_grid_select_has(&s->select, data_row) ? selected_bg : row_bg[r & 1];
+        draw->AddRectFilled(ImVec2(clip.Min.x, y), ImVec2(right, y + row_h), bg);
+    }
+    draw->PopClipRect();
+
+    for (i64_t i = 0; i < col_n; i++) {
+        i64_t col_idx = win[i];
+        float x0 = origin.x + columns->x[col_idx];
+        float x1 = x0 + columns->widths[col_idx] + pad.x * 2.0f;
+        if (x1 <= clip.Min.x) continue;
+        if (x0 >= clip.Max.x) break;
+
+        draw->PushClipRect(ImVec2(x0, body_top), ImVec2(x1, clip.Max.y), true);
+        for (i64_t r = first; r < last; r++) {
+            i64_t data_row = (rows && r < rows_n) ? (i64_t)rows[r] : r;
+            if (data_row >= nrows) continue;
+            float y = origin.y + (float)(r + 1) * row_h;
+
+            if (find && rfui_grid_find_cell(find, table, col_idx, data_row)) {
+                bool current = r == find->cur_row && col_idx == find->cur_col;
+                draw->AddRectFilled(ImVec2(x0, y), ImVec2(x1, y + row_h), find_color(current));
+            }
+            if (flash) {
+                float fade;
+                u8_t dir = rfui_grid_flash_at(flash, col_idx, data_row, now, &fade);
+                if (dir) draw->AddRectFilled(ImVec2(x0, y), ImVec2(x1, y + row_h), flash_color(dir, fade));
+            }
+
+            ImU32 color = text_color;
+            if (styles && styles->cells[col_idx] && styles->cells[col_idx][data_row]) {
+                const rfui_rgba_t* c = &styles->palette[styles->cells[col_idx][data_row]];
+                color = ImGui::ColorConvertFloat4ToU32(ImVec4(c->r, c->g, c->b, c->a));
+            }
+
+            ImVec2 pos(x0 + pad.x, y + pad.y);
+            if (cache) {
+                i64_t cell = i * cache->row_count + (r - cache->row_start);
+                u32_t spark = cache->spark_offsets[cell];
+                if (cache->spark_offsets[cell + 1] > spark) {
+                    draw_spark_at(draw, pos, columns->widths[col_idx], cache->spark.points + spark,
+                                  (int)(cache->spark_offsets[cell + 1] - spark));
+                    continue;
+                }
+                const char* text = cache->text.text + cache->offsets[cell];
+                draw->AddText(font, font_size, pos, cache->disabled[cell] ? disabled_color : color,
+                              text, cache->text.text + cache->offsets[cell + 1]);
+            } else {
+                char buf[RFUI_FMT_CELL_MAX];
+                b8_t disabled;
+                int len = rfui_fmt_cell(cols[col_idx], data_row, &s->fmt, buf, sizeof(buf), &disabled);
+                draw->AddText(font, font_size, pos, disabled ? disabled_color : color, buf, buf + len);
+            }
         }
-        case TYPE_B8:      snprintf(buf, buf_sz, "%s", AS_B8(col)[row] ? "true" : "false"); break;
-        default: break;
+        draw->PopClipRect();
+        draw->AddLine(ImVec2(x1, body_top), ImVec2(x1, bottom), border_color);
     }
+
+    // Header on top, fixed while the rows scroll under it
+    draw->AddRectFilled(clip.Min, ImVec2(right, body_top), ImGui::GetColorU32(ImGuiCol_TableHeaderBg));
+    for (i64_t i = 0; i < col_n; i++) {
+        i64_t col_idx = win[i];
+        float x0 = origin.x + columns->x[col_idx];
+        float x1 = x0 + columns->widths[col_idx] + pad.x * 2.0f;
+        if (x1 <= clip.Min.x) continue;
+        if (x0 >= clip.Max.x) break;
+
+        if (col_idx == hit_col && mouse.y < body_top) {
+            draw->AddRectFilled(ImVec2(x0, clip.Min.y), ImVec2(x1, body_top),
+                                ImGui::GetColorU32(ImGuiCol_HeaderHovered));
+        }
+        const char* col_name = rfui_symbols_get(AS_SYMBOL(keys)[col_idx]);
+        const char* arrow = "";
+        for (i32_t k = 0; k < s->sort.nkeys; k++) {
+            if (s->sort.keys[k].col == col_idx) arrow = s->sort.keys[k].desc ? " " ICON_SORT_DOWN : " " ICON_SORT_UP;
+        }
+        char label[128];
+        int len = snprintf(label, sizeof(label), "%s%s", col_name ? col_name : "<invalid>", arrow);
+        if (len >= (int)sizeof(label)) len = (int)sizeof(label) - 1;
+        draw->PushClipRect(ImVec2(x0, clip.Min.y), ImVec2(x1, body_top), true);
+        draw->AddText(font, font_size, ImVec2(x0 + pad.x, clip.Min.y + pad.y), text_color, label, label + len);
+        draw->PopClipRect();
+    }
+
+    ImGui::EndChild();
 }
 
 extern "C" {
@@ -313,28 +1237,65 @@ nil_t rfui_render_grid(rfui_widget_t* widget) {
     // Initialize UI state if needed
     grid_ui_state_t* ui_state = (grid_ui_state_t*)widget->ui_state;
     if (!ui_state) {
-        ui_state = (grid_ui_state_t*)malloc(sizeof(grid_ui_state_t));
+        ui_state = (grid_ui_state_t*)calloc(1, sizeof(grid_ui_state_t));
         if (ui_state) {
-            ui_state->selected_row = -1;
+            ui_state->select.anchor = -1;
+            ui_state->profile.col = -1;
+            ui_state->profile.last_col = -1;
+            ui_state->pivot.config.value = -1;
+            ui_state->find.cur_row = -1;
+            ui_state->find.version = -1;
+            ui_state->flash.enabled = B8_TRUE;
+            ui_state->flash.key_col = -1;
+            ui_state->fmt = rfui_fmt_default;
             ui_state->num_rules = 0;
             ui_state->settings_open = false;
+            ui_state->dense = widget->dense != 0;
+            ui_state->cache.version = -1;
+            ui_state->cache.patch_base = -1;
+            ui_state->styles.version = -1;
             widget->ui_state = ui_state;
         }
     }
 
+    // Adopt a finished background sort / start one for new data or keys
+    const u32_t* perm = nullptr;
+    i64_t perm_n = 0;
+    if (ui_state) {
+        rfui_grid_sort_update(&ui_state->sort, table, widget->version);
+        hidden_resize(ui_state, ncols);
+        rfui_grid_export_update(&ui_state->exporter, ImGui::GetTime());
+        rfui_grid_find_update(&ui_state->find, table, widget->version);
+        if (ui_state->exporter.clipboard) {
+            ImGui::SetClipboardText(ui_state->exporter.clipboard);
+            free(ui_state->exporter.clipboard);
+            ui_state->exporter.clipboard = nullptr;
+        }
+        sweep_retired(ui_state);
+        perm = rfui_grid_sort_perm(&ui_state->sort, nrows, &perm_n);
+    }
+
     // Display table info with secondary text color
     ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.545f, 0.580f, 0.620f, 1.0f));
-    if (ui_state && ui_state->selected_row >= 0) {
-        ImGui::Text("Rows: %lld  Columns: %lld  Selected: %d",
-                    (long long)nrows, (long long)ncols, ui_state->selected_row);
+    char rows_text[64];
+    if (ui_state && ui_state->filter.active) {
+        snprintf(rows_text, sizeof(rows_text), "Rows: %lld of %lld",
+                 (long long)ui_state->filter.nsel, (long long)nrows);
+    } else {
+        snprintf(rows_text, sizeof(rows_text), "Rows: %lld", (long long)nrows);
+    }
+    if (ui_state) rfui_grid_select_resize(&ui_state->select, nrows);
+    if (ui_state && ui_state->select.count > 0) {
+        ImGui::Text("%s  Columns: %lld  Selected: %lld",
+                    rows_text, (long long)ncols, (long long)ui_state->select.count);
         ImGui::SameLine();
         ImGui::PopStyleColor();
         if (ImGui::SmallButton(ICON_ERASER " Clear")) {
-            ui_state->selected_row = -1;
-            send_post_query(widget, nullptr);
+            rfui_grid_select_clear(&ui_state->select);
+            ui_state->select.anchor = -1;
         }
     } else {
-        ImGui::Text("Rows: %lld  Columns: %lld", (long long)nrows, (long long)ncols);
+        ImGui::Text("%s  Columns: %lld", rows_text, (long long)ncols);
         ImGui::PopStyleColor();
     }
 
@@ -349,17 +1310,19 @@ nil_t rfui_render_grid(rfui_widget_t* widget) {
             ImGui::Text(ICON_PALETTE " Color Rules");
             ImGui::Separator();
 
+            bool edited = false;
             for (int i = 0; i < ui_state->num_rules; i++) {
-                color_rule_t* r = &ui_state->color_rules[i];
+                rfui_grid_rule_t* r = &ui_state->rules[i];
                 ImGui::PushID(i);
 
                 // Column combo
                 ImGui::SetNextItemWidth(100);
                 if (ImGui::BeginCombo("##col", r->column[0] ? r->column : "<column>")) {
                     for (i64_t c = 0; c < ncols; c++) {
-                        const char* name = str_from_symbol(AS_SYMBOL(keys)[c]);
+                        const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
                         if (name && ImGui::Selectable(name, strcmp(r->column, name) == 0)) {
                             snprintf(r->column, sizeof(r->column), "%s", name);
+                            edited = true;
                         }
                     }
                     ImGui::EndCombo();
@@ -367,149 +1330,627 @@ nil_t rfui_render_grid(rfui_widget_t* widget) {
 
                 ImGui::SameLine();
                 ImGui::SetNextItemWidth(80);
-                ImGui::InputText("##val", r->value, sizeof(r->value));
+                if (ImGui::BeginCombo("##op", rfui_rule_op_names[r->op])) {
+                    for (int op = 0; op < RFUI_RULE_OP_COUNT; op++) {
+                        if (ImGui::Selectable(rfui_rule_op_names[op], r->op == op)) {
+                            r->op = op;
+                            edited = true;
+                        }
+                    }
+                    ImGui::EndCombo();
+                }
+
+                bool two_values = r->op == RFUI_RULE_BETWEEN || r->op == RFUI_RULE_GRADIENT;
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(two_values ? 60 : 124);
+                edited |= ImGui::InputTextWithHint("##val", two_values ? "min" : "value",
+                                                   r->value, sizeof(r->value));
+                if (two_values) {
+                    ImGui::SameLine();
+                    ImGui::SetNextItemWidth(60);
+                    edited |= ImGui::InputTextWithHint("##val2", "max", r->value2, sizeof(r->value2));
+                }
 
                 ImGui::SameLine();
-                ImGui::ColorEdit3("##clr", (float*)&r->color,
+                edited |= ImGui::ColorEdit3("##clr", r->color,
                     ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel);
+                if (r->op == RFUI_RULE_GRADIENT) {
+                    ImGui::SameLine();
+                    edited |= ImGui::ColorEdit3("##clr2", r->color2,
+                        ImGuiColorEditFlags_NoInputs | ImGuiColorEditFlags_NoLabel);
+                }
 
                 ImGui::SameLine();
-                ImGui::Checkbox("##en", &r->enabled);
+                bool enabled = r->enabled != 0;
+                if (ImGui::Checkbox("##en", &enabled)) {
+                    r->enabled = enabled ? B8_TRUE : B8_FALSE;
+                    edited = true;
+                }
 
                 ImGui::SameLine();
                 if (ImGui::SmallButton(ICON_XMARK)) {
                     // Remove rule by shifting
                     for (int j = i; j < ui_state->num_rules - 1; j++)
-                        ui_state->color_rules[j] = ui_state->color_rules[j + 1];
+                        ui_state->rules[j] = ui_state->rules[j + 1];
                     ui_state->num_rules--;
                     i--;
+                    edited = true;
                 }
 
                 ImGui::PopID();
             }
 
-            if (ui_state->num_rules < MAX_COLOR_RULES) {
-                if (ImGui::Button(ICON_PLUS " Add Rule")) {
-                    color_rule_t* r = &ui_state->color_rules[ui_state->num_rules++];
-                    r->column[0] = '\0';
-                    r->value[0] = '\0';
-                    r->color = ImVec4(0.0f, 1.0f, 0.0f, 1.0f);
-                    r->enabled = true;
+            if (ImGui::Button(ICON_PLUS " Add Rule")) {
+                if (ui_state->num_rules == ui_state->rules_cap) {
+                    int cap = ui_state->rules_cap ? ui_state->rules_cap * 2 : 8;
+                    rfui_grid_rule_t* rules = (rfui_grid_rule_t*)realloc(
+                        ui_state->rules, sizeof(rfui_grid_rule_t) * cap);
+                    if (rules) {
+                        ui_state->rules = rules;
+                        ui_state->rules_cap = cap;
+                    }
+                }
+                if (ui_state->num_rules < ui_state->rules_cap) {
+                    rfui_grid_rule_t* r = &ui_state->rules[ui_state->num_rules++];
+                    memset(r, 0, sizeof(*r));
+                    r->op = RFUI_RULE_EQ;
+                    r->color[1] = 1.0f;   // Green
+                    r->color[3] = 1.0f;
+                    r->color2[0] = 1.0f;  // Gradient: green -> red
+                    r->color2[3] = 1.0f;
+                    r->enabled = B8_TRUE;
+                    edited = true;
                 }
             }
 
+            if (edited) ui_state->rules_version++;
+
+            ImGui::Spacing();
+            ImGui::Text(ICON_CALCULATOR " Number Format");
+            ImGui::Separator();
+
+            // Float decimals: Auto = shortest text that reads back exactly
+            rfui_fmt_t* fmt = &ui_state->fmt;
+            static const char* decimal_names[] = { "Auto", "0", "1", "2", "3", "4", "5", "6", "7", "8", "9" };
+            ImGui::SetNextItemWidth(80);
+            if (ImGui::BeginCombo("Decimals", decimal_names[fmt->decimals + 1])) {
+                for (int d = -1; d <= 9; d++) {
+                    if (ImGui::Selectable(decimal_names[d + 1], fmt->decimals == d)) {
+                        fmt->decimals = d;
+                        ui_state->fmt_gen++;
+                    }
+                }
+                ImGui::EndCombo();
+            }
+            ImGui::SameLine();
+            bool thousands = fmt->thousands != 0;
+            if (ImGui::Checkbox("Thousands separator", &thousands)) {
+                fmt->thousands = thousands ? B8_TRUE : B8_FALSE;
+                ui_state->fmt_gen++;
+            }
+
+            ImGui::Spacing();
+            ImGui::Text(ICON_BOLT " Change Flash");
+            ImGui::Separator();
+
+            rfui_grid_flash_t* flash = &ui_state->flash;
+            bool flash_on = flash->enabled != 0;
+            if (ImGui::Checkbox("Flash changed cells", &flash_on)) {
+                flash->enabled = flash_on ? B8_TRUE : B8_FALSE;
+                rfui_grid_flash_clear(flash);
+            }
+
+            // Rows are matched by position unless a key column is chosen
+            const char* key_name = flash->key_col >= 0 && flash->key_col < ncols ?
+                rfui_symbols_get(AS_SYMBOL(keys)[flash->key_col]) : nullptr;
+            ImGui::SetNextItemWidth(160);
+            if (ImGui::BeginCombo("Match rows by", key_name ? key_name : "Row number")) {
+                if (ImGui::Selectable("Row number", flash->key_col < 0)) {
+                    flash->key_col = -1;
+                    rfui_grid_flash_clear(flash);
+                }
+                for (i64_t c = 0; c < ncols; c++) {
+                    obj_p col = AS_LIST(vals)[c];
+                    const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
+                    if (!name || !col || !rfui_grid_flash_key_supported(col->type)) continue;
+                    if (ImGui::Selectable(name, flash->key_col == c)) {
+                        flash->key_col = (i32_t)c;
+                        rfui_grid_flash_clear(flash);
+                    }
+                }
+                ImGui::EndCombo();
+            }
+
+            ImGui::Spacing();
+            ImGui::Text(ICON_GAUGE " Rendering");
+            ImGui::Separator();
+            ImGui::Checkbox("Dense rows (no table)", &ui_state->dense);
+
+            ImGui::EndPopup();
+        }
+
+        // Column profiler: runs only while the popup is open
+        ImGui::SameLine();
+        if (ImGui::SmallButton(ICON_CHART_COLUMN " Profile")) {
+            for (i64_t c = 0; c < ncols && ui_state->profile.col < 0; c++) {
+                obj_p col = AS_LIST(vals)[c];
+                if (rfui_grid_profile_supported(col->type)) rfui_grid_profile_open(&ui_state->profile, (i32_t)c);
+            }
+            ImGui::OpenPopup("GridProfile");
+        }
+        if (ImGui::BeginPopup("GridProfile")) {
+            draw_profile(&ui_state->profile, table, widget->version, keys, vals, &ui_state->fmt);
+            ImGui::EndPopup();
+        } else if (ui_state->profile.col >= 0) {
+            rfui_grid_profile_open(&ui_state->profile, -1);
+        }
+
+        // Pivot: settings popup; the grid below switches to the crosstab
+        ImGui::SameLine();
+        if (ImGui::SmallButton(ICON_TABLE " Pivot")) ImGui::OpenPopup("GridPivot");
+        if (ImGui::BeginPopup("GridPivot")) {
+            rfui_grid_pivot_t* pivot = &ui_state->pivot;
+            rfui_pivot_config_t* cfg = &pivot->config;
+            bool changed = false;
+            bool enabled = pivot->enabled;
+            if (ImGui::Checkbox("Show pivot", &enabled)) {
+                pivot->enabled = enabled ? B8_TRUE : B8_FALSE;
+                // Hidden pivots hold no memory and no table
+                if (!enabled) rfui_grid_pivot_free(pivot);
+                if (enabled && ui_state->group.enabled) {
+                    ui_state->group.enabled = B8_FALSE;
+                    rfui_grid_group_free(&ui_state->group);
+                }
+            }
+            ImGui::Separator();
+            changed |= keys_edit("Rows", cfg->row_keys, &cfg->nrow_keys, RFUI_PIVOT_MAX_KEYS, keys, vals,
+                                 rfui_grid_pivot_key_supported);
+            changed |= keys_edit("Columns", cfg->col_keys, &cfg->ncol_keys, RFUI_PIVOT_MAX_KEYS, keys, vals,
+                                 rfui_grid_pivot_key_supported);
+            static const char* const agg_names[] = {"sum", "avg", "count", "last"};
+            int agg = (int)cfg->agg;
+            ImGui::SetNextItemWidth(160.0f);
+            if (ImGui::Combo("Aggregate", &agg, agg_names, IM_ARRAYSIZE(agg_names))) {
+                cfg->agg = (rfui_pivot_agg_t)agg;
+                changed = true;
+            }
+            if (cfg->agg != RFUI_PIVOT_COUNT) {
+                changed |= column_combo("Value", &cfg->value, keys, vals, rfui_grid_pivot_value_supported);
+            }
+            if (changed) {
+                pivot->config_gen++;
+                pivot->enabled = B8_TRUE;
+                if (ui_state->group.enabled) {
+                    ui_state->group.enabled = B8_FALSE;
+                    rfui_grid_group_free(&ui_state->group);
+                }
+            }
+            ImGui::EndPopup();
+        }
+
+        // Group: key levels; the grid below switches to the tree
+        ImGui::SameLine();
+        if (ImGui::SmallButton(ICON_LAYER_GROUP " Group")) ImGui::OpenPopup("GridGroup");
+        if (ImGui::BeginPopup("GridGroup")) {
+            rfui_grid_group_t* group = &ui_state->group;
+            bool enabled = group->enabled;
+            if (ImGui::Checkbox("Group rows", &enabled)) {
+                group->enabled = enabled ? B8_TRUE : B8_FALSE;
+                // Like a hidden pivot, an ungrouped grid keeps no index
+                if (!enabled) rfui_grid_group_free(group);
+            }
+            ImGui::SameLine();
+            if (ImGui::SmallButton("Collapse all")) rfui_grid_group_collapse_all(group);
+            ImGui::Separator();
+            if (keys_edit("Group by", group->key_cols, &group->nkeys, RFUI_GROUP_MAX_LEVELS, keys, vals,
+                          rfui_grid_group_key_supported)) {
+                group->config_gen++;
+                group->enabled = B8_TRUE;
+            }
+            if (group->enabled && ui_state->pivot.enabled) {
+                ui_state->pivot.enabled = B8_FALSE;
+                rfui_grid_pivot_free(&ui_state->pivot);
+            }
+            ImGui::EndPopup();
+        }
+
+        // Columns: show / hide by name in every mode (wide and dense grids
+        // have no header menu)
+        ImGui::SameLine();
+        if (ImGui::SmallButton(ICON_EYE " Columns")) ImGui::OpenPopup("GridColumns");
+        if (ImGui::BeginPopup("GridColumns")) {
+            columns_edit(ui_state, keys);
+            ImGui::EndPopup();
+        }
+
+        // Export: one job at a time, progress and Cancel while it runs
+        rfui_grid_export_t* exporter = &ui_state->exporter;
+        char dialog_key[48];
+        snprintf(dialog_key, sizeof(dialog_key), "GridExport%p", (void*)widget);
+        ImGui::SameLine();
+        f64_t progress = rfui_grid_export_progress(exporter);
+        if (progress >= 0.0) {
+            ImGui::ProgressBar((float)progress, ImVec2(120.0f, ImGui::GetTextLineHeight()));
+            ImGui::SameLine();
+            if (ImGui::SmallButton(ICON_XMARK " Cancel")) rfui_grid_export_cancel(exporter);
+        } else {
+            if (ImGui::SmallButton(ICON_FILE_EXPORT " Export")) ImGui::OpenPopup("GridExport");
+            if (ui_state->select.count > 0 && !ui_state->export_pending &&
+                ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_C)) {
+                ui_state->export_pending = true;
+                ui_state->export_kind = RFUI_EXPORT_CLIPBOARD;
+            }
+        }
+        if (ImGui::BeginPopup("GridExport")) {
+            IGFD::FileDialogConfig config;
+            config.path = ".";
+            config.flags = ImGuiFileDialogFlags_ConfirmOverwrite | ImGuiFileDialogFlags_Modal;
+            if (ImGui::MenuItem(ICON_FILE_LINES " CSV File...")) {
+                ui_state->dialog_kind = RFUI_EXPORT_CSV;
+                config.fileName = "export.csv";
+                ImGuiFileDialog::Instance()->OpenDialog(dialog_key, "Export CSV", ".csv", config);
+            }
+            if (ImGui::MenuItem(ICON_FILE_LINES " TSV File...")) {
+                ui_state->dialog_kind = RFUI_EXPORT_TSV;
+                config.fileName = "export.tsv";
+                ImGuiFileDialog::Instance()->OpenDialog(dialog_key, "Export TSV", ".tsv", config);
+            }
+            if (ImGui::MenuItem(ICON_COPY " Copy Selection", "Ctrl+C", false, ui_state->select.count > 0)) {
+                ui_state->export_pending = true;
+                ui_state->export_kind = RFUI_EXPORT_CLIPBOARD;
+            }
             ImGui::EndPopup();
         }
+        if (ImGuiFileDialog::Instance()->Display(dialog_key, ImGuiWindowFlags_NoCollapse, ImVec2(800, 500))) {
+            if (ImGuiFileDialog::Instance()->IsOk()) {
+                std::string path = ImGuiFileDialog::Instance()->GetFilePathName();
+                snprintf(ui_state->export_path, sizeof(ui_state->export_path), "%s", path.c_str());
+                ui_state->export_pending = true;
+                ui_state->export_kind = ui_state->dialog_kind;
+            }
+            ImGuiFileDialog::Instance()->Close();
+        }
+
+        // Outcome of the last export, fading after a few seconds
+        if (exporter->status[0] && ImGui::GetTime() - exporter->status_time < GRID_EXPORT_STATUS_SECONDS) {
+            ImGui::SameLine();
+            if (exporter->failed) {
+                ImGui::TextColored(ImVec4(0.973f, 0.318f, 0.286f, 1.0f), "%s", exporter->status);  // #F85149
+            } else {
+                ImGui::TextDisabled("%s", exporter->status);
+            }
+        }
+
+        // Find: Ctrl+F focuses the box; Enter / F3 next, Shift+Enter / Shift+F3 previous
+        rfui_grid_find_t* find = &ui_state->find;
+        ImGui::SameLine();
+        if (ImGui::Shortcut(ImGuiMod_Ctrl | ImGuiKey_F)) ImGui::SetKeyboardFocusHere();
+        ImGui::SetNextItemWidth(160.0f);
+        bool find_enter = ImGui::InputTextWithHint("##find", ICON_MAGNIFYING_GLASS " Find (Ctrl+F)", find->text,
+                                                   sizeof(find->text),
+                                                   ImGuiInputTextFlags_EnterReturnsTrue |
+                                                   ImGuiInputTextFlags_EscapeClearsAll);
+        if (ImGui::IsItemEdited()) find->dirty = B8_TRUE;
+        if (find_enter) {
+            ui_state->find_step = ImGui::GetIO().KeyShift ? -1 : 1;
+            ImGui::SetKeyboardFocusHere(-1);   // Keep typing / stepping
+        }
+        if (ImGui::Shortcut(ImGuiKey_F3)) ui_state->find_step = 1;
+        if (ImGui::Shortcut(ImGuiMod_Shift | ImGuiKey_F3)) ui_state->find_step = -1;
+
+        i64_t find_cells;
+        f64_t scanned = rfui_grid_find_progress(find, &find_cells);
+        if (scanned >= 0.0) {
+            ImGui::SameLine();
+            if (ImGui::SmallButton(ICON_ARROW_UP "##findprev")) ui_state->find_step = -1;
+            ImGui::SameLine();
+            if (ImGui::SmallButton(ICON_ARROW_DOWN "##findnext")) ui_state->find_step = 1;
+            ImGui::SameLine();
+            if (scanned < 1.0) {
+                ImGui::TextDisabled("%lld matches (%d%%)", (long long)find_cells, (int)(scanned * 100.0));
+            } else {
+                ImGui::TextDisabled("%lld matches", (long long)find_cells);
+            }
+        }
     }
 
     ImGui::Separator();
 
-    // Create ImGui table with virtualization
+    // Hidden columns are shipped blank from the next draw on
+    if (ui_state) send_hidden(widget, ui_state, keys);
+
+    if (ui_state && ui_state->pivot.enabled) {
+        rfui_grid_pivot_update(&ui_state->pivot, table, widget->version);
+        draw_pivot(&ui_state->pivot, keys, &ui_state->fmt);
+        send_select(widget, &ui_state->select);
+        return;
+    }
+    if (ui_state && ui_state->group.enabled) {
+        rfui_grid_group_update(&ui_state->group, table, widget->version);
+        draw_grouped(ui_state, keys, vals);
+        send_select(widget, &ui_state->select);
+        return;
+    }
+    if (ui_state && ui_state->dense) {
+        draw_dense(widget, ui_state, table, keys, vals, perm, perm_n);
+        send_select(widget, &ui_state->select);
+        return;
+    }
+
+    // Create ImGui table with virtualization. Grids wider than the column
+    // window draw a moving window of columns between two spacers instead
+    // (see grid_columns.h); the header is then drawn and sorted here.
+    bool windowed = ncols > RFUI_GRID_COLUMN_WINDOW;
     ImGuiTableFlags table_flags =
-        ImGuiTableFlags_Resizable |
-        ImGuiTableFlags_Reorderable |
-        ImGuiTableFlags_Hideable |
-        ImGuiTableFlags_Sortable |
         ImGuiTableFlags_RowBg |
         ImGuiTableFlags_Borders |
         ImGuiTableFlags_ScrollX |
         ImGuiTableFlags_ScrollY |
         ImGuiTableFlags_SizingFixedFit;  // Required for specifying column widths
+    if (!windowed) {
+        table_flags |=
+            ImGuiTableFlags_Resizable |
+            ImGuiTableFlags_Reorderable |
+            ImGuiTableFlags_Hideable |
+            ImGuiTableFlags_Sortable |
+            ImGuiTableFlags_SortMulti |
+            ImGuiTableFlags_SortTristate;  // Natural order until a header is clicked
+    }
 
     // Use available content region for table
     ImVec2 outer_size = ImVec2(0.0f, 0.0f);
 
-    if (ImGui::BeginTable("##grid", (int)ncols, table_flags, outer_size)) {
-        // Setup columns with headers
-        for (i64_t col_idx = 0; col_idx < ncols; col_idx++) {
-            i64_t sym_id = AS_SYMBOL(keys)[col_idx];
-            const char* col_name = str_from_symbol(sym_id);
-            if (!col_name) col_name = "<invalid>";
+    // Data columns win[0..col_n) sit at table columns slot0..
+    i64_t win[RFUI_GRID_COLUMN_WINDOW];
+    i64_t col_n = 0;
+    int slot0 = 0;
+    int table_cols = (int)ncols;
+    if (windowed) {
+        slot0 = 1;
+        table_cols = RFUI_GRID_COLUMN_WINDOW + 2;
+    } else {
+        for (i64_t i = 0; i < ncols; i++) win[col_n++] = i;
+    }
 
-            // Get column type for sizing hints
-            obj_p col = AS_LIST(vals)[col_idx];
-            ImGuiTableColumnFlags col_flags = ImGuiTableColumnFlags_None;
+    if (ImGui::BeginTable("##grid", table_cols, table_flags, outer_size)) {
+        if (windowed) {
+            // Window from this frame's scroll position (inner window is current)
+            rfui_grid_columns_t* columns = ui_state ? &ui_state->columns : nullptr;
+            float pad = 1.0f + ImGui::GetStyle().CellPadding.x * 2.0f;  // Inner border + padding
+            if (columns) {
+                rfui_grid_columns_update(columns, vals, widget->version, pad, ui_state->hidden,
+                                         ui_state->hidden_gen);
+                col_n = rfui_grid_columns_window(columns, ImGui::GetScrollX(), win);
+            }
+            bool sized = columns && columns->widths;
+            if (!sized) {
+                for (col_n = 0; col_n < RFUI_GRID_COLUMN_WINDOW; col_n++) win[col_n] = col_n;
+            }
 
-            // Set initial column width based on type
-            float init_width = 0.0f;  // 0 = auto
-            if (col) {
+            // Spacers stand in for the columns scrolled past on either side.
+            // With enough columns hidden the window runs short; the slots
+            // left over stay disabled so the table keeps its shape.
+            ImGuiTableColumnFlags spacer_flags = ImGuiTableColumnFlags_WidthFixed |
+                ImGuiTableColumnFlags_NoResize | ImGuiTableColumnFlags_NoHeaderLabel;
+            float left = 0.0f, right = 0.0f;
+            if (sized && col_n > 0) {
+                left = columns->x[win[0]] - pad;
+                right = columns->x[ncols] - columns->x[win[col_n - 1] + 1] - pad;
+            }
+            ImGui::TableSetupColumn("##left", spacer_flags | (left > 0.0f ? 0 : ImGuiTableColumnFlags_Disabled),
+                                    left > 0.0f ? left : 1.0f);
+            for (i64_t i = 0; i < RFUI_GRID_COLUMN_WINDOW; i++) {
+                ImGuiTableColumnFlags flags = ImGuiTableColumnFlags_WidthFixed | ImGuiTableColumnFlags_NoResize;
+                if (i >= col_n) {
+                    ImGui::TableSetupColumn("##unused", flags | ImGuiTableColumnFlags_Disabled, 1.0f);
+                    continue;
+                }
+                i64_t col_idx = win[i];
+                const char* col_name = rfui_symbols_get(AS_SYMBOL(keys)[col_idx]);
+                obj_p col = AS_LIST(vals)[col_idx];
+                float width = sized ? columns->widths[col_idx] : rfui_grid_column_width(col ? col->type : TYPE_LIST);
+                ImGui::TableSetupColumn(col_name ? col_name : "<invalid>", flags, width);
+            }
+            ImGui::TableSetupColumn("##right", spacer_flags | (right > 0.0f ? 0 : ImGuiTableColumnFlags_Disabled),
+                                    right > 0.0f ? right : 1.0f);
+        } else {
+            // Setup columns with headers
+            for (i64_t col_idx = 0; col_idx < ncols; col_idx++) {
+                i64_t sym_id = AS_SYMBOL(keys)[col_idx];
+                const char* col_name = rfui_symbols_get(sym_id);
+                if (!col_name) col_name = "<invalid>";
+
+                // Set initial column width based on type (0 = auto)
+                obj_p col = AS_LIST(vals)[col_idx];
+                float init_width = col ? rfui_grid_column_width(col->type) : 0.0f;
+
+                ImGui::TableSetupColumn(col_name, ImGuiTableColumnFlags_None, init_width);
+            }
+        }
+
+        // Freeze header row (and the filter row under it)
+        ImGui::TableSetupScrollFreeze(0, ui_state ? 2 : 1);
+
+        if (windowed) {
+            // Own header row: ImGui's sort specs follow table columns, which
+            // move with the window
+            ImGui::TableNextRow(ImGuiTableRowFlags_Headers);
+            for (i64_t i = 0; i < col_n; i++) {
+                i64_t col_idx = win[i];
+                if (!ImGui::TableSetColumnIndex(slot0 + (int)i)) continue;
+
+                const char* col_name = rfui_symbols_get(AS_SYMBOL(keys)[col_idx]);
+                const char* arrow = "";
+                for (i32_t k = 0; ui_state && k < ui_state->sort.nkeys; k++) {
+                    if (ui_state->sort.keys[k].col == col_idx) {
+                        arrow = ui_state->sort.keys[k].desc ? " " ICON_SORT_DOWN : " " ICON_SORT_UP;
+                    }
+                }
+                char label[128];
+                snprintf(label, sizeof(label), "%s%s", col_name ? col_name : "<invalid>", arrow);
+
+                ImGui::PushID((int)col_idx);
+                ImGui::TableHeader(label);
+                if (ImGui::IsItemClicked(ImGuiMouseButton_Left) && ui_state) {
+                    rfui_grid_sort_click(&ui_state->sort, (i32_t)col_idx,
+                                         ImGui::GetIO().KeyShift ? B8_TRUE : B8_FALSE);
+                    perm = rfui_grid_sort_perm(&ui_state->sort, nrows, &perm_n);
+                }
+                ImGui::PopID();
+            }
+        } else {
+            // Display headers
+            ImGui::TableHeadersRow();
+        }
+
+        // A plain table hides columns from its header menu too
+        if (ui_state && !windowed) hidden_sync_table(ui_state, ncols);
+
+        // Header clicks: the new order is built on the worker pool
+        ImGuiTableSortSpecs* sort_specs = ImGui::TableGetSortSpecs();
+        if (ui_state && sort_specs && sort_specs->SpecsDirty) {
+            rfui_sort_key_t sort_keys[RFUI_SORT_MAX_KEYS];
+            int nkeys = 0;
+            for (int i = 0; i < sort_specs->SpecsCount && nkeys < RFUI_SORT_MAX_KEYS; i++) {
+                const ImGuiTableColumnSortSpecs* spec = &sort_specs->Specs[i];
+                sort_keys[nkeys].col = spec->ColumnIndex;
+                sort_keys[nkeys].desc = spec->SortDirection == ImGuiSortDirection_Descending ? B8_TRUE : B8_FALSE;
+                nkeys++;
+            }
+            rfui_grid_sort_set(&ui_state->sort, sort_keys, nkeys);
+            sort_specs->SpecsDirty = false;
+            perm = rfui_grid_sort_perm(&ui_state->sort, nrows, &perm_n);
+        }
+
+        // Filter row: one input per filterable column, rescanned when edited
+        const u32_t* rows = perm;
+        i64_t rows_n = perm_n;
+        i64_t display_rows = nrows;
+        if (ui_state) {
+            rfui_grid_filter_t* filter = &ui_state->filter;
+            rfui_grid_filter_resize(filter, ncols);
+
+            ImGui::TableNextRow();
+            for (i64_t i = 0; i < col_n && win[i] < filter->ncols; i++) {
+                i64_t col_idx = win[i];
+                obj_p col = AS_LIST(vals)[col_idx];
+                if (!ImGui::TableSetColumnIndex(slot0 + (int)i) || !col ||
+                    !rfui_grid_filter_supported(col->type)) {
+                    continue;
+                }
+
+                const char* hint;
                 switch (col->type) {
-                    case TYPE_B8:
-                        init_width = 50.0f;
-                        break;
-                    case TYPE_I16:
-                    case TYPE_I32:
-                        init_width = 80.0f;
-                        break;
-                    case TYPE_I64:
-                    case TYPE_TIMESTAMP:
-                        init_width = 120.0f;
-                        break;
-                    case TYPE_F64:
-                        init_width = 100.0f;
-                        break;
+                    case TYPE_SYMBOL: hint = "prefix or a,b"; break;
+                    case TYPE_LIST:   hint = "contains"; break;
+                    case TYPE_TIME:   hint = "09:30..10:00"; break;
                     case TYPE_DATE:
-                        init_width = 90.0f;
-                        break;
-                    case TYPE_TIME:
-                        init_width = 100.0f;
-                        break;
-                    case TYPE_SYMBOL:
-                    case TYPE_C8:
-                        init_width = 120.0f;
-                        break;
-                    case TYPE_GUID:
-                        init_width = 280.0f;
-                        break;
-                    default:
-                        init_width = 100.0f;
-                        break;
+                    case TYPE_TIMESTAMP: hint = ">=2024.01.31"; break;
+                    default:          hint = "10..20  >5"; break;
+                }
+
+                rfui_col_filter_t* cf = &filter->cols[col_idx];
+                ImGui::PushID((int)col_idx);
+                ImGui::SetNextItemWidth(-FLT_MIN);
+                if (cf->invalid) {
+                    ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(0.973f, 0.318f, 0.286f, 1.0f));  // #F85149
+                }
+                if (ImGui::InputTextWithHint("##filter", hint, cf->text, sizeof(cf->text))) {
+                    rfui_grid_filter_changed(filter, col_idx);
+                }
+                if (cf->invalid) {
+                    ImGui::PopStyleColor();
                 }
+                ImGui::PopID();
             }
 
-            ImGui::TableSetupColumn(col_name ? col_name : "?", col_flags, init_width);
-        }
+            rfui_grid_filter_update(filter, table, widget->version, perm, perm_n,
+                                    ui_state->sort.order_gen);
+            if (filter->active) {
+                rows = filter->sel;
+                rows_n = filter->nsel;
+                display_rows = filter->nsel;
+            }
 
-        // Freeze header row
-        ImGui::TableSetupScrollFreeze(0, 1);
+            if (ui_state->export_pending) {
+                start_export(ui_state, table, ncols, windowed, rows, rows_n, display_rows);
+            }
 
-        // Display headers
-        ImGui::TableHeadersRow();
+            if (ui_state->find_step) {
+                rfui_grid_find_next(&ui_state->find, table, rows, rows_n, display_rows, ui_state->find_step);
+                ui_state->find_step = 0;
+            }
+        }
 
         // Use ListClipper for virtualized row rendering
         ImGuiListClipper clipper;
-        clipper.Begin((int)nrows);
+        clipper.Begin((int)display_rows);
+
+        // Find: the match being jumped to is drawn even while off screen, so
+        // it can scroll itself into view (wide grids move the window first)
+        const rfui_grid_find_t* find = ui_state && ui_state->find.job ? &ui_state->find : nullptr;
+        bool find_jump = find && find->jump && find->cur_row >= 0 && find->cur_row < display_rows;
+        if (find_jump) {
+            clipper.IncludeItemByIndex((int)find->cur_row);
+            if (windowed && ui_state->columns.x && find->cur_col < ncols) {
+                ImGui::SetScrollX(ui_state->columns.x[find->cur_col] - ImGui::GetContentRegionAvail().x * 0.5f);
+            }
+            ui_state->find.jump = B8_FALSE;
+        }
 
         // Cache column pointers for performance (avoid repeated AS_LIST dereference)
         obj_p* cols = AS_LIST(vals);
 
-        // Pre-resolve color rule column indices
-        int rule_col_idx[MAX_COLOR_RULES];
+        // Compile rules into per-cell styles (no-op unless data or rules changed)
+        const rfui_grid_styles_t* styles = nullptr;
         if (ui_state) {
-            for (int ri = 0; ri < ui_state->num_rules; ri++) {
-                rule_col_idx[ri] = -1;
-                if (!ui_state->color_rules[ri].enabled || !ui_state->color_rules[ri].column[0])
-                    continue;
-                for (i64_t c = 0; c < ncols; c++) {
-                    const char* name = str_from_symbol(AS_SYMBOL(keys)[c]);
-                    if (name && strcmp(name, ui_state->color_rules[ri].column) == 0) {
-                        rule_col_idx[ri] = (int)c;
-                        break;
-                    }
-                }
-            }
+            rfui_grid_styles_update(&ui_state->styles, widget->version, ui_state->rules_version,
+                                    keys, vals, ui_state->rules, ui_state->num_rules);
+            if (ui_state->styles.cells) styles = &ui_state->styles;
+        }
+
+        // Changed-cell flash: per-cell lookups only while an update is fading
+        f64_t now = ImGui::GetTime();
+        const rfui_grid_flash_t* flash = nullptr;
+        if (ui_state && rfui_grid_flash_live(&ui_state->flash, now)) flash = &ui_state->flash;
+
+        // Sparkline widths follow the list columns' current pixel widths
+        i32_t spark_px[RFUI_GRID_COLUMN_WINDOW] = {};
+        ImGuiTable* grid_table = ImGui::GetCurrentTable();
+        for (i64_t i = 0; grid_table && i < col_n; i++) {
+            obj_p col = AS_LIST(vals)[win[i]];
+            if (col && col->type == TYPE_LIST) spark_px[i] = (i32_t)grid_table->Columns[slot0 + (int)i].WidthGiven;
         }
 
+        // The row selectable goes in the first drawn column that isn't hidden
+        // (a wide grid's window holds visible columns only)
+        i64_t select_i = 0;
+        while (select_i + 1 < col_n && column_hidden(ui_state, win[select_i])) select_i++;
+
         while (clipper.Step()) {
+            cell_cache_t* cache = nullptr;
+            // All three generations only grow, so their sum changes with any of them
+            i64_t layout = ui_state ? ui_state->sort.order_gen + ui_state->filter.gen + ui_state->fmt_gen : 0;
+            if (ui_state && cache_ensure(&ui_state->cache, widget->version, layout,
+                                         cols, win, col_n, display_rows, rows, rows_n,
+                                         &ui_state->fmt, spark_px, clipper.DisplayStart, clipper.DisplayEnd)) {
+                cache = &ui_state->cache;
+            }
+
             for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
                 ImGui::TableNextRow();
 
-                // Check if this row is selected
-                bool is_selected = (ui_state && ui_state->selected_row == row);
+                // Display row -> data row (rows appended since the last sort stay at the end)
+                i64_t data_row = (rows && row < rows_n) ? (i64_t)rows[row] : (i64_t)row;
+
+                // Check if this row is selected (selection is by data row)
+                bool is_selected = ui_state && rfui_grid_select_has(&ui_state->select, data_row);
 
                 // Render each cell in the row
-                for (i64_t col_idx = 0; col_idx < ncols; col_idx++) {
-                    ImGui::TableSetColumnIndex((int)col_idx);
+                for (i64_t i = 0; i < col_n; i++) {
+                    i64_t col_idx = win[i];
+                    ImGui::TableSetColumnIndex(slot0 + (int)i);
+                    if (i != select_i && column_hidden(ui_state, col_idx)) continue;
 
                     obj_p col = cols[col_idx];
                     if (col == nullptr) {
@@ -518,59 +1959,76 @@ nil_t rfui_render_grid(rfui_widget_t* widget) {
                     }
 
                     // Verify row is within column bounds
-                    if (row >= col->len) {
+                    if (data_row >= col->len) {
                         ImGui::TextDisabled("OOB");
                         continue;
                     }
 
-                    // For the first column, add a selectable that spans all columns
-                    if (col_idx == 0) {
+                    // For the first drawn column, add a selectable that spans all columns
+                    if (i == select_i) {
                         // Create unique ID for this row's selectable
                         char selectable_id[32];
                         snprintf(selectable_id, sizeof(selectable_id), "##row%d", row);
 
                         // Selectable spans all columns and is drawn behind cell content
+                        // SelectOnNav: arrow keys move the selection like clicks
                         if (ImGui::Selectable(selectable_id, is_selected,
                                               ImGuiSelectableFlags_SpanAllColumns |
-                                              ImGuiSelectableFlags_AllowOverlap)) {
-                            // Row was clicked
+                                              ImGuiSelectableFlags_AllowOverlap |
+                                              ImGuiSelectableFlags_SelectOnNav)) {
                             if (ui_state) {
-                                if (ui_state->selected_row == row) {
-                                    // Clicking same row deselects
-                                    ui_state->selected_row = -1;
-                                    send_post_query(widget, nullptr);
-                                } else {
-                                    // Select new row
-                                    ui_state->selected_row = row;
-                                    char* expr = build_row_filter_expr(row);
-                                    if (expr) {
-                                        send_post_query(widget, expr);
-                                        free(expr);
-                                    }
-                                }
+                                select_click(&ui_state->select, row, data_row, rows, rows_n,
+                                             display_rows);
                             }
                         }
                         ImGui::SameLine();
                     }
 
-                    // Check color rules for this cell
+                    if (find && rfui_grid_find_cell(find, table, col_idx, data_row)) {
+                        bool current = row == find->cur_row && col_idx == find->cur_col;
+                        ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, find_color(current));
+                        if (current && find_jump) {
+                            ImGui::SetScrollHereY(0.5f);
+                            if (!windowed) ImGui::SetScrollHereX(0.5f);
+                        }
+                    }
+
+                    if (flash) {
+                        float fade;
+                        u8_t dir = rfui_grid_flash_at(flash, col_idx, data_row, now, &fade);
+                        if (dir) ImGui::TableSetBgColor(ImGuiTableBgTarget_CellBg, flash_color(dir, fade));
+                    }
+
+                    // Conditional formatting: one style lookup per cell
                     bool cell_colored = false;
-                    if (ui_state) {
-                        for (int ri = 0; ri < ui_state->num_rules; ri++) {
-                            color_rule_t* r = &ui_state->color_rules[ri];
-                            if (!r->enabled || rule_col_idx[ri] != (int)col_idx) continue;
-                            char cell_buf[128];
-                            cell_to_string(col, (i64_t)row, cell_buf, sizeof(cell_buf));
-                            if (strcmp(cell_buf, r->value) == 0) {
-                                ImGui::PushStyleColor(ImGuiCol_Text, r->color);
-                                cell_colored = true;
-                                break;
-                            }
+                    if (styles && styles->cells[col_idx]) {
+                        uint16_t style = styles->cells[col_idx][data_row];
+                        if (style) {
+                            const rfui_rgba_t* c = &styles->palette[style];
+                            ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(c->r, c->g, c->b, c->a));
+                            cell_colored = true;
                         }
                     }
 
-                    // Render cell with zero-copy direct buffer access
-                    render_cell(col, (i64_t)row);
+                    // Render cell from the formatted cache (format inline without one)
+                    if (cache) {
+                        i64_t cell = i * cache->row_count + ((i64_t)row - cache->row_start);
+                        u32_t spark = cache->spark_offsets[cell];
+                        if (cache->spark_offsets[cell + 1] > spark) {
+                            draw_spark(cache->spark.points + spark, (int)(cache->spark_offsets[cell + 1] - spark));
+                            if (cell_colored) ImGui::PopStyleColor();
+                            continue;
+                        }
+                        u32_t begin = cache->offsets[cell];
+                        draw_cell_text(cache->text.text + begin, (int)(cache->offsets[cell + 1] - begin),
+                                       cache->disabled[cell] != 0);
+                    } else {
+                        char buf[RFUI_FMT_CELL_MAX];
+                        b8_t disabled;
+                        int len = rfui_fmt_cell(col, data_row, ui_state ? &ui_state->fmt : &rfui_fmt_default,
+                                                buf, sizeof(buf), &disabled);
+                        draw_cell_text(buf, len, disabled != 0);
+                    }
 
                     if (cell_colored)
                         ImGui::PopStyleColor();
@@ -581,6 +2039,86 @@ nil_t rfui_render_grid(rfui_widget_t* widget) {
         clipper.End();
         ImGui::EndTable();
     }
+
+    if (ui_state) send_select(widget, &ui_state->select);
+}
+
+i64_t rfui_grid_state_bytes(rfui_widget_t* widget) {
+    if (!widget || !widget->ui_state) return 0;
+    const grid_ui_state_t* state = (const grid_ui_state_t*)widget->ui_state;
+    const cell_cache_t* cache = &state->cache;
+    return (i64_t)sizeof(grid_ui_state_t) + cache->cells_cap * (i64_t)(2 * sizeof(u32_t) + 1) +
+           cache->text.cap + cache->spark.cap + cache->spare.cap + cache->spare_spark.cap +
+           cache->patch_cap * (i64_t)sizeof(i64_t) + state->rules_cap * (i64_t)sizeof(rfui_grid_rule_t) +
+           rfui_grid_styles_bytes(&state->styles) + rfui_grid_sort_bytes(&state->sort) +
+           rfui_grid_filter_bytes(&state->filter) + rfui_grid_select_bytes(&state->select) +
+           rfui_grid_profile_bytes(&state->profile) + rfui_grid_columns_bytes(&state->columns) +
+           rfui_grid_flash_bytes(&state->flash) + rfui_grid_pivot_bytes(&state->pivot) +
+           rfui_grid_group_bytes(&state->group) + rfui_grid_find_bytes(&state->find) +
+           state->hidden_n + state->nhidden_sent * (i64_t)sizeof(i64_t);
+}
+
+obj_p rfui_grid_retire_data(rfui_widget_t* widget, obj_p old_data, i64_t bytes) {
+    if (!widget || !widget->ui_state) return old_data;
+    grid_ui_state_t* state = (grid_ui_state_t*)widget->ui_state;
+    // Diff once per update while both tables are at hand
+    rfui_grid_flash_diff(&state->flash, old_data, widget->render_data, ImGui::GetTime());
+    if (!jobs_read(state, old_data)) return old_data;
+    for (int i = 0; i < GRID_RETIRED_MAX; i++) {
+        if (!state->retired[i]) {
+            state->retired[i] = old_data;
+            state->retired_bytes[i] = bytes;
+            return nullptr;
+        }
+    }
+    return old_data;
+}
+
+nil_t rfui_grid_upsert_rows(rfui_widget_t* widget, i64_t base, const i64_t* rows, i64_t n) {
+    if (!widget || !widget->ui_state) return;
+    cell_cache_t* cache = &((grid_ui_state_t*)widget->ui_state)->cache;
+    // Start over from the cached version, or chain onto the last upsert
+    if (cache->version == base || cache->patch_version != base) {
+        cache->patch_base = base;
+        cache->npatch = 0;
+    }
+    if (cache->npatch + n > cache->patch_cap) {
+        i64_t cap = cache->patch_cap ? cache->patch_cap : 1024;
+        while (cap < cache->npatch + n) cap *= 2;
+        i64_t* grown = (i64_t*)realloc(cache->patch_rows, sizeof(i64_t) * (size_t)cap);
+        if (!grown) {
+            cache->patch_base = -1;   // Rebuild the window instead
+            return;
+        }
+        cache->patch_rows = grown;
+        cache->patch_cap = cap;
+    }
+    if (n > 0) memcpy(cache->patch_rows + cache->npatch, rows, sizeof(i64_t) * (size_t)n);
+    cache->npatch += n;
+    cache->patch_version = widget->version;
+}
+
+nil_t rfui_grid_free_state(rfui_widget_t* widget) {
+    if (!widget || !widget->ui_state) return;
+    grid_ui_state_t* state = (grid_ui_state_t*)widget->ui_state;
+    // Parked tables are abandoned like render_data at shutdown
+    rfui_grid_sort_free(&state->sort);
+    rfui_grid_profile_free(&state->profile);
+    rfui_grid_export_free(&state->exporter);
+    rfui_grid_pivot_free(&state->pivot);
+    rfui_grid_group_free(&state->group);
+    rfui_grid_find_free(&state->find);
+    cache_free(&state->cache);
+    rfui_grid_styles_free(&state->styles);
+    rfui_grid_filter_free(&state->filter);
+    rfui_grid_columns_free(&state->columns);
+    rfui_grid_flash_free(&state->flash);
+    rfui_grid_select_free(&state->select);
+    free(state->hidden);
+    free(state->hidden_sent);
+    free(state->rules);
+    free(state);
+    widget->ui_state = nullptr;
 }
 
 } // extern "C"
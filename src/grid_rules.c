@@ -0,0 +1,672 @@
+// src/grid_rules.c
+// Conditional formatting engine: rules -> typed predicates -> per-cell styles
+//
+// Numeric rules compile to an inclusive [lo, hi] range (or a set of values)
+// in the column's own domain, so each rule is one branchless pass over the
+// column that the compiler vectorizes. Symbol rules decide once per distinct
+// symbol id and memoize. Rules are applied last to first so the first
+// matching rule owns the cell, as in the per-cell matcher this replaces.
+// The grid filter bar evaluates its filters through the same passes.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/rfui/grid_rules.h"
+#include "../include/rfui/symbols.h"
+
+#define MAX_SET_VALUES 64
+#define MAX_PALETTE 65535
+
+const char* rfui_rule_op_names[RFUI_RULE_OP_COUNT] = {
+    "=", "<", ">", "between", "in", "gradient", "prefix", "contains"
+};
+
+// Rule values parsed for one column type
+typedef struct compiled_t {
+    i64_t lo, hi;                    // Integer-domain columns
+    f64_t flo, fhi;                  // F64 columns
+    i32_t nset;
+    i64_t set[MAX_SET_VALUES];       // IN on integer columns
+    f64_t fset[MAX_SET_VALUES];      // IN on F64 columns
+    char* sset[MAX_SET_VALUES];      // IN on symbols (into buf)
+    char buf[64];
+} compiled_t;
+
+static b8_t is_int_domain(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8:
+        case TYPE_B8: case TYPE_C8:
+        case TYPE_DATE: case TYPE_TIME: case TYPE_TIMESTAMP:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+static b8_t rule_supported(i32_t op, i8_t type) {
+    if (op < 0 || op >= RFUI_RULE_OP_COUNT) return B8_FALSE;
+    if (type == TYPE_SYMBOL) return op != RFUI_RULE_GRADIENT;
+    if (type == TYPE_LIST) return op == RFUI_RULE_PREFIX || op == RFUI_RULE_CONTAINS;
+    if (op == RFUI_RULE_PREFIX || op == RFUI_RULE_CONTAINS) return B8_FALSE;
+    if (op == RFUI_RULE_GRADIENT) {
+        return type == TYPE_F64 || (is_int_domain(type) && type != TYPE_B8 && type != TYPE_C8);
+    }
+    return is_int_domain(type) || type == TYPE_F64;
+}
+
+// Copy src without surrounding blanks (and a leading quote on symbols)
+static void trim_copy(char* dst, size_t dst_sz, const char* src, size_t len) {
+    while (len > 0 && (*src == ' ' || *src == '\t')) { src++; len--; }
+    while (len > 0 && (src[len - 1] == ' ' || src[len - 1] == '\t')) len--;
+    if (len > 0 && *src == '\'') { src++; len--; }
+    if (len >= dst_sz) len = dst_sz - 1;
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
+
+// Days since 2000.01.01 for a civil date
+static i64_t days_from_civil(i64_t y, i64_t m, i64_t d) {
+    y -= m <= 2;
+    i64_t era = (y >= 0 ? y : y - 399) / 400;
+    i64_t yoe = y - era * 400;
+    i64_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    i64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 730425;
+}
+
+// HH:MM[:SS[.fffffffff]] -> nanoseconds; false on trailing junk
+static b8_t parse_time_ns(const char* s, i64_t* out) {
+    int hr, min, sec = 0, used = 0;
+    if (sscanf(s, "%d:%d%n", &hr, &min, &used) < 2) return B8_FALSE;
+    s += used;
+    if (*s == ':') {
+        if (sscanf(s, ":%d%n", &sec, &used) < 1) return B8_FALSE;
+        s += used;
+    }
+    i64_t frac = 0, scale = 100000000;
+    if (*s == '.') {
+        for (s++; *s >= '0' && *s <= '9'; s++, scale /= 10) frac += (*s - '0') * scale;
+    }
+    if (*s) return B8_FALSE;
+    *out = ((i64_t)(hr * 60 + min) * 60 + sec) * 1000000000LL + frac;
+    return B8_TRUE;
+}
+
+b8_t rfui_grid_rule_parse(i8_t type, const char* text, f64_t* out) {
+    char s[64];
+    trim_copy(s, sizeof(s), text, strlen(text));
+    if (!s[0]) return B8_FALSE;
+
+    if (type == TYPE_B8) {
+        if (strcmp(s, "true") == 0 || strcmp(s, "1") == 0) { *out = 1.0; return B8_TRUE; }
+        if (strcmp(s, "false") == 0 || strcmp(s, "0") == 0) { *out = 0.0; return B8_TRUE; }
+        return B8_FALSE;
+    }
+    if (type == TYPE_C8 && s[1] == '\0') {
+        *out = (f64_t)s[0];
+        return B8_TRUE;
+    }
+    if (type == TYPE_TIME && strchr(s, ':')) {
+        // HH:MM[:SS[.mmm]] -> milliseconds since midnight (the fraction is
+        // read by digit position, so .5 is 500 ms)
+        i64_t ns;
+        if (!parse_time_ns(s, &ns)) return B8_FALSE;
+        *out = (f64_t)(ns / 1000000);
+        return B8_TRUE;
+    }
+
+    if (type == TYPE_DATE || type == TYPE_TIMESTAMP) {
+        // YYYY.MM.DD[DHH:MM[:SS[.fff]]] -> days / nanoseconds since 2000.01.01
+        int y, mo, d, used = 0;
+        if (sscanf(s, "%d.%d.%d%n", &y, &mo, &d, &used) == 3) {
+            if (mo < 1 || mo > 12 || d < 1 || d > 31) return B8_FALSE;
+            i64_t days = days_from_civil(y, mo, d);
+            i64_t ns = 0;
+            if (type == TYPE_DATE && s[used]) return B8_FALSE;
+            if (type == TYPE_TIMESTAMP && s[used] && (s[used] != 'D' || !parse_time_ns(s + used + 1, &ns))) {
+                return B8_FALSE;
+            }
+            *out = type == TYPE_DATE ? (f64_t)days : (f64_t)(days * 86400000000000LL + ns);
+            return B8_TRUE;
+        }
+    }
+
+    char* end;
+    f64_t v = strtod(s, &end);
+    if (end == s || *end != '\0' || v != v) return B8_FALSE;
+    *out = v;
+    return B8_TRUE;
+}
+
+static i64_t clamp_i64(f64_t v) {
+    if (v <= -9.2e18) return INT64_MIN;
+    if (v >= 9.2e18) return INT64_MAX;
+    return (i64_t)v;
+}
+
+// Smallest valid value (null sentinels sit at the type minimum)
+static i64_t int_floor(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: return NULL_I64 + 1;
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: return (i64_t)NULL_I32 + 1;
+        default: return INT64_MIN;
+    }
+}
+
+// Compile the rule's range/set. Returns false when the rule can't match.
+static b8_t compile_rule(const rfui_grid_rule_t* r, i8_t type, compiled_t* c) {
+    f64_t v1 = 0.0, v2 = 0.0;
+    b8_t has1 = B8_FALSE, has2 = B8_FALSE;
+
+    c->nset = 0;
+    if (type == TYPE_SYMBOL || type == TYPE_LIST) {
+        if (r->op == RFUI_RULE_IN) {
+            // Split "a, b, c" into trimmed strings inside c->buf
+            const char* p = r->value;
+            char* dst = c->buf;
+            size_t left = sizeof(c->buf);
+            while (*p && c->nset < MAX_SET_VALUES && left > 1) {
+                const char* comma = strchr(p, ',');
+                size_t len = comma ? (size_t)(comma - p) : strlen(p);
+                trim_copy(dst, left, p, len);
+                size_t n = strlen(dst);
+                if (n > 0) {
+                    c->sset[c->nset++] = dst;
+                    dst += n + 1;
+                    left -= n + 1;
+                }
+                if (!comma) break;
+                p = comma + 1;
+            }
+            return c->nset > 0;
+        }
+        // EQ/LT/GT/BETWEEN compare against c->buf = "value\0value2"
+        trim_copy(c->buf, sizeof(c->buf), r->value, strlen(r->value));
+        size_t n1 = strlen(c->buf) + 1;
+        c->sset[0] = c->buf + n1 - 1;  // Empty value2 unless it fits
+        if (n1 < sizeof(c->buf)) {
+            trim_copy(c->buf + n1, sizeof(c->buf) - n1, r->value2, strlen(r->value2));
+            c->sset[0] = c->buf + n1;
+        }
+        if (r->op == RFUI_RULE_BETWEEN) return c->buf[0] != '\0' || c->sset[0][0] != '\0';
+        return c->buf[0] != '\0';
+    }
+
+    if (r->op == RFUI_RULE_IN) {
+        const char* p = r->value;
+        while (*p && c->nset < MAX_SET_VALUES) {
+            const char* comma = strchr(p, ',');
+            size_t len = comma ? (size_t)(comma - p) : strlen(p);
+            char item[64];
+            trim_copy(item, sizeof(item), p, len);
+            f64_t v;
+            if (rfui_grid_rule_parse(type, item, &v)) {
+                if (type == TYPE_F64) {
+                    c->fset[c->nset++] = v;
+                } else if (v == floor(v)) {
+                    c->set[c->nset++] = clamp_i64(v);
+                }
+            }
+            if (!comma) break;
+            p = comma + 1;
+        }
+        return c->nset > 0;
+    }
+
+    has1 = rfui_grid_rule_parse(type, r->value, &v1);
+    has2 = rfui_grid_rule_parse(type, r->value2, &v2);
+
+    if (type == TYPE_F64) {
+        c->flo = -INFINITY;
+        c->fhi = INFINITY;
+        switch (r->op) {
+            case RFUI_RULE_EQ: if (!has1) return B8_FALSE; c->flo = c->fhi = v1; break;
+            case RFUI_RULE_LT: if (!has1) return B8_FALSE; c->fhi = nextafter(v1, -INFINITY); break;
+            case RFUI_RULE_GT: if (!has1) return B8_FALSE; c->flo = nextafter(v1, INFINITY); break;
+            case RFUI_RULE_BETWEEN:
+            case RFUI_RULE_GRADIENT:
+                if (r->op == RFUI_RULE_BETWEEN && !has1 && !has2) return B8_FALSE;
+                if (has1) c->flo = v1;
+                if (has2) c->fhi = v2;
+                break;
+        }
+        return c->flo <= c->fhi;
+    }
+
+    c->lo = int_floor(type);
+    c->hi = INT64_MAX;
+    switch (r->op) {
+        case RFUI_RULE_EQ:
+            if (!has1 || v1 != floor(v1)) return B8_FALSE;
+            c->lo = c->hi = clamp_i64(v1);
+            break;
+        case RFUI_RULE_LT:
+            if (!has1 || clamp_i64(ceil(v1)) == INT64_MIN) return B8_FALSE;
+            c->hi = clamp_i64(ceil(v1)) - 1;
+            break;
+        case RFUI_RULE_GT:
+            if (!has1 || clamp_i64(floor(v1)) == INT64_MAX) return B8_FALSE;
+            c->lo = clamp_i64(floor(v1)) + 1;
+            break;
+        case RFUI_RULE_BETWEEN:
+        case RFUI_RULE_GRADIENT:
+            if (r->op == RFUI_RULE_BETWEEN && !has1 && !has2) return B8_FALSE;
+            if (has1) c->lo = clamp_i64(ceil(v1));
+            if (has2) c->hi = clamp_i64(floor(v2));
+            break;
+    }
+    if (c->lo < int_floor(type)) c->lo = int_floor(type);
+    return c->lo <= c->hi;
+}
+
+// ============================================================================
+// Column passes (branchless so the loops vectorize)
+// ============================================================================
+
+#define RANGE_PASS(T, arr) \
+    do { \
+        const T* a = (const T*)(arr); \
+        for (i64_t i = 0; i < n; i++) { \
+            i64_t x = (i64_t)a[i]; \
+            out[i] = ((x >= lo) & (x <= hi)) ? style : out[i]; \
+        } \
+    } while (0)
+
+static void int_pass(obj_p col, i64_t lo, i64_t hi, uint16_t style, uint16_t* out) {
+    i64_t n = col->len;
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: RANGE_PASS(i64_t, AS_I64(col)); break;
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: RANGE_PASS(i32_t, AS_I32(col)); break;
+        case TYPE_I16: RANGE_PASS(i16_t, AS_I16(col)); break;
+        case TYPE_U8: case TYPE_B8: RANGE_PASS(u8_t, AS_U8(col)); break;
+        case TYPE_C8: RANGE_PASS(c8_t, AS_C8(col)); break;
+        default: break;
+    }
+}
+
+static void f64_pass(obj_p col, f64_t lo, f64_t hi, uint16_t style, uint16_t* out) {
+    const f64_t* a = AS_F64(col);
+    i64_t n = col->len;
+    for (i64_t i = 0; i < n; i++) {
+        f64_t x = a[i];
+        out[i] = ((x >= lo) & (x <= hi)) ? style : out[i];  // NaN (null) never matches
+    }
+}
+
+#define MINMAX_PASS(T, arr, is_null) \
+    do { \
+        const T* a = (const T*)(arr); \
+        for (i64_t i = 0; i < n; i++) { \
+            T v = a[i]; \
+            if (is_null) continue; \
+            if ((f64_t)v < *lo) *lo = (f64_t)v; \
+            if ((f64_t)v > *hi) *hi = (f64_t)v; \
+        } \
+    } while (0)
+
+static void column_minmax(obj_p col, f64_t* lo, f64_t* hi) {
+    i64_t n = col->len;
+    *lo = INFINITY;
+    *hi = -INFINITY;
+    switch (col->type) {
+        case TYPE_F64: MINMAX_PASS(f64_t, AS_F64(col), v != v); break;
+        case TYPE_I64: case TYPE_TIMESTAMP: MINMAX_PASS(i64_t, AS_I64(col), v == NULL_I64); break;
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: MINMAX_PASS(i32_t, AS_I32(col), v == NULL_I32); break;
+        case TYPE_I16: MINMAX_PASS(i16_t, AS_I16(col), 0); break;
+        case TYPE_U8: MINMAX_PASS(u8_t, AS_U8(col), 0); break;
+        default: break;
+    }
+}
+
+#define GRADIENT_PASS(T, arr, is_null) \
+    do { \
+        const T* a = (const T*)(arr); \
+        for (i64_t i = 0; i < n; i++) { \
+            T v = a[i]; \
+            f64_t t = ((f64_t)v - lo) * scale; \
+            t = t < 0.0 ? 0.0 : (t > top ? top : t); \
+            uint16_t st = (uint16_t)(base + (i32_t)(t + 0.5)); \
+            out[i] = (is_null) ? out[i] : st; \
+        } \
+    } while (0)
+
+static void gradient_pass(obj_p col, f64_t lo, f64_t hi, uint16_t base, uint16_t* out) {
+    i64_t n = col->len;
+    const f64_t top = (f64_t)(RFUI_GRADIENT_STEPS - 1);
+    f64_t scale = hi > lo ? top / (hi - lo) : 0.0;
+    switch (col->type) {
+        case TYPE_F64: GRADIENT_PASS(f64_t, AS_F64(col), v != v); break;
+        case TYPE_I64: case TYPE_TIMESTAMP: GRADIENT_PASS(i64_t, AS_I64(col), v == NULL_I64); break;
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: GRADIENT_PASS(i32_t, AS_I32(col), v == NULL_I32); break;
+        case TYPE_I16: GRADIENT_PASS(i16_t, AS_I16(col), 0); break;
+        case TYPE_U8: GRADIENT_PASS(u8_t, AS_U8(col), 0); break;
+        default: break;
+    }
+}
+
+// ============================================================================
+// Text matching (symbols and string columns)
+// ============================================================================
+
+static inline char lower(char ch) {
+    return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch;
+}
+
+static b8_t starts_with_nocase(const char* s, i64_t len, const char* prefix) {
+    i64_t i = 0;
+    for (; prefix[i]; i++) {
+        if (i >= len || lower(s[i]) != lower(prefix[i])) return B8_FALSE;
+    }
+    return B8_TRUE;
+}
+
+static b8_t contains_nocase(const char* s, i64_t len, const char* needle) {
+    i64_t n = (i64_t)strlen(needle);
+    if (n == 0) return B8_TRUE;
+    char first = lower(needle[0]);
+    for (i64_t i = 0; i + n <= len; i++) {
+        if (lower(s[i]) == first && starts_with_nocase(s + i, len - i, needle)) return B8_TRUE;
+    }
+    return B8_FALSE;
+}
+
+// String column: a list of C8 vectors
+static void string_pass(const rfui_grid_rule_t* r, const compiled_t* c, obj_p col,
+                        uint16_t style, uint16_t* out) {
+    obj_p* items = AS_LIST(col);
+    i64_t n = col->len;
+    for (i64_t i = 0; i < n; i++) {
+        obj_p item = items[i];
+        if (!item || item->type != TYPE_C8) continue;
+        b8_t hit = r->op == RFUI_RULE_PREFIX
+            ? starts_with_nocase(AS_C8(item), item->len, c->buf)
+            : contains_nocase(AS_C8(item), item->len, c->buf);
+        if (hit) out[i] = style;
+    }
+}
+
+// Symbol columns: one string comparison per distinct id
+
+#define MEMO_EMPTY 0xFF
+
+typedef struct sym_memo_t {
+    i64_t* ids;
+    u8_t* match;     // 0/1, MEMO_EMPTY = free slot
+    i64_t cap;       // Power of two
+    i64_t count;
+} sym_memo_t;
+
+static b8_t memo_init(sym_memo_t* m, i64_t cap) {
+    m->ids = (i64_t*)malloc(sizeof(i64_t) * cap);
+    m->match = (u8_t*)malloc(cap);
+    if (!m->ids || !m->match) {
+        free(m->ids);
+        free(m->match);
+        return B8_FALSE;
+    }
+    memset(m->match, MEMO_EMPTY, cap);
+    m->cap = cap;
+    m->count = 0;
+    return B8_TRUE;
+}
+
+static i64_t memo_slot(const sym_memo_t* m, i64_t id) {
+    u64_t h = ((u64_t)id * 0x9E3779B97F4A7C15ULL) >> 17;
+    i64_t mask = m->cap - 1;
+    i64_t i = (i64_t)h & mask;
+    while (m->match[i] != MEMO_EMPTY && m->ids[i] != id) i = (i + 1) & mask;
+    return i;
+}
+
+static b8_t memo_grow(sym_memo_t* m) {
+    sym_memo_t next;
+    if (!memo_init(&next, m->cap * 2)) return B8_FALSE;
+    for (i64_t i = 0; i < m->cap; i++) {
+        if (m->match[i] == MEMO_EMPTY) continue;
+        i64_t s = memo_slot(&next, m->ids[i]);
+        next.ids[s] = m->ids[i];
+        next.match[s] = m->match[i];
+    }
+    next.count = m->count;
+    free(m->ids);
+    free(m->match);
+    *m = next;
+    return B8_TRUE;
+}
+
+static u8_t symbol_matches(const rfui_grid_rule_t* r, const compiled_t* c, const char* s) {
+    if (!s) return 0;
+    switch (r->op) {
+        case RFUI_RULE_EQ: return strcmp(s, c->buf) == 0;
+        case RFUI_RULE_LT: return strcmp(s, c->buf) < 0;
+        case RFUI_RULE_GT: return strcmp(s, c->buf) > 0;
+        case RFUI_RULE_BETWEEN:
+            return (!c->buf[0] || strcmp(s, c->buf) >= 0) &&
+                   (!c->sset[0][0] || strcmp(s, c->sset[0]) <= 0);
+        case RFUI_RULE_IN:
+            for (i32_t k = 0; k < c->nset; k++) {
+                if (strcmp(s, c->sset[k]) == 0) return 1;
+            }
+            return 0;
+        case RFUI_RULE_PREFIX: return starts_with_nocase(s, (i64_t)strlen(s), c->buf);
+        case RFUI_RULE_CONTAINS: return contains_nocase(s, (i64_t)strlen(s), c->buf);
+        default:
+            return 0;
+    }
+}
+
+static void symbol_pass(const rfui_grid_rule_t* r, const compiled_t* c, obj_p col,
+                        uint16_t style, uint16_t* out) {
+    sym_memo_t memo;
+    if (!memo_init(&memo, 256)) return;
+
+    const i64_t* ids = AS_SYMBOL(col);
+    i64_t n = col->len;
+    i64_t last_id = 0;
+    u8_t last = 0;
+    b8_t have_last = B8_FALSE;
+
+    for (i64_t i = 0; i < n; i++) {
+        i64_t id = ids[i];
+        if (!have_last || id != last_id) {
+            i64_t s = memo_slot(&memo, id);
+            if (memo.match[s] == MEMO_EMPTY) {
+                memo.ids[s] = id;
+                memo.match[s] = symbol_matches(r, c, rfui_symbols_get(id));
+                if (++memo.count * 2 > memo.cap && !memo_grow(&memo)) break;
+                s = memo_slot(&memo, id);
+            }
+            last = memo.match[s];
+            last_id = id;
+            have_last = B8_TRUE;
+        }
+        if (last) out[i] = style;
+    }
+
+    free(memo.ids);
+    free(memo.match);
+}
+
+static void apply_compiled(const rfui_grid_rule_t* r, compiled_t* c, obj_p col,
+                           uint16_t style, uint16_t* out) {
+    if (col->type == TYPE_SYMBOL) {
+        symbol_pass(r, c, col, style, out);
+    } else if (col->type == TYPE_LIST) {
+        string_pass(r, c, col, style, out);
+    } else if (r->op == RFUI_RULE_IN) {
+        for (i32_t k = 0; k < c->nset; k++) {
+            if (col->type == TYPE_F64) {
+                f64_pass(col, c->fset[k], c->fset[k], style, out);
+            } else {
+                int_pass(col, c->set[k], c->set[k], style, out);
+            }
+        }
+    } else if (col->type == TYPE_F64) {
+        f64_pass(col, c->flo, c->fhi, style, out);
+    } else {
+        int_pass(col, c->lo, c->hi, style, out);
+    }
+}
+
+b8_t rfui_grid_rule_apply(const rfui_grid_rule_t* r, obj_p col, uint16_t style, uint16_t* out) {
+    compiled_t compiled;
+    if (!col || r->op == RFUI_RULE_GRADIENT || !rule_supported(r->op, col->type)) return B8_FALSE;
+    if (!compile_rule(r, col->type, &compiled)) return B8_FALSE;
+    apply_compiled(r, &compiled, col, style, out);
+    return B8_TRUE;
+}
+
+// ============================================================================
+// Styles
+// ============================================================================
+
+static i64_t palette_add(rfui_grid_styles_t* s, const float* rgba) {
+    if (s->npalette >= MAX_PALETTE) return -1;
+    if (s->npalette >= s->palette_cap) {
+        i64_t cap = s->palette_cap ? s->palette_cap * 2 : 64;
+        rfui_rgba_t* p = (rfui_rgba_t*)realloc(s->palette, sizeof(rfui_rgba_t) * cap);
+        if (!p) return -1;
+        s->palette = p;
+        s->palette_cap = cap;
+    }
+    rfui_rgba_t* e = &s->palette[s->npalette];
+    e->r = rgba[0];
+    e->g = rgba[1];
+    e->b = rgba[2];
+    e->a = rgba[3] > 0.0f ? rgba[3] : 1.0f;
+    return s->npalette++;
+}
+
+static void free_cells(rfui_grid_styles_t* s) {
+    if (s->cells) {
+        for (i64_t c = 0; c < s->ncols; c++) free(s->cells[c]);
+        free(s->cells);
+    }
+    s->cells = NULL;
+    s->ncols = 0;
+    s->nrows = 0;
+}
+
+static i32_t rule_column(const rfui_grid_rule_t* r, obj_p keys) {
+    if (!r->enabled || !r->column[0]) return -1;
+    for (i64_t c = 0; c < keys->len; c++) {
+        const char* name = rfui_symbols_get(AS_SYMBOL(keys)[c]);
+        if (name && strcmp(name, r->column) == 0) return (i32_t)c;
+    }
+    return -1;
+}
+
+nil_t rfui_grid_styles_update(rfui_grid_styles_t* s, i64_t version, i64_t rules_version,
+                              obj_p keys, obj_p vals,
+                              const rfui_grid_rule_t* rules, i32_t nrules) {
+    if (s->version == version && s->rules_version == rules_version) return;
+
+    i64_t ncols = keys->len;
+    i64_t nrows = ncols > 0 ? AS_LIST(vals)[0]->len : 0;
+
+    s->version = version;
+    s->rules_version = rules_version;
+    s->npalette = 0;
+    float none[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    palette_add(s, none);  // Style 0 = unstyled
+
+    if (s->ncols != ncols || s->nrows != nrows) {
+        free_cells(s);
+    }
+    if (!s->cells) {
+        s->cells = (uint16_t**)calloc(ncols > 0 ? ncols : 1, sizeof(uint16_t*));
+        if (!s->cells) return;
+        s->ncols = ncols;
+        s->nrows = nrows;
+    }
+
+    i32_t* rule_col = (i32_t*)malloc(sizeof(i32_t) * (nrules > 0 ? nrules : 1));
+    if (!rule_col) return;
+
+    // Which columns carry rules this build
+    for (i32_t ri = 0; ri < nrules; ri++) {
+        i32_t c = rule_column(&rules[ri], keys);
+        if (c >= 0 && !rule_supported(rules[ri].op, AS_LIST(vals)[c]->type)) c = -1;
+        rule_col[ri] = c;
+    }
+    for (i64_t c = 0; c < ncols; c++) {
+        b8_t needed = B8_FALSE;
+        for (i32_t ri = 0; ri < nrules && !needed; ri++) needed = rule_col[ri] == (i32_t)c;
+        if (!needed) {
+            free(s->cells[c]);
+            s->cells[c] = NULL;
+            continue;
+        }
+        if (!s->cells[c]) {
+            s->cells[c] = (uint16_t*)malloc(sizeof(uint16_t) * (nrows > 0 ? nrows : 1));
+            if (!s->cells[c]) continue;
+        }
+        memset(s->cells[c], 0, sizeof(uint16_t) * nrows);
+    }
+
+    // Last rule first: earlier matches overwrite later ones
+    compiled_t compiled;
+    for (i32_t ri = nrules - 1; ri >= 0; ri--) {
+        const rfui_grid_rule_t* r = &rules[ri];
+        i32_t c = rule_col[ri];
+        if (c < 0 || !s->cells[c]) continue;
+
+        obj_p col = AS_LIST(vals)[c];
+        uint16_t* out = s->cells[c];
+        if (!compile_rule(r, col->type, &compiled)) continue;
+
+        if (r->op == RFUI_RULE_GRADIENT) {
+            f64_t lo, hi;
+            column_minmax(col, &lo, &hi);
+            if (col->type == TYPE_F64) {
+                if (r->value[0]) lo = compiled.flo;
+                if (r->value2[0]) hi = compiled.fhi;
+            } else {
+                if (r->value[0]) lo = (f64_t)compiled.lo;
+                if (r->value2[0]) hi = (f64_t)compiled.hi;
+            }
+            if (!(lo <= hi)) continue;  // Empty or all-null column
+
+            if (s->npalette + RFUI_GRADIENT_STEPS > MAX_PALETTE) continue;
+            i64_t base = s->npalette;
+            for (i32_t k = 0; k < RFUI_GRADIENT_STEPS; k++) {
+                float t = (float)k / (float)(RFUI_GRADIENT_STEPS - 1);
+                float mix[4];
+                for (i32_t j = 0; j < 4; j++) {
+                    mix[j] = r->color[j] + (r->color2[j] - r->color[j]) * t;
+                }
+                if (palette_add(s, mix) < 0) break;
+            }
+            if (s->npalette == base + RFUI_GRADIENT_STEPS) {
+                gradient_pass(col, lo, hi, (uint16_t)base, out);
+            }
+            continue;
+        }
+
+        i64_t style = palette_add(s, r->color);
+        if (style < 0) continue;
+        apply_compiled(r, &compiled, col, (uint16_t)style, out);
+    }
+
+    free(rule_col);
+}
+
+nil_t rfui_grid_styles_free(rfui_grid_styles_t* s) {
+    free_cells(s);
+    free(s->palette);
+    s->palette = NULL;
+    s->npalette = 0;
+    s->palette_cap = 0;
+    s->version = -1;
+}
+
+i64_t rfui_grid_styles_bytes(const rfui_grid_styles_t* s) {
+    i64_t bytes = s->palette_cap * (i64_t)sizeof(rfui_rgba_t);
+    if (s->cells) {
+        bytes += s->ncols * (i64_t)sizeof(uint16_t*);
+        for (i64_t c = 0; c < s->ncols; c++) {
+            if (s->cells[c]) bytes += s->nrows * (i64_t)sizeof(uint16_t);
+        }
+    }
+    return bytes;
+}
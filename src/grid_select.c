@@ -0,0 +1,91 @@
+// src/grid_select.c
+// Grid row selection bitmap
+#include <stdlib.h>
+#include <string.h>
+#include "../include/rfui/grid_select.h"
+
+#define WORDS(n) (((n) + 63) >> 6)
+
+nil_t rfui_grid_select_resize(rfui_grid_select_t* s, i64_t nrows) {
+    if (s->nrows == nrows && (s->bits || nrows == 0)) return;
+
+    i64_t old_words = s->bits ? WORDS(s->nrows) : 0;
+    i64_t words = WORDS(nrows);
+    u64_t* bits = (u64_t*)realloc(s->bits, sizeof(u64_t) * (words > 0 ? words : 1));
+    if (!bits) {
+        rfui_grid_select_free(s);
+        return;
+    }
+    if (words > old_words) memset(bits + old_words, 0, sizeof(u64_t) * (words - old_words));
+
+    // Clear the tail past the new last row
+    if (nrows & 63) bits[words - 1] &= ((u64_t)1 << (nrows & 63)) - 1;
+
+    i64_t count = 0;
+    for (i64_t w = 0; w < words; w++) count += __builtin_popcountll(bits[w]);
+    if (count != s->count) s->dirty = B8_TRUE;
+
+    s->bits = bits;
+    s->nrows = nrows;
+    s->count = count;
+}
+
+b8_t rfui_grid_select_has(const rfui_grid_select_t* s, i64_t row) {
+    return row >= 0 && row < s->nrows && ((s->bits[row >> 6] >> (row & 63)) & 1);
+}
+
+nil_t rfui_grid_select_clear(rfui_grid_select_t* s) {
+    if (s->count == 0) return;
+    memset(s->bits, 0, sizeof(u64_t) * WORDS(s->nrows));
+    s->count = 0;
+    s->dirty = B8_TRUE;
+}
+
+nil_t rfui_grid_select_set(rfui_grid_select_t* s, i64_t row, b8_t on) {
+    if (row < 0 || row >= s->nrows || rfui_grid_select_has(s, row) == on) return;
+    s->bits[row >> 6] ^= (u64_t)1 << (row & 63);
+    s->count += on ? 1 : -1;
+    s->dirty = B8_TRUE;
+}
+
+nil_t rfui_grid_select_range(rfui_grid_select_t* s, i64_t from, i64_t to,
+                             const u32_t* rows, i64_t rows_n) {
+    if (from > to) {
+        i64_t t = from;
+        from = to;
+        to = t;
+    }
+    for (i64_t i = from; i <= to; i++) {
+        rfui_grid_select_set(s, rows && i < rows_n ? (i64_t)rows[i] : i, B8_TRUE);
+    }
+}
+
+i64_t* rfui_grid_select_rows(const rfui_grid_select_t* s, i64_t* n) {
+    *n = 0;
+    if (s->count == 0) return NULL;
+
+    i64_t* out = (i64_t*)malloc(sizeof(i64_t) * s->count);
+    if (!out) return NULL;
+
+    i64_t k = 0;
+    for (i64_t w = 0; w < WORDS(s->nrows); w++) {
+        u64_t word = s->bits[w];
+        while (word) {
+            out[k++] = (w << 6) + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+    }
+    *n = k;
+    return out;
+}
+
+nil_t rfui_grid_select_free(rfui_grid_select_t* s) {
+    free(s->bits);
+    s->bits = NULL;
+    s->nrows = 0;
+    s->count = 0;
+}
+
+i64_t rfui_grid_select_bytes(const rfui_grid_select_t* s) {
+    return s->bits ? WORDS(s->nrows) * (i64_t)sizeof(u64_t) : 0;
+}
@@ -0,0 +1,568 @@
+// src/grid_sort.c
+// Grid row permutation sort (worker pool)
+//
+// Each key becomes an order-preserving u64 (sign-flipped integers, IEEE bit
+// trick for f64 with NaN first, string rank for symbols, inverted for
+// descending) and an LSD radix sort with 8-bit digits reorders row indices.
+// Digits every key shares are skipped, so narrow and clustered columns take
+// only a few passes.
+#include <stdlib.h>
+#include <string.h>
+#include "../include/rfui/grid_sort.h"
+#include "../include/rfui/memory.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/symbols.h"
+
+typedef struct rfui_sort_job_t {
+    // Inputs: data is kept alive by the grid until the job is adopted
+    obj_p data;
+    i64_t nrows;
+    i32_t nkeys;
+    rfui_sort_key_t keys[RFUI_SORT_MAX_KEYS];
+    const u32_t* prev_perm;        // Previous order with the same keys (read only)
+    i64_t prev_n;
+    u64_t prev_hash[RFUI_SORT_MAX_KEYS];
+
+    // Outputs
+    u32_t* perm;                   // NULL on failure or cancel
+    u64_t hash[RFUI_SORT_MAX_KEYS];
+
+    rfui_task_t task;
+} rfui_sort_job_t;
+
+// ============================================================================
+// Keys
+// ============================================================================
+
+static b8_t sortable(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: case TYPE_I32: case TYPE_DATE: case TYPE_TIME:
+        case TYPE_I16: case TYPE_U8: case TYPE_B8: case TYPE_C8: case TYPE_F64: case TYPE_SYMBOL:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+#define SIGN_BIT 0x8000000000000000ULL
+
+static inline u64_t f64_key(f64_t v) {
+    u64_t bits;
+    if (v != v) return 0;  // Nulls first
+    memcpy(&bits, &v, sizeof(bits));
+    return (bits & SIGN_BIT) ? ~bits : (bits | SIGN_BIT);
+}
+
+// Symbol id -> rank of its string among the column's distinct symbols
+typedef struct rank_map_t {
+    i64_t* ids;
+    u32_t* rank;
+    u8_t* used;
+    i64_t cap;      // Power of two, kept at least twice count
+    i64_t count;
+} rank_map_t;
+
+typedef struct sym_str_t {
+    const char* s;
+    i64_t id;
+} sym_str_t;
+
+static i64_t rank_slot(const rank_map_t* m, i64_t id) {
+    u64_t h = ((u64_t)id * 0x9E3779B97F4A7C15ULL) >> 17;
+    i64_t mask = m->cap - 1;
+    i64_t i = (i64_t)h & mask;
+    while (m->used[i] && m->ids[i] != id) i = (i + 1) & mask;
+    return i;
+}
+
+static int sym_cmp(const void* a, const void* b) {
+    return strcmp(((const sym_str_t*)a)->s, ((const sym_str_t*)b)->s);
+}
+
+static void rank_map_free(rank_map_t* m) {
+    free(m->ids);
+    free(m->rank);
+    free(m->used);
+    memset(m, 0, sizeof(*m));
+}
+
+// Double the table (ranks are assigned after every id is in, so only ids move)
+static b8_t rank_map_grow(rank_map_t* m) {
+    rank_map_t g = { 0 };
+    g.cap = m->cap ? m->cap * 2 : 256;
+    g.count = m->count;
+    g.ids = (i64_t*)malloc(sizeof(i64_t) * g.cap);
+    g.rank = (u32_t*)malloc(sizeof(u32_t) * g.cap);
+    g.used = (u8_t*)calloc(g.cap, 1);
+    if (!g.ids || !g.rank || !g.used) {
+        rank_map_free(&g);
+        return B8_FALSE;
+    }
+    for (i64_t i = 0; i < m->cap; i++) {
+        if (!m->used[i]) continue;
+        i64_t s = rank_slot(&g, m->ids[i]);
+        g.used[s] = 1;
+        g.ids[s] = m->ids[i];
+    }
+    rank_map_free(m);
+    *m = g;
+    return B8_TRUE;
+}
+
+// Symbol strings are read the same way the renderer reads them. The table is
+// sized by the distinct count, not the row count: it starts small and doubles
+// at half load.
+static b8_t rank_map_build(rank_map_t* m, obj_p col) {
+    const i64_t* ids = AS_SYMBOL(col);
+    i64_t n = col->len;
+
+    memset(m, 0, sizeof(*m));
+    if (!rank_map_grow(m)) return B8_FALSE;
+
+    // Distinct ids (runs of one id, common in sorted or grouped data, probe once)
+    i64_t last = 0;
+    for (i64_t i = 0; i < n; i++) {
+        if (i > 0 && ids[i] == last) continue;
+        last = ids[i];
+        i64_t s = rank_slot(m, last);
+        if (m->used[s]) continue;
+        if ((m->count + 1) * 2 > m->cap) {
+            if (!rank_map_grow(m)) {
+                rank_map_free(m);
+                return B8_FALSE;
+            }
+            s = rank_slot(m, last);
+        }
+        m->used[s] = 1;
+        m->ids[s] = last;
+        m->count++;
+    }
+    i64_t ndistinct = m->count;
+
+    sym_str_t* strs = (sym_str_t*)malloc(sizeof(sym_str_t) * (ndistinct > 0 ? ndistinct : 1));
+    if (!strs) {
+        rank_map_free(m);
+        return B8_FALSE;
+    }
+    i64_t k = 0;
+    for (i64_t i = 0; i < m->cap; i++) {
+        if (!m->used[i]) continue;
+        const char* s = rfui_symbols_get(m->ids[i]);
+        strs[k].s = s ? s : "";
+        strs[k].id = m->ids[i];
+        k++;
+    }
+    qsort(strs, ndistinct, sizeof(sym_str_t), sym_cmp);
+    for (i64_t i = 0; i < ndistinct; i++) {
+        m->rank[rank_slot(m, strs[i].id)] = (u32_t)i;
+    }
+    free(strs);
+    return B8_TRUE;
+}
+
+// Key of one row (merge path)
+static u64_t key_at(obj_p col, i64_t row, const rank_map_t* ranks) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: return (u64_t)AS_I64(col)[row] ^ SIGN_BIT;
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: return (u64_t)(i64_t)AS_I32(col)[row] ^ SIGN_BIT;
+        case TYPE_I16: return (u64_t)(i64_t)AS_I16(col)[row] ^ SIGN_BIT;
+        case TYPE_U8: case TYPE_B8: return AS_U8(col)[row];
+        case TYPE_C8: return (u8_t)AS_C8(col)[row];
+        case TYPE_F64: return f64_key(AS_F64(col)[row]);
+        case TYPE_SYMBOL: return ranks->rank[rank_slot(ranks, AS_SYMBOL(col)[row])];
+        default: return 0;
+    }
+}
+
+#define GATHER_KEYS(expr) \
+    for (i64_t i = 0; i < m; i++) { \
+        i64_t r = rows[i]; \
+        out[i] = (expr); \
+    }
+
+// keys[i] = key of rows[i] (typed loops; the per-row switch stays out)
+static void gather_keys(obj_p col, const u32_t* rows, i64_t m, const rank_map_t* ranks,
+                        b8_t desc, u64_t* out) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: {
+            const i64_t* a = AS_I64(col);
+            GATHER_KEYS((u64_t)a[r] ^ SIGN_BIT);
+            break;
+        }
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: {
+            const i32_t* a = AS_I32(col);
+            GATHER_KEYS((u64_t)(i64_t)a[r] ^ SIGN_BIT);
+            break;
+        }
+        case TYPE_I16: {
+            const i16_t* a = AS_I16(col);
+            GATHER_KEYS((u64_t)(i64_t)a[r] ^ SIGN_BIT);
+            break;
+        }
+        case TYPE_U8: case TYPE_B8: {
+            const u8_t* a = AS_U8(col);
+            GATHER_KEYS(a[r]);
+            break;
+        }
+        case TYPE_C8: {
+            const c8_t* a = AS_C8(col);
+            GATHER_KEYS((u8_t)a[r]);
+            break;
+        }
+        case TYPE_F64: {
+            const f64_t* a = AS_F64(col);
+            GATHER_KEYS(f64_key(a[r]));
+            break;
+        }
+        case TYPE_SYMBOL: {
+            const i64_t* a = AS_SYMBOL(col);
+            GATHER_KEYS(ranks->rank[rank_slot(ranks, a[r])]);
+            break;
+        }
+        default:
+            memset(out, 0, sizeof(u64_t) * m);
+            break;
+    }
+    if (desc) {
+        for (i64_t i = 0; i < m; i++) out[i] = ~out[i];
+    }
+}
+
+// ============================================================================
+// Radix sort
+// ============================================================================
+
+// Stable LSD radix sort of (keys, idx) pairs; tk/ti are scratch of size m
+static b8_t radix_sort(u64_t* keys, u32_t* idx, u64_t* tk, u32_t* ti, i64_t m) {
+    static const i32_t DIGITS = 8;
+    i64_t* counts = (i64_t*)calloc(DIGITS * 256, sizeof(i64_t));
+    if (!counts) return B8_FALSE;
+
+    // One histogram pass for all digits
+    for (i64_t i = 0; i < m; i++) {
+        u64_t k = keys[i];
+        for (i32_t d = 0; d < DIGITS; d++) {
+            counts[d * 256 + ((k >> (d * 8)) & 0xFF)]++;
+        }
+    }
+
+    u64_t* src_k = keys; u32_t* src_i = idx;
+    u64_t* dst_k = tk;   u32_t* dst_i = ti;
+    for (i32_t d = 0; d < DIGITS; d++) {
+        i64_t* c = &counts[d * 256];
+        i32_t shift = d * 8;
+
+        // Every key has the same digit: the pass would be the identity
+        if (c[(src_k[0] >> shift) & 0xFF] == m) continue;
+
+        i64_t sum = 0;
+        for (i32_t b = 0; b < 256; b++) {
+            i64_t t = c[b];
+            c[b] = sum;
+            sum += t;
+        }
+        for (i64_t i = 0; i < m; i++) {
+            i64_t pos = c[(src_k[i] >> shift) & 0xFF]++;
+            dst_k[pos] = src_k[i];
+            dst_i[pos] = src_i[i];
+        }
+
+        u64_t* swap_k = src_k; src_k = dst_k; dst_k = swap_k;
+        u32_t* swap_i = src_i; src_i = dst_i; dst_i = swap_i;
+    }
+
+    if (src_i != idx) {
+        memcpy(keys, src_k, sizeof(u64_t) * m);
+        memcpy(idx, src_i, sizeof(u32_t) * m);
+    }
+    free(counts);
+    return B8_TRUE;
+}
+
+// ============================================================================
+// Job
+// ============================================================================
+
+u64_t rfui_grid_column_hash(obj_p col, i64_t prefix_n, u64_t* prefix) {
+    i64_t es = rfui_elem_size(col->type);
+    const u8_t* p = (const u8_t*)AS_U8(col);
+    u64_t h = 0xCBF29CE484222325ULL;
+    *prefix = h;
+    for (i64_t i = 0; i < col->len; i++) {
+        if (i == prefix_n) *prefix = h;
+        // Eight bytes at a time, so wide elements (GUID) fold in every word
+        for (i64_t off = 0; off < es; off += 8) {
+            u64_t v = 0;
+            memcpy(&v, p + i * es + off, (size_t)(es - off < 8 ? es - off : 8));
+            h = (h ^ v) * 0x100000001B3ULL;
+        }
+    }
+    if (prefix_n >= col->len) *prefix = h;
+    return h;
+}
+
+// Sort rows[0..m) by all keys (least significant key first, stable)
+static b8_t sort_rows(rfui_sort_job_t* job, obj_p* cols, const rank_map_t* ranks,
+                      u32_t* rows, i64_t m) {
+    if (m <= 1) return B8_TRUE;
+
+    u64_t* keys = (u64_t*)malloc(sizeof(u64_t) * m);
+    u64_t* tk = (u64_t*)malloc(sizeof(u64_t) * m);
+    u32_t* ti = (u32_t*)malloc(sizeof(u32_t) * m);
+    b8_t ok = keys && tk && ti;
+
+    for (i32_t k = job->nkeys - 1; ok && k >= 0; k--) {
+        if (rfui_task_cancelled(&job->task)) {
+            ok = B8_FALSE;
+            break;
+        }
+        obj_p col = cols[job->keys[k].col];
+        gather_keys(col, rows, m, &ranks[k], job->keys[k].desc, keys);
+        ok = radix_sort(keys, rows, tk, ti, m);
+    }
+
+    free(keys);
+    free(tk);
+    free(ti);
+    return ok;
+}
+
+static i32_t compare_rows(rfui_sort_job_t* job, obj_p* cols, const rank_map_t* ranks,
+                          i64_t a, i64_t b) {
+    for (i32_t k = 0; k < job->nkeys; k++) {
+        obj_p col = cols[job->keys[k].col];
+        u64_t ka = key_at(col, a, &ranks[k]);
+        u64_t kb = key_at(col, b, &ranks[k]);
+        if (job->keys[k].desc) {
+            ka = ~ka;
+            kb = ~kb;
+        }
+        if (ka != kb) return ka < kb ? -1 : 1;
+    }
+    return 0;
+}
+
+static void run_sort(rfui_sort_job_t* job) {
+    obj_p* cols = AS_LIST(AS_LIST(job->data)[1]);
+    i64_t n = job->nrows;
+    rank_map_t ranks[RFUI_SORT_MAX_KEYS];
+    memset(ranks, 0, sizeof(ranks));
+
+    // Fingerprints, and whether the previous order still holds for its rows
+    b8_t incremental = job->prev_perm != NULL && job->prev_n <= n;
+    for (i32_t k = 0; k < job->nkeys; k++) {
+        u64_t prefix;
+        job->hash[k] = rfui_grid_column_hash(cols[job->keys[k].col], job->prev_n, &prefix);
+        if (prefix != job->prev_hash[k]) incremental = B8_FALSE;
+    }
+
+    for (i32_t k = 0; k < job->nkeys; k++) {
+        obj_p col = cols[job->keys[k].col];
+        if (col->type == TYPE_SYMBOL && !rank_map_build(&ranks[k], col)) goto done;
+    }
+
+    u32_t* perm = (u32_t*)malloc(sizeof(u32_t) * (n > 0 ? n : 1));
+    if (!perm) goto done;
+
+    if (incremental) {
+        // Sort only the appended rows, then merge (old rows win ties: stable)
+        i64_t old_n = job->prev_n;
+        i64_t tail_n = n - old_n;
+        u32_t* tail = (u32_t*)malloc(sizeof(u32_t) * (tail_n > 0 ? tail_n : 1));
+        if (!tail) {
+            free(perm);
+            goto done;
+        }
+        for (i64_t i = 0; i < tail_n; i++) tail[i] = (u32_t)(old_n + i);
+        if (!sort_rows(job, cols, ranks, tail, tail_n)) {
+            free(tail);
+            free(perm);
+            goto done;
+        }
+
+        const u32_t* old = job->prev_perm;
+        i64_t i = 0, j = 0, o = 0;
+        while (i < old_n && j < tail_n) {
+            if (compare_rows(job, cols, ranks, old[i], tail[j]) <= 0) {
+                perm[o++] = old[i++];
+            } else {
+                perm[o++] = tail[j++];
+            }
+        }
+        while (i < old_n) perm[o++] = old[i++];
+        while (j < tail_n) perm[o++] = tail[j++];
+        free(tail);
+    } else {
+        for (i64_t i = 0; i < n; i++) perm[i] = (u32_t)i;
+        if (!sort_rows(job, cols, ranks, perm, n)) {
+            free(perm);
+            goto done;
+        }
+    }
+    job->perm = perm;
+
+done:
+    for (i32_t k = 0; k < job->nkeys; k++) rank_map_free(&ranks[k]);
+}
+
+static nil_t sort_job(raw_p arg) {
+    rfui_sort_job_t* job = (rfui_sort_job_t*)arg;
+
+    i64_t trace_span = rfui_trace_begin();
+    run_sort(job);
+    rfui_trace_end("grid_sort", NULL, trace_span);
+}
+
+static void job_free(rfui_sort_job_t* job) {
+    free(job->perm);
+    rfui_task_free(&job->task);
+    free(job);
+}
+
+// ============================================================================
+// Grid side (UI thread)
+// ============================================================================
+
+static b8_t same_keys(const rfui_sort_key_t* a, i32_t na, const rfui_sort_key_t* b, i32_t nb) {
+    if (na != nb) return B8_FALSE;
+    for (i32_t i = 0; i < na; i++) {
+        if (a[i].col != b[i].col || a[i].desc != b[i].desc) return B8_FALSE;
+    }
+    return B8_TRUE;
+}
+
+static void start_job(rfui_grid_sort_t* s, obj_p table, i64_t version) {
+    s->dirty = B8_FALSE;
+    s->version = version;
+
+    obj_p vals = AS_LIST(table)[1];
+    i64_t nrows = vals->len > 0 ? AS_LIST(vals)[0]->len : 0;
+    if (nrows > (i64_t)UINT32_MAX) return;
+
+    rfui_sort_job_t* job = (rfui_sort_job_t*)calloc(1, sizeof(rfui_sort_job_t));
+    if (!job) return;
+    job->data = table;
+    job->nrows = nrows;
+    for (i32_t k = 0; k < s->nkeys; k++) {
+        // Skip keys on missing or unsortable columns
+        rfui_sort_key_t key = s->keys[k];
+        if (key.col < 0 || key.col >= vals->len || !sortable(AS_LIST(vals)[key.col]->type)) continue;
+        job->keys[job->nkeys++] = key;
+    }
+
+    // Reuse the current order for its rows if the keys are unchanged
+    if (s->perm && s->perm_n <= nrows && same_keys(s->perm_keys, s->perm_nkeys, job->keys, job->nkeys)) {
+        job->prev_perm = s->perm;
+        job->prev_n = s->perm_n;
+        memcpy(job->prev_hash, s->perm_hash, sizeof(job->prev_hash));
+    }
+
+    s->job = job;
+    rfui_task_submit(&job->task, sort_job, job, 1);
+}
+
+nil_t rfui_grid_sort_set(rfui_grid_sort_t* s, const rfui_sort_key_t* keys, i32_t nkeys) {
+    if (nkeys > RFUI_SORT_MAX_KEYS) nkeys = RFUI_SORT_MAX_KEYS;
+    if (same_keys(s->keys, s->nkeys, keys, nkeys)) return;
+
+    memcpy(s->keys, keys, sizeof(rfui_sort_key_t) * nkeys);
+    s->nkeys = nkeys;
+    s->dirty = B8_TRUE;
+    if (nkeys == 0) s->order_gen++;  // Back to natural order right away
+}
+
+nil_t rfui_grid_sort_click(rfui_grid_sort_t* s, i32_t col, b8_t add) {
+    rfui_sort_key_t keys[RFUI_SORT_MAX_KEYS];
+    i32_t nkeys = 0;
+    i32_t found = -1;
+    for (i32_t k = 0; k < s->nkeys; k++) {
+        if (s->keys[k].col == col) found = k;
+    }
+
+    if (add) {
+        for (i32_t k = 0; k < s->nkeys; k++) {
+            if (k != found) {
+                keys[nkeys++] = s->keys[k];
+            } else if (!s->keys[k].desc) {
+                keys[nkeys].col = col;
+                keys[nkeys++].desc = B8_TRUE;
+            }
+        }
+        if (found < 0 && nkeys < RFUI_SORT_MAX_KEYS) {
+            keys[nkeys].col = col;
+            keys[nkeys++].desc = B8_FALSE;
+        }
+    } else if (found < 0 || s->nkeys > 1) {
+        keys[0].col = col;
+        keys[0].desc = B8_FALSE;
+        nkeys = 1;
+    } else if (!s->keys[found].desc) {
+        keys[0].col = col;
+        keys[0].desc = B8_TRUE;
+        nkeys = 1;
+    }
+    rfui_grid_sort_set(s, keys, nkeys);
+}
+
+nil_t rfui_grid_sort_update(rfui_grid_sort_t* s, obj_p table, i64_t version) {
+    rfui_sort_job_t* job = s->job;
+    if (job && rfui_task_done(&job->task)) {
+        s->job = NULL;
+        if (job->perm && s->nkeys > 0) {
+            free(s->perm);
+            s->perm = job->perm;
+            s->perm_n = job->nrows;
+            s->perm_nkeys = job->nkeys;
+            memcpy(s->perm_keys, job->keys, sizeof(s->perm_keys));
+            memcpy(s->perm_hash, job->hash, sizeof(s->perm_hash));
+            s->order_gen++;
+            job->perm = NULL;
+        }
+        job_free(job);
+    }
+
+    if (s->job) return;
+
+    if (s->nkeys == 0) {
+        if (s->perm) {
+            free(s->perm);
+            s->perm = NULL;
+            s->perm_n = 0;
+            s->perm_nkeys = 0;
+        }
+        s->dirty = B8_FALSE;
+        return;
+    }
+
+    if (s->dirty || s->version != version) {
+        start_job(s, table, version);
+    }
+}
+
+const u32_t* rfui_grid_sort_perm(const rfui_grid_sort_t* s, i64_t nrows, i64_t* perm_n) {
+    // A permutation for more rows than we have can't be shown (data shrank)
+    if (s->nkeys == 0 || !s->perm || s->perm_n > nrows) return NULL;
+    *perm_n = s->perm_n;
+    return s->perm;
+}
+
+b8_t rfui_grid_sort_reads(const rfui_grid_sort_t* s, obj_p table) {
+    return s->job != NULL && s->job->data == table;
+}
+
+nil_t rfui_grid_sort_free(rfui_grid_sort_t* s) {
+    rfui_sort_job_t* job = s->job;
+    if (job) {
+        rfui_task_wait(&job->task);
+        job_free(job);
+        s->job = NULL;
+    }
+    free(s->perm);
+    s->perm = NULL;
+    s->perm_n = 0;
+}
+
+i64_t rfui_grid_sort_bytes(const rfui_grid_sort_t* s) {
+    return s->perm ? s->perm_n * (i64_t)sizeof(u32_t) : 0;
+}
@@ -0,0 +1,111 @@
+// src/grid_spark.c
+// Grid sparklines for nested numeric vectors
+//
+// Two passes per cell: the vector's range, then each bucket's min and max
+// with their positions, so a spike inside a bucket survives downsampling and
+// rising / falling buckets keep their direction.
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "../include/rfui/grid_spark.h"
+
+b8_t rfui_spark_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8: case TYPE_F64:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+// One cell: len values into buckets point pairs at p
+#define DEFINE_SPARK(NAME, T, IS_NULL)                                                  \
+    static void NAME(const T* a, i64_t len, i64_t buckets, u8_t* p) {                   \
+        f64_t lo = INFINITY, hi = -INFINITY;                                            \
+        for (i64_t i = 0; i < len; i++) {                                               \
+            T x = a[i];                                                                 \
+            if (IS_NULL) continue;                                                      \
+            if ((f64_t)x < lo) lo = (f64_t)x;                                           \
+            if ((f64_t)x > hi) hi = (f64_t)x;                                           \
+        }                                                                               \
+        /* A flat vector draws along the middle */                                     \
+        f64_t scale = hi > lo ? RFUI_SPARK_TOP / (hi - lo) : 0.0;                       \
+        f64_t base = hi > lo ? 0.5 : RFUI_SPARK_TOP / 2 + 0.5;                          \
+        for (i64_t b = 0; b < buckets; b++) {                                           \
+            i64_t start = b * len / buckets;                                            \
+            i64_t end = (b + 1) * len / buckets;                                        \
+            i64_t imin = -1, imax = -1;                                                 \
+            for (i64_t i = start; i < end; i++) {                                       \
+                T x = a[i];                                                             \
+                if (IS_NULL) continue;                                                  \
+                if (imin < 0 || x < a[imin]) imin = i;                                  \
+                if (imax < 0 || x > a[imax]) imax = i;                                  \
+            }                                                                           \
+            if (imin < 0) {                                                             \
+                p[2 * b] = p[2 * b + 1] = RFUI_SPARK_GAP;                               \
+                continue;                                                               \
+            }                                                                           \
+            u8_t ymin = (u8_t)(((f64_t)a[imin] - lo) * scale + base);                   \
+            u8_t ymax = (u8_t)(((f64_t)a[imax] - lo) * scale + base);                   \
+            p[2 * b] = imin <= imax ? ymin : ymax;                                      \
+            p[2 * b + 1] = imin <= imax ? ymax : ymin;                                  \
+        }                                                                               \
+    }
+
+DEFINE_SPARK(spark_i64, i64_t, x == NULL_I64)
+DEFINE_SPARK(spark_i32, i32_t, x == NULL_I32)
+DEFINE_SPARK(spark_i16, i16_t, 0)
+DEFINE_SPARK(spark_u8, u8_t, 0)
+DEFINE_SPARK(spark_f64, f64_t, x != x)
+
+static b8_t reserve(rfui_spark_buf_t* out, i64_t n) {
+    if (out->len + n <= out->cap) return B8_TRUE;
+    i64_t cap = out->cap ? out->cap * 2 : 16384;
+    while (cap < out->len + n) cap *= 2;
+    u8_t* points = (u8_t*)realloc(out->points, (size_t)cap);
+    if (!points) return B8_FALSE;
+    out->points = points;
+    out->cap = cap;
+    return B8_TRUE;
+}
+
+b8_t rfui_spark_column(obj_p col, const u32_t* rows, i64_t rows_n, i64_t from, i64_t n,
+                       i32_t width, rfui_spark_buf_t* out, u32_t* offsets) {
+    if (width > RFUI_SPARK_MAX_WIDTH) width = RFUI_SPARK_MAX_WIDTH;
+    for (i64_t i = 0; i < n; i++) {
+        offsets[i] = (u32_t)out->len;
+        i64_t r = from + i;
+        if (rows && r < rows_n) r = rows[r];
+        if (!col || col->type != TYPE_LIST || width <= 0 || r < 0 || r >= col->len) continue;
+
+        obj_p item = AS_LIST(col)[r];
+        if (!item || item->len <= 0 || !rfui_spark_supported(item->type)) continue;
+        i64_t buckets = item->len < width ? item->len : width;
+        if (!reserve(out, 2 * buckets)) return B8_FALSE;
+
+        u8_t* p = out->points + out->len;
+        switch (item->type) {
+            case TYPE_I64: spark_i64(AS_I64(item), item->len, buckets, p); break;
+            case TYPE_I32: spark_i32(AS_I32(item), item->len, buckets, p); break;
+            case TYPE_I16: spark_i16(AS_I16(item), item->len, buckets, p); break;
+            case TYPE_U8:  spark_u8(AS_U8(item), item->len, buckets, p); break;
+            default:       spark_f64(AS_F64(item), item->len, buckets, p); break;
+        }
+        out->len += 2 * buckets;
+    }
+    return B8_TRUE;
+}
+
+b8_t rfui_spark_buf_append(rfui_spark_buf_t* out, const u8_t* points, i64_t n) {
+    if (!reserve(out, n)) return B8_FALSE;
+    memcpy(out->points + out->len, points, (size_t)n);
+    out->len += n;
+    return B8_TRUE;
+}
+
+nil_t rfui_spark_buf_free(rfui_spark_buf_t* out) {
+    free(out->points);
+    out->points = NULL;
+    out->len = 0;
+    out->cap = 0;
+}
@@ -0,0 +1,110 @@
+// src/hdr.c
+// Log-linear (HDR) histogram
+//
+// Bucket layout: values below 2^SUB_BITS map 1:1. Above that, each power of
+// two [2^e, 2^(e+1)) holds HALF linear sub-buckets of width 2^(e-SUB_BITS+1).
+#include <string.h>
+#include "../include/rfui/hdr.h"
+
+#define SUB_COUNT  (1 << RFUI_HDR_SUB_BITS)
+#define HALF       (SUB_COUNT / 2)
+
+static i32_t log2_floor(u64_t v) {
+    i32_t e = 0;
+    while (v >>= 1) e++;
+    return e;
+}
+
+static i32_t bucket_index(i64_t value) {
+    if (value < SUB_COUNT) return (i32_t)value;
+
+    i32_t shift = log2_floor((u64_t)value) - RFUI_HDR_SUB_BITS + 1;
+    i64_t mantissa = value >> shift;  // in [HALF, SUB_COUNT)
+    i32_t idx = SUB_COUNT + (shift - 1) * HALF + (i32_t)(mantissa - HALF);
+    return idx < RFUI_HDR_BUCKETS ? idx : RFUI_HDR_BUCKETS - 1;
+}
+
+// Highest value that maps to bucket idx
+static i64_t bucket_upper(i32_t idx) {
+    if (idx < SUB_COUNT) return idx;
+
+    i32_t k = idx - SUB_COUNT;
+    i32_t shift = k / HALF + 1;
+    i64_t mantissa = k % HALF + HALF;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+nil_t rfui_hdr_reset(rfui_hdr_t* h) {
+    memset(h, 0, sizeof(*h));
+}
+
+nil_t rfui_hdr_record(rfui_hdr_t* h, i64_t value) {
+    if (value < 0) value = 0;
+
+    h->counts[bucket_index(value)]++;
+    if (h->total == 0 || value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+    h->total++;
+    h->sum += (f64_t)value;
+}
+
+nil_t rfui_hdr_merge(rfui_hdr_t* dst, const rfui_hdr_t* src) {
+    if (src->total == 0) return;
+
+    for (i32_t i = 0; i < RFUI_HDR_BUCKETS; i++) {
+        dst->counts[i] += src->counts[i];
+    }
+    if (dst->total == 0 || src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->total += src->total;
+    dst->sum += src->sum;
+}
+
+i64_t rfui_hdr_percentile(const rfui_hdr_t* h, f64_t p) {
+    if (h->total == 0) return 0;
+    if (p <= 0.0) return h->min;
+    if (p >= 100.0) return h->max;
+
+    i64_t rank = (i64_t)(p / 100.0 * (f64_t)h->total + 0.5);
+    if (rank < 1) rank = 1;
+
+    i64_t seen = 0;
+    for (i32_t i = 0; i < RFUI_HDR_BUCKETS; i++) {
+        seen += h->counts[i];
+        if (seen >= rank) {
+            i64_t v = bucket_upper(i);
+            return v < h->max ? v : h->max;
+        }
+    }
+    return h->max;
+}
+
+nil_t rfui_hdr_summarize(const rfui_hdr_t* h, rfui_hdr_summary_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (h->total == 0) return;
+
+    out->count = h->total;
+    out->mean = h->sum / (f64_t)h->total;
+    out->min = h->min;
+    out->max = h->max;
+
+    static const f64_t pcts[4] = { 50.0, 90.0, 99.0, 99.9 };
+    i64_t* dst[4] = { &out->p50, &out->p90, &out->p99, &out->p999 };
+    i64_t ranks[4];
+    for (i32_t k = 0; k < 4; k++) {
+        ranks[k] = (i64_t)(pcts[k] / 100.0 * (f64_t)h->total + 0.5);
+        if (ranks[k] < 1) ranks[k] = 1;
+        *dst[k] = h->max;
+    }
+
+    i64_t seen = 0;
+    i32_t k = 0;
+    for (i32_t i = 0; i < RFUI_HDR_BUCKETS && k < 4; i++) {
+        seen += h->counts[i];
+        while (k < 4 && seen >= ranks[k]) {
+            i64_t v = bucket_upper(i);
+            *dst[k] = v < h->max ? v : h->max;
+            k++;
+        }
+    }
+}
@@ -0,0 +1,216 @@
+// src/headless.cpp
+// Headless GL context using EGL surfaceless (no X11/Wayland display)
+//
+// libEGL is loaded with dlopen so the windowed build keeps no link-time EGL
+// dependency. Rendering goes to an offscreen FBO (see offscreen.cpp); the
+// context itself has no surface. ImGui's GL loader picks EGL automatically
+// once libEGL.so.1 is resident.
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#ifdef __linux__
+#include <dlfcn.h>
+#endif
+
+extern "C" {
+#include "../include/rfui/headless.h"
+}
+
+#ifdef __linux__
+
+// Minimal EGL definitions (avoids requiring EGL development headers)
+typedef void* EGLDisplay;
+typedef void* EGLConfig;
+typedef void* EGLContext;
+typedef void* EGLSurface;
+typedef int   EGLint;
+typedef unsigned int EGLBoolean;
+typedef unsigned int EGLenum;
+
+#define EGL_FALSE                      0
+#define EGL_NONE                       0x3038
+#define EGL_SURFACE_TYPE               0x3033
+#define EGL_RENDERABLE_TYPE            0x3040
+#define EGL_OPENGL_BIT                 0x0008
+#define EGL_OPENGL_API                 0x30A2
+#define EGL_CONTEXT_MAJOR_VERSION      0x3098
+#define EGL_CONTEXT_MINOR_VERSION      0x30FB
+#define EGL_PLATFORM_SURFACELESS_MESA  0x31DD
+
+typedef void*      (*egl_get_proc_fn_t)(const char*);
+typedef EGLDisplay (*egl_get_platform_display_fn_t)(EGLenum, void*, const EGLint*);
+typedef EGLDisplay (*egl_get_display_fn_t)(void*);
+typedef EGLBoolean (*egl_initialize_fn_t)(EGLDisplay, EGLint*, EGLint*);
+typedef EGLBoolean (*egl_terminate_fn_t)(EGLDisplay);
+typedef EGLBoolean (*egl_bind_api_fn_t)(EGLenum);
+typedef EGLBoolean (*egl_choose_config_fn_t)(EGLDisplay, const EGLint*, EGLConfig*, EGLint, EGLint*);
+typedef EGLContext (*egl_create_context_fn_t)(EGLDisplay, EGLConfig, EGLContext, const EGLint*);
+typedef EGLBoolean (*egl_destroy_context_fn_t)(EGLDisplay, EGLContext);
+typedef EGLBoolean (*egl_make_current_fn_t)(EGLDisplay, EGLSurface, EGLSurface, EGLContext);
+
+static struct {
+    void* lib;
+    egl_get_proc_fn_t        get_proc_address;
+    egl_get_display_fn_t     get_display;
+    egl_initialize_fn_t      initialize;
+    egl_terminate_fn_t       terminate;
+    egl_bind_api_fn_t        bind_api;
+    egl_choose_config_fn_t   choose_config;
+    egl_create_context_fn_t  create_context;
+    egl_destroy_context_fn_t destroy_context;
+    egl_make_current_fn_t    make_current;
+    EGLDisplay display;
+    EGLContext context;
+} egl;
+
+static bool load_egl(void) {
+    egl.lib = dlopen("libEGL.so.1", RTLD_NOW | RTLD_GLOBAL);
+    if (!egl.lib) {
+        fprintf(stderr, "Headless: failed to load libEGL.so.1\n");
+        return false;
+    }
+
+    egl.get_proc_address = (egl_get_proc_fn_t)dlsym(egl.lib, "eglGetProcAddress");
+    egl.get_display      = (egl_get_display_fn_t)dlsym(egl.lib, "eglGetDisplay");
+    egl.initialize       = (egl_initialize_fn_t)dlsym(egl.lib, "eglInitialize");
+    egl.terminate        = (egl_terminate_fn_t)dlsym(egl.lib, "eglTerminate");
+    egl.bind_api         = (egl_bind_api_fn_t)dlsym(egl.lib, "eglBindAPI");
+    egl.choose_config    = (egl_choose_config_fn_t)dlsym(egl.lib, "eglChooseConfig");
+    egl.create_context   = (egl_create_context_fn_t)dlsym(egl.lib, "eglCreateContext");
+    egl.destroy_context  = (egl_destroy_context_fn_t)dlsym(egl.lib, "eglDestroyContext");
+    egl.make_current     = (egl_make_current_fn_t)dlsym(egl.lib, "eglMakeCurrent");
+
+    if (!egl.get_proc_address || !egl.get_display || !egl.initialize || !egl.terminate ||
+        !egl.bind_api || !egl.choose_config || !egl.create_context ||
+        !egl.destroy_context || !egl.make_current) {
+        fprintf(stderr, "Headless: libEGL is missing required entry points\n");
+        dlclose(egl.lib);
+        egl.lib = nullptr;
+        return false;
+    }
+    return true;
+}
+
+extern "C" {
+
+int rfui_headless_init(void) {
+    if (egl.context) return 0;
+    if (!load_egl()) return -1;
+
+    // Prefer the Mesa surfaceless platform; fall back to the default display
+    // (works with vendor drivers that expose a headless default device)
+    egl_get_platform_display_fn_t get_platform_display =
+        (egl_get_platform_display_fn_t)egl.get_proc_address("eglGetPlatformDisplayEXT");
+    if (get_platform_display) {
+        egl.display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, nullptr, nullptr);
+    }
+    if (!egl.display) {
+        egl.display = egl.get_display(nullptr);
+    }
+
+    EGLint major = 0, minor = 0;
+    if (!egl.display || egl.initialize(egl.display, &major, &minor) == EGL_FALSE) {
+        fprintf(stderr, "Headless: failed to initialize EGL display\n");
+        rfui_headless_destroy();
+        return -1;
+    }
+
+    if (egl.bind_api(EGL_OPENGL_API) == EGL_FALSE) {
+        fprintf(stderr, "Headless: EGL has no desktop OpenGL support\n");
+        rfui_headless_destroy();
+        return -1;
+    }
+
+    const EGLint config_attribs[] = {
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_SURFACE_TYPE, 0,  // surfaceless: rendering goes to an FBO
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint num_configs = 0;
+    if (egl.choose_config(egl.display, config_attribs, &config, 1, &num_configs) == EGL_FALSE ||
+        num_configs < 1) {
+        fprintf(stderr, "Headless: no suitable EGL config\n");
+        rfui_headless_destroy();
+        return -1;
+    }
+
+    // GL 3.0 to match the GLSL 130 shaders used by the windowed path
+    const EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 0,
+        EGL_NONE
+    };
+    egl.context = egl.create_context(egl.display, config, nullptr, context_attribs);
+    if (!egl.context) {
+        fprintf(stderr, "Headless: failed to create EGL context\n");
+        rfui_headless_destroy();
+        return -1;
+    }
+
+    if (egl.make_current(egl.display, nullptr, nullptr, egl.context) == EGL_FALSE) {
+        fprintf(stderr, "Headless: EGL_KHR_surfaceless_context not supported\n");
+        rfui_headless_destroy();
+        return -1;
+    }
+
+    printf("Headless: EGL %d.%d surfaceless context\n", major, minor);
+    return 0;
+}
+
+void rfui_headless_destroy(void) {
+    if (egl.display) {
+        egl.make_current(egl.display, nullptr, nullptr, nullptr);
+        if (egl.context) egl.destroy_context(egl.display, egl.context);
+        egl.terminate(egl.display);
+    }
+    egl.context = nullptr;
+    egl.display = nullptr;
+    // libEGL stays loaded: ImGui's GL loader holds its own handle to it
+}
+
+void* rfui_headless_get_proc(const char* name) {
+    if (!egl.get_proc_address) return nullptr;
+    return egl.get_proc_address(name);
+}
+
+} // extern "C"
+
+#else // !__linux__
+
+extern "C" {
+
+int rfui_headless_init(void) {
+    fprintf(stderr, "Headless: only supported on Linux (EGL surfaceless)\n");
+    return -1;
+}
+
+void rfui_headless_destroy(void) {
+}
+
+void* rfui_headless_get_proc(const char* name) {
+    (void)name;
+    return nullptr;
+}
+
+} // extern "C"
+
+#endif // __linux__
+
+extern "C" void rfui_headless_sleep(double seconds) {
+    if (seconds <= 0.0) return;
+#ifdef _WIN32
+    Sleep((DWORD)(seconds * 1000.0));
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)seconds;
+    ts.tv_nsec = (long)((seconds - (double)ts.tv_sec) * 1e9);
+    nanosleep(&ts, nullptr);
+#endif
+}
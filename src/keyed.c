@@ -0,0 +1,330 @@
+// src/keyed.c
+// Keyed tables for grids: flattening and upserts by key (Rayforce thread)
+
+#include "../include/rfui/keyed.h"
+#include "../include/rfui/memory.h"
+#include <stdlib.h>
+#include <string.h>
+
+b8_t rfui_keyed_is(obj_p o) {
+    return o && o->type == TYPE_DICT && o->len >= 2 &&
+           AS_LIST(o)[0] && AS_LIST(o)[0]->type == TYPE_TABLE &&
+           AS_LIST(o)[1] && AS_LIST(o)[1]->type == TYPE_TABLE;
+}
+
+b8_t rfui_keyed_key_supported(i8_t type) {
+    switch (type) {
+        case TYPE_I64: case TYPE_I32: case TYPE_I16: case TYPE_U8:
+        case TYPE_SYMBOL: case TYPE_DATE: case TYPE_TIME: case TYPE_TIMESTAMP:
+            return B8_TRUE;
+        default:
+            return B8_FALSE;
+    }
+}
+
+// Column names and vectors of a well-formed table (equal column lengths)
+static b8_t table_parts(obj_p t, obj_p* names, obj_p* cols, i64_t* nrows) {
+    if (!t || t->type != TYPE_TABLE || t->len < 2) return B8_FALSE;
+    obj_p n = AS_LIST(t)[0];
+    obj_p c = AS_LIST(t)[1];
+    if (!n || !c || n->type != TYPE_SYMBOL || c->type != TYPE_LIST || n->len != c->len || n->len == 0) {
+        return B8_FALSE;
+    }
+    for (i64_t i = 0; i < c->len; i++) {
+        obj_p col = AS_LIST(c)[i];
+        if (!col || col->type < 0 || col->len != AS_LIST(c)[0]->len) return B8_FALSE;
+    }
+    *names = n;
+    *cols = c;
+    *nrows = AS_LIST(c)[0]->len;
+    return B8_TRUE;
+}
+
+obj_p rfui_keyed_flatten(obj_p keyed, i64_t* nkeys) {
+    obj_p kn, kc, vn, vc;
+    i64_t krows, vrows;
+    if (!table_parts(AS_LIST(keyed)[0], &kn, &kc, &krows) ||
+        !table_parts(AS_LIST(keyed)[1], &vn, &vc, &vrows) || krows != vrows) {
+        return ray_err("keyed table: key and value tables don't line up");
+    }
+
+    i64_t n = kn->len + vn->len;
+    obj_p names = vector(TYPE_SYMBOL, n);
+    obj_p cols = vector(TYPE_LIST, n);
+    if (!names || !cols) {
+        if (names) drop_obj(names);
+        if (cols) drop_obj(cols);
+        return ray_err("keyed table: memory allocation failed");
+    }
+    for (i64_t i = 0; i < kn->len; i++) {
+        AS_SYMBOL(names)[i] = AS_SYMBOL(kn)[i];
+        AS_LIST(cols)[i] = clone_obj(AS_LIST(kc)[i]);
+    }
+    for (i64_t i = 0; i < vn->len; i++) {
+        AS_SYMBOL(names)[kn->len + i] = AS_SYMBOL(vn)[i];
+        AS_LIST(cols)[kn->len + i] = clone_obj(AS_LIST(vc)[i]);
+    }
+    *nkeys = kn->len;
+    return table(names, cols);
+}
+
+nil_t rfui_keyed_reset(rfui_keyed_t* k, i64_t nkeys) {
+    free(k->slots);
+    k->slots = NULL;
+    k->cap = 0;
+    k->nrows = 0;
+    k->nkeys = nkeys;
+}
+
+nil_t rfui_keyed_free(rfui_keyed_t* k) {
+    if (!k) return;
+    rfui_keyed_reset(k, 0);
+}
+
+// ============================================================================
+// Index
+// ============================================================================
+
+static inline u64_t key_at(obj_p col, i64_t row) {
+    switch (col->type) {
+        case TYPE_I64: case TYPE_TIMESTAMP: return (u64_t)AS_I64(col)[row];
+        case TYPE_SYMBOL: return (u64_t)AS_SYMBOL(col)[row];
+        case TYPE_I32: case TYPE_DATE: case TYPE_TIME: return (u64_t)(i64_t)AS_I32(col)[row];
+        case TYPE_I16: return (u64_t)(i64_t)AS_I16(col)[row];
+        case TYPE_U8: return (u64_t)AS_U8(col)[row];
+        default: return 0;
+    }
+}
+
+static inline u64_t mix64(u64_t x) {
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDULL;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+// Key columns of a table or of the rows being merged
+typedef struct keys_t {
+    obj_p cols[RFUI_KEYED_MAX_KEYS];
+    i64_t n;
+} keys_t;
+
+static u64_t key_hash(const keys_t* k, i64_t row) {
+    u64_t h = 0x9E3779B97F4A7C15ULL;
+    for (i64_t c = 0; c < k->n; c++) h = mix64(h ^ key_at(k->cols[c], row));
+    return h;
+}
+
+static b8_t key_eq(const keys_t* a, i64_t ra, const keys_t* b, i64_t rb) {
+    for (i64_t c = 0; c < a->n; c++) {
+        if (key_at(a->cols[c], ra) != key_at(b->cols[c], rb)) return B8_FALSE;
+    }
+    return B8_TRUE;
+}
+
+// Index every row of the table into at least 2 * (nrows + extra) slots
+// (duplicate keys: the last row wins)
+static b8_t index_build(rfui_keyed_t* k, const keys_t* keys, i64_t nrows, i64_t extra) {
+    i64_t cap = 16;
+    while (cap < (nrows + extra) * 2) cap <<= 1;
+    i64_t* slots = (i64_t*)calloc((size_t)cap, sizeof(i64_t));
+    if (!slots) return B8_FALSE;
+
+    u64_t mask = (u64_t)cap - 1;
+    for (i64_t r = 0; r < nrows; r++) {
+        u64_t s = key_hash(keys, r) & mask;
+        while (slots[s] && !key_eq(keys, slots[s] - 1, keys, r)) s = (s + 1) & mask;
+        slots[s] = r + 1;
+    }
+    free(k->slots);
+    k->slots = slots;
+    k->cap = cap;
+    k->nrows = nrows;
+    return B8_TRUE;
+}
+
+// ============================================================================
+// Upsert
+// ============================================================================
+
+static int cmp_i64(const void* a, const void* b) {
+    i64_t x = *(const i64_t*)a, y = *(const i64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Copy of col with nrows + nnew rows, src's rows written at pos
+static obj_p merge_column(obj_p col, i64_t nrows, i64_t nnew, obj_p src, const i64_t* pos, i64_t m) {
+    obj_p out = vector(col->type, nrows + nnew);
+    if (!out) return NULL;
+
+    if (col->type == TYPE_LIST) {
+        for (i64_t i = 0; i < nrows; i++) AS_LIST(out)[i] = clone_obj(AS_LIST(col)[i]);
+        for (i64_t i = nrows; i < nrows + nnew; i++) AS_LIST(out)[i] = NULL;
+        for (i64_t b = 0; b < m; b++) {
+            obj_p* dst = &AS_LIST(out)[pos[b]];
+            if (*dst) drop_obj(*dst);
+            *dst = clone_obj(AS_LIST(src)[b]);
+        }
+        return out;
+    }
+
+    i64_t sz = rfui_elem_size(col->type);
+    memcpy(out->raw, col->raw, (size_t)(nrows * sz));
+    for (i64_t b = 0; b < m; b++) {
+        memcpy(out->raw + pos[b] * sz, src->raw + b * sz, (size_t)sz);
+    }
+    return out;
+}
+
+obj_p rfui_keyed_upsert(rfui_keyed_t* k, obj_p base, obj_p rows, obj_p* merged,
+                        i64_t** written, i64_t* nwritten) {
+    if (k->nkeys <= 0 || !base) {
+        return ray_err("draw-upsert: widget was not drawn with a keyed table");
+    }
+
+    obj_p flat = NULL;
+    if (rfui_keyed_is(rows)) {
+        i64_t rkeys;
+        flat = rfui_keyed_flatten(rows, &rkeys);
+        if (IS_ERR(flat)) return flat;
+        rows = flat;
+    }
+
+    obj_p tn, tc, rn, rc;
+    i64_t nrows, m;
+    if (!table_parts(base, &tn, &tc, &nrows) || !table_parts(rows, &rn, &rc, &m)) {
+        if (flat) drop_obj(flat);
+        return ray_err("draw-upsert: rows must be a table or keyed table");
+    }
+
+    // Table column -> rows column (-1 = not written)
+    i64_t ncols = tn->len;
+    i64_t* src_of = (i64_t*)malloc(sizeof(i64_t) * (size_t)(ncols + 2 * m));
+    if (!src_of) {
+        if (flat) drop_obj(flat);
+        return ray_err("draw-upsert: memory allocation failed");
+    }
+    i64_t* pos = src_of + ncols;      // Per rows row: table row it lands in
+    i64_t* newsrc = pos + m;          // Per appended row: first rows row with its key
+
+    const char* err = NULL;
+    for (i64_t j = 0; j < ncols; j++) src_of[j] = -1;
+    for (i64_t i = 0; i < rn->len && !err; i++) {
+        i64_t j = 0;
+        while (j < ncols && AS_SYMBOL(tn)[j] != AS_SYMBOL(rn)[i]) j++;
+        obj_p col = j < ncols ? AS_LIST(tc)[j] : NULL;
+        if (!col) {
+            err = "draw-upsert: rows have a column the widget doesn't";
+        } else if (AS_LIST(rc)[i]->type != col->type) {
+            err = "draw-upsert: column type differs from the widget's";
+        } else if (col->type != TYPE_LIST && rfui_elem_size(col->type) == 0) {
+            err = "draw-upsert: unsupported column type";
+        } else {
+            src_of[j] = i;
+        }
+    }
+
+    keys_t tkeys = { .n = k->nkeys }, rkeys = { .n = k->nkeys };
+    if (!err && (k->nkeys > RFUI_KEYED_MAX_KEYS || k->nkeys > ncols)) {
+        err = "draw-upsert: too many key columns";
+    }
+    for (i64_t c = 0; c < k->nkeys && !err; c++) {
+        if (src_of[c] < 0) {
+            err = "draw-upsert: rows must have every key column";
+        } else if (!rfui_keyed_key_supported(AS_LIST(tc)[c]->type)) {
+            err = "draw-upsert: key columns must be integers, temporals or symbols";
+        } else {
+            tkeys.cols[c] = AS_LIST(tc)[c];
+            rkeys.cols[c] = AS_LIST(rc)[src_of[c]];
+        }
+    }
+
+    // Room for every row to be new, so probing never has to rehash
+    if (!err && (!k->slots || k->nrows != nrows || k->cap < (nrows + m) * 2) &&
+        !index_build(k, &tkeys, nrows, m)) {
+        err = "draw-upsert: memory allocation failed";
+    }
+    if (err) {
+        free(src_of);
+        if (flat) drop_obj(flat);
+        return ray_err(err);
+    }
+
+    // Land every row: known keys keep their row, new keys append in order
+    i64_t nnew = 0;
+    u64_t mask = (u64_t)k->cap - 1;
+    for (i64_t b = 0; b < m; b++) {
+        u64_t s = key_hash(&rkeys, b) & mask;
+        for (;;) {
+            i64_t r = k->slots[s] - 1;
+            if (r < 0) {
+                newsrc[nnew] = b;
+                pos[b] = nrows + nnew++;
+                k->slots[s] = pos[b] + 1;
+                break;
+            }
+            b8_t eq = r < nrows ? key_eq(&tkeys, r, &rkeys, b) : key_eq(&rkeys, newsrc[r - nrows], &rkeys, b);
+            if (eq) {
+                pos[b] = r;
+                break;
+            }
+            s = (s + 1) & mask;
+        }
+    }
+
+    // Appended rows need a value in every column
+    for (i64_t j = 0; nnew > 0 && j < ncols && !err; j++) {
+        if (src_of[j] < 0) err = "draw-upsert: new keys need every column";
+    }
+
+    // Untouched columns (and keys, unless rows were appended) are shared
+    obj_p* outs = err ? NULL : (obj_p*)calloc((size_t)ncols, sizeof(obj_p));
+    obj_p cols = outs ? vector(TYPE_LIST, ncols) : NULL;
+    if (!err && !cols) err = "draw-upsert: memory allocation failed";
+    for (i64_t j = 0; !err && j < ncols; j++) {
+        obj_p col = AS_LIST(tc)[j];
+        b8_t shared = src_of[j] < 0 || (j < k->nkeys && nnew == 0);
+        outs[j] = shared ? clone_obj(col) : merge_column(col, nrows, nnew, AS_LIST(rc)[src_of[j]], pos, m);
+        if (!outs[j]) err = "draw-upsert: memory allocation failed";
+    }
+    if (err) {
+        for (i64_t j = 0; outs && j < ncols; j++) {
+            if (outs[j]) drop_obj(outs[j]);
+        }
+        free(outs);
+        if (cols) drop_obj(cols);
+        // The index may already hold the new keys: rebuild it next time
+        rfui_keyed_reset(k, k->nkeys);
+        free(src_of);
+        if (flat) drop_obj(flat);
+        return ray_err(err);
+    }
+    for (i64_t j = 0; j < ncols; j++) AS_LIST(cols)[j] = outs[j];
+    free(outs);
+
+    // Rows written, ascending and unique
+    i64_t* out_rows = (i64_t*)malloc(sizeof(i64_t) * (size_t)(m ? m : 1));
+    if (!out_rows) {
+        drop_obj(cols);
+        rfui_keyed_reset(k, k->nkeys);
+        free(src_of);
+        if (flat) drop_obj(flat);
+        return ray_err("draw-upsert: memory allocation failed");
+    }
+    memcpy(out_rows, pos, sizeof(i64_t) * (size_t)m);
+    qsort(out_rows, (size_t)m, sizeof(i64_t), cmp_i64);
+    i64_t nout = 0;
+    for (i64_t i = 0; i < m; i++) {
+        if (nout == 0 || out_rows[nout - 1] != out_rows[i]) out_rows[nout++] = out_rows[i];
+    }
+
+    k->nrows = nrows + nnew;
+    *merged = table(clone_obj(tn), cols);
+    *written = out_rows;
+    *nwritten = nout;
+    free(src_of);
+    if (flat) drop_obj(flat);
+    return NULL;
+}
@@ -0,0 +1,99 @@
+// src/latency.c
+// Per-widget draw latency histograms
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "../include/rfui/latency.h"
+
+// Process-wide totals (UI thread only, no lock)
+static rfui_hdr_t g_all_apply;
+static rfui_hdr_t g_all_present;
+static i64_t g_all_superseded = 0;
+
+i64_t rfui_clock_ns(nil_t) {
+#ifdef _WIN32
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0) QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (i64_t)((f64_t)now.QuadPart * 1e9 / (f64_t)freq.QuadPart);
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (i64_t)ts.tv_sec * 1000000000ll + ts.tv_nsec;
+#endif
+}
+
+rfui_latency_t* rfui_latency_create(nil_t) {
+    rfui_latency_t* l = calloc(1, sizeof(rfui_latency_t));
+    if (!l) return NULL;
+    l->mutex = mutex_create();
+    return l;
+}
+
+nil_t rfui_latency_destroy(rfui_latency_t* l) {
+    if (!l) return;
+    mutex_destroy(&l->mutex);
+    free(l);
+}
+
+nil_t rfui_latency_applied(rfui_latency_t* l, i64_t stamp, i64_t now) {
+    if (!l || stamp <= 0) return;
+
+    mutex_lock(&l->mutex);
+    rfui_hdr_record(&l->apply, now - stamp);
+    if (l->pending) {
+        // Previous draw never reached the screen
+        l->superseded++;
+        g_all_superseded++;
+    }
+    l->pending = stamp;
+    mutex_unlock(&l->mutex);
+
+    rfui_hdr_record(&g_all_apply, now - stamp);
+}
+
+nil_t rfui_latency_presented(rfui_latency_t* l, i64_t now) {
+    if (!l) return;
+
+    mutex_lock(&l->mutex);
+    i64_t stamp = l->pending;
+    if (stamp) {
+        rfui_hdr_record(&l->present, now - stamp);
+        l->pending = 0;
+    }
+    mutex_unlock(&l->mutex);
+
+    if (stamp) rfui_hdr_record(&g_all_present, now - stamp);
+}
+
+nil_t rfui_latency_reset(rfui_latency_t* l) {
+    if (!l) return;
+
+    mutex_lock(&l->mutex);
+    rfui_hdr_reset(&l->apply);
+    rfui_hdr_reset(&l->present);
+    l->superseded = 0;
+    mutex_unlock(&l->mutex);
+}
+
+nil_t rfui_latency_summary(rfui_latency_t* l, rfui_latency_summary_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (!l) return;
+
+    mutex_lock(&l->mutex);
+    rfui_hdr_summarize(&l->apply, &out->apply);
+    rfui_hdr_summarize(&l->present, &out->present);
+    out->superseded = l->superseded;
+    mutex_unlock(&l->mutex);
+}
+
+nil_t rfui_latency_global_summary(rfui_latency_summary_t* out) {
+    rfui_hdr_summarize(&g_all_apply, &out->apply);
+    rfui_hdr_summarize(&g_all_present, &out->present);
+    out->superseded = g_all_superseded;
+}
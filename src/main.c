@@ -6,6 +6,7 @@
 #include "../include/rfui/queue.h"
 #include "../include/rfui/rayforce_thread.h"
 #include "../include/rfui/ui.h"
+#include "../include/rfui/trace.h"
 #include "../deps/rayforce/core/thread.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -55,19 +56,131 @@ static char* rfui_strdup(const char* s) {
 rfui_ctx_t* g_ctx = NULL;
 static ray_thread_t g_ray_thread;
 
+// UI options and the remaining argv handed to the Rayforce runtime
+// (must outlive the context - see rfui_ctx_create)
+static rfui_ui_opts_t g_ui_opts;
+static str_p* g_runtime_argv = NULL;
+static const char* g_replay = NULL;
+static f64_t g_replay_speed = 1.0;
+
+// Parse rayforce-ui options and strip them from argv:
+//   --headless        render offscreen, no display required
+//   --size WxH        headless framebuffer size (default 1280x720)
+//   --frames N        exit after N frames and print frame timing statistics
+//   --fps N           headless frame rate cap (default: as fast as possible)
+//   --stats-json FILE write frame timing statistics as JSON on exit
+//   --trace FILE      record trace spans from startup, write Chrome trace JSON on exit
+//   --replay FILE     draw from a (ui-record) log instead of running a script
+//   --speed N         replay speed multiplier (default 1, 0 = no delays)
+// Everything else is copied to out_argv for runtime_create.
+// Returns the new argc, or -1 on invalid usage.
+static i32_t parse_ui_opts(i32_t argc, str_p argv[], rfui_ui_opts_t* opts, str_p out_argv[]) {
+    opts->headless = B8_FALSE;
+    opts->width = 1280;
+    opts->height = 720;
+    opts->max_frames = 0;
+    opts->fps = 0.0;
+    opts->stats_json = NULL;
+    opts->trace = NULL;
+
+    i32_t out = 0;
+    for (i32_t i = 0; i < argc; i++) {
+        const char* arg = argv[i];
+        b8_t has_value = (i + 1 < argc);
+
+        if (i == 0) {
+            out_argv[out++] = argv[i];
+        } else if (strcmp(arg, "--headless") == 0) {
+            opts->headless = B8_TRUE;
+        } else if (strcmp(arg, "--frames") == 0) {
+            if (!has_value) {
+                fprintf(stderr, "--frames expects a frame count\n");
+                return -1;
+            }
+            opts->max_frames = strtoll(argv[++i], NULL, 10);
+        } else if (strcmp(arg, "--fps") == 0) {
+            if (!has_value) {
+                fprintf(stderr, "--fps expects a frame rate\n");
+                return -1;
+            }
+            opts->fps = strtod(argv[++i], NULL);
+        } else if (strcmp(arg, "--stats-json") == 0) {
+            if (!has_value) {
+                fprintf(stderr, "--stats-json expects a file path\n");
+                return -1;
+            }
+            opts->stats_json = argv[++i];
+        } else if (strcmp(arg, "--trace") == 0) {
+            if (!has_value) {
+                fprintf(stderr, "--trace expects a file path\n");
+                return -1;
+            }
+            opts->trace = argv[++i];
+        } else if (strcmp(arg, "--replay") == 0) {
+            if (!has_value) {
+                fprintf(stderr, "--replay expects a recording file\n");
+                return -1;
+            }
+            g_replay = argv[++i];
+        } else if (strcmp(arg, "--speed") == 0) {
+            if (!has_value || (g_replay_speed = strtod(argv[i + 1], NULL)) < 0.0) {
+                fprintf(stderr, "--speed expects a non-negative multiplier\n");
+                return -1;
+            }
+            i++;
+        } else if (strcmp(arg, "--size") == 0) {
+            if (!has_value || sscanf(argv[i + 1], "%dx%d", &opts->width, &opts->height) != 2 ||
+                opts->width <= 0 || opts->height <= 0) {
+                fprintf(stderr, "--size expects WIDTHxHEIGHT (e.g. 1920x1080)\n");
+                return -1;
+            }
+            i++;
+        } else {
+            out_argv[out++] = argv[i];
+        }
+    }
+    out_argv[out] = NULL;
+
+    return out;
+}
+
 i32_t rfui_init(i32_t argc, str_p argv[]) {
+    // Split rayforce-ui options from runtime arguments
+    g_runtime_argv = malloc(sizeof(str_p) * (argc + 1));
+    if (!g_runtime_argv) {
+        fprintf(stderr, "Failed to allocate argument vector\n");
+        return -1;
+    }
+    i32_t runtime_argc = parse_ui_opts(argc, argv, &g_ui_opts, g_runtime_argv);
+    if (runtime_argc < 0) {
+        free(g_runtime_argv);
+        g_runtime_argv = NULL;
+        return -1;
+    }
+
     // Create context with command line arguments
-    g_ctx = rfui_ctx_create(argc, argv);
+    g_ctx = rfui_ctx_create(runtime_argc, g_runtime_argv);
     if (!g_ctx) {
         fprintf(stderr, "Failed to create rayforce-ui context\n");
+        free(g_runtime_argv);
+        g_runtime_argv = NULL;
         return -1;
     }
+    g_ctx->replay = g_replay;
+    g_ctx->replay_speed = g_replay_speed;
+
+    // Start tracing before any thread runs so startup is on the timeline
+    if (g_ui_opts.trace) {
+        rfui_trace_start();
+    }
 
-    // Initialize UI (GLFW/ImGui)
-    if (rfui_ui_init() != 0) {
+    // Initialize UI (GLFW/ImGui, or offscreen GL when headless)
+    if (rfui_ui_init(&g_ui_opts) != 0) {
         fprintf(stderr, "Failed to initialize UI\n");
         rfui_ctx_destroy(g_ctx);
         g_ctx = NULL;
+        free(g_runtime_argv);
+        g_runtime_argv = NULL;
         return -1;
     }
 
@@ -78,6 +191,8 @@ i32_t rfui_init(i32_t argc, str_p argv[]) {
         rfui_ui_destroy();
         rfui_ctx_destroy(g_ctx);
         g_ctx = NULL;
+        free(g_runtime_argv);
+        g_runtime_argv = NULL;
         return -1;
     }
 
@@ -171,12 +286,25 @@ nil_t rfui_destroy(nil_t) {
         fprintf(stderr, "Warning: thread_join failed with error %d\n", join_result);
     }
 
+    // Both threads are idle: dump the --trace session
+    if (g_ui_opts.trace) {
+        i64_t events = rfui_trace_dump(g_ui_opts.trace);
+        if (events < 0) {
+            fprintf(stderr, "Failed to write trace to %s\n", g_ui_opts.trace);
+        } else {
+            printf("Trace: %lld events written to %s\n", (long long)events, g_ui_opts.trace);
+        }
+    }
+
     // Destroy UI (GLFW/ImGui)
     rfui_ui_destroy();
 
     // Destroy context
     rfui_ctx_destroy(g_ctx);
     g_ctx = NULL;
+
+    free(g_runtime_argv);
+    g_runtime_argv = NULL;
 }
 
 i32_t main(i32_t argc, str_p argv[]) {
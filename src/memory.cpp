@@ -0,0 +1,218 @@
+// src/memory.cpp
+// Memory accounting report
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "imgui.h"
+
+// Make rayforce headers C++ compatible by redefining _Static_assert
+#define _Static_assert static_assert
+
+extern "C" {
+#include "../include/rfui/memory.h"
+#include "../include/rfui/widget.h"
+#include "../include/rfui/widget_registry.h"
+#include "../include/rfui/grid_renderer.h"
+#include "../include/rfui/repl_renderer.h"
+#include "../include/rfui/logo.h"
+#include "../include/rfui/symbols.h"
+#include "../include/rfui/overlay.h"
+#include "../deps/rayforce/core/thread.h"
+}
+
+// Seconds between report rebuilds
+#define REFRESH_INTERVAL 1.0
+
+static bool g_init = false;
+static mutex_t g_mutex;
+static rfui_mem_report_t g_report;     // Published copy (guarded by g_mutex)
+static i64_t g_pending_drops = 0;      // Guarded by g_mutex
+static i64_t g_pending_drop_bytes = 0;
+static double g_last_refresh = -1.0;   // UI thread only
+static i64_t g_generation = 0;         // Reports published (atomic)
+static i32_t g_requested = 0;          // Rebuild asked for (atomic)
+
+static i64_t widget_state_bytes(rfui_widget_t* w) {
+    if (!w->ui_state) return 0;
+    switch (w->type) {
+        case RFUI_WIDGET_GRID: return rfui_grid_state_bytes(w);
+        case RFUI_WIDGET_TEXT: return (i64_t)strlen((const char*)w->ui_state) + 1;  // Formatted text
+        default: return 0;
+    }
+}
+
+extern "C" {
+
+i64_t rfui_obj_bytes(obj_p obj) {
+    if (obj == nullptr) return 0;
+
+    i64_t bytes = (i64_t)sizeof(struct obj_t);
+    if (obj->type < 0) return bytes;  // Atom
+
+    switch (obj->type) {
+        case TYPE_LIST:
+        case TYPE_TABLE:
+        case TYPE_DICT:
+            bytes += obj->len * (i64_t)sizeof(obj_p);
+            for (i64_t i = 0; i < obj->len; i++) {
+                bytes += rfui_obj_bytes(AS_LIST(obj)[i]);
+            }
+            return bytes;
+        default:
+            // Functions, externals, errors: header only (element size 0)
+            return bytes + obj->len * rfui_elem_size(obj->type);
+    }
+}
+
+i64_t rfui_elem_size(i8_t type) {
+    switch (type) {
+        case TYPE_B8:
+        case TYPE_U8:
+        case TYPE_C8:
+            return 1;
+        case TYPE_I16:
+            return 2;
+        case TYPE_I32:
+        case TYPE_DATE:
+        case TYPE_TIME:
+            return 4;
+        case TYPE_I64:
+        case TYPE_F64:
+        case TYPE_SYMBOL:
+        case TYPE_TIMESTAMP:
+            return 8;
+        case TYPE_GUID:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+nil_t rfui_memory_init(nil_t) {
+    if (g_init) return;
+    g_mutex = mutex_create();
+    memset(&g_report, 0, sizeof(g_report));
+    g_init = true;
+}
+
+nil_t rfui_memory_destroy(nil_t) {
+    if (!g_init) return;
+    free(g_report.widgets);
+    memset(&g_report, 0, sizeof(g_report));
+    mutex_destroy(&g_mutex);
+    g_init = false;
+}
+
+nil_t rfui_memory_drop_queued(i64_t bytes) {
+    if (!g_init) return;
+    mutex_lock(&g_mutex);
+    g_pending_drops++;
+    g_pending_drop_bytes += bytes;
+    mutex_unlock(&g_mutex);
+}
+
+nil_t rfui_memory_drop_done(i64_t bytes) {
+    if (!g_init) return;
+    mutex_lock(&g_mutex);
+    g_pending_drops--;
+    g_pending_drop_bytes -= bytes;
+    mutex_unlock(&g_mutex);
+}
+
+nil_t rfui_memory_refresh(b8_t force) {
+    if (!g_init) return;
+
+    // Nobody reads the report while the overlay is hidden and no one asks
+    double now = ImGui::GetTime();
+    bool requested = __atomic_exchange_n(&g_requested, 0, __ATOMIC_ACQ_REL) != 0;
+    bool due = rfui_overlay_visible() && (g_last_refresh < 0.0 || now - g_last_refresh >= REFRESH_INTERVAL);
+    if (!force && !requested && !due) return;
+    g_last_refresh = now;
+
+    rfui_mem_report_t r;
+    memset(&r, 0, sizeof(r));
+
+    i64_t count = rfui_registry_count();
+    if (count > 0) {
+        r.widgets = (rfui_mem_widget_t*)calloc((size_t)count, sizeof(rfui_mem_widget_t));
+    }
+    if (r.widgets) {
+        for (i64_t i = 0; i < count; i++) {
+            rfui_widget_t* w = rfui_registry_get(i);
+            if (!w) continue;
+            rfui_mem_widget_t* mw = &r.widgets[r.nwidgets++];
+            snprintf(mw->name, sizeof(mw->name), "%s", w->name);
+            mw->render_data = w->render_bytes;
+            mw->ui_state = widget_state_bytes(w);
+            r.total += mw->render_data + mw->ui_state;
+        }
+    }
+
+    rfui_repl_memory(&r.repl_lines, &r.repl_history);
+
+    ImVector<ImTextureData*>& textures = ImGui::GetPlatformIO().Textures;
+    for (ImTextureData* tex : textures) {
+        if (tex && tex->Status != ImTextureStatus_Destroyed) {
+            r.font_atlas += (i64_t)tex->GetSizeInBytes();
+        }
+    }
+
+    int logo_w = 0, logo_h = 0;
+    rfui_logo_size(&logo_w, &logo_h);
+    r.textures = (i64_t)logo_w * logo_h * 4;
+
+    r.symbols = rfui_symbols_bytes();
+
+    r.total += r.repl_lines + r.repl_history + r.font_atlas + r.textures + r.symbols;
+
+    mutex_lock(&g_mutex);
+    r.pending_drops = g_pending_drops;
+    r.pending_drop_bytes = g_pending_drop_bytes;
+    r.total += r.pending_drop_bytes;
+    free(g_report.widgets);
+    g_report = r;
+    mutex_unlock(&g_mutex);
+    __atomic_add_fetch(&g_generation, 1, __ATOMIC_RELEASE);
+}
+
+i64_t rfui_memory_request(nil_t) {
+    i64_t gen = __atomic_load_n(&g_generation, __ATOMIC_ACQUIRE) + 1;
+    __atomic_store_n(&g_requested, 1, __ATOMIC_RELEASE);
+    return gen;
+}
+
+i64_t rfui_memory_generation(nil_t) {
+    return __atomic_load_n(&g_generation, __ATOMIC_ACQUIRE);
+}
+
+nil_t rfui_memory_report(rfui_mem_report_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (!g_init) return;
+
+    mutex_lock(&g_mutex);
+    *out = g_report;
+    out->widgets = nullptr;
+    if (g_report.nwidgets > 0) {
+        out->widgets = (rfui_mem_widget_t*)malloc((size_t)g_report.nwidgets * sizeof(rfui_mem_widget_t));
+        if (out->widgets) {
+            memcpy(out->widgets, g_report.widgets, (size_t)g_report.nwidgets * sizeof(rfui_mem_widget_t));
+        } else {
+            out->nwidgets = 0;
+        }
+    }
+    // Drop counters are live, not as of the last refresh
+    out->total += g_pending_drop_bytes - g_report.pending_drop_bytes;
+    out->pending_drops = g_pending_drops;
+    out->pending_drop_bytes = g_pending_drop_bytes;
+    mutex_unlock(&g_mutex);
+}
+
+nil_t rfui_memory_report_free(rfui_mem_report_t* r) {
+    free(r->widgets);
+    r->widgets = nullptr;
+    r->nwidgets = 0;
+}
+
+} // extern "C"
@@ -0,0 +1,151 @@
+// src/offscreen.cpp
+// Offscreen OpenGL render targets (framebuffer objects)
+//
+// FBO entry points are GL 3.0 and not exported by every libGL, so they are
+// resolved at runtime through the loader of whichever context is current
+// (GLFW window or headless EGL).
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define GL_SILENCE_DEPRECATION
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+#include <GLES2/gl2.h>
+#else
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+#endif
+
+extern "C" {
+#include "../include/rfui/offscreen.h"
+}
+
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#define RFUI_GL_FRAMEBUFFER          0x8D40
+#define RFUI_GL_RENDERBUFFER         0x8D41
+#define RFUI_GL_RGBA8                0x8058
+#define RFUI_GL_COLOR_ATTACHMENT0    0x8CE0
+#define RFUI_GL_FRAMEBUFFER_COMPLETE 0x8CD5
+
+typedef void   (APIENTRY *gen_fn_t)(GLsizei n, GLuint* ids);
+typedef void   (APIENTRY *del_fn_t)(GLsizei n, const GLuint* ids);
+typedef void   (APIENTRY *bind_fn_t)(GLenum target, GLuint id);
+typedef void   (APIENTRY *rb_storage_fn_t)(GLenum target, GLenum fmt, GLsizei w, GLsizei h);
+typedef void   (APIENTRY *fb_rb_fn_t)(GLenum target, GLenum attach, GLenum rbtarget, GLuint rb);
+typedef GLenum (APIENTRY *fb_status_fn_t)(GLenum target);
+
+static struct {
+    gen_fn_t        gen_framebuffers;
+    del_fn_t        delete_framebuffers;
+    bind_fn_t       bind_framebuffer;
+    gen_fn_t        gen_renderbuffers;
+    del_fn_t        delete_renderbuffers;
+    bind_fn_t       bind_renderbuffer;
+    rb_storage_fn_t renderbuffer_storage;
+    fb_rb_fn_t      framebuffer_renderbuffer;
+    fb_status_fn_t  check_framebuffer_status;
+} gl;
+
+static bool g_loaded = false;
+
+extern "C" {
+
+int rfui_offscreen_init(rfui_gl_loader_t loader) {
+    if (g_loaded) return 0;
+    if (!loader) return -1;
+
+    gl.gen_framebuffers         = (gen_fn_t)loader("glGenFramebuffers");
+    gl.delete_framebuffers      = (del_fn_t)loader("glDeleteFramebuffers");
+    gl.bind_framebuffer         = (bind_fn_t)loader("glBindFramebuffer");
+    gl.gen_renderbuffers        = (gen_fn_t)loader("glGenRenderbuffers");
+    gl.delete_renderbuffers     = (del_fn_t)loader("glDeleteRenderbuffers");
+    gl.bind_renderbuffer        = (bind_fn_t)loader("glBindRenderbuffer");
+    gl.renderbuffer_storage     = (rb_storage_fn_t)loader("glRenderbufferStorage");
+    gl.framebuffer_renderbuffer = (fb_rb_fn_t)loader("glFramebufferRenderbuffer");
+    gl.check_framebuffer_status = (fb_status_fn_t)loader("glCheckFramebufferStatus");
+
+    if (!gl.gen_framebuffers || !gl.delete_framebuffers || !gl.bind_framebuffer ||
+        !gl.gen_renderbuffers || !gl.delete_renderbuffers || !gl.bind_renderbuffer ||
+        !gl.renderbuffer_storage || !gl.framebuffer_renderbuffer ||
+        !gl.check_framebuffer_status) {
+        fprintf(stderr, "Offscreen: framebuffer objects not supported by GL context\n");
+        return -1;
+    }
+
+    g_loaded = true;
+    return 0;
+}
+
+int rfui_fbo_create(rfui_fbo_t* fbo, int width, int height) {
+    if (!g_loaded || !fbo || width <= 0 || height <= 0) return -1;
+
+    memset(fbo, 0, sizeof(*fbo));
+    fbo->width = width;
+    fbo->height = height;
+
+    gl.gen_renderbuffers(1, &fbo->rbo);
+    gl.bind_renderbuffer(RFUI_GL_RENDERBUFFER, fbo->rbo);
+    gl.renderbuffer_storage(RFUI_GL_RENDERBUFFER, RFUI_GL_RGBA8, width, height);
+    gl.bind_renderbuffer(RFUI_GL_RENDERBUFFER, 0);
+
+    gl.gen_framebuffers(1, &fbo->fbo);
+    gl.bind_framebuffer(RFUI_GL_FRAMEBUFFER, fbo->fbo);
+    gl.framebuffer_renderbuffer(RFUI_GL_FRAMEBUFFER, RFUI_GL_COLOR_ATTACHMENT0,
+                                RFUI_GL_RENDERBUFFER, fbo->rbo);
+    GLenum status = gl.check_framebuffer_status(RFUI_GL_FRAMEBUFFER);
+    gl.bind_framebuffer(RFUI_GL_FRAMEBUFFER, 0);
+
+    if (status != RFUI_GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Offscreen: framebuffer incomplete (0x%x)\n", (unsigned)status);
+        rfui_fbo_destroy(fbo);
+        return -1;
+    }
+    return 0;
+}
+
+void rfui_fbo_bind(const rfui_fbo_t* fbo) {
+    if (!g_loaded) return;
+    gl.bind_framebuffer(RFUI_GL_FRAMEBUFFER, fbo ? fbo->fbo : 0);
+}
+
+void rfui_fbo_read(const rfui_fbo_t* fbo, unsigned char* rgba) {
+    if (!g_loaded || !fbo || !rgba) return;
+
+    gl.bind_framebuffer(RFUI_GL_FRAMEBUFFER, fbo->fbo);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, fbo->width, fbo->height, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+
+    // GL origin is bottom-left; flip rows in place to top-down
+    size_t stride = (size_t)fbo->width * 4;
+    unsigned char* tmp = (unsigned char*)malloc(stride);
+    if (tmp) {
+        for (int y = 0; y < fbo->height / 2; y++) {
+            unsigned char* a = rgba + (size_t)y * stride;
+            unsigned char* b = rgba + (size_t)(fbo->height - 1 - y) * stride;
+            memcpy(tmp, a, stride);
+            memcpy(a, b, stride);
+            memcpy(b, tmp, stride);
+        }
+        free(tmp);
+    }
+}
+
+void rfui_fbo_destroy(rfui_fbo_t* fbo) {
+    if (!g_loaded || !fbo) return;
+    if (fbo->fbo) gl.delete_framebuffers(1, &fbo->fbo);
+    if (fbo->rbo) gl.delete_renderbuffers(1, &fbo->rbo);
+    fbo->fbo = 0;
+    fbo->rbo = 0;
+}
+
+} // extern "C"
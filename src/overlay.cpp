@@ -0,0 +1,235 @@
+// src/overlay.cpp
+// Performance overlay window
+
+#include <stdio.h>
+#include <string.h>
+
+#include "imgui.h"
+#include "../include/rfui/icons.h"
+
+// Make rayforce headers C++ compatible by redefining _Static_assert
+#define _Static_assert static_assert
+
+extern "C" {
+#include "../include/rfui/overlay.h"
+#include "../include/rfui/widget.h"
+#include "../include/rfui/widget_registry.h"
+#include "../include/rfui/latency.h"
+#include "../include/rfui/memory.h"
+}
+
+// Frame time history for the sparkline (ring buffer)
+#define FRAME_HISTORY 240
+
+static bool g_visible = false;
+static float g_frame_ms[FRAME_HISTORY];
+static int g_frame_pos = 0;
+static int g_frame_count = 0;
+
+static const ImVec4 COL_DIM(0.545f, 0.580f, 0.620f, 1.0f);   // #8B949E
+static const ImVec4 COL_WARN(0.824f, 0.600f, 0.133f, 1.0f);  // #D29922
+static const ImVec4 COL_BAD(0.973f, 0.318f, 0.286f, 1.0f);   // #F85149
+
+// Widgets listed in the memory section (largest first)
+#define MEMORY_TOP_WIDGETS 8
+
+// Human-readable byte count
+static void format_bytes(i64_t bytes, char* buf, size_t size) {
+    if (bytes >= (1LL << 30)) {
+        snprintf(buf, size, "%.2f GB", (double)bytes / (double)(1LL << 30));
+    } else if (bytes >= (1LL << 20)) {
+        snprintf(buf, size, "%.1f MB", (double)bytes / (double)(1LL << 20));
+    } else if (bytes >= (1LL << 10)) {
+        snprintf(buf, size, "%.1f KB", (double)bytes / (double)(1LL << 10));
+    } else {
+        snprintf(buf, size, "%lld B", (long long)bytes);
+    }
+}
+
+static void memory_row(const char* label, i64_t bytes) {
+    char buf[32];
+    format_bytes(bytes, buf, sizeof(buf));
+    ImGui::TableNextRow();
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(label);
+    ImGui::TableNextColumn();
+    ImGui::TextUnformatted(buf);
+}
+
+static void render_memory(nil_t) {
+    rfui_mem_report_t r;
+    rfui_memory_report(&r);
+
+    char total[32];
+    format_bytes(r.total, total, sizeof(total));
+    ImGui::Separator();
+    ImGui::TextColored(COL_DIM, "Memory: %s", total);
+
+    if (ImGui::BeginTable("##memory", 2, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+        // Selection pass for the largest widgets (report is small, no sort needed)
+        i64_t picked[MEMORY_TOP_WIDGETS];
+        int npicked = 0;
+        while (npicked < MEMORY_TOP_WIDGETS && npicked < r.nwidgets) {
+            i64_t best = -1;
+            for (i64_t i = 0; i < r.nwidgets; i++) {
+                bool taken = false;
+                for (int j = 0; j < npicked; j++) taken |= picked[j] == i;
+                if (taken) continue;
+                if (best < 0 || r.widgets[i].render_data + r.widgets[i].ui_state >
+                                r.widgets[best].render_data + r.widgets[best].ui_state) {
+                    best = i;
+                }
+            }
+            picked[npicked++] = best;
+            const rfui_mem_widget_t* mw = &r.widgets[best];
+            memory_row(mw->name, mw->render_data + mw->ui_state);
+        }
+        if (r.nwidgets > MEMORY_TOP_WIDGETS) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextDisabled("(%lld more widgets)", (long long)(r.nwidgets - MEMORY_TOP_WIDGETS));
+        }
+
+        memory_row("REPL scrollback", r.repl_lines);
+        memory_row("REPL history", r.repl_history);
+        char label[48];
+        snprintf(label, sizeof(label), "Pending drops (%lld)", (long long)r.pending_drops);
+        memory_row(label, r.pending_drop_bytes);
+        memory_row("Font atlas", r.font_atlas);
+        memory_row("Textures", r.textures);
+        memory_row("Symbol strings", r.symbols);
+        ImGui::EndTable();
+    }
+
+    rfui_memory_report_free(&r);
+}
+
+// Latency cell in ms, colored by how many 60 Hz frames stale it is
+static void latency_cell(i64_t ns) {
+    double ms = (double)ns / 1e6;
+    if (ms >= 50.0) {
+        ImGui::TextColored(COL_BAD, "%.2f", ms);
+    } else if (ms >= 16.7) {
+        ImGui::TextColored(COL_WARN, "%.2f", ms);
+    } else {
+        ImGui::Text("%.2f", ms);
+    }
+}
+
+extern "C" {
+
+nil_t rfui_overlay_set_visible(b8_t visible) {
+    g_visible = visible != 0;
+}
+
+b8_t rfui_overlay_visible(nil_t) {
+    return g_visible ? B8_TRUE : B8_FALSE;
+}
+
+nil_t rfui_overlay_toggle(nil_t) {
+    g_visible = !g_visible;
+}
+
+nil_t rfui_overlay_frame(f64_t ms) {
+    g_frame_ms[g_frame_pos] = (float)ms;
+    g_frame_pos = (g_frame_pos + 1) % FRAME_HISTORY;
+    if (g_frame_count < FRAME_HISTORY) g_frame_count++;
+}
+
+nil_t rfui_overlay_render(nil_t) {
+    if (!g_visible) return;
+
+    const ImGuiViewport* vp = ImGui::GetMainViewport();
+    ImGui::SetNextWindowPos(ImVec2(vp->WorkPos.x + vp->WorkSize.x - 16.0f, vp->WorkPos.y + 48.0f),
+                            ImGuiCond_FirstUseEver, ImVec2(1.0f, 0.0f));
+    ImGui::SetNextWindowBgAlpha(0.92f);
+
+    ImGuiWindowFlags flags = ImGuiWindowFlags_AlwaysAutoResize |
+                             ImGuiWindowFlags_NoFocusOnAppearing |
+                             ImGuiWindowFlags_NoNav |
+                             ImGuiWindowFlags_NoDocking;
+    if (!ImGui::Begin(ICON_GAUGE " Performance", &g_visible, flags)) {
+        ImGui::End();
+        return;
+    }
+
+    // --- Frame timing ---
+    float max_ms = 0.0f;
+    float sum_ms = 0.0f;
+    float ordered[FRAME_HISTORY];
+    for (int i = 0; i < g_frame_count; i++) {
+        int idx = (g_frame_pos - g_frame_count + i + FRAME_HISTORY) % FRAME_HISTORY;
+        ordered[i] = g_frame_ms[idx];
+        sum_ms += ordered[i];
+        if (ordered[i] > max_ms) max_ms = ordered[i];
+    }
+    float avg_ms = g_frame_count ? sum_ms / (float)g_frame_count : 0.0f;
+
+    ImGui::Text("%.1f fps", ImGui::GetIO().Framerate);
+    ImGui::SameLine();
+    ImGui::TextColored(COL_DIM, "frame avg %.2f ms  max %.2f ms", avg_ms, max_ms);
+    if (g_frame_count > 0) {
+        char label[32];
+        snprintf(label, sizeof(label), "%.1f ms", ordered[g_frame_count - 1]);
+        ImGui::PlotLines("##frames", ordered, g_frame_count, 0, label,
+                         0.0f, max_ms > 33.4f ? max_ms : 33.4f, ImVec2(360.0f, 48.0f));
+    }
+
+    // --- Draw latency per widget ---
+    ImGui::Separator();
+    ImGui::TextColored(COL_DIM, "Draw latency (ms): draw->apply / draw->present");
+
+    i64_t count = rfui_registry_count();
+    if (count == 0) {
+        ImGui::TextDisabled("No widgets");
+    } else if (ImGui::BeginTable("##latency", 7,
+                                 ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV |
+                                 ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Widget");
+        ImGui::TableSetupColumn("Draws");
+        ImGui::TableSetupColumn("Skip");
+        ImGui::TableSetupColumn("Apply p99");
+        ImGui::TableSetupColumn("Present p50");
+        ImGui::TableSetupColumn("p99");
+        ImGui::TableSetupColumn("max");
+        ImGui::TableHeadersRow();
+
+        for (i64_t i = 0; i < count; i++) {
+            rfui_widget_t* w = rfui_registry_get(i);
+            if (!w) continue;
+
+            rfui_latency_summary_t s;
+            rfui_latency_summary(w->latency, &s);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(w->name);
+            ImGui::TableNextColumn();
+            ImGui::Text("%lld", (long long)s.apply.count);
+            ImGui::TableNextColumn();
+            if (s.superseded > 0) {
+                ImGui::TextColored(COL_WARN, "%lld", (long long)s.superseded);
+            } else {
+                ImGui::TextColored(COL_DIM, "0");
+            }
+            ImGui::TableNextColumn();
+            latency_cell(s.apply.p99);
+            ImGui::TableNextColumn();
+            latency_cell(s.present.p50);
+            ImGui::TableNextColumn();
+            latency_cell(s.present.p99);
+            ImGui::TableNextColumn();
+            latency_cell(s.present.max);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::TextColored(COL_DIM, "Skip = draws replaced before reaching the screen");
+
+    // --- Memory ---
+    render_memory();
+
+    ImGui::End();
+}
+
+} // extern "C"
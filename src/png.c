@@ -0,0 +1,298 @@
+// src/png.c
+// Minimal PNG encoder: adaptive scanline filters + LZ77 with fixed Huffman
+// deflate. UI captures are mostly flat color, so greedy matching over a 32K
+// window gets close to zlib's default level without the dependency.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/rfui/png.h"
+
+#define WINDOW_SIZE   32768
+#define WINDOW_MASK   (WINDOW_SIZE - 1)
+#define HASH_BITS     15
+#define HASH_SIZE     (1 << HASH_BITS)
+#define MAX_CHAIN     16
+#define MIN_MATCH     3
+#define MAX_MATCH     258
+
+// Growable output buffer
+typedef struct png_buf_t {
+    u8_t* data;
+    i64_t len;
+    i64_t cap;
+    b8_t failed;
+    u32_t bitbuf;
+    i32_t bitcount;
+} png_buf_t;
+
+static nil_t buf_put(png_buf_t* b, const u8_t* src, i64_t n) {
+    if (b->failed) return;
+    if (b->len + n > b->cap) {
+        i64_t cap = b->cap ? b->cap : 65536;
+        while (cap < b->len + n) cap *= 2;
+        u8_t* data = realloc(b->data, cap);
+        if (!data) {
+            b->failed = B8_TRUE;
+            return;
+        }
+        b->data = data;
+        b->cap = cap;
+    }
+    memcpy(b->data + b->len, src, n);
+    b->len += n;
+}
+
+static nil_t buf_byte(png_buf_t* b, u8_t v) {
+    buf_put(b, &v, 1);
+}
+
+static nil_t buf_u32be(png_buf_t* b, u32_t v) {
+    u8_t be[4] = { (u8_t)(v >> 24), (u8_t)(v >> 16), (u8_t)(v >> 8), (u8_t)v };
+    buf_put(b, be, 4);
+}
+
+// Deflate bit stream is LSB-first
+static nil_t put_bits(png_buf_t* b, u32_t bits, i32_t n) {
+    b->bitbuf |= bits << b->bitcount;
+    b->bitcount += n;
+    while (b->bitcount >= 8) {
+        buf_byte(b, (u8_t)b->bitbuf);
+        b->bitbuf >>= 8;
+        b->bitcount -= 8;
+    }
+}
+
+// Huffman codes are stored MSB-first, so reverse before emitting
+static nil_t put_code(png_buf_t* b, u32_t code, i32_t n) {
+    u32_t rev = 0;
+    for (i32_t i = 0; i < n; i++) {
+        rev = (rev << 1) | (code & 1);
+        code >>= 1;
+    }
+    put_bits(b, rev, n);
+}
+
+static nil_t flush_bits(png_buf_t* b) {
+    if (b->bitcount > 0) buf_byte(b, (u8_t)b->bitbuf);
+    b->bitbuf = 0;
+    b->bitcount = 0;
+}
+
+// Fixed Huffman literal/length alphabet (RFC 1951 3.2.6)
+static nil_t put_litlen(png_buf_t* b, i32_t sym) {
+    if (sym < 144)      put_code(b, 0x30 + sym, 8);
+    else if (sym < 256) put_code(b, 0x190 + (sym - 144), 9);
+    else if (sym < 280) put_code(b, sym - 256, 7);
+    else                put_code(b, 0xC0 + (sym - 280), 8);
+}
+
+static const i32_t len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const u8_t len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const i32_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577
+};
+static const u8_t dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+static nil_t put_match(png_buf_t* b, i32_t len, i32_t dist) {
+    i32_t li = 28;
+    while (len_base[li] > len) li--;
+    put_litlen(b, 257 + li);
+    if (len_extra[li]) put_bits(b, len - len_base[li], len_extra[li]);
+
+    i32_t di = 29;
+    while (dist_base[di] > dist) di--;
+    put_code(b, di, 5);
+    if (dist_extra[di]) put_bits(b, dist - dist_base[di], dist_extra[di]);
+}
+
+static u32_t hash3(const u8_t* p) {
+    return ((u32_t)p[0] << 10 ^ (u32_t)p[1] << 5 ^ (u32_t)p[2]) & (HASH_SIZE - 1);
+}
+
+// zlib stream: header, one fixed-Huffman deflate block, adler32
+static b8_t zlib_compress(png_buf_t* out, const u8_t* src, i64_t n) {
+    i32_t* head = malloc(sizeof(i32_t) * HASH_SIZE);
+    i32_t* prev = malloc(sizeof(i32_t) * WINDOW_SIZE);
+    if (!head || !prev) {
+        free(head);
+        free(prev);
+        return B8_FALSE;
+    }
+    for (i32_t i = 0; i < HASH_SIZE; i++) head[i] = -1;
+
+    buf_byte(out, 0x78);
+    buf_byte(out, 0x01);
+    put_bits(out, 1, 1);  // BFINAL
+    put_bits(out, 1, 2);  // BTYPE = fixed Huffman
+
+    i64_t pos = 0;
+    while (pos < n && !out->failed) {
+        i32_t best_len = 0;
+        i32_t best_dist = 0;
+
+        if (pos + MIN_MATCH <= n) {
+            u32_t h = hash3(src + pos);
+            i64_t cand = head[h];
+            i64_t max_len = n - pos < MAX_MATCH ? n - pos : MAX_MATCH;
+            for (i32_t chain = 0; chain < MAX_CHAIN && cand >= 0 && pos - cand <= WINDOW_SIZE - 1; chain++) {
+                const u8_t* a = src + cand;
+                const u8_t* c = src + pos;
+                i32_t l = 0;
+                while (l < max_len && a[l] == c[l]) l++;
+                if (l > best_len) {
+                    best_len = l;
+                    best_dist = (i32_t)(pos - cand);
+                    if (l == max_len) break;
+                }
+                i64_t next = prev[cand & WINDOW_MASK];
+                if (next >= cand) break;
+                cand = next;
+            }
+        }
+
+        i64_t advance = best_len >= MIN_MATCH ? best_len : 1;
+        if (best_len >= MIN_MATCH) {
+            put_match(out, best_len, best_dist);
+        } else {
+            put_litlen(out, src[pos]);
+        }
+
+        // Insert every position covered so later matches can reference it
+        for (i64_t k = 0; k < advance; k++, pos++) {
+            if (pos + MIN_MATCH <= n) {
+                u32_t h = hash3(src + pos);
+                prev[pos & WINDOW_MASK] = head[h];
+                head[h] = (i32_t)pos;
+            }
+        }
+    }
+
+    put_litlen(out, 256);  // end of block
+    flush_bits(out);
+
+    // Adler-32 over uncompressed data
+    u32_t a = 1, b = 0;
+    for (i64_t i = 0; i < n; i++) {
+        a = (a + src[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    buf_u32be(out, (b << 16) | a);
+
+    free(head);
+    free(prev);
+    return !out->failed;
+}
+
+// CRC table is built per image (cheap) so concurrent writers share no state
+static nil_t crc32_init(u32_t* table) {
+    for (u32_t i = 0; i < 256; i++) {
+        u32_t c = i;
+        for (i32_t k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[i] = c;
+    }
+}
+
+static u32_t crc32_update(const u32_t* table, u32_t crc, const u8_t* p, i64_t n) {
+    for (i64_t i = 0; i < n; i++) crc = table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+static nil_t write_chunk(FILE* f, const u32_t* crc_table, const char* type, const u8_t* data, i64_t len) {
+    u8_t hdr[8] = { (u8_t)(len >> 24), (u8_t)(len >> 16), (u8_t)(len >> 8), (u8_t)len,
+                    (u8_t)type[0], (u8_t)type[1], (u8_t)type[2], (u8_t)type[3] };
+    fwrite(hdr, 1, 8, f);
+    if (len > 0) fwrite(data, 1, len, f);
+    u32_t crc = crc32_update(crc_table, 0xFFFFFFFFu, hdr + 4, 4);
+    crc = crc32_update(crc_table, crc, data, len) ^ 0xFFFFFFFFu;
+    u8_t be[4] = { (u8_t)(crc >> 24), (u8_t)(crc >> 16), (u8_t)(crc >> 8), (u8_t)crc };
+    fwrite(be, 1, 4, f);
+}
+
+// Per-row filter choice (None/Sub/Up) by minimum sum of absolute differences
+static nil_t filter_rows(const u8_t* rgba, i32_t width, i32_t height, u8_t* out) {
+    i64_t stride = (i64_t)width * 4;
+    for (i32_t y = 0; y < height; y++) {
+        const u8_t* row = rgba + y * stride;
+        const u8_t* up = y > 0 ? row - stride : NULL;
+        u8_t* dst = out + y * (stride + 1);
+
+        u64_t cost_none = 0, cost_sub = 0, cost_up = 0;
+        for (i64_t i = 0; i < stride; i++) {
+            u8_t none = row[i];
+            u8_t sub = (u8_t)(row[i] - (i >= 4 ? row[i - 4] : 0));
+            u8_t upv = (u8_t)(row[i] - (up ? up[i] : 0));
+            cost_none += none < 128 ? none : 256 - none;
+            cost_sub  += sub  < 128 ? sub  : 256 - sub;
+            cost_up   += upv  < 128 ? upv  : 256 - upv;
+        }
+
+        if (cost_sub <= cost_none && cost_sub <= cost_up) {
+            dst[0] = 1;
+            for (i64_t i = 0; i < stride; i++)
+                dst[1 + i] = (u8_t)(row[i] - (i >= 4 ? row[i - 4] : 0));
+        } else if (cost_up < cost_none) {
+            dst[0] = 2;
+            for (i64_t i = 0; i < stride; i++)
+                dst[1 + i] = (u8_t)(row[i] - up[i]);
+        } else {
+            dst[0] = 0;
+            memcpy(dst + 1, row, stride);
+        }
+    }
+}
+
+i32_t rfui_png_write(const char* path, const u8_t* rgba, i32_t width, i32_t height) {
+    if (!path || !rgba || width <= 0 || height <= 0) return -1;
+
+    i64_t raw_len = ((i64_t)width * 4 + 1) * height;
+    u8_t* raw = malloc(raw_len);
+    if (!raw) return -1;
+    filter_rows(rgba, width, height, raw);
+
+    png_buf_t z;
+    memset(&z, 0, sizeof(z));
+    b8_t ok = zlib_compress(&z, raw, raw_len);
+    free(raw);
+    if (!ok) {
+        free(z.data);
+        return -1;
+    }
+
+    FILE* f = fopen(path, "wb");
+    if (!f) {
+        free(z.data);
+        return -1;
+    }
+
+    static const u8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    fwrite(signature, 1, 8, f);
+
+    u8_t ihdr[13] = {
+        (u8_t)(width >> 24), (u8_t)(width >> 16), (u8_t)(width >> 8), (u8_t)width,
+        (u8_t)(height >> 24), (u8_t)(height >> 16), (u8_t)(height >> 8), (u8_t)height,
+        8,  // bit depth
+        6,  // color type RGBA
+        0, 0, 0
+    };
+    u32_t crc_table[256];
+    crc32_init(crc_table);
+    write_chunk(f, crc_table, "IHDR", ihdr, sizeof(ihdr));
+    write_chunk(f, crc_table, "IDAT", z.data, z.len);
+    write_chunk(f, crc_table, "IEND", NULL, 0);
+
+    free(z.data);
+    i32_t rc = ferror(f) ? -1 : 0;
+    if (fclose(f) != 0) rc = -1;
+    return rc;
+}
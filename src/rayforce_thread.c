@@ -14,13 +14,105 @@
 #include "../include/rfui/queue.h"
 #include "../include/rfui/widget.h"
 #include "../include/rfui/rayforce_thread.h"
+#include "../include/rfui/latency.h"
+#include "../include/rfui/memory.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/record.h"
+#include "../include/rfui/keyed.h"
+#include "../include/rfui/symbols.h"
+#include "../include/rfui/headless.h"
 #include <GLFW/glfw3.h>
 
 // Thread-local context for rayforce-ui functions
 static __thread rfui_ctx_t* g_ctx = NULL;
 
-// Forward declaration
+// Forward declarations
 static void on_ui_message(raw_p data);
+static void replay_record(const u8_t* blob, i64_t len);
+static obj_p project(rfui_widget_t* w, obj_p data);
+static obj_p send_draw(rfui_widget_t* w, obj_p data, i64_t stamp);
+
+static int cmp_i64(const void* a, const void* b) {
+    i64_t x = *(const i64_t*)a, y = *(const i64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Allocate a zeroed Rayforce -> UI message
+static rfui_ray_msg_t* ray_msg_new(rfui_ray_msg_type_t type, rfui_widget_t* widget) {
+    rfui_ray_msg_t* msg = (rfui_ray_msg_t*)calloc(1, sizeof(rfui_ray_msg_t));
+    if (msg) {
+        msg->type = type;
+        msg->widget = widget;
+    }
+    return msg;
+}
+
+// Format a result (consumed) and send it to the REPL
+static void send_result(rfui_ctx_t* ctx, obj_p result) {
+    char* result_text = NULL;
+    if (result) {
+        i64_t trace_span = rfui_trace_begin();
+        obj_p fmt = obj_fmt(result, B8_TRUE);
+        rfui_trace_end("obj_fmt", NULL, trace_span);
+        if (fmt && fmt->type == TYPE_C8) {
+            // Copy formatted string
+            result_text = (char*)malloc(fmt->len + 1);
+            if (result_text) {
+                memcpy(result_text, AS_C8(fmt), fmt->len);
+                result_text[fmt->len] = '\0';
+            }
+            drop_obj(fmt);
+        }
+        drop_obj(result);
+    }
+
+    // Send result back to UI
+    if (result_text) {
+        rfui_ray_msg_t* reply = ray_msg_new(RFUI_MSG_RESULT, NULL);
+        if (reply) {
+            reply->text = result_text;
+
+            if (rfui_queue_push(ctx->ray_to_ui, reply)) {
+                glfwPostEmptyEvent();  // Wake UI thread
+            } else {
+                free(result_text);
+                free(reply);
+            }
+        } else {
+            free(result_text);
+        }
+    }
+}
+
+// Call the widget's on_select with the selected rows as an i64 vector.
+// Errors go to the REPL; other results are dropped.
+static void dispatch_select(rfui_ctx_t* ctx, rfui_widget_t* w, const i64_t* rows, i64_t n) {
+    if (!w->on_select) return;
+
+    obj_p vec = vector(TYPE_I64, n);
+    if (!vec || IS_ERR(vec)) {
+        if (vec) drop_obj(vec);
+        return;
+    }
+    if (n > 0) memcpy(AS_I64(vec), rows, sizeof(i64_t) * n);
+
+    obj_p fn = clone_obj(w->on_select);
+    obj_p call_expr = fn ? vn_list(2, fn, vec) : NULL;
+    if (!call_expr) {
+        if (fn) drop_obj(fn);
+        drop_obj(vec);
+        return;
+    }
+
+    i64_t trace_span = rfui_trace_begin();
+    obj_p result = eval_obj(call_expr);
+    rfui_trace_end("on_select", w->name, trace_span);
+    if (result && IS_ERR(result)) {
+        send_result(ctx, result);
+    } else if (result) {
+        drop_obj(result);
+    }
+}
 
 // Process a single UI message
 static void process_ui_message(rfui_ctx_t* ctx, rfui_ui_msg_t* msg) {
@@ -30,44 +122,11 @@ static void process_ui_message(rfui_ctx_t* ctx, rfui_ui_msg_t* msg) {
         case RFUI_MSG_EVAL:
             if (msg->expr) {
                 // Evaluate expression
+                i64_t trace_span = rfui_trace_begin();
                 obj_p result = eval_str(msg->expr);
+                rfui_trace_end("eval", msg->expr, trace_span);
 
-                // Format result for display
-                char* result_text = NULL;
-                if (result) {
-                    obj_p fmt = obj_fmt(result, B8_TRUE);
-                    if (fmt && fmt->type == TYPE_C8) {
-                        // Copy formatted string
-                        result_text = (char*)malloc(fmt->len + 1);
-                        if (result_text) {
-                            memcpy(result_text, AS_C8(fmt), fmt->len);
-                            result_text[fmt->len] = '\0';
-                        }
-                        drop_obj(fmt);
-                    }
-                    drop_obj(result);
-                }
-
-                // Send result back to UI
-                if (result_text) {
-                    rfui_ray_msg_t* reply = (rfui_ray_msg_t*)malloc(sizeof(rfui_ray_msg_t));
-                    if (reply) {
-                        reply->type = RFUI_MSG_RESULT;
-                        reply->widget = NULL;
-                        reply->data = NULL;
-                        reply->text = result_text;
-
-                        if (rfui_queue_push(ctx->ray_to_ui, reply)) {
-                            glfwPostEmptyEvent();  // Wake UI thread
-                        } else {
-                            free(result_text);
-                            free(reply);
-                        }
-                    } else {
-                        free(result_text);
-                    }
-                }
-
+                send_result(ctx, result);
                 free(msg->expr);
             }
             break;
@@ -99,7 +158,45 @@ static void process_ui_message(rfui_ctx_t* ctx, rfui_ui_msg_t* msg) {
             // Drop obj_p after render
             if (msg->obj) {
                 drop_obj(msg->obj);
+                rfui_memory_drop_done(msg->bytes);
+            }
+            break;
+
+        case RFUI_MSG_REPLAY:
+            // Recorded widget/draw from the --replay thread
+            if (msg->blob) {
+                replay_record(msg->blob, msg->bytes);
+                free(msg->blob);
+            }
+            break;
+
+        case RFUI_MSG_SELECT:
+            if (msg->widget) {
+                dispatch_select(ctx, msg->widget, msg->rows, msg->bytes);
+                // Let the UI send the selection that piled up meanwhile
+                __atomic_store_n(&msg->widget->select_busy, 0, __ATOMIC_RELEASE);
+                glfwPostEmptyEvent();
+            }
+            free(msg->rows);
+            break;
+
+        case RFUI_MSG_SET_HIDDEN:
+            // Ship hidden grid columns blank from now on, and re-send the last
+            // table so columns shown again fill in without waiting for a draw
+            if (msg->widget) {
+                rfui_widget_t* w = msg->widget;
+                free(w->hidden);
+                w->hidden = msg->rows;
+                w->nhidden = msg->rows ? msg->bytes : 0;
+                msg->rows = NULL;
+                // Sorted, so project() finds each name with a binary search
+                if (w->nhidden > 1) qsort(w->hidden, (size_t)w->nhidden, sizeof(i64_t), cmp_i64);
+                if (w->data) {
+                    obj_p err = send_draw(w, project(w, clone_obj(w->data)), rfui_clock_ns());
+                    if (err) drop_obj(err);
+                }
             }
+            free(msg->rows);
             break;
 
         case RFUI_MSG_QUIT:
@@ -133,10 +230,12 @@ static void on_ui_message(raw_p data) {
 
     // Drain the queue and process all pending messages
     // Check quit flag to exit early on shutdown
+    i64_t trace_span = rfui_trace_begin();
     while (!rfui_ctx_get_quit(ctx) &&
            (msg = (rfui_ui_msg_t*)rfui_queue_pop(ctx->ui_to_ray)) != NULL) {
         process_ui_message(ctx, msg);
     }
+    rfui_trace_end("on_ui_message", NULL, trace_span);
 }
 
 // Register rayforce-ui extension types (stub for now)
@@ -171,8 +270,19 @@ static nil_t widget_drop(raw_p ptr) {
     // Widget is owned by UI thread, do not free here
 }
 
+// Hand a new widget to the UI thread, which owns it from here on
+static b8_t send_widget_created(rfui_widget_t* w) {
+    rfui_ray_msg_t* msg = ray_msg_new(RFUI_MSG_WIDGET_CREATED, w);
+    if (!msg) return B8_FALSE;
+
+    rfui_queue_push(g_ctx->ray_to_ui, msg);
+    glfwPostEmptyEvent();  // Wake UI thread
+    return B8_TRUE;
+}
+
 // fn_widget: (widget {type: 'grid name: "myname"})
-// Takes a dict with 'type and 'name keys, returns external object wrapping widget
+// Takes a dict with 'type and 'name keys (and an optional on-select lambda),
+// returns external object wrapping widget
 static obj_p fn_widget(obj_p* x, i64_t n) {
     if (n != 1) {
         return ray_err("widget: expects 1 argument (config dict)");
@@ -212,10 +322,34 @@ static obj_p fn_widget(obj_p* x, i64_t n) {
     }
     drop_obj(type_val);
 
+    // Optional on-select callback: called with the selected row indices
+    obj_p select_val = at_sym(config, "on-select", 9);
+    if (select_val && select_val->type != TYPE_LAMBDA) {
+        drop_obj(select_val);
+        select_val = NULL;
+    }
+
+    // Optional column list: tables drawn to the widget keep only these
+    obj_p columns_val = at_sym(config, "columns", 7);
+    if (columns_val && columns_val->type != TYPE_SYMBOL) {
+        drop_obj(columns_val);
+        columns_val = NULL;
+    }
+
+    // Optional dense: true starts a grid in dense rendering mode (no ImGui table)
+    b8_t dense = B8_FALSE;
+    obj_p dense_val = at_sym(config, "dense", 5);
+    if (dense_val) {
+        dense = dense_val->type == -TYPE_B8 && dense_val->b8;
+        drop_obj(dense_val);
+    }
+
     // Get the name string (null-terminated)
     char* name_str = malloc(name_val->len + 1);
     if (!name_str) {
         drop_obj(name_val);
+        if (select_val) drop_obj(select_val);
+        if (columns_val) drop_obj(columns_val);
         return ray_err("widget: memory allocation failed");
     }
     memcpy(name_str, AS_C8(name_val), name_val->len);
@@ -227,65 +361,29 @@ static obj_p fn_widget(obj_p* x, i64_t n) {
     free(name_str);
 
     if (!w) {
+        if (select_val) drop_obj(select_val);
+        if (columns_val) drop_obj(columns_val);
         return ray_err("widget: failed to create widget");
     }
+    w->on_select = select_val;
+    w->columns = columns_val;
+    w->dense = dense;
 
     // Send WIDGET_CREATED message to UI
-    rfui_ray_msg_t* msg = malloc(sizeof(rfui_ray_msg_t));
-    if (!msg) {
+    if (!send_widget_created(w)) {
         rfui_widget_destroy(w);
         return ray_err("widget: failed to allocate message");
     }
-    msg->type = RFUI_MSG_WIDGET_CREATED;
-    msg->widget = w;
-    msg->data = NULL;
-    msg->text = NULL;
-
-    rfui_queue_push(g_ctx->ray_to_ui, msg);
-    glfwPostEmptyEvent();  // Wake UI thread
+    rfui_record_widget(w);
 
     // Return external object wrapping widget pointer
     // The widget_drop function is a no-op since UI owns the widget
     return external(w, widget_drop);
 }
 
-// fn_draw: (draw widget data)
-// widget is external object, data is the data to render
-// Returns the widget for chaining
-//
-// KNOWN TECHNICAL DEBT: Widget lifecycle race condition
-// The widget pointer validity relies on the assumption that the UI thread
-// will not destroy the widget while we hold a reference to it. This is safe
-// under the current design where widgets live for the session lifetime and
-// are only destroyed during shutdown. A proper fix would require either:
-// - Widget IDs with lookup validation on the UI side, or
-// - Reference counting with atomic operations
-// For now, we assume widgets are never destroyed mid-session.
-static obj_p fn_draw(obj_p* x, i64_t n) {
-    if (n != 2) {
-        return ray_err("draw: expects 2 arguments (widget, data)");
-    }
-
-    obj_p widget_obj = x[0];
-    obj_p data = x[1];
-
-    if (widget_obj->type != TYPE_EXT) {
-        return ray_err("draw: first argument must be a widget");
-    }
-
-    // Extract widget pointer from external object
-    // TYPE_EXT stores data in ext_t structure: { raw_p ptr; nil_t (*drop)(raw_p); }
-    ext_p ext = (ext_p)AS_C8(widget_obj);
-    rfui_widget_t* w = (rfui_widget_t*)ext->ptr;
-    if (!w) {
-        return ray_err("draw: widget is null");
-    }
-
-    // Check we have context
-    if (!g_ctx) {
-        return ray_err("draw: no rayforce-ui context available");
-    }
-
+// Apply post_query and send the result to the UI (shared by draw and replay).
+// stamp is the latency clock start. Returns NULL on success or an error.
+static obj_p draw_widget(rfui_widget_t* w, obj_p data, i64_t stamp) {
     // Apply post_query transformation if widget has one
     // The post_query is a lambda/function that takes data as argument.
     // We build a call expression (post_query data) and evaluate it.
@@ -312,7 +410,9 @@ static obj_p fn_draw(obj_p* x, i64_t n) {
         }
 
         // eval_obj consumes the call expression and returns the result
+        i64_t trace_span = rfui_trace_begin();
         obj_p result = eval_obj(call_expr);
+        rfui_trace_end("post_query", w->name, trace_span);
         if (result && !IS_ERR(result)) {
             final_data = result;
         } else {
@@ -331,19 +431,177 @@ static obj_p fn_draw(obj_p* x, i64_t n) {
         }
     }
 
-    // Send DRAW message to UI
-    rfui_ray_msg_t* msg = malloc(sizeof(rfui_ray_msg_t));
+    // Grids draw keyed tables flattened; that table is the base for draw-upsert
+    if (w->type == RFUI_WIDGET_GRID) {
+        i64_t nkeys = 0;
+        if (rfui_keyed_is(final_data)) {
+            obj_p flat = rfui_keyed_flatten(final_data, &nkeys);
+            drop_obj(final_data);
+            if (IS_ERR(flat)) {
+                return flat;
+            }
+            final_data = flat;
+        }
+        if (w->data) drop_obj(w->data);
+        w->data = clone_obj(final_data);
+        rfui_keyed_reset(&w->keyed, nkeys);
+    }
+
+    return send_draw(w, project(w, final_data), stamp);
+}
+
+// One blank column per widget (spaces, never matched or aggregated by the
+// grid), reused while the row count holds. NULL if out of memory.
+static obj_p blank_column(rfui_widget_t* w, i64_t nrows) {
+    if (!w->blank || w->blank->len != nrows) {
+        if (w->blank) drop_obj(w->blank);
+        w->blank = vector(TYPE_C8, nrows);
+        if (!w->blank) return NULL;
+        memset(AS_C8(w->blank), ' ', (size_t)nrows);
+    }
+    return clone_obj(w->blank);
+}
+
+// Project a table (consumed) before it is shipped: the config columns pick
+// and order the columns (names the table lacks are skipped), and columns the
+// grid hides become the blank column, so the UI keeps its column indices and
+// can show them again. Anything else passes through.
+static obj_p project(rfui_widget_t* w, obj_p data) {
+    if (!data || data->type != TYPE_TABLE || data->len < 2 || (!w->columns && w->nhidden == 0)) {
+        return data;
+    }
+    obj_p names = AS_LIST(data)[0];
+    obj_p cols = AS_LIST(data)[1];
+    if (!names || !cols || names->type != TYPE_SYMBOL || cols->type != TYPE_LIST ||
+        names->len != cols->len || cols->len == 0 || !AS_LIST(cols)[0]) {
+        return data;
+    }
+
+    i64_t n = w->columns ? w->columns->len : names->len;
+    i64_t* pick = (i64_t*)malloc(sizeof(i64_t) * (size_t)(n ? n : 1));
+    if (!pick) return data;
+    i64_t kept = 0;
+    for (i64_t i = 0; i < n; i++) {
+        i64_t j = i;
+        if (w->columns) {
+            for (j = 0; j < names->len && AS_SYMBOL(names)[j] != AS_SYMBOL(w->columns)[i]; j++) {}
+            if (j == names->len) continue;
+        }
+        pick[kept++] = j;
+    }
+
+    obj_p out_names = kept ? vector(TYPE_SYMBOL, kept) : NULL;
+    obj_p out_cols = kept ? vector(TYPE_LIST, kept) : NULL;
+    if (!out_names || !out_cols) {
+        if (out_names) drop_obj(out_names);
+        if (out_cols) drop_obj(out_cols);
+        free(pick);
+        return data;
+    }
+
+    i64_t nrows = AS_LIST(cols)[0]->len;
+    for (i64_t i = 0; i < kept; i++) {
+        i64_t sym = AS_SYMBOL(names)[pick[i]];
+        obj_p col = NULL;
+        if (w->nhidden && bsearch(&sym, w->hidden, (size_t)w->nhidden, sizeof(i64_t), cmp_i64)) {
+            col = blank_column(w, nrows);
+        }
+        AS_SYMBOL(out_names)[i] = sym;
+        AS_LIST(out_cols)[i] = col ? col : clone_obj(AS_LIST(cols)[pick[i]]);
+    }
+    free(pick);
+    drop_obj(data);
+    return table(out_names, out_cols);
+}
+
+// Byte counts for a table about to ship, measured here so the UI thread never
+// walks tables: *bytes is the size of data, *drop_bytes what dropping the
+// table it replaces frees. Columns are matched with that table by position
+// (projection and upserts keep positions), so a shared column is walked once
+// and not counted as freed. The blank column stays with the widget: it counts
+// once in *bytes and never as freed.
+static void ship_bytes(rfui_widget_t* w, obj_p data, i64_t* bytes, i64_t* drop_bytes) {
+    i64_t drop = w->shipped_total;
+    obj_p cols = NULL;
+    if (data && data->type == TYPE_TABLE && data->len >= 2 && AS_LIST(data)[1] &&
+        AS_LIST(data)[1]->type == TYPE_LIST) {
+        cols = AS_LIST(data)[1];
+    }
+    i64_t n = cols ? cols->len : 0;
+    obj_p* shipped = n ? (obj_p*)malloc(sizeof(obj_p) * (size_t)n) : NULL;
+    i64_t* sizes = n ? (i64_t*)malloc(sizeof(i64_t) * (size_t)n) : NULL;
+    if (n && (!shipped || !sizes)) {
+        // Out of memory: walk everything, nothing is matched next time
+        free(shipped);
+        free(sizes);
+        shipped = NULL;
+        sizes = NULL;
+        cols = NULL;
+        n = 0;
+    }
+
+    i64_t total, blank = 0;
+    if (!cols) {
+        total = rfui_obj_bytes(data);
+    } else {
+        // Table and column list headers, names
+        total = 2 * (i64_t)sizeof(struct obj_t) + (data->len + n) * (i64_t)sizeof(obj_p) +
+                rfui_obj_bytes(AS_LIST(data)[0]);
+        for (i64_t i = 0; i < n; i++) {
+            obj_p col = AS_LIST(cols)[i];
+            i64_t size;
+            if (col && col == w->blank) {
+                size = 0;
+                if (!blank) blank = rfui_obj_bytes(col);
+            } else if (i < w->nshipped && w->shipped[i] == col) {
+                size = w->shipped_bytes[i];
+                drop -= size;
+            } else {
+                size = rfui_obj_bytes(col);
+            }
+            shipped[i] = col;
+            sizes[i] = size;
+            total += size;
+        }
+    }
+
+    free(w->shipped);
+    free(w->shipped_bytes);
+    w->shipped = shipped;
+    w->shipped_bytes = sizes;
+    w->nshipped = n;
+    w->shipped_total = total;
+    *bytes = total + blank;
+    *drop_bytes = drop > 0 ? drop : 0;
+}
+
+// The shipped table never reached the UI: forget its columns (they may be
+// freed now), keeping the previous size as the next drop estimate
+static void ship_lost(rfui_widget_t* w) {
+    free(w->shipped);
+    free(w->shipped_bytes);
+    w->shipped = NULL;
+    w->shipped_bytes = NULL;
+    w->nshipped = 0;
+}
+
+// Send data (consumed) to the UI as a DRAW. Returns NULL on success or an error.
+static obj_p send_draw(rfui_widget_t* w, obj_p final_data, i64_t stamp) {
+    // Logged as the UI gets it, so replay needs no post_query or projection
+    rfui_record_draw(w, final_data);
+
+    rfui_ray_msg_t* msg = ray_msg_new(RFUI_MSG_DRAW, w);
     if (!msg) {
         drop_obj(final_data);
         return ray_err("draw: failed to allocate message");
     }
-    msg->type = RFUI_MSG_DRAW;
-    msg->widget = w;
-    msg->text = NULL;
+    msg->stamp = stamp;
 
     // For text widgets, pre-format on Rayforce thread (UI thread has no runtime)
     if (w->type == RFUI_WIDGET_TEXT) {
+        i64_t trace_span = rfui_trace_begin();
         obj_p fmt = obj_fmt(final_data, B8_TRUE);
+        rfui_trace_end("obj_fmt", w->name, trace_span);
         if (fmt && fmt->type == TYPE_C8) {
             msg->text = (char*)malloc(fmt->len + 1);
             if (msg->text) {
@@ -357,15 +615,510 @@ static obj_p fn_draw(obj_p* x, i64_t n) {
         msg->data = NULL;
     } else {
         msg->data = final_data;
+        msg->symbols = rfui_symbols_collect(final_data);
+        ship_bytes(w, final_data, &msg->bytes, &msg->drop_bytes);
     }
 
-    rfui_queue_push(g_ctx->ray_to_ui, msg);
+    if (!rfui_queue_push(g_ctx->ray_to_ui, msg)) {
+        // A delta that never arrives would leave its ids unresolved for good
+        if (msg->symbols) rfui_symbols_reset();
+        if (msg->data) {
+            ship_lost(w);
+            drop_obj(msg->data);
+        }
+        free(msg->text);
+        free(msg->symbols);
+        free(msg);
+        return ray_err("draw: failed to queue update");
+    }
     glfwPostEmptyEvent();  // Wake UI thread
 
+    return NULL;
+}
+
+// fn_draw: (draw widget data)
+// widget is external object, data is the data to render
+// Returns the widget for chaining
+//
+// KNOWN TECHNICAL DEBT: Widget lifecycle race condition
+// The widget pointer validity relies on the assumption that the UI thread
+// will not destroy the widget while we hold a reference to it. This is safe
+// under the current design where widgets live for the session lifetime and
+// are only destroyed during shutdown. A proper fix would require either:
+// - Widget IDs with lookup validation on the UI side, or
+// - Reference counting with atomic operations
+// For now, we assume widgets are never destroyed mid-session.
+static obj_p fn_draw(obj_p* x, i64_t n) {
+    // Latency clock starts here: post_query time counts toward staleness
+    i64_t stamp = rfui_clock_ns();
+
+    if (n != 2) {
+        return ray_err("draw: expects 2 arguments (widget, data)");
+    }
+
+    obj_p widget_obj = x[0];
+    obj_p data = x[1];
+
+    if (widget_obj->type != TYPE_EXT) {
+        return ray_err("draw: first argument must be a widget");
+    }
+
+    // Extract widget pointer from external object
+    // TYPE_EXT stores data in ext_t structure: { raw_p ptr; nil_t (*drop)(raw_p); }
+    ext_p ext = (ext_p)AS_C8(widget_obj);
+    rfui_widget_t* w = (rfui_widget_t*)ext->ptr;
+    if (!w) {
+        return ray_err("draw: widget is null");
+    }
+
+    // Check we have context
+    if (!g_ctx) {
+        return ray_err("draw: no rayforce-ui context available");
+    }
+
+    obj_p err = draw_widget(w, data, stamp);
+    if (err) {
+        return err;
+    }
+
     // Return widget for chaining
     return clone_obj(widget_obj);
 }
 
+// Widgets created by --replay, indexed by their id in the log
+static rfui_widget_t** g_replay_widgets = NULL;
+static u32_t g_replay_nwidgets = 0;
+
+// Apply one recorded record: create the widget or run the draw path
+static void replay_record(const u8_t* blob, i64_t len) {
+    if (!g_ctx) return;
+
+    rfui_replay_rec_t rec;
+    if (!rfui_replay_decode(blob, len, &rec)) {
+        fprintf(stderr, "Replay: skipping undecodable record\n");
+        free(rec.name);
+        return;
+    }
+
+    if (rec.kind == RFUI_RECORD_WIDGET) {
+        if (rec.id >= g_replay_nwidgets) {
+            rfui_widget_t** widgets = (rfui_widget_t**)realloc(
+                g_replay_widgets, sizeof(rfui_widget_t*) * (rec.id + 1));
+            if (!widgets) {
+                free(rec.name);
+                return;
+            }
+            for (u32_t i = g_replay_nwidgets; i <= rec.id; i++) widgets[i] = NULL;
+            g_replay_widgets = widgets;
+            g_replay_nwidgets = rec.id + 1;
+        }
+        rfui_widget_t* w = rfui_widget_create(rec.type, rec.name);
+        free(rec.name);
+        if (w) w->dense = rec.dense;
+        if (w && !send_widget_created(w)) {
+            rfui_widget_destroy(w);
+            w = NULL;
+        }
+        g_replay_widgets[rec.id] = w;
+        return;
+    }
+
+    rfui_widget_t* w = rec.id < g_replay_nwidgets ? g_replay_widgets[rec.id] : NULL;
+    if (w) {
+        obj_p err = draw_widget(w, rec.data, rfui_clock_ns());
+        if (err) drop_obj(err);
+    }
+    drop_obj(rec.data);
+}
+
+// Queue a snapshot request for the UI thread. path is a string, size is an
+// optional 2-element integer vector [w h] (fit capture into that box).
+static obj_p send_snapshot(rfui_widget_t* w, obj_p path, obj_p size) {
+    if (!path || path->type != TYPE_C8 || path->len == 0) {
+        return ray_err("ui-snapshot: path must be a non-empty string");
+    }
+
+    i32_t width = 0, height = 0;
+    if (size) {
+        if (size->type != TYPE_I64 || size->len != 2) {
+            return ray_err("ui-snapshot: size must be [width height]");
+        }
+        i64_t sw = AS_I64(size)[0];
+        i64_t sh = AS_I64(size)[1];
+        if (sw <= 0 || sh <= 0 || sw > 16384 || sh > 16384) {
+            return ray_err("ui-snapshot: size must be between 1 and 16384");
+        }
+        width = (i32_t)sw;
+        height = (i32_t)sh;
+    }
+
+    if (!g_ctx) {
+        return ray_err("ui-snapshot: no rayforce-ui context available");
+    }
+
+    char* path_str = malloc(path->len + 1);
+    if (!path_str) {
+        return ray_err("ui-snapshot: memory allocation failed");
+    }
+    memcpy(path_str, AS_C8(path), path->len);
+    path_str[path->len] = '\0';
+
+    rfui_ray_msg_t* msg = ray_msg_new(RFUI_MSG_SNAPSHOT, w);
+    if (!msg) {
+        free(path_str);
+        return ray_err("ui-snapshot: failed to allocate message");
+    }
+    msg->text = path_str;
+    msg->width = width;
+    msg->height = height;
+
+    if (!rfui_queue_push(g_ctx->ray_to_ui, msg)) {
+        free(path_str);
+        free(msg);
+        return ray_err("ui-snapshot: failed to queue request");
+    }
+    glfwPostEmptyEvent();  // Wake UI thread
+
+    return clone_obj(path);
+}
+
+// Widget pointer from a widget external object (NULL if not a widget)
+static rfui_widget_t* widget_from_obj(obj_p obj) {
+    if (!obj || obj->type != TYPE_EXT) return NULL;
+    ext_p ext = (ext_p)AS_C8(obj);
+    return (rfui_widget_t*)ext->ptr;
+}
+
+// fn_draw_upsert: (draw-upsert widget rows)
+// Merges rows (keyed table, or table with the key columns) into the keyed
+// table the grid was last drawn with: known keys are overwritten in place,
+// new keys appended. Only the merged table and the rows written go to the UI.
+// Returns the widget for chaining.
+static obj_p fn_draw_upsert(obj_p* x, i64_t n) {
+    i64_t stamp = rfui_clock_ns();
+
+    if (n != 2) {
+        return ray_err("draw-upsert: expects 2 arguments (widget, rows)");
+    }
+
+    rfui_widget_t* w = widget_from_obj(x[0]);
+    if (!w) {
+        return ray_err("draw-upsert: first argument must be a widget");
+    }
+    if (!g_ctx) {
+        return ray_err("draw-upsert: no rayforce-ui context available");
+    }
+    if (w->type != RFUI_WIDGET_GRID) {
+        return ray_err("draw-upsert: widget must be a grid");
+    }
+    if (w->post_query) {
+        return ray_err("draw-upsert: widget has a post-query (use draw)");
+    }
+
+    obj_p merged;
+    i64_t* rows;
+    i64_t nrows;
+    i64_t trace_span = rfui_trace_begin();
+    obj_p err = rfui_keyed_upsert(&w->keyed, w->data, x[1], &merged, &rows, &nrows);
+    rfui_trace_end("upsert", w->name, trace_span);
+    if (err) {
+        return err;
+    }
+
+    // The merged table is the base from here on, even if the UI misses it
+    drop_obj(w->data);
+    w->data = merged;
+
+    rfui_ray_msg_t* msg = ray_msg_new(RFUI_MSG_UPSERT, w);
+    if (!msg) {
+        free(rows);
+        return ray_err("draw-upsert: failed to allocate message");
+    }
+    msg->data = project(w, clone_obj(merged));
+    rfui_record_draw(w, msg->data);
+    msg->rows = rows;
+    msg->nrows = nrows;
+    msg->stamp = stamp;
+    // Only the written rows can hold ids the UI hasn't seen
+    msg->symbols = rfui_symbols_collect(x[1]);
+    ship_bytes(w, msg->data, &msg->bytes, &msg->drop_bytes);
+
+    if (!rfui_queue_push(g_ctx->ray_to_ui, msg)) {
+        // Queue full: the symbol delta is lost with the message
+        if (msg->symbols) rfui_symbols_reset();
+        ship_lost(w);
+        if (msg->data) drop_obj(msg->data);
+        free(msg->rows);
+        free(msg->symbols);
+        free(msg);
+        return ray_err("draw-upsert: failed to queue update");
+    }
+    glfwPostEmptyEvent();  // Wake UI thread
+
+    return clone_obj(x[0]);
+}
+
+// fn_ui_snapshot: (ui-snapshot widget "out.png") or (ui-snapshot widget "out.png" [w h])
+// Captured on the UI thread after the next render; PNG is written in background.
+// Returns the path.
+static obj_p fn_ui_snapshot(obj_p* x, i64_t n) {
+    if (n != 2 && n != 3) {
+        return ray_err("ui-snapshot: expects 2 or 3 arguments (widget, path, [w h])");
+    }
+
+    rfui_widget_t* w = widget_from_obj(x[0]);
+    if (!w) {
+        return ray_err("ui-snapshot: first argument must be a widget");
+    }
+
+    return send_snapshot(w, x[1], n == 3 ? x[2] : NULL);
+}
+
+// fn_ui_snapshot_all: (ui-snapshot-all "out.png") or (ui-snapshot-all "out.png" [w h])
+// Captures the whole dashboard (main viewport). Returns the path.
+static obj_p fn_ui_snapshot_all(obj_p* x, i64_t n) {
+    if (n != 1 && n != 2) {
+        return ray_err("ui-snapshot-all: expects 1 or 2 arguments (path, [w h])");
+    }
+
+    return send_snapshot(NULL, x[0], n == 2 ? x[1] : NULL);
+}
+
+// Build {draws: .. superseded: .. apply-p50: .. present-p99: ..} with latencies in ms
+static obj_p latency_dict(const rfui_latency_summary_t* s) {
+    static const char* names[] = {
+        "draws", "superseded",
+        "apply-mean", "apply-p50", "apply-p90", "apply-p99", "apply-p999", "apply-max",
+        "present-mean", "present-p50", "present-p90", "present-p99", "present-p999", "present-max"
+    };
+    const i64_t n = (i64_t)(sizeof(names) / sizeof(names[0]));
+    const rfui_hdr_summary_t* h[2] = { &s->apply, &s->present };
+
+    obj_p keys = vector(TYPE_SYMBOL, n);
+    obj_p vals = vector(TYPE_F64, n);
+    if (!keys || !vals) {
+        if (keys) drop_obj(keys);
+        if (vals) drop_obj(vals);
+        return ray_err("ui-latency: memory allocation failed");
+    }
+
+    for (i64_t i = 0; i < n; i++) {
+        AS_SYMBOL(keys)[i] = symbols_intern(names[i], strlen(names[i]));
+    }
+
+    f64_t* v = AS_F64(vals);
+    v[0] = (f64_t)s->apply.count;
+    v[1] = (f64_t)s->superseded;
+    for (i32_t k = 0; k < 2; k++) {
+        f64_t* dst = v + 2 + k * 6;
+        dst[0] = h[k]->mean / 1e6;
+        dst[1] = (f64_t)h[k]->p50 / 1e6;
+        dst[2] = (f64_t)h[k]->p90 / 1e6;
+        dst[3] = (f64_t)h[k]->p99 / 1e6;
+        dst[4] = (f64_t)h[k]->p999 / 1e6;
+        dst[5] = (f64_t)h[k]->max / 1e6;
+    }
+
+    return dict(keys, vals);
+}
+
+// fn_ui_latency: (ui-latency widget) -> dict of draw->apply / draw->present
+// latency percentiles in milliseconds since start (or last reset)
+static obj_p fn_ui_latency(obj_p* x, i64_t n) {
+    if (n != 1) {
+        return ray_err("ui-latency: expects 1 argument (widget)");
+    }
+
+    rfui_widget_t* w = widget_from_obj(x[0]);
+    if (!w) {
+        return ray_err("ui-latency: argument must be a widget");
+    }
+
+    rfui_latency_summary_t s;
+    rfui_latency_summary(w->latency, &s);
+    return latency_dict(&s);
+}
+
+// fn_ui_latency_reset: (ui-latency-reset widget) -> widget
+static obj_p fn_ui_latency_reset(obj_p* x, i64_t n) {
+    if (n != 1) {
+        return ray_err("ui-latency-reset: expects 1 argument (widget)");
+    }
+
+    rfui_widget_t* w = widget_from_obj(x[0]);
+    if (!w) {
+        return ray_err("ui-latency-reset: argument must be a widget");
+    }
+
+    rfui_latency_reset(w->latency);
+    return clone_obj(x[0]);
+}
+
+// fn_ui_overlay: (ui-overlay true) shows the performance overlay, false hides it
+static obj_p fn_ui_overlay(obj_p* x, i64_t n) {
+    if (n != 1 || x[0]->type != -TYPE_B8) {
+        return ray_err("ui-overlay: expects a boolean");
+    }
+
+    if (!g_ctx) {
+        return ray_err("ui-overlay: no rayforce-ui context available");
+    }
+
+    rfui_ray_msg_t* msg = ray_msg_new(RFUI_MSG_OVERLAY, NULL);
+    if (!msg) {
+        return ray_err("ui-overlay: failed to allocate message");
+    }
+    msg->width = x[0]->b8 ? 1 : 0;
+
+    if (!rfui_queue_push(g_ctx->ray_to_ui, msg)) {
+        free(msg);
+        return ray_err("ui-overlay: failed to queue request");
+    }
+    glfwPostEmptyEvent();  // Wake UI thread
+
+    return clone_obj(x[0]);
+}
+
+// fn_ui_memory: (ui-memory) -> table [kind name bytes], one row per widget
+// render_data/ui_state plus REPL, pending drops, textures and symbol strings.
+// Rebuilt by the UI thread on request (up to 250 ms wait for the next frame).
+static obj_p fn_ui_memory(obj_p* x, i64_t n) {
+    (void)x;
+    if (n != 0) {
+        return ray_err("ui-memory: expects no arguments");
+    }
+
+    // The UI rebuilds the report only while the overlay shows: ask for a
+    // fresh one and give it a few frames to publish
+    i64_t gen = rfui_memory_request();
+    glfwPostEmptyEvent();
+    for (i32_t i = 0; i < 250 && rfui_memory_generation() < gen; i++) rfui_headless_sleep(0.001);
+
+    rfui_mem_report_t r;
+    rfui_memory_report(&r);
+
+    static const char* kinds[] = {
+        "repl-lines", "repl-history", "pending-drop", "font-atlas", "textures", "symbols"
+    };
+    const i64_t nfixed = (i64_t)(sizeof(kinds) / sizeof(kinds[0]));
+    const i64_t fixed[] = {
+        r.repl_lines, r.repl_history, r.pending_drop_bytes, r.font_atlas, r.textures, r.symbols
+    };
+    i64_t rows = r.nwidgets * 2 + nfixed;
+
+    obj_p kind_col = vector(TYPE_SYMBOL, rows);
+    obj_p name_col = vector(TYPE_SYMBOL, rows);
+    obj_p bytes_col = vector(TYPE_I64, rows);
+    obj_p keys = vector(TYPE_SYMBOL, 3);
+    obj_p vals = vector(TYPE_LIST, 3);
+    if (!kind_col || !name_col || !bytes_col || !keys || !vals) {
+        if (kind_col) drop_obj(kind_col);
+        if (name_col) drop_obj(name_col);
+        if (bytes_col) drop_obj(bytes_col);
+        if (keys) drop_obj(keys);
+        if (vals) drop_obj(vals);
+        rfui_memory_report_free(&r);
+        return ray_err("ui-memory: memory allocation failed");
+    }
+
+    i64_t render_sym = symbols_intern("render-data", 11);
+    i64_t state_sym = symbols_intern("ui-state", 8);
+    i64_t empty_sym = symbols_intern("", 0);
+    i64_t row = 0;
+
+    for (i64_t i = 0; i < r.nwidgets; i++) {
+        i64_t name_sym = symbols_intern(r.widgets[i].name, strlen(r.widgets[i].name));
+        AS_SYMBOL(kind_col)[row] = render_sym;
+        AS_SYMBOL(name_col)[row] = name_sym;
+        AS_I64(bytes_col)[row++] = r.widgets[i].render_data;
+        AS_SYMBOL(kind_col)[row] = state_sym;
+        AS_SYMBOL(name_col)[row] = name_sym;
+        AS_I64(bytes_col)[row++] = r.widgets[i].ui_state;
+    }
+    for (i64_t i = 0; i < nfixed; i++) {
+        AS_SYMBOL(kind_col)[row] = symbols_intern(kinds[i], strlen(kinds[i]));
+        AS_SYMBOL(name_col)[row] = empty_sym;
+        AS_I64(bytes_col)[row++] = fixed[i];
+    }
+    rfui_memory_report_free(&r);
+
+    AS_SYMBOL(keys)[0] = symbols_intern("kind", 4);
+    AS_SYMBOL(keys)[1] = symbols_intern("name", 4);
+    AS_SYMBOL(keys)[2] = symbols_intern("bytes", 5);
+    AS_LIST(vals)[0] = kind_col;
+    AS_LIST(vals)[1] = name_col;
+    AS_LIST(vals)[2] = bytes_col;
+
+    return table(keys, vals);
+}
+
+// fn_ui_record: (ui-record "file.rfrec") records every widget and draw to a
+// binary log for --replay; (ui-record false) stops. Returns the argument.
+static obj_p fn_ui_record(obj_p* x, i64_t n) {
+    if (n != 1) {
+        return ray_err("ui-record: expects a file path or false");
+    }
+
+    if (x[0]->type == -TYPE_B8) {
+        if (x[0]->b8) {
+            return ray_err("ui-record: expects a file path or false");
+        }
+        rfui_record_stop();
+        return clone_obj(x[0]);
+    }
+
+    if (x[0]->type != TYPE_C8 || x[0]->len == 0) {
+        return ray_err("ui-record: expects a file path or false");
+    }
+
+    char path[1024];
+    if (x[0]->len >= (i64_t)sizeof(path)) {
+        return ray_err("ui-record: path too long");
+    }
+    memcpy(path, AS_C8(x[0]), x[0]->len);
+    path[x[0]->len] = '\0';
+
+    if (rfui_record_start(path) != 0) {
+        return ray_err("ui-record: failed to open file");
+    }
+    return clone_obj(x[0]);
+}
+
+// fn_ui_trace: (ui-trace true) starts a new trace session, false stops it
+static obj_p fn_ui_trace(obj_p* x, i64_t n) {
+    if (n != 1 || x[0]->type != -TYPE_B8) {
+        return ray_err("ui-trace: expects a boolean");
+    }
+
+    if (x[0]->b8) {
+        rfui_trace_start();
+    } else {
+        rfui_trace_stop();
+    }
+    return clone_obj(x[0]);
+}
+
+// fn_ui_trace_dump: (ui-trace-dump "trace.json") writes Chrome trace-event JSON
+// for the current session. Returns the number of events written.
+static obj_p fn_ui_trace_dump(obj_p* x, i64_t n) {
+    if (n != 1 || x[0]->type != TYPE_C8 || x[0]->len == 0) {
+        return ray_err("ui-trace-dump: expects a file path");
+    }
+
+    char path[1024];
+    if (x[0]->len >= (i64_t)sizeof(path)) {
+        return ray_err("ui-trace-dump: path too long");
+    }
+    memcpy(path, AS_C8(x[0]), x[0]->len);
+    path[x[0]->len] = '\0';
+
+    i64_t written = rfui_trace_dump(path);
+    if (written < 0) {
+        return ray_err("ui-trace-dump: failed to write file");
+    }
+    return i64(written);
+}
+
 // Macro to register a function into the runtime's function dict
 // Based on REGISTER_FN from env.c but adapted for external registration
 #define RFUI_REGISTER_FN(functions, name, fn_type, flags, fn_ptr)   \
@@ -390,6 +1143,28 @@ static void register_rfui_functions(void) {
 
     // Register draw function: (draw widget data) -> widget
     RFUI_REGISTER_FN(functions, "draw", TYPE_VARY, FN_NONE, fn_draw);
+
+    // Register keyed-grid merge: (draw-upsert widget rows) -> widget
+    RFUI_REGISTER_FN(functions, "draw-upsert", TYPE_VARY, FN_NONE, fn_draw_upsert);
+
+    // Register snapshot functions: (ui-snapshot widget path [w h]?) -> path
+    RFUI_REGISTER_FN(functions, "ui-snapshot", TYPE_VARY, FN_NONE, fn_ui_snapshot);
+    RFUI_REGISTER_FN(functions, "ui-snapshot-all", TYPE_VARY, FN_NONE, fn_ui_snapshot_all);
+
+    // Register profiling functions: (ui-latency widget) -> dict, (ui-overlay bool)
+    RFUI_REGISTER_FN(functions, "ui-latency", TYPE_VARY, FN_NONE, fn_ui_latency);
+    RFUI_REGISTER_FN(functions, "ui-latency-reset", TYPE_VARY, FN_NONE, fn_ui_latency_reset);
+    RFUI_REGISTER_FN(functions, "ui-overlay", TYPE_VARY, FN_NONE, fn_ui_overlay);
+
+    // Register memory report: (ui-memory) -> table
+    RFUI_REGISTER_FN(functions, "ui-memory", TYPE_VARY, FN_NONE, fn_ui_memory);
+
+    // Register recording: (ui-record path), (ui-record false)
+    RFUI_REGISTER_FN(functions, "ui-record", TYPE_VARY, FN_NONE, fn_ui_record);
+
+    // Register tracing: (ui-trace bool), (ui-trace-dump path) -> event count
+    RFUI_REGISTER_FN(functions, "ui-trace", TYPE_VARY, FN_NONE, fn_ui_trace);
+    RFUI_REGISTER_FN(functions, "ui-trace-dump", TYPE_VARY, FN_NONE, fn_ui_trace_dump);
 }
 
 void* rfui_rayforce_thread(void* arg) {
@@ -412,6 +1187,7 @@ void* rfui_rayforce_thread(void* arg) {
 
     // Step 2: Set thread-local context for rayforce-ui functions
     g_ctx = ctx;
+    rfui_trace_thread_name("rayforce");
 
     // Step 3: Register rayforce-ui extension types
     register_rfui_types();
@@ -420,10 +1196,16 @@ void* rfui_rayforce_thread(void* arg) {
     register_rfui_functions();
 
     // Step 5: Load script file if provided via command line
+    // (--replay draws from the recording instead, so no script runs)
     {
         obj_p file_arg = runtime_get_arg("file");
-        if (!is_null(file_arg)) {
+        if (!is_null(file_arg) && ctx->replay) {
+            fprintf(stderr, "Replay: ignoring script, drawing from %s\n", ctx->replay);
+            drop_obj(file_arg);
+        } else if (!is_null(file_arg)) {
+            i64_t trace_span = rfui_trace_begin();
             obj_p res = ray_load(file_arg);
+            rfui_trace_end("load_script", NULL, trace_span);
             drop_obj(file_arg);
             if (IS_ERR(res)) {
                 // Print error but continue - GUI still runs
@@ -453,10 +1235,20 @@ void* rfui_rayforce_thread(void* arg) {
     // Step 8: Signal ready
     rfui_ctx_signal_ready(ctx);
 
-    // Step 9: Run poll loop (blocks until exit)
+    // Step 9: Start feeding recorded draws (needs the waker)
+    if (ctx->replay) {
+        rfui_replay_start(ctx, ctx->replay, ctx->replay_speed);
+    }
+
+    // Step 10: Run poll loop (blocks until exit)
     runtime_run();
 
     // Cleanup
+    rfui_replay_stop();
+    rfui_record_stop();
+    free(g_replay_widgets);  // Widgets themselves are owned by the UI
+    g_replay_widgets = NULL;
+    g_replay_nwidgets = 0;
     g_ctx = NULL;
     // Waker is a separate allocation - must be explicitly destroyed
     rfui_ctx_set_waker(ctx, NULL);
@@ -0,0 +1,567 @@
+// src/record.c
+// Draw stream recorder, replay thread and payload codec
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "../deps/rayforce/core/symbols.h"
+#include "../include/rfui/record.h"
+#include "../include/rfui/message.h"
+#include "../include/rfui/memory.h"
+#include "../include/rfui/latency.h"
+#include "../include/rfui/headless.h"
+#include "../include/rfui/trace.h"
+
+#define RECORD_MAGIC "RFUIREC2"
+#define RECORD_MAGIC_LEN 8
+
+// Object encoding tag for values the log cannot carry (functions, externals)
+#define ENC_NONE 127
+
+// Longest replay sleep slice, so stop requests are noticed promptly
+#define REPLAY_SLICE_S 0.05
+
+// ============================================================================
+// Growable byte buffer
+// ============================================================================
+
+typedef struct rec_buf_t {
+    u8_t* data;
+    i64_t len;
+    i64_t cap;
+    b8_t failed;
+} rec_buf_t;
+
+static u8_t* buf_reserve(rec_buf_t* b, i64_t n) {
+    if (b->failed) return NULL;
+    if (b->len + n > b->cap) {
+        i64_t cap = b->cap ? b->cap : 4096;
+        while (cap < b->len + n) cap *= 2;
+        u8_t* data = (u8_t*)realloc(b->data, (size_t)cap);
+        if (!data) {
+            b->failed = B8_TRUE;
+            return NULL;
+        }
+        b->data = data;
+        b->cap = cap;
+    }
+    u8_t* p = b->data + b->len;
+    b->len += n;
+    return p;
+}
+
+static nil_t buf_put(rec_buf_t* b, const void* src, i64_t n) {
+    u8_t* p = buf_reserve(b, n);
+    if (p && n > 0) memcpy(p, src, (size_t)n);
+}
+
+static nil_t buf_put_u8(rec_buf_t* b, u8_t v) { buf_put(b, &v, 1); }
+static nil_t buf_put_u32(rec_buf_t* b, u32_t v) { buf_put(b, &v, 4); }
+static nil_t buf_put_i64(rec_buf_t* b, i64_t v) { buf_put(b, &v, 8); }
+
+static nil_t buf_put_str(rec_buf_t* b, const char* s) {
+    u32_t n = s ? (u32_t)strlen(s) : 0;
+    buf_put_u32(b, n);
+    buf_put(b, s, n);
+}
+
+// ============================================================================
+// Encoder
+// ============================================================================
+
+// Symbol id -> dictionary index (open addressing, capacity power of two)
+typedef struct sym_map_t {
+    i64_t* keys;
+    u32_t* vals;
+    b8_t* used;
+    i64_t cap;
+} sym_map_t;
+
+static nil_t enc_obj(rec_buf_t* b, obj_p obj);
+
+// Symbol column: distinct strings once, then one u32 index per row
+static nil_t enc_symbols(rec_buf_t* b, obj_p obj) {
+    i64_t n = obj->len;
+    i64_t* ids = AS_SYMBOL(obj);
+
+    sym_map_t map;
+    map.cap = 16;
+    while (map.cap < n * 2) map.cap *= 2;
+    map.keys = (i64_t*)malloc(sizeof(i64_t) * (size_t)map.cap);
+    map.vals = (u32_t*)malloc(sizeof(u32_t) * (size_t)map.cap);
+    map.used = (b8_t*)calloc((size_t)map.cap, sizeof(b8_t));
+    u32_t* idx = (u32_t*)malloc(sizeof(u32_t) * (size_t)(n > 0 ? n : 1));
+    i64_t* distinct = (i64_t*)malloc(sizeof(i64_t) * (size_t)(n > 0 ? n : 1));
+
+    if (!map.keys || !map.vals || !map.used || !idx || !distinct) {
+        b->failed = B8_TRUE;
+    } else {
+        u32_t ndistinct = 0;
+        for (i64_t i = 0; i < n; i++) {
+            u64_t h = (u64_t)ids[i] * 0x9E3779B97F4A7C15ull;
+            i64_t slot = (i64_t)(h >> 16) & (map.cap - 1);
+            while (map.used[slot] && map.keys[slot] != ids[i]) {
+                slot = (slot + 1) & (map.cap - 1);
+            }
+            if (!map.used[slot]) {
+                map.used[slot] = B8_TRUE;
+                map.keys[slot] = ids[i];
+                map.vals[slot] = ndistinct;
+                distinct[ndistinct++] = ids[i];
+            }
+            idx[i] = map.vals[slot];
+        }
+
+        buf_put_i64(b, n);
+        buf_put_u32(b, ndistinct);
+        for (u32_t i = 0; i < ndistinct; i++) {
+            buf_put_str(b, str_from_symbol(distinct[i]));
+        }
+        buf_put(b, idx, n * 4);
+    }
+
+    free(map.keys);
+    free(map.vals);
+    free(map.used);
+    free(idx);
+    free(distinct);
+}
+
+static nil_t enc_obj(rec_buf_t* b, obj_p obj) {
+    if (!obj) {
+        buf_put_u8(b, ENC_NONE);
+        return;
+    }
+
+    i8_t type = obj->type;
+
+    if (type < 0) {
+        // Atom: symbols by name, everything else as its 8-byte payload
+        if (type == -TYPE_SYMBOL) {
+            buf_put_u8(b, (u8_t)type);
+            buf_put_str(b, str_from_symbol(obj->i64));
+        } else if (rfui_elem_size(-type) > 0 && rfui_elem_size(-type) <= 8) {
+            buf_put_u8(b, (u8_t)type);
+            buf_put_i64(b, obj->i64);
+        } else {
+            buf_put_u8(b, ENC_NONE);
+        }
+        return;
+    }
+
+    switch (type) {
+        case TYPE_LIST:
+            buf_put_u8(b, (u8_t)type);
+            buf_put_i64(b, obj->len);
+            for (i64_t i = 0; i < obj->len; i++) {
+                enc_obj(b, AS_LIST(obj)[i]);
+            }
+            return;
+        case TYPE_TABLE:
+        case TYPE_DICT:
+            // [keys, values]
+            buf_put_u8(b, (u8_t)type);
+            enc_obj(b, AS_LIST(obj)[0]);
+            enc_obj(b, AS_LIST(obj)[1]);
+            return;
+        case TYPE_SYMBOL:
+            buf_put_u8(b, (u8_t)type);
+            enc_symbols(b, obj);
+            return;
+        default: {
+            i64_t size = rfui_elem_size(type);
+            if (size == 0) {
+                buf_put_u8(b, ENC_NONE);
+                return;
+            }
+            buf_put_u8(b, (u8_t)type);
+            buf_put_i64(b, obj->len);
+            buf_put(b, obj->raw, obj->len * size);
+            return;
+        }
+    }
+}
+
+// ============================================================================
+// Decoder (Rayforce thread)
+// ============================================================================
+
+typedef struct rec_cur_t {
+    const u8_t* p;
+    const u8_t* end;
+} rec_cur_t;
+
+static b8_t cur_take(rec_cur_t* c, void* dst, i64_t n) {
+    if (n < 0 || c->end - c->p < n) return B8_FALSE;
+    if (n > 0) memcpy(dst, c->p, (size_t)n);
+    c->p += n;
+    return B8_TRUE;
+}
+
+// Symbol id for a length-prefixed string
+static b8_t cur_symbol(rec_cur_t* c, i64_t* out) {
+    u32_t n;
+    if (!cur_take(c, &n, 4) || c->end - c->p < (i64_t)n) return B8_FALSE;
+    *out = symbols_intern((lit_p)c->p, n);
+    c->p += n;
+    return B8_TRUE;
+}
+
+static obj_p dec_obj(rec_cur_t* c) {
+    u8_t tag;
+    if (!cur_take(c, &tag, 1)) return NULL;
+
+    if (tag == ENC_NONE) {
+        return vector(TYPE_LIST, 0);
+    }
+
+    i8_t type = (i8_t)tag;
+
+    if (type < 0) {
+        i64_t v;
+        if (type == -TYPE_SYMBOL) {
+            if (!cur_symbol(c, &v)) return NULL;
+        } else if (!cur_take(c, &v, 8)) {
+            return NULL;
+        }
+        obj_p a = atom(type);
+        if (a) a->i64 = v;
+        return a;
+    }
+
+    switch (type) {
+        case TYPE_LIST: {
+            i64_t n;
+            if (!cur_take(c, &n, 8) || n < 0 || n > c->end - c->p) return NULL;
+            obj_p list = vector(TYPE_LIST, n);
+            if (!list) return NULL;
+            for (i64_t i = 0; i < n; i++) {
+                obj_p item = dec_obj(c);
+                if (!item) {
+                    // Unfilled slots are dropped as empty lists
+                    for (i64_t j = i; j < n; j++) AS_LIST(list)[j] = vector(TYPE_LIST, 0);
+                    drop_obj(list);
+                    return NULL;
+                }
+                AS_LIST(list)[i] = item;
+            }
+            return list;
+        }
+        case TYPE_TABLE:
+        case TYPE_DICT: {
+            obj_p keys = dec_obj(c);
+            if (!keys) return NULL;
+            obj_p vals = dec_obj(c);
+            if (!vals) {
+                drop_obj(keys);
+                return NULL;
+            }
+            return type == TYPE_TABLE ? table(keys, vals) : dict(keys, vals);
+        }
+        case TYPE_SYMBOL: {
+            i64_t n;
+            u32_t ndistinct;
+            if (!cur_take(c, &n, 8) || n < 0 || !cur_take(c, &ndistinct, 4)) return NULL;
+            i64_t* dict_ids = (i64_t*)malloc(sizeof(i64_t) * (size_t)(ndistinct ? ndistinct : 1));
+            if (!dict_ids) return NULL;
+            for (u32_t i = 0; i < ndistinct; i++) {
+                if (!cur_symbol(c, &dict_ids[i])) {
+                    free(dict_ids);
+                    return NULL;
+                }
+            }
+            if (c->end - c->p < n * 4) {
+                free(dict_ids);
+                return NULL;
+            }
+            obj_p vec = vector(TYPE_SYMBOL, n);
+            if (!vec) {
+                free(dict_ids);
+                return NULL;
+            }
+            for (i64_t i = 0; i < n; i++) {
+                u32_t k;
+                memcpy(&k, c->p + i * 4, 4);
+                AS_SYMBOL(vec)[i] = k < ndistinct ? dict_ids[k] : 0;
+            }
+            c->p += n * 4;
+            free(dict_ids);
+            return vec;
+        }
+        default: {
+            i64_t size = rfui_elem_size(type);
+            i64_t n;
+            if (size == 0 || !cur_take(c, &n, 8) || n < 0 || n > (c->end - c->p) / size) {
+                return NULL;
+            }
+            obj_p vec = vector(type, n);
+            if (!vec) return NULL;
+            memcpy(vec->raw, c->p, (size_t)(n * size));
+            c->p += n * size;
+            return vec;
+        }
+    }
+}
+
+b8_t rfui_replay_decode(const u8_t* blob, i64_t len, rfui_replay_rec_t* out) {
+    memset(out, 0, sizeof(*out));
+
+    rec_cur_t c = { blob, blob + len };
+    if (!cur_take(&c, &out->kind, 1) || !cur_take(&c, &out->id, 4)) return B8_FALSE;
+
+    if (out->kind == RFUI_RECORD_WIDGET) {
+        u8_t type, flags;
+        if (!cur_take(&c, &type, 1) || !cur_take(&c, &flags, 1)) return B8_FALSE;
+        out->type = (rfui_widget_type_t)type;
+        out->dense = (flags & RFUI_RECORD_DENSE) ? B8_TRUE : B8_FALSE;
+        i64_t n = c.end - c.p;
+        out->name = (char*)malloc((size_t)n + 1);
+        if (!out->name) return B8_FALSE;
+        memcpy(out->name, c.p, (size_t)n);
+        out->name[n] = '\0';
+        return B8_TRUE;
+    }
+
+    if (out->kind == RFUI_RECORD_DRAW) {
+        out->data = dec_obj(&c);
+        return out->data != NULL;
+    }
+
+    return B8_FALSE;
+}
+
+// ============================================================================
+// Recorder (Rayforce thread)
+// ============================================================================
+
+static FILE* g_rec_file = NULL;
+static i64_t g_rec_origin = 0;
+static rfui_widget_t** g_rec_widgets = NULL;  // Index = widget id in the log
+static u32_t g_rec_nwidgets = 0;
+static u32_t g_rec_cap = 0;
+static rec_buf_t g_rec_buf;
+
+static nil_t write_record(u8_t kind, u32_t id, const rec_buf_t* payload) {
+    i64_t t = rfui_clock_ns() - g_rec_origin;
+    u64_t len = (u64_t)payload->len;
+    fwrite(&kind, 1, 1, g_rec_file);
+    fwrite(&t, 8, 1, g_rec_file);
+    fwrite(&id, 4, 1, g_rec_file);
+    fwrite(&len, 8, 1, g_rec_file);
+    fwrite(payload->data, 1, (size_t)payload->len, g_rec_file);
+}
+
+// Widget id in the log, writing its creation record on first sight
+static b8_t record_widget_id(rfui_widget_t* w, u32_t* id) {
+    for (u32_t i = 0; i < g_rec_nwidgets; i++) {
+        if (g_rec_widgets[i] == w) {
+            *id = i;
+            return B8_TRUE;
+        }
+    }
+
+    if (g_rec_nwidgets == g_rec_cap) {
+        u32_t cap = g_rec_cap ? g_rec_cap * 2 : 16;
+        rfui_widget_t** widgets = (rfui_widget_t**)realloc(g_rec_widgets, sizeof(rfui_widget_t*) * cap);
+        if (!widgets) return B8_FALSE;
+        g_rec_widgets = widgets;
+        g_rec_cap = cap;
+    }
+    *id = g_rec_nwidgets;
+    g_rec_widgets[g_rec_nwidgets++] = w;
+
+    g_rec_buf.len = 0;
+    g_rec_buf.failed = B8_FALSE;
+    buf_put_u8(&g_rec_buf, (u8_t)w->type);
+    buf_put_u8(&g_rec_buf, w->dense ? RFUI_RECORD_DENSE : 0);
+    buf_put(&g_rec_buf, w->name, (i64_t)strlen(w->name));
+    if (g_rec_buf.failed) return B8_FALSE;
+    write_record(RFUI_RECORD_WIDGET, *id, &g_rec_buf);
+    return B8_TRUE;
+}
+
+i32_t rfui_record_start(const char* path) {
+    rfui_record_stop();
+
+    g_rec_file = fopen(path, "wb");
+    if (!g_rec_file) return -1;
+
+    fwrite(RECORD_MAGIC, 1, RECORD_MAGIC_LEN, g_rec_file);
+    g_rec_origin = rfui_clock_ns();
+    g_rec_nwidgets = 0;
+    return 0;
+}
+
+nil_t rfui_record_stop(nil_t) {
+    if (g_rec_file) {
+        fclose(g_rec_file);
+        g_rec_file = NULL;
+    }
+    free(g_rec_widgets);
+    g_rec_widgets = NULL;
+    g_rec_nwidgets = 0;
+    g_rec_cap = 0;
+    free(g_rec_buf.data);
+    memset(&g_rec_buf, 0, sizeof(g_rec_buf));
+}
+
+b8_t rfui_record_active(nil_t) {
+    return g_rec_file ? B8_TRUE : B8_FALSE;
+}
+
+nil_t rfui_record_widget(rfui_widget_t* w) {
+    if (!g_rec_file || !w) return;
+    u32_t id;
+    record_widget_id(w, &id);
+}
+
+nil_t rfui_record_draw(rfui_widget_t* w, obj_p data) {
+    if (!g_rec_file || !w) return;
+
+    u32_t id;
+    if (!record_widget_id(w, &id)) return;
+
+    i64_t trace_span = rfui_trace_begin();
+    g_rec_buf.len = 0;
+    g_rec_buf.failed = B8_FALSE;
+    enc_obj(&g_rec_buf, data);
+    if (!g_rec_buf.failed) {
+        write_record(RFUI_RECORD_DRAW, id, &g_rec_buf);
+    }
+    rfui_trace_end("record", w->name, trace_span);
+}
+
+// ============================================================================
+// Replay thread
+// ============================================================================
+
+typedef struct replay_t {
+    rfui_ctx_t* ctx;
+    FILE* file;
+    f64_t speed;
+    i64_t stop;      // Set with __atomic_store_n by rfui_replay_stop
+    ray_thread_t thread;
+} replay_t;
+
+static replay_t* g_replay = NULL;
+
+static b8_t replay_stopping(replay_t* r) {
+    return __atomic_load_n(&r->stop, __ATOMIC_ACQUIRE) != 0;
+}
+
+static void* replay_main(void* arg) {
+    replay_t* r = (replay_t*)arg;
+    i64_t origin = rfui_clock_ns();
+    i64_t records = 0;
+
+    rfui_trace_thread_name("replay");
+
+    while (!replay_stopping(r)) {
+        u8_t kind;
+        i64_t t;
+        u32_t id;
+        u64_t len;
+        if (fread(&kind, 1, 1, r->file) != 1 || fread(&t, 8, 1, r->file) != 1 ||
+            fread(&id, 4, 1, r->file) != 1 || fread(&len, 8, 1, r->file) != 1) {
+            break;  // End of log
+        }
+
+        // Blob handed to the Rayforce thread: kind, id, payload
+        u8_t* blob = (u8_t*)malloc((size_t)len + 5);
+        if (!blob) break;
+        blob[0] = kind;
+        memcpy(blob + 1, &id, 4);
+        if (fread(blob + 5, 1, (size_t)len, r->file) != (size_t)len) {
+            free(blob);
+            fprintf(stderr, "Replay: truncated record\n");
+            break;
+        }
+
+        // Wait until the record is due at the requested speed
+        if (r->speed > 0.0) {
+            i64_t due = origin + (i64_t)((f64_t)t / r->speed);
+            i64_t now;
+            while (!replay_stopping(r) && (now = rfui_clock_ns()) < due) {
+                f64_t wait = (f64_t)(due - now) / 1e9;
+                rfui_headless_sleep(wait < REPLAY_SLICE_S ? wait : REPLAY_SLICE_S);
+            }
+        }
+
+        rfui_ui_msg_t* msg = (rfui_ui_msg_t*)calloc(1, sizeof(rfui_ui_msg_t));
+        if (!msg) {
+            free(blob);
+            break;
+        }
+        msg->type = RFUI_MSG_REPLAY;
+        msg->blob = blob;
+        msg->bytes = (i64_t)len + 5;
+
+        // Queue full: the Rayforce thread is behind, wait for it
+        while (!rfui_queue_push(r->ctx->ui_to_ray, msg)) {
+            if (replay_stopping(r)) {
+                free(blob);
+                free(msg);
+                msg = NULL;
+                break;
+            }
+            rfui_headless_sleep(0.001);
+        }
+        if (!msg) break;
+
+        poll_waker_p waker = rfui_ctx_get_waker(r->ctx);
+        if (waker) poll_waker_wake(waker);
+        records++;
+    }
+
+    printf("Replay: %lld records in %.2f s\n", (long long)records,
+           (f64_t)(rfui_clock_ns() - origin) / 1e9);
+    return NULL;
+}
+
+i32_t rfui_replay_start(rfui_ctx_t* ctx, const char* path, f64_t speed) {
+    if (g_replay || !ctx || !path) return -1;
+
+    FILE* f = fopen(path, "rb");
+    if (!f) {
+        fprintf(stderr, "Replay: cannot open %s\n", path);
+        return -1;
+    }
+
+    char magic[RECORD_MAGIC_LEN];
+    if (fread(magic, 1, RECORD_MAGIC_LEN, f) != RECORD_MAGIC_LEN ||
+        memcmp(magic, RECORD_MAGIC, RECORD_MAGIC_LEN) != 0) {
+        fprintf(stderr, "Replay: %s is not a rayforce-ui recording\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    replay_t* r = (replay_t*)calloc(1, sizeof(replay_t));
+    if (!r) {
+        fclose(f);
+        return -1;
+    }
+    r->ctx = ctx;
+    r->file = f;
+    r->speed = speed;
+
+    r->thread = ray_thread_create(replay_main, r);
+    if (!r->thread.handle) {
+        fclose(f);
+        free(r);
+        return -1;
+    }
+
+    g_replay = r;
+    return 0;
+}
+
+nil_t rfui_replay_stop(nil_t) {
+    replay_t* r = g_replay;
+    if (!r) return;
+
+    __atomic_store_n(&r->stop, 1, __ATOMIC_RELEASE);
+    thread_join(r->thread);
+
+    g_replay = NULL;
+    fclose(r->file);
+    free(r);
+}
@@ -414,6 +414,24 @@ nil_t rfui_repl_load_file(const char* path) {
     rfui_eval(expr);
 }
 
+nil_t rfui_repl_memory(i64_t* lines, i64_t* history) {
+    *lines = 0;
+    *history = 0;
+    if (!g_repl) return;
+
+    i64_t n = (i64_t)(g_repl->lines.capacity() * sizeof(terminal_line_t));
+    for (const terminal_line_t& line : g_repl->lines) {
+        n += (i64_t)line.text.capacity();
+    }
+    *lines = n;
+
+    n = (i64_t)(g_repl->history.capacity() * sizeof(std::string));
+    for (const std::string& cmd : g_repl->history) {
+        n += (i64_t)cmd.capacity();
+    }
+    *history = n;
+}
+
 nil_t rfui_repl_destroy(nil_t) {
     if (!g_repl) return;
 
@@ -0,0 +1,246 @@
+// src/snapshot.cpp
+// Offscreen widget/dashboard snapshots
+//
+// After ImGui::Render() the widget's draw lists (window + visible children)
+// are replayed into an FBO at the requested scale and read back once. PNG
+// encoding and file IO run on the worker pool so the UI frame only pays for
+// the readback.
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include <string>
+
+#include "imgui.h"
+#include "imgui_internal.h"
+#include "imgui_impl_opengl3.h"
+
+#define GL_SILENCE_DEPRECATION
+#if defined(IMGUI_IMPL_OPENGL_ES2)
+#include <GLES2/gl2.h>
+#endif
+#include <GLFW/glfw3.h>
+
+// Make rayforce headers C++ compatible by redefining _Static_assert
+#define _Static_assert static_assert
+
+extern "C" {
+#include "../include/rfui/snapshot.h"
+#include "../include/rfui/offscreen.h"
+#include "../include/rfui/png.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/widget_registry.h"
+#include "../include/rfui/repl_renderer.h"
+#include "../deps/rayforce/core/thread.h"
+}
+
+// Largest capture edge in pixels (GL_MAX_RENDERBUFFER_SIZE on most drivers)
+#define MAX_SNAPSHOT_DIM 16384
+
+struct snapshot_req_t {
+    rfui_widget_t* widget;   // NULL = whole dashboard
+    char* path;
+    i32_t width;
+    i32_t height;
+};
+
+struct png_job_t {
+    char* path;
+    u8_t* rgba;
+    i32_t width;
+    i32_t height;
+};
+
+static std::vector<snapshot_req_t> g_pending;
+
+// Finished writes reported back to the REPL on the UI thread
+static bool g_done_init = false;
+static mutex_t g_done_mutex;
+static std::vector<std::string> g_done;
+
+static void report(const char* text) {
+    if (!g_done_init) return;
+    mutex_lock(&g_done_mutex);
+    g_done.push_back(text);
+    mutex_unlock(&g_done_mutex);
+    glfwPostEmptyEvent();  // Wake UI thread
+}
+
+// Worker pool job: encode and write the PNG
+static void png_job(raw_p arg) {
+    png_job_t* job = (png_job_t*)arg;
+    char msg[1100];
+
+    if (rfui_png_write(job->path, job->rgba, job->width, job->height) == 0) {
+        snprintf(msg, sizeof(msg), "snapshot: wrote %s (%dx%d)", job->path, job->width, job->height);
+    } else {
+        snprintf(msg, sizeof(msg), "error: snapshot: failed to write %s", job->path);
+    }
+    report(msg);
+
+    free(job->rgba);
+    free(job->path);
+    free(job);
+}
+
+// Mirror ImGui's AddWindowToDrawData: window list first, then visible children
+static void collect_window(ImGuiWindow* window, ImDrawData* dd) {
+    dd->AddDrawList(window->DrawList);
+    for (ImGuiWindow* child : window->DC.ChildWindows) {
+        if (child->Active && !child->Hidden) {
+            collect_window(child, dd);
+        }
+    }
+}
+
+// Render one request and queue its PNG write. Returns false with an error in err.
+static bool capture(const snapshot_req_t& req, char* err, size_t err_sz) {
+    ImDrawData dd;
+    ImVec2 pos, size, base_scale;
+
+    if (req.widget) {
+        char label[256];
+        rfui_registry_window_label(req.widget, label, sizeof(label));
+        ImGuiWindow* window = ImGui::FindWindowByName(label);
+        if (!window || !window->Active || window->Hidden) {
+            snprintf(err, err_sz, "widget \"%s\" is not visible", req.widget->name);
+            return false;
+        }
+        collect_window(window, &dd);
+        pos = window->Pos;
+        size = window->Size;
+        base_scale = window->Viewport ? window->Viewport->FramebufferScale : ImVec2(1.0f, 1.0f);
+    } else {
+        ImDrawData* main_dd = ImGui::GetMainViewport()->DrawData;
+        if (!main_dd || !main_dd->Valid) {
+            snprintf(err, err_sz, "no rendered frame");
+            return false;
+        }
+        for (ImDrawList* list : main_dd->CmdLists) {
+            dd.AddDrawList(list);
+        }
+        pos = main_dd->DisplayPos;
+        size = main_dd->DisplaySize;
+        base_scale = main_dd->FramebufferScale;
+    }
+
+    if (size.x < 1.0f || size.y < 1.0f) {
+        snprintf(err, err_sz, "nothing to capture");
+        return false;
+    }
+
+    // Uniform scale so text keeps its aspect; fit inside the requested box
+    float scale = base_scale.x > 0.0f ? base_scale.x : 1.0f;
+    if (req.width > 0 && req.height > 0) {
+        float sx = (float)req.width / size.x;
+        float sy = (float)req.height / size.y;
+        scale = sx < sy ? sx : sy;
+    }
+    int out_w = (int)(size.x * scale + 0.5f);
+    int out_h = (int)(size.y * scale + 0.5f);
+    if (out_w < 1 || out_h < 1 || out_w > MAX_SNAPSHOT_DIM || out_h > MAX_SNAPSHOT_DIM) {
+        snprintf(err, err_sz, "invalid snapshot size %dx%d", out_w, out_h);
+        return false;
+    }
+
+    dd.Valid = true;
+    dd.DisplayPos = pos;
+    dd.DisplaySize = size;
+    dd.FramebufferScale = ImVec2(scale, scale);
+    dd.Textures = nullptr;  // Atlas already uploaded by this frame's render
+
+    rfui_fbo_t fbo;
+    if (rfui_fbo_create(&fbo, out_w, out_h) != 0) {
+        snprintf(err, err_sz, "offscreen framebuffer unavailable");
+        return false;
+    }
+
+    u8_t* rgba = (u8_t*)malloc((size_t)out_w * out_h * 4);
+    if (!rgba) {
+        rfui_fbo_destroy(&fbo);
+        snprintf(err, err_sz, "out of memory");
+        return false;
+    }
+
+    rfui_fbo_bind(&fbo);
+    glViewport(0, 0, out_w, out_h);
+    glClearColor(0.051f, 0.067f, 0.090f, 1.0f);  // COL_BG #0D1117
+    glClear(GL_COLOR_BUFFER_BIT);
+    ImGui_ImplOpenGL3_RenderDrawData(&dd);
+    rfui_fbo_read(&fbo, rgba);
+    rfui_fbo_bind(nullptr);
+    rfui_fbo_destroy(&fbo);
+
+    png_job_t* job = (png_job_t*)malloc(sizeof(png_job_t));
+    if (!job) {
+        free(rgba);
+        snprintf(err, err_sz, "out of memory");
+        return false;
+    }
+    job->path = req.path;
+    job->rgba = rgba;
+    job->width = out_w;
+    job->height = out_h;
+
+    if (!rfui_worker_submit(png_job, job)) {
+        // No pool - encode inline rather than lose the capture
+        png_job(job);
+    }
+    return true;
+}
+
+extern "C" {
+
+nil_t rfui_snapshot_request(rfui_widget_t* widget, char* path, i32_t width, i32_t height) {
+    if (!path) return;
+
+    if (!g_done_init) {
+        g_done_mutex = mutex_create();
+        g_done_init = true;
+    }
+
+    snapshot_req_t req;
+    req.widget = widget;
+    req.path = path;
+    req.width = width;
+    req.height = height;
+    g_pending.push_back(req);
+}
+
+nil_t rfui_snapshot_process(nil_t) {
+    // Report finished writes
+    if (g_done_init) {
+        std::vector<std::string> done;
+        mutex_lock(&g_done_mutex);
+        done.swap(g_done);
+        mutex_unlock(&g_done_mutex);
+        for (const std::string& line : done) {
+            rfui_repl_add_result_text(line.c_str());
+        }
+    }
+
+    if (g_pending.empty()) return;
+
+    for (const snapshot_req_t& req : g_pending) {
+        char err[256];
+        if (!capture(req, err, sizeof(err))) {
+            char msg[1400];
+            snprintf(msg, sizeof(msg), "error: snapshot: %s: %s", req.path, err);
+            rfui_repl_add_result_text(msg);
+            free(req.path);
+        }
+        // On success the path is owned by the PNG job
+    }
+    g_pending.clear();
+}
+
+nil_t rfui_snapshot_destroy(nil_t) {
+    for (const snapshot_req_t& req : g_pending) {
+        free(req.path);
+    }
+    g_pending.clear();
+    // g_done_mutex stays alive: worker jobs may still report until the pool joins
+}
+
+} // extern "C"
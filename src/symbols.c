@@ -0,0 +1,285 @@
+// src/symbols.c
+// Symbol strings shipped from the Rayforce thread to a lock-free UI cache
+
+#include "../include/rfui/symbols.h"
+#include "../include/rfui/keyed.h"
+#include <stdlib.h>
+#include <string.h>
+
+static i64_t sym_slot(i64_t id, i64_t cap) {
+    return (i64_t)(((u64_t)id * 0x9E3779B97F4A7C15ull) >> 32) & (cap - 1);
+}
+
+// ============================================================================
+// Rayforce thread: ids already shipped
+// ============================================================================
+
+typedef struct sent_set_t {
+    i64_t* ids;
+    u8_t* used;
+    i64_t cap;        // Slots, a power of two (0 = not allocated)
+    i64_t count;
+} sent_set_t;
+
+static sent_set_t g_sent;
+
+// New ids found by the current collect
+typedef struct pending_t {
+    i64_t* ids;
+    i64_t n;
+    i64_t cap;
+    i64_t text;       // Bytes of their strings, NULs included
+} pending_t;
+
+nil_t rfui_symbols_reset(nil_t) {
+    free(g_sent.ids);
+    free(g_sent.used);
+    memset(&g_sent, 0, sizeof(g_sent));
+}
+
+static b8_t sent_grow(nil_t) {
+    i64_t cap = g_sent.cap ? g_sent.cap * 2 : 1024;
+    i64_t* ids = (i64_t*)malloc(sizeof(i64_t) * (size_t)cap);
+    u8_t* used = (u8_t*)calloc((size_t)cap, 1);
+    if (!ids || !used) {
+        free(ids);
+        free(used);
+        return B8_FALSE;
+    }
+    for (i64_t i = 0; i < g_sent.cap; i++) {
+        if (!g_sent.used[i]) continue;
+        i64_t slot = sym_slot(g_sent.ids[i], cap);
+        while (used[slot]) slot = (slot + 1) & (cap - 1);
+        used[slot] = 1;
+        ids[slot] = g_sent.ids[i];
+    }
+    free(g_sent.ids);
+    free(g_sent.used);
+    g_sent.ids = ids;
+    g_sent.used = used;
+    g_sent.cap = cap;
+    return B8_TRUE;
+}
+
+// Mark id as sent; a new one is added to p. False when out of memory.
+static b8_t sent_add(i64_t id, pending_t* p) {
+    if ((g_sent.count + 1) * 2 > g_sent.cap && !sent_grow()) return B8_FALSE;
+    i64_t slot = sym_slot(id, g_sent.cap);
+    while (g_sent.used[slot]) {
+        if (g_sent.ids[slot] == id) return B8_TRUE;
+        slot = (slot + 1) & (g_sent.cap - 1);
+    }
+
+    if (p->n == p->cap) {
+        i64_t cap = p->cap ? p->cap * 2 : 64;
+        i64_t* ids = (i64_t*)realloc(p->ids, sizeof(i64_t) * (size_t)cap);
+        if (!ids) return B8_FALSE;
+        p->ids = ids;
+        p->cap = cap;
+    }
+    const char* s = str_from_symbol(id);
+    p->text += (s ? (i64_t)strlen(s) : 0) + 1;
+    p->ids[p->n++] = id;
+
+    g_sent.used[slot] = 1;
+    g_sent.ids[slot] = id;
+    g_sent.count++;
+    return B8_TRUE;
+}
+
+// Runs of one id (sorted or grouped columns) cost a single lookup
+static b8_t scan_symbols(obj_p v, pending_t* p) {
+    const i64_t* ids = AS_SYMBOL(v);
+    for (i64_t i = 0; i < v->len; i++) {
+        if (i > 0 && ids[i] == ids[i - 1]) continue;
+        if (!sent_add(ids[i], p)) return B8_FALSE;
+    }
+    return B8_TRUE;
+}
+
+// Column names and symbol columns of a table (other shapes carry none the UI reads)
+static b8_t scan_table(obj_p t, pending_t* p) {
+    if (!t || t->type != TYPE_TABLE || t->len < 2) return B8_TRUE;
+    obj_p names = AS_LIST(t)[0];
+    obj_p cols = AS_LIST(t)[1];
+    if (names && names->type == TYPE_SYMBOL && !scan_symbols(names, p)) return B8_FALSE;
+    if (!cols || cols->type != TYPE_LIST) return B8_TRUE;
+    for (i64_t c = 0; c < cols->len; c++) {
+        obj_p col = AS_LIST(cols)[c];
+        if (col && col->type == TYPE_SYMBOL && !scan_symbols(col, p)) return B8_FALSE;
+    }
+    return B8_TRUE;
+}
+
+rfui_sym_delta_t* rfui_symbols_collect(obj_p data) {
+    pending_t p = {0};
+    b8_t ok = rfui_keyed_is(data) ?
+        scan_table(AS_LIST(data)[0], &p) && scan_table(AS_LIST(data)[1], &p) :
+        scan_table(data, &p);
+    if (ok && p.n == 0) return NULL;
+
+    rfui_sym_delta_t* d = NULL;
+    if (ok) {
+        size_t ids = sizeof(i64_t) * (size_t)p.n;
+        size_t offsets = sizeof(u32_t) * (size_t)(p.n + 1);
+        d = (rfui_sym_delta_t*)malloc(sizeof(rfui_sym_delta_t) + ids + offsets + (size_t)p.text);
+    }
+    if (!d) {
+        // Ids marked above never reach the UI: start over
+        free(p.ids);
+        rfui_symbols_reset();
+        return NULL;
+    }
+
+    d->n = p.n;
+    d->done = 0;
+    d->next = NULL;
+    d->ids = (i64_t*)(d + 1);
+    d->offsets = (u32_t*)(d->ids + p.n);
+    d->text = (char*)(d->offsets + p.n + 1);
+    u32_t off = 0;
+    for (i64_t i = 0; i < p.n; i++) {
+        const char* s = str_from_symbol(p.ids[i]);
+        size_t len = s ? strlen(s) : 0;
+        d->ids[i] = p.ids[i];
+        d->offsets[i] = off;
+        if (len) memcpy(d->text + off, s, len);
+        d->text[off + len] = '\0';
+        off += (u32_t)len + 1;
+    }
+    d->offsets[p.n] = off;
+    free(p.ids);
+    return d;
+}
+
+// ============================================================================
+// UI thread cache: one writer, lock-free readers
+// ============================================================================
+
+typedef struct sym_table_t {
+    i64_t cap;                  // Slots, a power of two
+    i64_t* ids;
+    const char** strs;          // NULL = empty; stored after the id (release)
+    struct sym_table_t* prev;   // Table this one replaced (freed at exit)
+} sym_table_t;
+
+static sym_table_t* g_table;    // Current table (published with release)
+static i64_t g_count;
+static i64_t g_bytes;
+static rfui_sym_delta_t* g_pending;   // Deltas cut short by out of memory, oldest first
+
+static sym_table_t* table_new(i64_t cap) {
+    sym_table_t* t = (sym_table_t*)malloc(sizeof(sym_table_t));
+    if (!t) return NULL;
+    t->cap = cap;
+    t->ids = (i64_t*)malloc(sizeof(i64_t) * (size_t)cap);
+    t->strs = (const char**)calloc((size_t)cap, sizeof(const char*));
+    t->prev = NULL;
+    if (!t->ids || !t->strs) {
+        free(t->ids);
+        free(t->strs);
+        free(t);
+        return NULL;
+    }
+    g_bytes += (i64_t)sizeof(sym_table_t) + cap * (i64_t)(sizeof(i64_t) + sizeof(const char*));
+    return t;
+}
+
+// Copy the entries into a table twice the size and publish it; readers on
+// the old one still find everything it held
+static b8_t table_grow(nil_t) {
+    sym_table_t* old = g_table;
+    sym_table_t* t = table_new(old ? old->cap * 2 : 1024);
+    if (!t) return B8_FALSE;
+    for (i64_t i = 0; old && i < old->cap; i++) {
+        if (!old->strs[i]) continue;
+        i64_t slot = sym_slot(old->ids[i], t->cap);
+        while (t->strs[slot]) slot = (slot + 1) & (t->cap - 1);
+        t->ids[slot] = old->ids[i];
+        t->strs[slot] = old->strs[i];
+    }
+    t->prev = old;
+    __atomic_store_n(&g_table, t, __ATOMIC_RELEASE);
+    return B8_TRUE;
+}
+
+// Add d's entries from d->done on; false when out of memory (d->done then
+// marks the first entry left)
+static b8_t apply_rest(rfui_sym_delta_t* d) {
+    for (; d->done < d->n; d->done++) {
+        i64_t i = d->done;
+        if ((g_count + 1) * 2 > (g_table ? g_table->cap : 0) && !table_grow()) return B8_FALSE;
+        sym_table_t* t = g_table;
+        i64_t id = d->ids[i];
+        i64_t slot = sym_slot(id, t->cap);
+        while (t->strs[slot] && t->ids[slot] != id) slot = (slot + 1) & (t->cap - 1);
+        if (t->strs[slot]) continue;   // Sent again after a reset
+
+        size_t len = d->offsets[i + 1] - d->offsets[i];
+        char* s = (char*)malloc(len);
+        if (!s) return B8_FALSE;
+        memcpy(s, d->text + d->offsets[i], len);
+        t->ids[slot] = id;
+        __atomic_store_n(&t->strs[slot], (const char*)s, __ATOMIC_RELEASE);
+        g_count++;
+        g_bytes += (i64_t)len;
+    }
+    return B8_TRUE;
+}
+
+nil_t rfui_symbols_apply(rfui_sym_delta_t* d) {
+    // Deltas left over from earlier frames go first
+    while (g_pending && apply_rest(g_pending)) {
+        rfui_sym_delta_t* next = g_pending->next;
+        free(g_pending);
+        g_pending = next;
+    }
+    if (!d) return;
+    if (!g_pending && apply_rest(d)) {
+        free(d);
+        return;
+    }
+
+    // Keep the rest: dropping it would leave its ids unresolved for good
+    d->next = NULL;
+    rfui_sym_delta_t** tail = &g_pending;
+    while (*tail) tail = &(*tail)->next;
+    *tail = d;
+}
+
+const char* rfui_symbols_get(i64_t id) {
+    const sym_table_t* t = __atomic_load_n(&g_table, __ATOMIC_ACQUIRE);
+    if (!t) return NULL;
+    // At most half full, so an empty slot ends every probe
+    for (i64_t slot = sym_slot(id, t->cap);; slot = (slot + 1) & (t->cap - 1)) {
+        const char* s = __atomic_load_n(&t->strs[slot], __ATOMIC_ACQUIRE);
+        if (!s) return NULL;
+        if (t->ids[slot] == id) return s;
+    }
+}
+
+i64_t rfui_symbols_bytes(nil_t) {
+    return g_bytes;
+}
+
+nil_t rfui_symbols_free(nil_t) {
+    sym_table_t* t = g_table;
+    // The current table holds every string once
+    for (i64_t i = 0; t && i < t->cap; i++) free((char*)t->strs[i]);
+    while (t) {
+        sym_table_t* prev = t->prev;
+        free(t->ids);
+        free(t->strs);
+        free(t);
+        t = prev;
+    }
+    g_table = NULL;
+    g_count = 0;
+    g_bytes = 0;
+    while (g_pending) {
+        rfui_sym_delta_t* next = g_pending->next;
+        free(g_pending);
+        g_pending = next;
+    }
+    rfui_symbols_reset();
+}
@@ -16,6 +16,8 @@ static const char* keywords[] = {
 // Builtin function table
 static const char* builtins[] = {
     "widget", "draw", "timer", "hopen", "hclose", "write", "read",
+    "ui-snapshot", "ui-snapshot-all", "ui-latency", "ui-latency-reset", "ui-overlay",
+    "ui-memory", "ui-trace", "ui-trace-dump", "ui-record",
     "count", "sum", "avg", "min", "max", "first", "last", "type",
     "string", "int", "float", "til", "show", "tables", "cols",
     "meta", "key", "value", "enlist", "raze", "flip", "group", NULL
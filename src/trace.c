@@ -0,0 +1,197 @@
+// src/trace.c
+// Lock-free per-thread span buffers and Chrome trace-event export
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include "../include/rfui/trace.h"
+#include "../include/rfui/latency.h"  // rfui_clock_ns
+
+#define TRACE_MAX_THREADS 32
+#define TRACE_DETAIL_LEN 40
+
+typedef struct trace_event_t {
+    const char* name;              // String literal
+    i64_t start;                   // rfui_clock_ns
+    i64_t dur;
+    char detail[TRACE_DETAIL_LEN];
+} trace_event_t;
+
+typedef struct trace_buf_t {
+    char thread_name[32];
+    i64_t tid;
+    i64_t epoch;       // Session the events belong to (written by the owner only)
+    i64_t count;       // Published with release; readers see [0, count)
+    i64_t dropped;
+    trace_event_t* events;
+} trace_buf_t;
+
+static trace_buf_t* g_bufs[TRACE_MAX_THREADS];
+static i64_t g_nbufs = 0;
+static i64_t g_enabled = 0;
+static i64_t g_epoch = 0;
+static i64_t g_origin = 0;   // Session start (ns)
+
+static __thread trace_buf_t* t_buf = NULL;
+static __thread b8_t t_failed = B8_FALSE;
+static __thread char t_name[32];
+
+// Calling thread's buffer, allocated and registered on first use
+static trace_buf_t* thread_buf(nil_t) {
+    if (t_buf || t_failed) return t_buf;
+
+    i64_t slot = __atomic_fetch_add(&g_nbufs, 1, __ATOMIC_ACQ_REL);
+    trace_buf_t* b = NULL;
+    if (slot < TRACE_MAX_THREADS) {
+        b = (trace_buf_t*)calloc(1, sizeof(trace_buf_t));
+        if (b) {
+            b->events = (trace_event_t*)malloc(sizeof(trace_event_t) * RFUI_TRACE_EVENTS);
+            if (!b->events) {
+                free(b);
+                b = NULL;
+            }
+        }
+    }
+    if (!b) {
+        // Out of slots or memory: this thread records nothing (its slot stays NULL)
+        t_failed = B8_TRUE;
+        return NULL;
+    }
+
+    b->tid = slot + 1;
+    b->epoch = -1;
+    if (t_name[0]) {
+        snprintf(b->thread_name, sizeof(b->thread_name), "%s", t_name);
+    } else {
+        snprintf(b->thread_name, sizeof(b->thread_name), "thread-%lld", (long long)b->tid);
+    }
+    __atomic_store_n(&g_bufs[slot], b, __ATOMIC_RELEASE);
+    t_buf = b;
+    return b;
+}
+
+nil_t rfui_trace_start(nil_t) {
+    __atomic_store_n(&g_enabled, 0, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_origin, rfui_clock_ns(), __ATOMIC_RELEASE);
+    __atomic_fetch_add(&g_epoch, 1, __ATOMIC_ACQ_REL);
+    __atomic_store_n(&g_enabled, 1, __ATOMIC_RELEASE);
+}
+
+nil_t rfui_trace_stop(nil_t) {
+    __atomic_store_n(&g_enabled, 0, __ATOMIC_RELEASE);
+}
+
+b8_t rfui_trace_enabled(nil_t) {
+    return __atomic_load_n(&g_enabled, __ATOMIC_ACQUIRE) ? B8_TRUE : B8_FALSE;
+}
+
+nil_t rfui_trace_thread_name(const char* name) {
+    snprintf(t_name, sizeof(t_name), "%s", name ? name : "");
+    if (t_buf) {
+        snprintf(t_buf->thread_name, sizeof(t_buf->thread_name), "%s", t_name);
+    }
+}
+
+i64_t rfui_trace_begin(nil_t) {
+    return __atomic_load_n(&g_enabled, __ATOMIC_ACQUIRE) ? rfui_clock_ns() : 0;
+}
+
+nil_t rfui_trace_end(const char* name, const char* detail, i64_t start) {
+    if (start == 0 || !__atomic_load_n(&g_enabled, __ATOMIC_ACQUIRE)) return;
+    // Span opened before the current session started
+    if (start < __atomic_load_n(&g_origin, __ATOMIC_ACQUIRE)) return;
+
+    trace_buf_t* b = thread_buf();
+    if (!b) return;
+
+    i64_t epoch = __atomic_load_n(&g_epoch, __ATOMIC_ACQUIRE);
+    if (b->epoch != epoch) {
+        __atomic_store_n(&b->count, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(&b->dropped, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&b->epoch, epoch, __ATOMIC_RELEASE);
+    }
+
+    i64_t n = b->count;
+    if (n >= RFUI_TRACE_EVENTS) {
+        __atomic_store_n(&b->dropped, b->dropped + 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    trace_event_t* e = &b->events[n];
+    e->name = name;
+    e->start = start;
+    e->dur = rfui_clock_ns() - start;
+    if (detail) {
+        snprintf(e->detail, sizeof(e->detail), "%s", detail);
+    } else {
+        e->detail[0] = '\0';
+    }
+    __atomic_store_n(&b->count, n + 1, __ATOMIC_RELEASE);
+}
+
+// JSON string body (quotes added by the caller)
+static void write_escaped(FILE* f, const char* s) {
+    for (; *s; s++) {
+        unsigned char c = (unsigned char)*s;
+        if (c == '"' || c == '\\') {
+            fputc('\\', f);
+            fputc(c, f);
+        } else if (c < 0x20) {
+            fprintf(f, "\\u%04x", c);
+        } else {
+            fputc(c, f);
+        }
+    }
+}
+
+i64_t rfui_trace_dump(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (!f) return -1;
+
+    i64_t epoch = __atomic_load_n(&g_epoch, __ATOMIC_ACQUIRE);
+    i64_t origin = __atomic_load_n(&g_origin, __ATOMIC_ACQUIRE);
+    i64_t nbufs = __atomic_load_n(&g_nbufs, __ATOMIC_ACQUIRE);
+    if (nbufs > TRACE_MAX_THREADS) nbufs = TRACE_MAX_THREADS;
+
+    i64_t written = 0;
+    b8_t first = B8_TRUE;
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (i64_t i = 0; i < nbufs; i++) {
+        trace_buf_t* b = __atomic_load_n(&g_bufs[i], __ATOMIC_ACQUIRE);
+        if (!b) continue;
+
+        fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%lld,\"args\":{\"name\":\"",
+                first ? "" : ",\n", (long long)b->tid);
+        write_escaped(f, b->thread_name);
+        fprintf(f, "\"}}");
+        first = B8_FALSE;
+
+        // Buffers not yet touched this session still hold the previous one
+        if (__atomic_load_n(&b->epoch, __ATOMIC_ACQUIRE) != epoch) continue;
+
+        i64_t count = __atomic_load_n(&b->count, __ATOMIC_ACQUIRE);
+        for (i64_t j = 0; j < count; j++) {
+            const trace_event_t* e = &b->events[j];
+            fprintf(f, ",\n{\"name\":\"%s\",\"cat\":\"rfui\",\"ph\":\"X\",\"pid\":1,\"tid\":%lld,"
+                       "\"ts\":%.3f,\"dur\":%.3f",
+                    e->name, (long long)b->tid,
+                    (double)(e->start - origin) / 1e3, (double)e->dur / 1e3);
+            if (e->detail[0]) {
+                fprintf(f, ",\"args\":{\"detail\":\"");
+                write_escaped(f, e->detail);
+                fprintf(f, "\"}");
+            }
+            fputc('}', f);
+            written++;
+        }
+        i64_t dropped = __atomic_load_n(&b->dropped, __ATOMIC_RELAXED);
+        if (dropped > 0) {
+            fprintf(stderr, "Trace: %s dropped %lld events (buffer full)\n",
+                    b->thread_name, (long long)dropped);
+        }
+    }
+
+    fprintf(f, "\n]}\n");
+    if (fclose(f) != 0) return -1;
+    return written;
+}
@@ -5,6 +5,8 @@
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
+#include <algorithm>
 #ifdef _WIN32
 #include <direct.h>
 #define mkdir(path, mode) _mkdir(path)
@@ -24,6 +26,8 @@
 #include "../include/rfui/logo.h"
 #include "../include/rfui/icons.h"
 #include "../include/rfui/version.h"
+#include "../include/rfui/headless.h"
+#include "../include/rfui/offscreen.h"
 #include "embed_assets.h"
 
 #define GL_SILENCE_DEPRECATION
@@ -43,7 +47,15 @@ extern "C" {
 #include "../include/rfui/message.h"
 #include "../include/rfui/queue.h"
 #include "../include/rfui/widget_registry.h"
+#include "../include/rfui/grid_renderer.h"
 #include "../include/rfui/repl_renderer.h"
+#include "../include/rfui/snapshot.h"
+#include "../include/rfui/worker.h"
+#include "../include/rfui/latency.h"
+#include "../include/rfui/overlay.h"
+#include "../include/rfui/memory.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/symbols.h"
 }
 
 // Maximum messages to process per frame to avoid blocking rendering
@@ -60,6 +72,19 @@ static const char* g_glsl_version = nullptr;
 static bool g_initialized = false;
 static char* g_ini_path = nullptr;  // ImGui layout persistence path
 
+// Headless mode: offscreen framebuffer instead of a window
+static rfui_ui_opts_t g_opts;
+static bool g_headless = false;
+static rfui_fbo_t g_headless_fbo;
+
+// Per-frame wall time in milliseconds (collected when --frames or --headless)
+static std::vector<double> g_frame_ms;
+
+// GL entry point loader for the offscreen module (windowed mode)
+static void* glfw_gl_loader(const char* name) {
+    return (void*)glfwGetProcAddress(name);
+}
+
 // Get config directory path, creating it if necessary
 // Returns allocated string that caller must free, or nullptr on failure
 static char* get_config_path(void) {
@@ -101,70 +126,183 @@ static char* get_config_path(void) {
 // External context (set by main.c)
 extern "C" rfui_ctx_t* g_ctx;
 
+// Print frame timing summary (headless benchmarks, --frames runs)
+// and optionally write it as JSON for the benchmark suite
+static void print_frame_stats(void) {
+    size_t n = g_frame_ms.size();
+    if (n == 0) return;
+
+    std::vector<double> sorted(g_frame_ms);
+    std::sort(sorted.begin(), sorted.end());
+
+    double total = 0.0;
+    for (double ms : sorted) total += ms;
+    double avg = total / (double)n;
+    double fps = total > 0.0 ? (double)n * 1000.0 / total : 0.0;
+
+    auto pct = [&](double p) -> double {
+        size_t idx = (size_t)(p * (double)(n - 1) + 0.5);
+        return sorted[idx];
+    };
+
+    printf("frames: %zu  elapsed: %.3f s  fps: %.1f\n", n, total / 1000.0, fps);
+    printf("frame ms: min %.3f  avg %.3f  p50 %.3f  p95 %.3f  p99 %.3f  max %.3f\n",
+           sorted[0], avg, pct(0.50), pct(0.95), pct(0.99), sorted[n - 1]);
+
+    // Draw->present across all widgets (empty without fn_draw traffic)
+    rfui_latency_summary_t lat;
+    rfui_latency_global_summary(&lat);
+    const rfui_hdr_summary_t* pr = &lat.present;
+    if (pr->count > 0) {
+        printf("draw->present ms: draws %lld  p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f  superseded %lld\n",
+               (long long)pr->count, pr->p50 / 1e6, pr->p90 / 1e6, pr->p99 / 1e6, pr->p999 / 1e6,
+               pr->max / 1e6, (long long)lat.superseded);
+    }
+    fflush(stdout);
+
+    if (g_opts.stats_json) {
+        FILE* f = fopen(g_opts.stats_json, "w");
+        if (!f) {
+            fprintf(stderr, "Failed to write stats to %s\n", g_opts.stats_json);
+            return;
+        }
+        fprintf(f, "{\n  \"frames\": %zu,\n  \"elapsed_s\": %.6f,\n  \"fps\": %.3f,\n", n, total / 1000.0, fps);
+        fprintf(f, "  \"frame_ms\": {\"min\": %.6f, \"avg\": %.6f, \"p50\": %.6f, \"p95\": %.6f, "
+                   "\"p99\": %.6f, \"max\": %.6f},\n",
+                sorted[0], avg, pct(0.50), pct(0.95), pct(0.99), sorted[n - 1]);
+        fprintf(f, "  \"draw_present_ms\": {\"draws\": %lld, \"superseded\": %lld, \"mean\": %.6f, "
+                   "\"p50\": %.6f, \"p90\": %.6f, \"p99\": %.6f, \"p999\": %.6f, \"max\": %.6f}\n}\n",
+                (long long)pr->count, (long long)lat.superseded, pr->mean / 1e6, pr->p50 / 1e6,
+                pr->p90 / 1e6, pr->p99 / 1e6, pr->p999 / 1e6, pr->max / 1e6);
+        fclose(f);
+    }
+}
+
+// Hand an object back to the Rayforce thread for drop_obj
+static void queue_drop(obj_p obj, i64_t bytes) {
+    if (!obj) return;
+
+    rfui_ui_msg_t* drop_msg = (rfui_ui_msg_t*)malloc(sizeof(rfui_ui_msg_t));
+    if (!drop_msg) {
+        // Malloc failed - leak (drop_obj requires Rayforce thread)
+        return;
+    }
+    drop_msg->type = RFUI_MSG_DROP;
+    drop_msg->obj = obj;
+    drop_msg->widget = nullptr;
+    drop_msg->expr = nullptr;
+    drop_msg->bytes = bytes;
+
+    // Count before the push: the Rayforce thread may drop it immediately
+    rfui_memory_drop_queued(bytes);
+    if (!rfui_queue_push(g_ctx->ui_to_ray, drop_msg)) {
+        // Queue full - leak rather than crash
+        // (drop_obj requires Rayforce thread runtime)
+        rfui_memory_drop_done(bytes);
+        free(drop_msg);
+        return;
+    }
+    poll_waker_p waker = rfui_ctx_get_waker(g_ctx);
+    if (waker) poll_waker_wake(waker);
+}
+
 extern "C" {
 
-i32_t rfui_ui_init(nil_t) {
+i32_t rfui_ui_init(const rfui_ui_opts_t* opts) {
     if (g_initialized) {
         fprintf(stderr, "UI already initialized\n");
         return -1;
     }
 
+    memset(&g_opts, 0, sizeof(g_opts));
+    if (opts) g_opts = *opts;
+    g_headless = g_opts.headless != 0;
+
     // Setup GLFW error callback
     glfwSetErrorCallback(glfw_error_callback);
 
+    // Headless: GLFW null platform (no display connection) still provides
+    // timers and glfwPostEmptyEvent for the Rayforce thread
+    if (g_headless) {
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    }
+
     // Initialize GLFW
     if (!glfwInit()) {
         fprintf(stderr, "Failed to initialize GLFW\n");
         return -1;
     }
 
-    // Decide GL+GLSL versions
+    float dpi_scale = 1.0f;
+    float style_scale = 1.0f;
+
+    if (g_headless) {
+        // Surfaceless GL context rendering into an offscreen framebuffer
+        if (rfui_headless_init() != 0) {
+            glfwTerminate();
+            return -1;
+        }
+        if (rfui_offscreen_init(rfui_headless_get_proc) != 0 ||
+            rfui_fbo_create(&g_headless_fbo, g_opts.width, g_opts.height) != 0) {
+            rfui_headless_destroy();
+            glfwTerminate();
+            return -1;
+        }
+        g_glsl_version = "#version 130";
+    } else {
+        // Decide GL+GLSL versions
 #if defined(IMGUI_IMPL_OPENGL_ES2)
-    // GL ES 2.0 + GLSL 100 (WebGL 1.0)
-    g_glsl_version = "#version 100";
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
+        // GL ES 2.0 + GLSL 100 (WebGL 1.0)
+        g_glsl_version = "#version 100";
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_OPENGL_ES_API);
 #elif defined(__APPLE__)
-    // GL 3.2 + GLSL 150
-    g_glsl_version = "#version 150";
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        // GL 3.2 + GLSL 150
+        g_glsl_version = "#version 150";
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #else
-    // GL 3.0 + GLSL 130
-    g_glsl_version = "#version 130";
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
+        // GL 3.0 + GLSL 130
+        g_glsl_version = "#version 130";
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);
 #endif
 
-    // Borderless main window — custom title bar replaces OS decoration
-    glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
-    g_window = glfwCreateWindow(1280, 720, "Rayforce UI", nullptr, nullptr);
-    if (g_window == nullptr) {
-        fprintf(stderr, "Failed to create GLFW window\n");
-        glfwTerminate();
-        return -1;
-    }
+        // Borderless main window — custom title bar replaces OS decoration
+        glfwWindowHint(GLFW_DECORATED, GLFW_FALSE);
+        g_window = glfwCreateWindow(1280, 720, "Rayforce UI", nullptr, nullptr);
+        if (g_window == nullptr) {
+            fprintf(stderr, "Failed to create GLFW window\n");
+            glfwTerminate();
+            return -1;
+        }
+
+        glfwMakeContextCurrent(g_window);
+        glfwSwapInterval(1); // Enable vsync
 
-    glfwMakeContextCurrent(g_window);
-    glfwSwapInterval(1); // Enable vsync
-
-    // Get HiDPI scale factor
-    // On macOS Retina, content scale is 2.0 but GLFW already maps coordinates
-    // to screen points — only fonts need the scale for sharp rendering.
-    // On Windows/Linux, content scale reflects actual UI scaling (1.25, 1.5, etc.)
-    // and both fonts and style need scaling.
-    float xscale, yscale;
-    glfwGetWindowContentScale(g_window, &xscale, &yscale);
-    float dpi_scale = (xscale > yscale) ? xscale : yscale;
-    if (dpi_scale < 1.0f) dpi_scale = 1.0f;
+        // FBO entry points for snapshots (non-fatal: snapshots report an error)
+        if (rfui_offscreen_init(glfw_gl_loader) != 0) {
+            fprintf(stderr, "Offscreen rendering unavailable, snapshots disabled\n");
+        }
+
+        // Get HiDPI scale factor
+        // On macOS Retina, content scale is 2.0 but GLFW already maps coordinates
+        // to screen points — only fonts need the scale for sharp rendering.
+        // On Windows/Linux, content scale reflects actual UI scaling (1.25, 1.5, etc.)
+        // and both fonts and style need scaling.
+        float xscale, yscale;
+        glfwGetWindowContentScale(g_window, &xscale, &yscale);
+        dpi_scale = (xscale > yscale) ? xscale : yscale;
+        if (dpi_scale < 1.0f) dpi_scale = 1.0f;
 #ifdef __APPLE__
-    float style_scale = 1.0f;  // macOS handles point-to-pixel transparently
+        style_scale = 1.0f;  // macOS handles point-to-pixel transparently
 #else
-    float style_scale = dpi_scale;
+        style_scale = dpi_scale;
 #endif
+    }
 
     // Setup Dear ImGui and ImPlot contexts
     IMGUI_CHECKVERSION();
@@ -173,14 +311,20 @@ i32_t rfui_ui_init(nil_t) {
     ImGuiIO& io = ImGui::GetIO();
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard; // Enable Keyboard Controls
     io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;     // Enable Docking
-    io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;   // Enable Multi-Viewport
-
-    // Set up persistent layout file (ImGui auto-saves on shutdown, auto-loads on startup)
-    g_ini_path = get_config_path();
-    if (g_ini_path) {
-        io.IniFilename = g_ini_path;
+    if (g_headless) {
+        // No platform windows; fixed layout, never touch the user's layout.ini
+        io.IniFilename = nullptr;
+        io.DisplaySize = ImVec2((float)g_opts.width, (float)g_opts.height);
+    } else {
+        io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;   // Enable Multi-Viewport
+
+        // Set up persistent layout file (ImGui auto-saves on shutdown, auto-loads on startup)
+        g_ini_path = get_config_path();
+        if (g_ini_path) {
+            io.IniFilename = g_ini_path;
+        }
+        // If get_config_path() fails, io.IniFilename remains "imgui.ini" (ImGui default)
     }
-    // If get_config_path() fails, io.IniFilename remains "imgui.ini" (ImGui default)
 
     // Apply dashboard theme (replaces StyleColorsDark)
     rfui_theme_apply();
@@ -209,26 +353,38 @@ i32_t rfui_ui_init(nil_t) {
     // Scale style for HiDPI (but not fonts - they're already sized correctly)
     ImGui::GetStyle().ScaleAllSizes(style_scale);
 
-    // Setup Platform/Renderer backends
-    ImGui_ImplGlfw_InitForOpenGL(g_window, true);
+    // Setup Platform/Renderer backends (headless drives ImGui IO directly)
+    if (!g_headless) {
+        ImGui_ImplGlfw_InitForOpenGL(g_window, true);
+    }
     ImGui_ImplOpenGL3_Init(g_glsl_version);
 
     // Load background logo and window icon from embedded data
     rfui_logo_init();
-    rfui_icon_init(g_window);
+    if (!g_headless) {
+        rfui_icon_init(g_window);
+    }
 
     // Initialize widget registry
     rfui_registry_init();
+    rfui_memory_init();
 
     // Initialize REPL (renders directly in main window)
     rfui_repl_init();
 
+    rfui_trace_thread_name("ui");
+
+    // Background pool for PNG encoding and other off-frame work
+    if (rfui_worker_init(0) != 0) {
+        fprintf(stderr, "Failed to start worker pool, running jobs inline\n");
+    }
+
     g_initialized = true;
     return 0;
 }
 
 i32_t rfui_ui_run(nil_t) {
-    if (!g_initialized || !g_window) {
+    if (!g_initialized || (!g_window && !g_headless)) {
         fprintf(stderr, "UI not initialized\n");
         return -1;
     }
@@ -240,19 +396,39 @@ i32_t rfui_ui_run(nil_t) {
 
     ImVec4 clear_color = ImVec4(0.051f, 0.067f, 0.090f, 1.0f);
 
+    bool collect_stats = g_headless || g_opts.max_frames > 0;
+    if (collect_stats && g_opts.max_frames > 0) {
+        g_frame_ms.reserve((size_t)g_opts.max_frames);
+    }
+    double frame_interval = (g_headless && g_opts.fps > 0.0) ? 1.0 / g_opts.fps : 0.0;
+    double last_frame_time = glfwGetTime();
+    i64_t frame_count = 0;
+
     // Main loop
-    while (!glfwWindowShouldClose(g_window) && !rfui_ctx_get_quit(g_ctx)) {
-        // Poll events and use timeout to avoid busy-waiting
-        // Note: We always poll first, then process messages
-        glfwWaitEventsTimeout(0.016); // ~60fps timeout
+    while ((g_headless || !glfwWindowShouldClose(g_window)) && !rfui_ctx_get_quit(g_ctx)) {
+        double frame_start = glfwGetTime();
+        i64_t trace_frame = rfui_trace_begin();
+
+        i64_t trace_span = rfui_trace_begin();
+        if (g_headless) {
+            // No input to wait for - run the next frame immediately
+            glfwPollEvents();
+        } else {
+            // Poll events and use timeout to avoid busy-waiting
+            // Note: We always poll first, then process messages
+            glfwWaitEventsTimeout(0.016); // ~60fps timeout
+        }
+        rfui_trace_end("wait_events", NULL, trace_span);
 
-        bool main_minimized = glfwGetWindowAttrib(g_window, GLFW_ICONIFIED) != 0;
+        bool main_minimized = !g_headless && glfwGetWindowAttrib(g_window, GLFW_ICONIFIED) != 0;
 
         // Process messages from ray_to_ui queue (limited per frame)
         // Note: rfui_queue_pop returns NULL if queue is empty or NULL,
         // so we don't need a separate empty check (avoids TOCTOU race)
         int messages_processed = 0;
         rfui_ray_msg_t* msg;
+        trace_span = rfui_trace_begin();
+        rfui_symbols_apply(nullptr);  // Retry symbol strings an earlier frame had no memory for
         if (g_ctx->ray_to_ui != nullptr) {
             while (messages_processed < MAX_MESSAGES_PER_FRAME &&
                    (msg = (rfui_ray_msg_t*)rfui_queue_pop(g_ctx->ray_to_ui)) != nullptr) {
@@ -266,6 +442,9 @@ i32_t rfui_ui_run(nil_t) {
                         }
                         break;
                     case RFUI_MSG_DRAW:
+                        // Symbol strings first: the new data may use them
+                        rfui_symbols_apply(msg->symbols);
+                        msg->symbols = nullptr;
                         // Update widget render_data and queue old data for drop
                         if (msg->widget) {
                             // For text widgets, store pre-formatted string in ui_state
@@ -277,94 +456,91 @@ i32_t rfui_ui_run(nil_t) {
                                 msg->text = nullptr;
                             }
                             obj_p old_data = rfui_registry_update_data(msg->widget, msg->data);
-                            // Queue old data for drop in Rayforce thread (if not NULL)
-                            if (old_data) {
-                                rfui_ui_msg_t* drop_msg = (rfui_ui_msg_t*)malloc(sizeof(rfui_ui_msg_t));
-                                if (drop_msg) {
-                                    drop_msg->type = RFUI_MSG_DROP;
-                                    drop_msg->obj = old_data;
-                                    drop_msg->widget = nullptr;
-                                    drop_msg->expr = nullptr;
-                                    if (!rfui_queue_push(g_ctx->ui_to_ray, drop_msg)) {
-                                        // Queue full - leak rather than crash
-                                        // (drop_obj requires Rayforce thread runtime)
-                                        free(drop_msg);
-                                    } else {
-                                        poll_waker_p waker = rfui_ctx_get_waker(g_ctx);
-                                        if (waker) poll_waker_wake(waker);
-                                    }
-                                } else {
-                                    // Malloc failed - leak (drop_obj requires Rayforce thread)
-                                    (void)old_data;
-                                }
+                            msg->widget->render_bytes = msg->bytes;
+                            rfui_latency_applied(msg->widget->latency, msg->stamp, rfui_clock_ns());
+                            // Grids diff old against new (change flash); a background job may still read the old table
+                            if (old_data && msg->widget->type == RFUI_WIDGET_GRID) {
+                                old_data = rfui_grid_retire_data(msg->widget, old_data, msg->drop_bytes);
                             }
-                        } else if (msg->data) {
+                            // Queue old data for drop in Rayforce thread (if not NULL)
+                            queue_drop(old_data, msg->drop_bytes);
+                        } else {
                             // No widget - queue data for drop directly
-                            rfui_ui_msg_t* drop_msg = (rfui_ui_msg_t*)malloc(sizeof(rfui_ui_msg_t));
-                            if (drop_msg) {
-                                drop_msg->type = RFUI_MSG_DROP;
-                                drop_msg->obj = msg->data;
-                                drop_msg->widget = nullptr;
-                                drop_msg->expr = nullptr;
-                                if (!rfui_queue_push(g_ctx->ui_to_ray, drop_msg)) {
-                                    // Queue push failed - fall back to direct drop
-                                    // Leak (drop_obj requires Rayforce thread)
-                                        (void)msg->data;
-                                    free(drop_msg);
-                                } else {
-                                    poll_waker_p waker = rfui_ctx_get_waker(g_ctx);
-                                    if (waker) poll_waker_wake(waker);
-                                }
-                            } else {
-                                // Malloc failed - leak (drop_obj requires Rayforce thread)
-                                (void)msg->data;
+                            queue_drop(msg->data, msg->bytes);
+                        }
+                        break;
+                    case RFUI_MSG_UPSERT:
+                        // Grid rows merged by key: swap like a draw, re-format only the rows written
+                        rfui_symbols_apply(msg->symbols);
+                        msg->symbols = nullptr;
+                        if (msg->widget) {
+                            i64_t base = msg->widget->version;
+                            obj_p old_data = rfui_registry_update_data(msg->widget, msg->data);
+                            msg->widget->render_bytes = msg->bytes;
+                            rfui_latency_applied(msg->widget->latency, msg->stamp, rfui_clock_ns());
+                            if (old_data) {
+                                rfui_grid_upsert_rows(msg->widget, base, msg->rows, msg->nrows);
+                                old_data = rfui_grid_retire_data(msg->widget, old_data, msg->drop_bytes);
                             }
+                            queue_drop(old_data, msg->drop_bytes);
+                        } else {
+                            queue_drop(msg->data, msg->bytes);
                         }
                         break;
+                    case RFUI_MSG_SNAPSHOT:
+                        // Captured after this frame's render; request owns the path
+                        rfui_snapshot_request(msg->widget, msg->text, msg->width, msg->height);
+                        msg->text = nullptr;
+                        break;
+                    case RFUI_MSG_OVERLAY:
+                        rfui_overlay_set_visible(msg->width ? B8_TRUE : B8_FALSE);
+                        break;
                     case RFUI_MSG_RESULT:
                         // Display result in REPL
                         if (msg->text) {
                             rfui_repl_add_result_text(msg->text);
                         }
                         // Queue data for drop if present
-                        if (msg->data) {
-                            rfui_ui_msg_t* drop_msg = (rfui_ui_msg_t*)malloc(sizeof(rfui_ui_msg_t));
-                            if (drop_msg) {
-                                drop_msg->type = RFUI_MSG_DROP;
-                                drop_msg->obj = msg->data;
-                                drop_msg->widget = nullptr;
-                                drop_msg->expr = nullptr;
-                                if (!rfui_queue_push(g_ctx->ui_to_ray, drop_msg)) {
-                                    // Queue push failed - fall back to direct drop
-                                    // Leak (drop_obj requires Rayforce thread)
-                                        (void)msg->data;
-                                    free(drop_msg);
-                                } else {
-                                    poll_waker_p waker = rfui_ctx_get_waker(g_ctx);
-                                    if (waker) poll_waker_wake(waker);
-                                }
-                            } else {
-                                // Malloc failed - leak (drop_obj requires Rayforce thread)
-                                (void)msg->data;
-                            }
-                        }
+                        queue_drop(msg->data, msg->bytes);
                         break;
                 }
 
                 if (msg->text) {
                     free(msg->text);
                 }
+                free(msg->rows);
+                free(msg->symbols);
                 free(msg);
                 messages_processed++;
             }
         }
+        if (trace_span) {
+            char detail[24];
+            snprintf(detail, sizeof(detail), "%d messages", messages_processed);
+            rfui_trace_end("drain", detail, trace_span);
+        }
 
         // Single ImGui frame — viewports handle multi-window
+        trace_span = rfui_trace_begin();
         ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
+        if (g_headless) {
+            ImGuiIO& hio = ImGui::GetIO();
+            hio.DisplaySize = ImVec2((float)g_opts.width, (float)g_opts.height);
+            hio.DeltaTime = (float)std::max(frame_start - last_frame_time, 1e-6);
+        } else {
+            ImGui_ImplGlfw_NewFrame();
+        }
+        last_frame_time = frame_start;
         ImGui::NewFrame();
+        rfui_trace_end("new_frame", NULL, trace_span);
+
+        // F12 toggles the performance overlay
+        if (ImGui::IsKeyPressed(ImGuiKey_F12, false)) {
+            rfui_overlay_toggle();
+        }
 
         // Logo watermark behind content
+        trace_span = rfui_trace_begin();
         rfui_logo_render();
 
         // Main window: custom title bar + REPL content
@@ -418,7 +594,7 @@ i32_t rfui_ui_run(nil_t) {
             ImGui::PopStyleColor(4);
 
             // Window control buttons (right side) — simple text buttons
-            bool maximized = glfwGetWindowAttrib(g_window, GLFW_MAXIMIZED) != 0;
+            bool maximized = g_window && glfwGetWindowAttrib(g_window, GLFW_MAXIMIZED) != 0;
 
             ImGui::PushStyleColor(ImGuiCol_Button, ImVec4(0, 0, 0, 0));
             ImGui::PushStyleColor(ImGuiCol_ButtonHovered, ImVec4(1, 1, 1, 0.1f));
@@ -523,35 +699,88 @@ i32_t rfui_ui_run(nil_t) {
             ImGui::PopStyleColor();
             ImGui::PopStyleVar(2);
         }
+        rfui_trace_end("repl", NULL, trace_span);
 
         // Render all widgets (each opens its own ImGui window / viewport)
+        trace_span = rfui_trace_begin();
         rfui_registry_render();
+        rfui_trace_end("widgets", NULL, trace_span);
+
+        // Performance overlay on top of everything
+        rfui_overlay_render();
 
         // Render
+        trace_span = rfui_trace_begin();
         ImGui::Render();
+        rfui_trace_end("imgui_render", NULL, trace_span);
 
         // Draw main window (skip GL draw if minimized)
+        trace_span = rfui_trace_begin();
         if (!main_minimized) {
             int display_w, display_h;
-            glfwGetFramebufferSize(g_window, &display_w, &display_h);
+            if (g_headless) {
+                rfui_fbo_bind(&g_headless_fbo);
+                display_w = g_headless_fbo.width;
+                display_h = g_headless_fbo.height;
+            } else {
+                glfwGetFramebufferSize(g_window, &display_w, &display_h);
+            }
             glViewport(0, 0, display_w, display_h);
             glClearColor(clear_color.x * clear_color.w, clear_color.y * clear_color.w,
                          clear_color.z * clear_color.w, clear_color.w);
             glClear(GL_COLOR_BUFFER_BIT);
             ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-            glfwSwapBuffers(g_window);
+            if (g_headless) {
+                // No swap to throttle us: wait for the GPU so frame times are honest
+                glFinish();
+            } else {
+                glfwSwapBuffers(g_window);
+            }
         }
+        rfui_trace_end("gl_draw", NULL, trace_span);
+
+        // Offscreen captures replay this frame's draw lists (main context current)
+        rfui_snapshot_process();
 
         // Multi-viewport: update and render platform windows (always, even if main minimized)
         ImGuiIO& io = ImGui::GetIO();
         if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+            trace_span = rfui_trace_begin();
             GLFWwindow* backup_ctx = glfwGetCurrentContext();
             ImGui::UpdatePlatformWindows();
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_ctx);
+            rfui_trace_end("platform_windows", NULL, trace_span);
+        }
+
+        // Every viewport is swapped: draws applied this frame are now on screen
+        if (!main_minimized) {
+            rfui_registry_frame_presented(rfui_clock_ns());
+        }
+
+        rfui_trace_end("frame", NULL, trace_frame);
+
+        frame_count++;
+        double frame_ms = (glfwGetTime() - frame_start) * 1000.0;
+        rfui_overlay_frame(frame_ms);
+        rfui_memory_refresh(B8_FALSE);
+        if (collect_stats) {
+            g_frame_ms.push_back(frame_ms);
+        }
+        if (g_opts.max_frames > 0 && frame_count >= g_opts.max_frames) {
+            break;
+        }
+
+        // Fixed-rate headless frames
+        if (frame_interval > 0.0) {
+            rfui_headless_sleep(frame_start + frame_interval - glfwGetTime());
         }
     }
 
+    if (collect_stats) {
+        print_frame_stats();
+    }
+
     return 0;
 }
 
@@ -560,6 +789,10 @@ nil_t rfui_ui_destroy(nil_t) {
         return;
     }
 
+    // Finish in-flight PNG writes, drop pending captures
+    rfui_worker_destroy();
+    rfui_snapshot_destroy();
+
     // Destroy REPL state
     rfui_repl_destroy();
 
@@ -568,10 +801,14 @@ nil_t rfui_ui_destroy(nil_t) {
 
     // Destroy widget registry (frees all widgets)
     rfui_registry_destroy();
+    rfui_memory_destroy();
+    rfui_symbols_free();
 
     // Cleanup ImGui and ImPlot
     ImGui_ImplOpenGL3_Shutdown();
-    ImGui_ImplGlfw_Shutdown();
+    if (!g_headless) {
+        ImGui_ImplGlfw_Shutdown();
+    }
     ImPlot::DestroyContext();
     ImGui::DestroyContext();
 
@@ -586,13 +823,23 @@ nil_t rfui_ui_destroy(nil_t) {
         glfwDestroyWindow(g_window);
         g_window = nullptr;
     }
+    if (g_headless) {
+        rfui_fbo_destroy(&g_headless_fbo);
+        rfui_headless_destroy();
+    }
     glfwTerminate();
 
     g_initialized = false;
 }
 
 b8_t rfui_ui_should_run(nil_t) {
-    if (!g_initialized || !g_window) {
+    if (!g_initialized) {
+        return B8_FALSE;
+    }
+    if (g_headless) {
+        return B8_TRUE;
+    }
+    if (!g_window) {
         return B8_FALSE;
     }
     return glfwWindowShouldClose(g_window) ? B8_FALSE : B8_TRUE;
@@ -602,4 +849,8 @@ nil_t rfui_ui_wake(nil_t) {
     glfwPostEmptyEvent();
 }
 
+nil_t rfui_ui_queue_drop(obj_p obj, i64_t bytes) {
+    queue_drop(obj, bytes);
+}
+
 } // extern "C"
@@ -1,5 +1,6 @@
 // src/widget.c
 #include "../include/rfui/widget.h"
+#include "../include/rfui/grid_renderer.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -31,14 +32,34 @@ rfui_widget_t* rfui_widget_create(rfui_widget_type_t type, const char* name) {
         return NULL;
     }
 
+    w->latency = rfui_latency_create();
+    if (!w->latency) {
+        free(w->name);
+        free(w);
+        return NULL;
+    }
+
     w->type = type;
     w->data = NULL;
+    memset(&w->keyed, 0, sizeof(w->keyed));
+    w->columns = NULL;
+    w->hidden = NULL;
+    w->nhidden = 0;
+    w->blank = NULL;
+    w->shipped = NULL;
+    w->shipped_bytes = NULL;
+    w->nshipped = 0;
+    w->shipped_total = 0;
+    w->dense = B8_FALSE;
     w->post_query = NULL;
     w->on_select = NULL;
+    w->select_busy = 0;
     w->is_open = B8_TRUE;
     w->dock_id = 0;
     w->ui_state = NULL;
     w->render_data = NULL;
+    w->render_bytes = 0;
+    w->version = 0;
 
     return w;
 }
@@ -48,10 +69,21 @@ nil_t rfui_widget_destroy(rfui_widget_t* w) {
 
     free(w->name);
     if (w->data) drop_obj(w->data);
+    rfui_keyed_free(&w->keyed);
+    if (w->columns) drop_obj(w->columns);
+    if (w->blank) drop_obj(w->blank);
+    free(w->hidden);
+    free(w->shipped);
+    free(w->shipped_bytes);
     if (w->post_query) drop_obj(w->post_query);
     if (w->on_select) drop_obj(w->on_select);
     if (w->render_data) drop_obj(w->render_data);
-    free(w->ui_state);
+    if (w->type == RFUI_WIDGET_GRID) {
+        rfui_grid_free_state(w);
+    } else {
+        free(w->ui_state);
+    }
+    rfui_latency_destroy(w->latency);
     free(w);
 }
 
@@ -18,6 +18,7 @@ extern "C" {
 #include "../include/rfui/grid_renderer.h"
 #include "../include/rfui/chart_renderer.h"
 #include "../include/rfui/text_renderer.h"
+#include "../include/rfui/trace.h"
 }
 
 // Global widget storage
@@ -74,6 +75,17 @@ nil_t rfui_registry_add(rfui_widget_t* widget) {
     g_widgets.push_back(widget);
 }
 
+nil_t rfui_registry_window_label(rfui_widget_t* widget, char* buf, i64_t size) {
+    const char* icon = "";
+    switch (widget->type) {
+        case RFUI_WIDGET_GRID:  icon = ICON_TABLE " ";      break;
+        case RFUI_WIDGET_CHART: icon = ICON_CHART_LINE " "; break;
+        case RFUI_WIDGET_TEXT:  icon = ICON_FILE_LINES " "; break;
+        default: break;
+    }
+    snprintf(buf, size, "%s%s", icon, widget->name);
+}
+
 // Render widget (shared logic for both render paths)
 static void render_widget(rfui_widget_t* widget) {
     if (widget == nullptr || !widget->is_open) {
@@ -88,19 +100,13 @@ static void render_widget(rfui_widget_t* widget) {
 
         // Build icon-prefixed window label
         char window_label[256];
-        const char* icon = "";
-        switch (widget->type) {
-            case RFUI_WIDGET_GRID:  icon = ICON_TABLE " ";      break;
-            case RFUI_WIDGET_CHART: icon = ICON_CHART_LINE " "; break;
-            case RFUI_WIDGET_TEXT:  icon = ICON_FILE_LINES " "; break;
-            default: break;
-        }
-        snprintf(window_label, sizeof(window_label), "%s%s", icon, widget->name);
+        rfui_registry_window_label(widget, window_label, sizeof(window_label));
 
         // Begin widget window with close button
         ImGui::Begin(window_label, (bool*)&widget->is_open);
 
         // Render based on widget type
+        i64_t trace_span = rfui_trace_begin();
         switch (widget->type) {
             case RFUI_WIDGET_GRID:
                 rfui_render_grid(widget);
@@ -115,6 +121,7 @@ static void render_widget(rfui_widget_t* widget) {
                 ImGui::TextDisabled("Unknown widget type: %d", widget->type);
                 break;
         }
+        rfui_trace_end("render_widget", widget->name, trace_span);
 
     ImGui::End();
 }
@@ -125,6 +132,25 @@ nil_t rfui_registry_render(nil_t) {
     }
 }
 
+i64_t rfui_registry_count(nil_t) {
+    return (i64_t)g_widgets.size();
+}
+
+rfui_widget_t* rfui_registry_get(i64_t index) {
+    if (index < 0 || index >= (i64_t)g_widgets.size()) {
+        return nullptr;
+    }
+    return g_widgets[(size_t)index];
+}
+
+nil_t rfui_registry_frame_presented(i64_t now) {
+    for (rfui_widget_t* widget : g_widgets) {
+        if (widget->is_open) {
+            rfui_latency_presented(widget->latency, now);
+        }
+    }
+}
+
 obj_p rfui_registry_update_data(rfui_widget_t* widget, obj_p new_data) {
     if (widget == nullptr) {
         return nullptr;
@@ -140,6 +166,7 @@ obj_p rfui_registry_update_data(rfui_widget_t* widget, obj_p new_data) {
 
     // Set new data
     widget->render_data = new_data;
+    widget->version++;
 
     // Return old data for caller to queue for drop
     return old_data;
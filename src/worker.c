@@ -0,0 +1,196 @@
+// src/worker.c
+// Background worker pool: FIFO job list guarded by a mutex/cond pair
+#include <stdlib.h>
+#include <stdio.h>
+#include "../include/rfui/worker.h"
+#include "../include/rfui/trace.h"
+#include "../include/rfui/ui.h"
+#include "../deps/rayforce/core/thread.h"
+
+#define RFUI_WORKER_MAX_THREADS 64
+
+typedef struct rfui_job_t {
+    rfui_job_fn fn;
+    raw_p arg;
+    struct rfui_job_t* next;
+} rfui_job_t;
+
+typedef struct rfui_worker_pool_t {
+    mutex_t mutex;
+    cond_t cond;
+    rfui_job_t* head;
+    rfui_job_t* tail;
+    b8_t stopping;
+    i32_t nthreads;
+    ray_thread_t threads[RFUI_WORKER_MAX_THREADS];
+} rfui_worker_pool_t;
+
+static rfui_worker_pool_t* g_pool = NULL;
+
+static void* worker_main(void* arg) {
+    rfui_worker_pool_t* pool = (rfui_worker_pool_t*)arg;
+    rfui_trace_thread_name("worker");
+
+    for (;;) {
+        mutex_lock(&pool->mutex);
+        while (!pool->head && !pool->stopping) {
+            cond_wait(&pool->cond, &pool->mutex);
+        }
+        rfui_job_t* job = pool->head;
+        if (!job) {
+            // Stopping and queue drained
+            mutex_unlock(&pool->mutex);
+            break;
+        }
+        pool->head = job->next;
+        if (!pool->head) pool->tail = NULL;
+        mutex_unlock(&pool->mutex);
+
+        i64_t trace_span = rfui_trace_begin();
+        job->fn(job->arg);
+        rfui_trace_end("job", NULL, trace_span);
+        free(job);
+    }
+
+    return NULL;
+}
+
+i32_t rfui_worker_init(i32_t nthreads) {
+    if (g_pool) return 0;
+
+    if (nthreads <= 0) nthreads = RFUI_WORKER_THREADS;
+    if (nthreads > RFUI_WORKER_MAX_THREADS) nthreads = RFUI_WORKER_MAX_THREADS;
+
+    rfui_worker_pool_t* pool = calloc(1, sizeof(rfui_worker_pool_t));
+    if (!pool) return -1;
+
+    pool->mutex = mutex_create();
+    pool->cond = cond_create();
+
+    for (i32_t i = 0; i < nthreads; i++) {
+        pool->threads[i] = ray_thread_create(worker_main, pool);
+        if (!pool->threads[i].handle) {
+            fprintf(stderr, "Worker: failed to start thread %d\n", i);
+            break;
+        }
+        pool->nthreads++;
+    }
+
+    if (pool->nthreads == 0) {
+        cond_destroy(&pool->cond);
+        mutex_destroy(&pool->mutex);
+        free(pool);
+        return -1;
+    }
+
+    g_pool = pool;
+    return 0;
+}
+
+b8_t rfui_worker_submit(rfui_job_fn fn, raw_p arg) {
+    if (!g_pool || !fn) return B8_FALSE;
+
+    rfui_job_t* job = malloc(sizeof(rfui_job_t));
+    if (!job) return B8_FALSE;
+    job->fn = fn;
+    job->arg = arg;
+    job->next = NULL;
+
+    mutex_lock(&g_pool->mutex);
+    if (g_pool->stopping) {
+        mutex_unlock(&g_pool->mutex);
+        free(job);
+        return B8_FALSE;
+    }
+    if (g_pool->tail) g_pool->tail->next = job;
+    else g_pool->head = job;
+    g_pool->tail = job;
+    cond_signal(&g_pool->cond);
+    mutex_unlock(&g_pool->mutex);
+
+    return B8_TRUE;
+}
+
+i32_t rfui_worker_count(nil_t) {
+    return g_pool ? g_pool->nthreads : 0;
+}
+
+nil_t rfui_worker_destroy(nil_t) {
+    rfui_worker_pool_t* pool = g_pool;
+    if (!pool) return;
+
+    // Wake every thread; each exits once the queue is drained
+    mutex_lock(&pool->mutex);
+    pool->stopping = B8_TRUE;
+    for (i32_t i = 0; i < pool->nthreads; i++) {
+        cond_signal(&pool->cond);
+    }
+    mutex_unlock(&pool->mutex);
+
+    for (i32_t i = 0; i < pool->nthreads; i++) {
+        thread_join(pool->threads[i]);
+    }
+
+    g_pool = NULL;
+    cond_destroy(&pool->cond);
+    mutex_destroy(&pool->mutex);
+    free(pool);
+}
+
+// ============================================================================
+// Tasks
+// ============================================================================
+
+static nil_t task_main(raw_p arg) {
+    rfui_task_t* t = (rfui_task_t*)arg;
+    if (!rfui_task_cancelled(t)) t->fn(t->arg);
+
+    // The last copy out reports completion; the task may be freed right after
+    if (__atomic_sub_fetch(&t->running, 1, __ATOMIC_ACQ_REL) != 0) return;
+    mutex_lock(&t->mutex);
+    __atomic_store_n(&t->done, 1, __ATOMIC_RELEASE);
+    cond_broadcast(&t->cond);
+    mutex_unlock(&t->mutex);
+    rfui_ui_wake();
+}
+
+nil_t rfui_task_submit(rfui_task_t* t, rfui_job_fn fn, raw_p arg, i32_t copies) {
+    if (copies < 1) copies = 1;
+    t->fn = fn;
+    t->arg = arg;
+    t->running = copies;
+    t->cancel = 0;
+    t->done = 0;
+    t->mutex = mutex_create();
+    t->cond = cond_create();
+    for (i32_t i = 0; i < copies; i++) {
+        // No pool - run inline rather than never finishing
+        if (!rfui_worker_submit(task_main, t)) task_main(t);
+    }
+}
+
+nil_t rfui_task_cancel(rfui_task_t* t) {
+    __atomic_store_n(&t->cancel, 1, __ATOMIC_RELAXED);
+}
+
+b8_t rfui_task_cancelled(const rfui_task_t* t) {
+    return __atomic_load_n(&t->cancel, __ATOMIC_RELAXED) != 0;
+}
+
+b8_t rfui_task_done(const rfui_task_t* t) {
+    return __atomic_load_n(&t->done, __ATOMIC_ACQUIRE) != 0;
+}
+
+nil_t rfui_task_wait(rfui_task_t* t) {
+    rfui_task_cancel(t);
+    mutex_lock(&t->mutex);
+    while (!rfui_task_done(t)) {
+        cond_wait(&t->cond, &t->mutex);
+    }
+    mutex_unlock(&t->mutex);
+}
+
+nil_t rfui_task_free(rfui_task_t* t) {
+    mutex_destroy(&t->mutex);
+    cond_destroy(&t->cond);
+}